@@ -26,8 +26,11 @@
 #include <dirent.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <fnmatch.h>
 #include <grp.h>
+#include <limits.h>
 #include <pwd.h>
+#include <sched.h>
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
@@ -61,16 +64,27 @@ serialPort* pushBack(serialPortVector* vector, const char* key, const char* frie
 	// Initialize the serial port mutex and condition variables
 	memset(port, 0, sizeof(serialPort));
 	pthread_mutex_init(&port->eventMutex, NULL);
+	pthread_mutex_init(&port->txMutex, NULL);
+	pthread_mutex_init(&port->recordingMutex, NULL);
+	pthread_mutex_init(&port->rs485Mutex, NULL);
 	pthread_condattr_t conditionVariableAttributes;
 	pthread_condattr_init(&conditionVariableAttributes);
 #if !defined(__APPLE__) && !defined(__OpenBSD__)
 	pthread_condattr_setclock(&conditionVariableAttributes, CLOCK_MONOTONIC);
 #endif
 	pthread_cond_init(&port->eventReceived, &conditionVariableAttributes);
+	pthread_cond_init(&port->ringDataReceived, &conditionVariableAttributes);
+	pthread_cond_init(&port->ringSpaceAvailable, &conditionVariableAttributes);
+	pthread_cond_init(&port->txDataQueued, &conditionVariableAttributes);
+	pthread_cond_init(&port->txSpaceAvailable, &conditionVariableAttributes);
 	pthread_condattr_destroy(&conditionVariableAttributes);
 
 	// Initialize the storage structure
 	port->handle = -1;
+	port->virtualDevice = -1;
+	port->closingPipe[0] = port->closingPipe[1] = -1;
+	port->listenerWakePipe[0] = port->listenerWakePipe[1] = -1;
+	port->ringDataPipe[0] = port->ringDataPipe[1] = -1;
 	port->enumerated = 1;
 	port->portPath = (char*)malloc(strlen(key) + 1);
 	port->portLocation = (char*)malloc(strlen(location) + 1);
@@ -104,8 +118,28 @@ void removePort(serialPortVector* vector, serialPort* port)
 	free(port->portDescription);
 	if (port->readBuffer)
 		free(port->readBuffer);
+	if (port->ringBuffer)
+		free(port->ringBuffer);
+	if (port->txBuffer)
+		free(port->txBuffer);
+	for (int i = 0; i < 2; ++i)
+	{
+		if (port->closingPipe[i] >= 0)
+			close(port->closingPipe[i]);
+		if (port->listenerWakePipe[i] >= 0)
+			close(port->listenerWakePipe[i]);
+		if (port->ringDataPipe[i] >= 0)
+			close(port->ringDataPipe[i]);
+	}
 	pthread_cond_destroy(&port->eventReceived);
+	pthread_cond_destroy(&port->ringDataReceived);
+	pthread_cond_destroy(&port->ringSpaceAvailable);
+	pthread_cond_destroy(&port->txDataQueued);
+	pthread_cond_destroy(&port->txSpaceAvailable);
 	pthread_mutex_destroy(&port->eventMutex);
+	pthread_mutex_destroy(&port->txMutex);
+	pthread_mutex_destroy(&port->recordingMutex);
+	pthread_mutex_destroy(&port->rs485Mutex);
 
 	// Move up all remaining ports in the serial port listing
 	for (int i = 0; i < vector->length; ++i)
@@ -127,6 +161,7 @@ void removePort(serialPortVector* vector, serialPort* port)
 #include <linux/serial.h>
 #include <asm/termios.h>
 #include <asm/ioctls.h>
+#include <sys/syscall.h>
 
 void getDriverName(const char* directoryToSearch, char* friendlyName)
 {
@@ -330,7 +365,7 @@ char driverGetPortLocation(char topLevel, const char *fullPathToSearch, const ch
 	return isUSB;
 }
 
-void recursiveSearchForComPorts(serialPortVector* comPorts, const char* fullPathToSearch)
+void recursiveSearchForComPorts(serialPortVector* comPorts, const char* fullPathToSearch, const portFilter* filter)
 {
 	// Open the directory
 	DIR *directoryIterator = opendir(fullPathToSearch);
@@ -357,6 +392,14 @@ void recursiveSearchForComPorts(serialPortVector* comPorts, const char* fullPath
 					strcpy(systemName, "/dev/");
 					strcat(systemName, directoryEntry->d_name);
 
+					// Skip any port that does not match the requested filter before retrieving its details
+					if (filter && !portMatchesFilter(filter, systemName))
+					{
+						free(systemName);
+						directoryEntry = readdir(directoryIterator);
+						continue;
+					}
+
 					// Determine location of port
 					char* portLocation = (char*)malloc(128);
 					char* productFile = (char*)malloc(strlen(fullPathToSearch) + strlen(directoryEntry->d_name) + 30);
@@ -489,7 +532,7 @@ void recursiveSearchForComPorts(serialPortVector* comPorts, const char* fullPath
 					strcpy(nextDirectory, fullPathToSearch);
 					strcat(nextDirectory, directoryEntry->d_name);
 					strcat(nextDirectory, "/");
-					recursiveSearchForComPorts(comPorts, nextDirectory);
+					recursiveSearchForComPorts(comPorts, nextDirectory, filter);
 					free(nextDirectory);
 				}
 			}
@@ -501,7 +544,7 @@ void recursiveSearchForComPorts(serialPortVector* comPorts, const char* fullPath
 	closedir(directoryIterator);
 }
 
-void driverBasedSearchForComPorts(serialPortVector* comPorts, const char* fullPathToDriver, const char* fullBasePathToPort)
+void driverBasedSearchForComPorts(serialPortVector* comPorts, const char* fullPathToDriver, const char* fullBasePathToPort, const portFilter* filter)
 {
 	// Search for unidentified physical serial ports
 	FILE *serialDriverFile = fopen(fullPathToDriver, "rb");
@@ -521,7 +564,7 @@ void driverBasedSearchForComPorts(serialPortVector* comPorts, const char* fullPa
 				serialPort *port = fetchPort(comPorts, systemName);
 				if (port)
 					port->enumerated = 1;
-				else
+				else if (!filter || portMatchesFilter(filter, systemName))
 				{
 					// Ensure that the port is valid and not a symlink
 					struct stat fileStats;
@@ -548,7 +591,7 @@ void driverBasedSearchForComPorts(serialPortVector* comPorts, const char* fullPa
 	}
 }
 
-void lastDitchSearchForComPorts(serialPortVector* comPorts)
+void lastDitchSearchForComPorts(serialPortVector* comPorts, const portFilter* filter)
 {
 	// Open the linux dev directory
 	DIR *directoryIterator = opendir("/dev/");
@@ -557,8 +600,17 @@ void lastDitchSearchForComPorts(serialPortVector* comPorts)
 
 	// Read all files in the current directory
 	struct dirent *directoryEntry = readdir(directoryIterator);
+	char devicePath[sizeof(directoryEntry->d_name) + 8];
 	while (directoryEntry)
 	{
+		// Skip any file that does not match the requested filter
+		snprintf(devicePath, sizeof(devicePath), "/dev/%s", directoryEntry->d_name);
+		if (filter && !portMatchesFilter(filter, devicePath))
+		{
+			directoryEntry = readdir(directoryIterator);
+			continue;
+		}
+
 		// See if the file names a potential serial port
 		if ((strlen(directoryEntry->d_name) >= 6) && (directoryEntry->d_name[0] == 't') && (directoryEntry->d_name[1] == 't') && (directoryEntry->d_name[2] == 'y') &&
 				(((directoryEntry->d_name[3] == 'A') && (directoryEntry->d_name[4] == 'M') && (directoryEntry->d_name[5] == 'A')) ||
@@ -693,6 +745,51 @@ void lastDitchSearchForComPorts(serialPortVector* comPorts)
 	closedir(directoryIterator);
 }
 
+char portMatchesFilter(const portFilter *filter, const char *portPath)
+{
+	// Match the requested pattern against the full device path if it contains a directory, otherwise against the device name only
+	const char *portName = strrchr(portPath, '/') ? (strrchr(portPath, '/') + 1) : portPath;
+	if (filter->pathPattern && fnmatch(filter->pathPattern, strchr(filter->pathPattern, '/') ? portPath : portName, 0))
+		return 0;
+	if (!filter->driverName && (filter->vendorID < 0) && (filter->productID < 0))
+		return 1;
+
+	// Resolve the sysfs device that backs this terminal
+	char sysfsPath[PATH_MAX], devicePath[PATH_MAX];
+	if ((snprintf(sysfsPath, sizeof(sysfsPath), "/sys/class/tty/%s/device", portName) >= (int)sizeof(sysfsPath)) || !realpath(sysfsPath, devicePath))
+		return 0;
+
+	// Search upwards from the device for a matching kernel driver and for the USB device node holding its vendor and product identifiers
+	unsigned int vendorID = 0, productID = 0;
+	char driverMatched = !filter->driverName, identifiersFound = (filter->vendorID < 0) && (filter->productID < 0);
+	for (int i = 0; (!driverMatched || !identifiersFound) && (i < 5) && strrchr(devicePath, '/'); ++i)
+	{
+		// Stop searching if any attribute path would not fit, since a truncated path could name a different file
+		char linkedPath[PATH_MAX];
+		if (snprintf(sysfsPath, sizeof(sysfsPath), "%s/driver", devicePath) >= (int)sizeof(sysfsPath))
+			break;
+		if (!driverMatched && realpath(sysfsPath, linkedPath))
+			driverMatched = !strcmp(strrchr(linkedPath, '/') + 1, filter->driverName);
+		if (snprintf(sysfsPath, sizeof(sysfsPath), "%s/idVendor", devicePath) >= (int)sizeof(sysfsPath))
+			break;
+		FILE *input = identifiersFound ? NULL : fopen(sysfsPath, "rb");
+		if (input)
+		{
+			identifiersFound = (fscanf(input, "%x", &vendorID) == 1);
+			fclose(input);
+			if ((snprintf(sysfsPath, sizeof(sysfsPath), "%s/idProduct", devicePath) < (int)sizeof(sysfsPath)) && ((input = fopen(sysfsPath, "rb")) != NULL))
+			{
+				identifiersFound = identifiersFound && (fscanf(input, "%x", &productID) == 1);
+				fclose(input);
+			}
+			if (!identifiersFound || ((filter->vendorID >= 0) && (vendorID != (unsigned int)filter->vendorID)) || ((filter->productID >= 0) && (productID != (unsigned int)filter->productID)))
+				return 0;
+		}
+		*strrchr(devicePath, '/') = '\0';
+	}
+	return driverMatched && identifiersFound;
+}
+
 baud_rate getBaudRateCode(baud_rate baudRate)
 {
 	// Translate a raw baud rate into a system-specified one
@@ -875,6 +972,150 @@ int setBaudRateCustom(int portFD, baud_rate baudRate)
 	return retVal;
 }
 
+int setTermiosFlagsCustomBaudRate(int portFD, baud_rate baudRate, unsigned int inputFlags, unsigned int controlFlags)
+{
+#ifdef TCSETS2
+	// Apply the new flags and an arbitrary baud rate using a single atomic update
+	struct termios2 options = { 0 };
+	int retVal = ioctl(portFD, TCGETS2, &options);
+	if (retVal == 0)
+	{
+		options.c_iflag = inputFlags;
+		options.c_cflag = (controlFlags & ~(CBAUD | (CBAUD << IBSHIFT))) | BOTHER;
+		options.c_ispeed = baudRate;
+		options.c_ospeed = baudRate;
+		retVal = ioctl(portFD, TCSETS2, &options);
+	}
+#else
+	// Apply the new flags with the placeholder baud rate that selects the custom divisor
+	struct termios options = { 0 };
+	int retVal = ioctl(portFD, TCGETS, &options);
+	if (retVal == 0)
+	{
+		options.c_iflag = inputFlags;
+		options.c_cflag = (controlFlags & ~CBAUD) | B38400;
+		retVal = ioctl(portFD, TCSETS, &options);
+	}
+	if (retVal == 0)
+		retVal = setBaudRateCustom(portFD, baudRate);
+#endif
+	return retVal;
+}
+
+int setLatencyTimer(const char *portFile, int latencyMS)
+{
+	// Resolve the actual TTY device name in case the port was specified using a symbolic link
+	char *realPortFile = realpath(portFile, NULL);
+	const char *deviceName = strrchr(realPortFile ? realPortFile : portFile, '/');
+	deviceName = deviceName ? (deviceName + 1) : (realPortFile ? realPortFile : portFile);
+
+	// Only USB-serial drivers that support a configurable latency timer (e.g. ftdi_sio) expose this attribute
+	char latencyFile[256], latencyString[16] = { 0 };
+	snprintf(latencyFile, sizeof(latencyFile), "/sys/class/tty/%s/device/latency_timer", deviceName);
+	if (realPortFile)
+		free(realPortFile);
+	FILE *output = fopen(latencyFile, "wb");
+	if (!output)
+		return 0;
+	fprintf(output, "%d", latencyMS);
+	if (fclose(output))
+		return 0;
+
+	// Verify that the driver accepted the new latency value
+	FILE *input = fopen(latencyFile, "rb");
+	if (!input)
+		return 0;
+	if (!fgets(latencyString, sizeof(latencyString), input))
+		latencyString[0] = '\0';
+	fclose(input);
+	return (atoi(latencyString) == latencyMS);
+}
+
+// Hotplug monitoring functionality
+#include <linux/netlink.h>
+#include <poll.h>
+#include <sys/socket.h>
+
+static pthread_t hotplugThread;
+static volatile char hotplugThreadRunning = 0;
+static int hotplugSocket = -1;
+static void (*hotplugNotify)(void) = NULL;
+
+static void* hotplugMonitorThread(void *unused)
+{
+	// Loop forever while monitoring is enabled
+	char ueventBuffer[4096];
+	struct pollfd waitingSet = { hotplugSocket, POLLIN, 0 };
+	while (hotplugThreadRunning)
+	{
+		// Wait for a kernel device event
+		waitingSet.revents = 0;
+		if (poll(&waitingSet, 1, 500) <= 0)
+			continue;
+		ssize_t ueventLength = recv(hotplugSocket, ueventBuffer, sizeof(ueventBuffer) - 1, MSG_DONTWAIT);
+		if ((ueventLength < 0) && (errno != EINTR) && (errno != EAGAIN) && (errno != EWOULDBLOCK))
+		{
+			// Events may have been lost, such as after a socket receive buffer overrun, so invalidate any cached port listing
+			int errorNumber = errno;
+			hotplugNotify();
+			if (errorNumber != ENOBUFS)
+				poll(NULL, 0, 100);
+			continue;
+		}
+		else if (ueventLength <= 0)
+			continue;
+		ueventBuffer[ueventLength] = '\0';
+
+		// Each uevent is an "action@devpath" header followed by NUL-separated KEY=VALUE pairs, so only report TTY device changes
+		for (char *field = ueventBuffer; field < (ueventBuffer + ueventLength); field += strlen(field) + 1)
+			if (strcmp(field, "SUBSYSTEM=tty") == 0)
+			{
+				hotplugNotify();
+				break;
+			}
+	}
+	return NULL;
+}
+
+char startHotplugMonitor(void (*notifyCallback)(void))
+{
+	// Subscribe to kernel device uevents
+	struct sockaddr_nl address = { 0 };
+	address.nl_family = AF_NETLINK;
+	address.nl_groups = 1;
+	if ((hotplugSocket = socket(AF_NETLINK, SOCK_DGRAM | SOCK_CLOEXEC, NETLINK_KOBJECT_UEVENT)) < 0)
+		return 0;
+	if (bind(hotplugSocket, (struct sockaddr*)&address, sizeof(address)))
+	{
+		close(hotplugSocket);
+		hotplugSocket = -1;
+		return 0;
+	}
+
+	// Start the monitoring thread
+	hotplugNotify = notifyCallback;
+	hotplugThreadRunning = 1;
+	if (pthread_create(&hotplugThread, NULL, hotplugMonitorThread, NULL))
+	{
+		hotplugThreadRunning = 0;
+		close(hotplugSocket);
+		hotplugSocket = -1;
+		return 0;
+	}
+	return 1;
+}
+
+void stopHotplugMonitor(void)
+{
+	if (hotplugThreadRunning)
+	{
+		hotplugThreadRunning = 0;
+		pthread_join(hotplugThread, NULL);
+		close(hotplugSocket);
+		hotplugSocket = -1;
+	}
+}
+
 // Solaris-specific functionality
 #elif defined(__sun__)
 
@@ -1629,6 +1870,108 @@ int setBaudRateCustom(int portFD, baud_rate baudRate)
 	return retVal;
 }
 
+// Hotplug monitoring functionality
+static pthread_t hotplugThread;
+static volatile char hotplugThreadRunning = 0;
+static IONotificationPortRef hotplugNotificationPort = NULL;
+static io_iterator_t hotplugAddedIterator = 0, hotplugRemovedIterator = 0;
+static void (*hotplugNotify)(void) = NULL;
+
+static void hotplugNotificationCallback(void *refCon, io_iterator_t iterator)
+{
+	// The iterator must be fully drained to re-arm the notification
+	char portsChanged = 0;
+	io_object_t serialService;
+	while ((serialService = IOIteratorNext(iterator)))
+	{
+		IOObjectRelease(serialService);
+		portsChanged = 1;
+	}
+	if (portsChanged && refCon)
+		hotplugNotify();
+}
+
+static void* hotplugMonitorThread(void *unused)
+{
+	// Deliver IOKit notifications on this thread's run loop while monitoring is enabled
+	CFRunLoopAddSource(CFRunLoopGetCurrent(), IONotificationPortGetRunLoopSource(hotplugNotificationPort), kCFRunLoopDefaultMode);
+	while (hotplugThreadRunning)
+		CFRunLoopRunInMode(kCFRunLoopDefaultMode, 0.5, false);
+	CFRunLoopRemoveSource(CFRunLoopGetCurrent(), IONotificationPortGetRunLoopSource(hotplugNotificationPort), kCFRunLoopDefaultMode);
+	return NULL;
+}
+
+char startHotplugMonitor(void (*notifyCallback)(void))
+{
+	// Register for serial service publication and termination notifications
+	hotplugNotify = notifyCallback;
+	if (!(hotplugNotificationPort = IONotificationPortCreate(kIOMasterPortDefault)))
+		return 0;
+	if ((IOServiceAddMatchingNotification(hotplugNotificationPort, kIOPublishNotification, IOServiceMatching(kIOSerialBSDServiceValue), hotplugNotificationCallback, (void*)1, &hotplugAddedIterator) != KERN_SUCCESS) ||
+			(IOServiceAddMatchingNotification(hotplugNotificationPort, kIOTerminatedNotification, IOServiceMatching(kIOSerialBSDServiceValue), hotplugNotificationCallback, (void*)1, &hotplugRemovedIterator) != KERN_SUCCESS))
+	{
+		if (hotplugAddedIterator)
+			IOObjectRelease(hotplugAddedIterator);
+		IONotificationPortDestroy(hotplugNotificationPort);
+		hotplugNotificationPort = NULL;
+		hotplugAddedIterator = 0;
+		return 0;
+	}
+
+	// Arm both notifications without reporting the already-present ports
+	hotplugNotificationCallback(NULL, hotplugAddedIterator);
+	hotplugNotificationCallback(NULL, hotplugRemovedIterator);
+
+	// Start the monitoring thread
+	hotplugThreadRunning = 1;
+	if (pthread_create(&hotplugThread, NULL, hotplugMonitorThread, NULL))
+	{
+		hotplugThreadRunning = 0;
+		IOObjectRelease(hotplugAddedIterator);
+		IOObjectRelease(hotplugRemovedIterator);
+		IONotificationPortDestroy(hotplugNotificationPort);
+		hotplugNotificationPort = NULL;
+		hotplugAddedIterator = hotplugRemovedIterator = 0;
+		return 0;
+	}
+	return 1;
+}
+
+void stopHotplugMonitor(void)
+{
+	if (hotplugThreadRunning)
+	{
+		hotplugThreadRunning = 0;
+		pthread_join(hotplugThread, NULL);
+		IOObjectRelease(hotplugAddedIterator);
+		IOObjectRelease(hotplugRemovedIterator);
+		IONotificationPortDestroy(hotplugNotificationPort);
+		hotplugNotificationPort = NULL;
+		hotplugAddedIterator = hotplugRemovedIterator = 0;
+	}
+}
+
+#endif
+
+#if !defined(__linux__)
+
+char portMatchesFilter(const portFilter *filter, const char *portPath)
+{
+	// Device driver and USB identifier criteria can only be evaluated on Linux, so only match against the requested path pattern
+	const char *portName = strrchr(portPath, '/') ? (strrchr(portPath, '/') + 1) : portPath;
+	if (filter->driverName || (filter->vendorID >= 0) || (filter->productID >= 0))
+		return 0;
+	return !filter->pathPattern || !fnmatch(filter->pathPattern, strchr(filter->pathPattern, '/') ? portPath : portName, 0);
+}
+
+#endif
+
+#if !defined(__linux__) && !defined(__APPLE__)
+
+// Hotplug notifications are not available on this system, so the port listing is always fully re-enumerated
+char startHotplugMonitor(void (*notifyCallback)(void)) { return 0; }
+void stopHotplugMonitor(void) {}
+
 #endif
 
 int verifyAndSetUserPortGroup(const char *portFile)
@@ -1680,3 +2023,246 @@ int verifyAndSetUserPortGroup(const char *portFile)
 	// Return whether the user can currently access the serial port
 	return userCanAccess;
 }
+
+// Thread scheduling functionality
+int applyThreadScheduling(long long cpuAffinityMask, int realTimePriority, int roundRobin)
+{
+	// Restrict the calling thread to the requested CPUs (only supported on Linux)
+	int appliedSettings = 0;
+#if defined(__linux__)
+	if (cpuAffinityMask)
+	{
+		unsigned long cpuSet[64 / (8 * sizeof(unsigned long))];
+		memset(cpuSet, 0, sizeof(cpuSet));
+		for (int i = 0; i < 64; ++i)
+			if (cpuAffinityMask & (1LL << i))
+				cpuSet[i / (8 * sizeof(unsigned long))] |= (1UL << (i % (8 * sizeof(unsigned long))));
+		if (syscall(SYS_sched_setaffinity, 0, sizeof(cpuSet), cpuSet) == 0)
+			appliedSettings |= com_fazecast_jSerialComm_SerialPort_THREAD_SCHEDULING_AFFINITY;
+	}
+#endif
+
+	// Switch the calling thread to a real-time scheduling policy, clamping the priority to the range supported by the system
+	if (realTimePriority > 0)
+	{
+		struct sched_param schedulingParameters;
+		int policy = roundRobin ? SCHED_RR : SCHED_FIFO;
+		int minimumPriority = sched_get_priority_min(policy), maximumPriority = sched_get_priority_max(policy);
+		memset(&schedulingParameters, 0, sizeof(schedulingParameters));
+		schedulingParameters.sched_priority = (realTimePriority < minimumPriority) ? minimumPriority : ((realTimePriority > maximumPriority) ? maximumPriority : realTimePriority);
+		if (pthread_setschedparam(pthread_self(), policy, &schedulingParameters) == 0)
+			appliedSettings |= com_fazecast_jSerialComm_SerialPort_THREAD_SCHEDULING_REAL_TIME;
+	}
+	return appliedSettings;
+}
+
+// Streaming frame decoding functionality
+static inline int appendFrameByte(jint *state, unsigned char *frame, unsigned char value)
+{
+	// Start discarding the current frame if it would exceed the maximum length
+	if (state[FRAME_STATE_FRAME_LENGTH] >= state[FRAME_STATE_MAX_LENGTH])
+	{
+		state[FRAME_STATE_DISCARDING] = 1;
+		state[FRAME_STATE_FRAME_LENGTH] = 0;
+		return 0;
+	}
+	frame[state[FRAME_STATE_FRAME_LENGTH]++] = value;
+	return 1;
+}
+
+int decodeFrames(const unsigned char *data, int length, jint *state, unsigned char *frames, jint *boundaries)
+{
+	// The frame buffer starts with any partially decoded frame carried over from the previous chunk
+	int numFrames = 0, frameStart = 0, offset = 0;
+	if (state[FRAME_STATE_FORMAT] == FRAME_FORMAT_LENGTH_PREFIXED)
+	{
+		int headerLength = state[FRAME_STATE_LENGTH_OFFSET] + state[FRAME_STATE_LENGTH_WIDTH];
+		while (offset < length)
+		{
+			// Skip the remainder of any oversized frame
+			if (state[FRAME_STATE_DISCARDING] > 0)
+			{
+				int numToSkip = ((length - offset) < state[FRAME_STATE_DISCARDING]) ? (length - offset) : state[FRAME_STATE_DISCARDING];
+				state[FRAME_STATE_DISCARDING] -= numToSkip;
+				offset += numToSkip;
+				continue;
+			}
+
+			// Accumulate the frame header and determine the total frame length
+			if (state[FRAME_STATE_EXPECTED_LENGTH] == 0)
+			{
+				int numToCopy = headerLength - state[FRAME_STATE_FRAME_LENGTH];
+				if (numToCopy > (length - offset))
+					numToCopy = length - offset;
+				memcpy(frames + frameStart + state[FRAME_STATE_FRAME_LENGTH], data + offset, numToCopy);
+				state[FRAME_STATE_FRAME_LENGTH] += numToCopy;
+				offset += numToCopy;
+				if (state[FRAME_STATE_FRAME_LENGTH] < headerLength)
+					break;
+				unsigned long long fieldValue = 0;
+				const unsigned char *lengthField = frames + frameStart + state[FRAME_STATE_LENGTH_OFFSET];
+				for (int i = 0; i < state[FRAME_STATE_LENGTH_WIDTH]; ++i)
+					fieldValue = (fieldValue << 8) | lengthField[state[FRAME_STATE_BIG_ENDIAN] ? i : (state[FRAME_STATE_LENGTH_WIDTH] - 1 - i)];
+				long long frameLength = (long long)headerLength + (long long)fieldValue + state[FRAME_STATE_LENGTH_ADJUSTMENT];
+				if ((frameLength < headerLength) || (frameLength > state[FRAME_STATE_MAX_LENGTH]))
+				{
+					// Drop the header of an invalid frame and discard the rest of its contents
+					state[FRAME_STATE_DISCARDING] = (frameLength > 0x7FFFFFFFLL) ? 0x7FFFFFFF : ((frameLength > headerLength) ? (int)(frameLength - headerLength) : 0);
+					state[FRAME_STATE_FRAME_LENGTH] = 0;
+					continue;
+				}
+				state[FRAME_STATE_EXPECTED_LENGTH] = (jint)frameLength;
+			}
+
+			// Copy the frame contents and publish the frame once complete
+			int numToCopy = state[FRAME_STATE_EXPECTED_LENGTH] - state[FRAME_STATE_FRAME_LENGTH];
+			if (numToCopy > (length - offset))
+				numToCopy = length - offset;
+			memcpy(frames + frameStart + state[FRAME_STATE_FRAME_LENGTH], data + offset, numToCopy);
+			state[FRAME_STATE_FRAME_LENGTH] += numToCopy;
+			offset += numToCopy;
+			if (state[FRAME_STATE_FRAME_LENGTH] == state[FRAME_STATE_EXPECTED_LENGTH])
+			{
+				frameStart += state[FRAME_STATE_FRAME_LENGTH];
+				boundaries[numFrames++] = frameStart;
+				state[FRAME_STATE_FRAME_LENGTH] = state[FRAME_STATE_EXPECTED_LENGTH] = 0;
+			}
+		}
+	}
+	else if (state[FRAME_STATE_FORMAT] == FRAME_FORMAT_SLIP)
+	{
+		for (; offset < length; ++offset)
+		{
+			// Publish any non-empty frame at each END byte and resynchronize after discarded frames
+			unsigned char value = data[offset];
+			if (value == 0xC0)
+			{
+				if (!state[FRAME_STATE_DISCARDING] && state[FRAME_STATE_FRAME_LENGTH])
+				{
+					frameStart += state[FRAME_STATE_FRAME_LENGTH];
+					boundaries[numFrames++] = frameStart;
+				}
+				state[FRAME_STATE_FRAME_LENGTH] = state[FRAME_STATE_ESCAPED] = state[FRAME_STATE_DISCARDING] = 0;
+			}
+			else if (state[FRAME_STATE_DISCARDING])
+				continue;
+			else if (state[FRAME_STATE_ESCAPED])
+			{
+				state[FRAME_STATE_ESCAPED] = 0;
+				appendFrameByte(state, frames + frameStart, (value == 0xDC) ? 0xC0 : ((value == 0xDD) ? 0xDB : value));
+			}
+			else if (value == 0xDB)
+				state[FRAME_STATE_ESCAPED] = 1;
+			else
+				appendFrameByte(state, frames + frameStart, value);
+		}
+	}
+	else if (state[FRAME_STATE_FORMAT] == FRAME_FORMAT_COBS)
+	{
+		for (; offset < length; ++offset)
+		{
+			// Publish any complete, non-empty frame at each zero delimiter
+			unsigned char value = data[offset];
+			if (value == 0)
+			{
+				if (!state[FRAME_STATE_DISCARDING] && !state[FRAME_STATE_ESCAPED] && state[FRAME_STATE_FRAME_LENGTH])
+				{
+					frameStart += state[FRAME_STATE_FRAME_LENGTH];
+					boundaries[numFrames++] = frameStart;
+				}
+				state[FRAME_STATE_FRAME_LENGTH] = state[FRAME_STATE_ESCAPED] = state[FRAME_STATE_COBS_CODE] = state[FRAME_STATE_DISCARDING] = 0;
+			}
+			else if (state[FRAME_STATE_DISCARDING])
+				continue;
+			else if (state[FRAME_STATE_ESCAPED])
+			{
+				// Copy the data bytes within the current block
+				appendFrameByte(state, frames + frameStart, value);
+				--state[FRAME_STATE_ESCAPED];
+			}
+			else
+			{
+				// Restore the zero implied by the previous code byte, unless it was a maximum-length block
+				if (state[FRAME_STATE_COBS_CODE] && (state[FRAME_STATE_COBS_CODE] != 0xFF) && !appendFrameByte(state, frames + frameStart, 0))
+					continue;
+				state[FRAME_STATE_COBS_CODE] = value;
+				state[FRAME_STATE_ESCAPED] = value - 1;
+			}
+		}
+	}
+	return numFrames;
+}
+
+// Rolling traffic recording functionality
+static inline unsigned long long getRecordingEntrySize(unsigned int length)
+{
+	return sizeof(recordingEntry) + ((length + 7ULL) & ~7ULL);
+}
+
+static void reclaimRecordingSpace(recordingHeader *header, const char *dataRegion, unsigned long long numBytesNeeded)
+{
+	// Discard the oldest entries until the requested number of bytes fits in the data region
+	while ((header->writePosition + numBytesNeeded - header->oldestPosition) > header->dataLength)
+	{
+		unsigned long long offset = header->oldestPosition % header->dataLength, remaining = header->dataLength - offset;
+		if (remaining < sizeof(recordingEntry))
+			header->oldestPosition += remaining;
+		else
+			header->oldestPosition += getRecordingEntrySize(((const recordingEntry*)(dataRegion + offset))->length);
+	}
+}
+
+void initializeRecording(char *recording, unsigned long long recordingLength, long long startTimestampNS, long long startWallClockNS)
+{
+	// Describe an empty data region whose length is a multiple of the entry alignment
+	recordingHeader *header = (recordingHeader*)recording;
+	memset(header, 0, sizeof(recordingHeader));
+	memcpy(header->magic, RECORDING_MAGIC, sizeof(header->magic));
+	header->byteOrderMark = RECORDING_BYTE_ORDER_MARK;
+	header->version = RECORDING_VERSION;
+	header->dataLength = (recordingLength - sizeof(recordingHeader)) & ~7ULL;
+	header->startTimestampNS = startTimestampNS;
+	header->startWallClockNS = startWallClockNS;
+}
+
+void appendRecording(char *recording, unsigned short direction, long long timestampNS, const char *data, int length)
+{
+	// Split chunks that are too large to share the data region with any other entries
+	recordingHeader *header = (recordingHeader*)recording;
+	char *dataRegion = recording + sizeof(recordingHeader);
+	unsigned int maxChunkLength = (unsigned int)(((header->dataLength / 2) & ~7ULL) - sizeof(recordingEntry));
+	while (length > 0)
+	{
+		unsigned int chunkLength = ((unsigned int)length > maxChunkLength) ? maxChunkLength : (unsigned int)length;
+		unsigned long long entrySize = getRecordingEntrySize(chunkLength);
+		unsigned long long offset = header->writePosition % header->dataLength, remaining = header->dataLength - offset;
+
+		// Entries never wrap, so pad out the end of the data region if the entry does not fit before it
+		if (remaining < entrySize)
+		{
+			reclaimRecordingSpace(header, dataRegion, remaining);
+			if (remaining >= sizeof(recordingEntry))
+			{
+				recordingEntry *padding = (recordingEntry*)(dataRegion + offset);
+				padding->timestampNS = timestampNS;
+				padding->length = (unsigned int)(remaining - sizeof(recordingEntry));
+				padding->direction = RECORDING_DIRECTION_PADDING;
+				padding->reserved = 0;
+			}
+			header->writePosition += remaining;
+			continue;
+		}
+
+		// Write the entry contents before publishing the new write position
+		reclaimRecordingSpace(header, dataRegion, entrySize);
+		recordingEntry *entry = (recordingEntry*)(dataRegion + offset);
+		entry->timestampNS = timestampNS;
+		entry->length = chunkLength;
+		entry->direction = direction;
+		entry->reserved = 0;
+		memcpy(entry + 1, data, chunkLength);
+		__atomic_store_n(&header->writePosition, header->writePosition + entrySize, __ATOMIC_RELEASE);
+		data += chunkLength;
+		length -= (int)chunkLength;
+	}
+}
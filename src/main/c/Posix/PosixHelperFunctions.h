@@ -30,17 +30,54 @@
 #include <pthread.h>
 #include "com_fazecast_jSerialComm_SerialPort.h"
 
+// Serial port performance statistics
+#define STATISTICS_HISTOGRAM_BUCKETS 32
+#define STATISTICS_ARRAY_LENGTH (17 + (3 * STATISTICS_HISTOGRAM_BUCKETS))
+typedef struct serialPortStatistics
+{
+	unsigned long long bytesRead, bytesWritten, readCalls, writeCalls, readSyscalls, writeSyscalls, shortReads, readTimeouts, writeRetries, drainTimeNS;
+	unsigned long long rs485Transmissions, rs485TurnaroundNS, rs485MaxTurnaroundNS;
+	unsigned long long readLatency[STATISTICS_HISTOGRAM_BUCKETS], writeLatency[STATISTICS_HISTOGRAM_BUCKETS], rs485Turnaround[STATISTICS_HISTOGRAM_BUCKETS];
+	int lineErrorsSupported, lineErrorBaseline[4];
+} serialPortStatistics;
+
 // Serial port data structure
 typedef struct serialPort
 {
-	pthread_mutex_t eventMutex;
-	pthread_cond_t eventReceived;
-	pthread_t eventsThread1, eventsThread2;
-	char *portPath, *friendlyName, *portDescription, *portLocation, *readBuffer;
-	int errorLineNumber, errorNumber, handle, readBufferLength, eventsMask, event;
-	volatile char enumerated, eventListenerRunning, eventListenerUsesThreads;
+	pthread_mutex_t eventMutex, txMutex, recordingMutex, rs485Mutex;
+	pthread_cond_t eventReceived, ringDataReceived, ringSpaceAvailable, txDataQueued, txSpaceAvailable;
+	pthread_t eventsThread1, eventsThread2, ringReaderThread, txWriterThread, virtualDeviceThread;
+	char *portPath, *friendlyName, *portDescription, *portLocation, *readBuffer, *ringBuffer, *txBuffer, *recording, *virtualReplay;
+	int errorLineNumber, errorNumber, handle, readBufferLength, eventsMask, event, interByteTimeout, writeTimeout, eventEngineLineErrors[5];
+	int closingPipe[2], listenerWakePipe[2], ringDataPipe[2], virtualDevice, virtualModemLines, threadPriority, threadRoundRobin, threadSchedulingStatus;
+	long long threadAffinityMask;
+	unsigned int ringBufferLength, ringHead, ringTail, ringReaderWaiting, ringPollWaiting, ringSpaceWaiting, ringDiscardHead, ringDiscardPending, txBufferLength, txHead, txTail;
+	unsigned long long recordingLength, virtualReplayLength;
+	double virtualReplaySpeed;
+	long long readTimestampNS, ringTimestampNS, eventTimestampNS, pendingEventTimestampNS;
+	long long rs485DelayBeforeNS, rs485DelayAfterNS, characterTimeNS;
+	serialPortStatistics statistics;
+	struct asyncOperation *asyncRead, *asyncWrite;
+	volatile char enumerated, opening, eventListenerRunning, eventListenerUsesThreads, ringBufferEnabled, ringReaderRunning;
+	volatile char txQueueEnabled, txWriterRunning, txBlockWhenFull, txDiscard, txFailed, recordingEnabled, recordTransmitted, virtualDeviceRunning;
+	volatile char rs485SoftwareControl, rs485ActiveHigh, rs485RxDuringTx, rs485LineStatusSupported;
 } serialPort;
 
+// Asynchronous I/O engine data structures
+typedef struct asyncOperation
+{
+	serialPort *port;
+	struct asyncOperation *next;
+	char *buffer;
+	int length, numBytesTransferred, result, isWrite;
+} asyncOperation;
+
+typedef struct asyncEngine
+{
+	int queue, wakePipe[2];
+	asyncOperation *completed;
+} asyncEngine;
+
 // Common storage functionality
 typedef struct serialPortVector
 {
@@ -51,6 +88,13 @@ serialPort* pushBack(serialPortVector* vector, const char* key, const char* frie
 serialPort* fetchPort(serialPortVector* vector, const char* key);
 void removePort(serialPortVector* vector, serialPort* port);
 
+// Port enumeration filtering functionality
+typedef struct portFilter
+{
+	const char *pathPattern, *driverName;
+	int vendorID, productID;
+} portFilter;
+
 // Forced definitions
 #ifndef CMSPAR
 #define CMSPAR 010000000000
@@ -58,6 +102,9 @@ void removePort(serialPortVector* vector, serialPort* port);
 #ifndef O_CLOEXEC
 #define O_CLOEXEC 0
 #endif
+#ifndef IOV_MAX
+#define IOV_MAX 16
+#endif
 
 // Linux-specific functionality
 #if defined(__linux__)
@@ -71,9 +118,11 @@ extern int ioctl(int __fd, unsigned long int __request, ...);
 void getDriverName(const char* directoryToSearch, char* friendlyName);
 void getFriendlyName(const char* productFile, char* friendlyName);
 void getInterfaceDescription(const char* interfaceFile, char* interfaceDescription);
-void recursiveSearchForComPorts(serialPortVector* comPorts, const char* fullPathToSearch);
-void driverBasedSearchForComPorts(serialPortVector* comPorts, const char* fullPathToDriver, const char* fullBasePathToPort);
-void lastDitchSearchForComPorts(serialPortVector* comPorts);
+void recursiveSearchForComPorts(serialPortVector* comPorts, const char* fullPathToSearch, const portFilter* filter);
+void driverBasedSearchForComPorts(serialPortVector* comPorts, const char* fullPathToDriver, const char* fullBasePathToPort, const portFilter* filter);
+void lastDitchSearchForComPorts(serialPortVector* comPorts, const portFilter* filter);
+int setTermiosFlagsCustomBaudRate(int portFD, baud_rate baudRate, unsigned int inputFlags, unsigned int controlFlags);
+int setLatencyTimer(const char *portFile, int latencyMS);
 
 // Solaris-specific functionality
 #elif defined(__sun__)
@@ -108,5 +157,57 @@ void searchForComPorts(serialPortVector* comPorts);
 baud_rate getBaudRateCode(baud_rate baudRate);
 int setBaudRateCustom(int portFD, baud_rate baudRate);
 int verifyAndSetUserPortGroup(const char *portFile);
+char portMatchesFilter(const portFilter *filter, const char *portPath);
+char startHotplugMonitor(void (*notifyCallback)(void));
+void stopHotplugMonitor(void);
+int applyThreadScheduling(long long cpuAffinityMask, int realTimePriority, int roundRobin);
+
+// Frame decoder state layout (must match SerialPortFrameDecoder.java)
+#define FRAME_FORMAT_LENGTH_PREFIXED 1
+#define FRAME_FORMAT_SLIP 2
+#define FRAME_FORMAT_COBS 3
+#define FRAME_STATE_FORMAT 0
+#define FRAME_STATE_LENGTH_OFFSET 1
+#define FRAME_STATE_LENGTH_WIDTH 2
+#define FRAME_STATE_BIG_ENDIAN 3
+#define FRAME_STATE_LENGTH_ADJUSTMENT 4
+#define FRAME_STATE_MAX_LENGTH 5
+#define FRAME_STATE_FRAME_LENGTH 6
+#define FRAME_STATE_ESCAPED 7
+#define FRAME_STATE_COBS_CODE 8
+#define FRAME_STATE_DISCARDING 9
+#define FRAME_STATE_EXPECTED_LENGTH 10
+#define FRAME_STATE_LENGTH 11
+int decodeFrames(const unsigned char *data, int length, jint *state, unsigned char *frames, jint *boundaries);
+
+// Traffic recording file layout (must match SerialPortRecordingReader.java)
+#define RECORDING_MAGIC "jSCTrace"
+#define RECORDING_VERSION 1
+#define RECORDING_BYTE_ORDER_MARK 0x01020304
+#define RECORDING_MINIMUM_LENGTH 4096
+#define RECORDING_DIRECTION_RECEIVED 0
+#define RECORDING_DIRECTION_TRANSMITTED 1
+#define RECORDING_DIRECTION_PADDING 0xFFFF
+typedef struct recordingHeader
+{
+	char magic[8];
+	unsigned int byteOrderMark, version;
+	unsigned long long dataLength, writePosition, oldestPosition;
+	long long startTimestampNS, startWallClockNS;
+	unsigned long long reserved;
+} recordingHeader;
+typedef struct recordingEntry
+{
+	long long timestampNS;
+	unsigned int length;
+	unsigned short direction, reserved;
+} recordingEntry;
+void initializeRecording(char *recording, unsigned long long recordingLength, long long startTimestampNS, long long startWallClockNS);
+void appendRecording(char *recording, unsigned short direction, long long timestampNS, const char *data, int length);
+
+// Virtual port descriptors (must match SerialPort.java)
+#define VIRTUAL_PORT_PREFIX "virtual:"
+#define VIRTUAL_LOOPBACK_PREFIX "virtual:loopback:"
+#define VIRTUAL_REPLAY_PREFIX "virtual:replay:"
 
 #endif		// #ifndef __POSIX_HELPER_FUNCTIONS_HEADER_H__
@@ -23,8 +23,14 @@
  * see <http://www.gnu.org/licenses/> and <http://www.apache.org/licenses/>.
  */
 
+// Expose the pseudo-terminal functionality, including the reentrant ptsname_r(), hidden by the default glibc feature test macros
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE
+#endif
+
 #include <errno.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <poll.h>
 #include <signal.h>
 #include <stdint.h>
@@ -32,14 +38,21 @@
 #include <string.h>
 #include <sys/file.h>
 #include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/select.h>
+#include <sys/stat.h>
 #include <sys/time.h>
+#include <sys/uio.h>
 #include <termios.h>
 #include <time.h>
 #include <unistd.h>
 #if defined(__linux__)
 #include <linux/serial.h>
+#include <sys/epoll.h>
 #elif defined(__sun__)
 #include <sys/filio.h>
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__)
+#include <sys/event.h>
 #endif
 #include "PosixHelperFunctions.h"
 
@@ -72,16 +85,42 @@ jfieldID rs485EnableTerminationField;
 jfieldID rs485RxDuringTxField;
 jfieldID rs485DelayBeforeField;
 jfieldID rs485DelayAfterField;
+jfieldID rs485SoftwareControlField;
 jfieldID xonStartCharField;
 jfieldID xoffStopCharField;
 jfieldID timeoutModeField;
 jfieldID readTimeoutField;
 jfieldID writeTimeoutField;
 jfieldID eventFlagsField;
-
-// List of available serial ports
+jfieldID lowLatencyModeField;
+jfieldID interByteTimeoutField;
+jfieldID threadAffinityMaskField;
+jfieldID threadPriorityField;
+jfieldID threadRoundRobinField;
+
+// Maximum number of ready ports returned by a single event engine wait
+#define MAX_EVENT_ENGINE_EVENTS 64
+
+// Time the background ring buffer reader waits before polling a device again after it reported an error condition without any data
+#define RING_READER_ERROR_BACKOFF_MS 10
+
+// Software RS-485 timing: spin instead of sleeping within this long of a deadline, keep polling for an empty transmitter without
+//   sleeping for this long past its expected end, then poll at this interval until giving up on a transmitter that never empties
+#define PRECISE_WAIT_SPIN_NS 200000LL
+#define TRANSMITTER_SPIN_NS 2000000LL
+#define TRANSMITTER_POLL_INTERVAL_NS 100000LL
+#define TRANSMITTER_TIMEOUT_NS 1000000000LL
+
+// List of available serial ports, guarded by its own lock so that ports can be enumerated, opened, and closed concurrently
 char portsEnumerated = 0;
 serialPortVector serialPorts = { NULL, 0, 0 };
+pthread_mutex_t serialPortsMutex = PTHREAD_MUTEX_INITIALIZER;
+
+// Hotplug-driven port listing cache
+char hotplugMonitorStatus = 0;
+unsigned int portListingGeneration = 0, enumeratedGeneration = 0;
+pthread_mutex_t hotplugMutex;
+pthread_cond_t hotplugCondition;
 
 // JNI exception handler
 char jniErrorMessage[64] = { 0 };
@@ -100,26 +139,44 @@ static inline jboolean checkJniError(JNIEnv *env, int lineNumber)
 	return JNI_FALSE;
 }
 
-// Generalized port enumeration function
-static void enumeratePorts(void)
+// Platform-specific port searching function
+static void searchForMatchingPorts(serialPortVector *comPorts, const portFilter *filter)
 {
-	// Reset the enumerated flag on all non-open serial ports
-	for (int i = 0; i < serialPorts.length; ++i)
-		serialPorts.ports[i]->enumerated = (serialPorts.ports[i]->handle > 0);
-
-	// Enumerate serial ports on this machine
+	// Enumerate serial ports on this machine, only retrieving details for ports that match the filter
 #if defined(__linux__)
 
-	recursiveSearchForComPorts(&serialPorts, "/sys/devices/");
-	driverBasedSearchForComPorts(&serialPorts, "/proc/tty/driver/serial", "/dev/ttyS");
-	driverBasedSearchForComPorts(&serialPorts, "/proc/tty/driver/mvebu_serial", "/dev/ttyMV");
-	lastDitchSearchForComPorts(&serialPorts);
+	recursiveSearchForComPorts(comPorts, "/sys/devices/", filter);
+	driverBasedSearchForComPorts(comPorts, "/proc/tty/driver/serial", "/dev/ttyS", filter);
+	driverBasedSearchForComPorts(comPorts, "/proc/tty/driver/mvebu_serial", "/dev/ttyMV", filter);
+	lastDitchSearchForComPorts(comPorts, filter);
 
 #elif defined(__sun__) || defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__)
 
-	searchForComPorts(&serialPorts);
+	searchForComPorts(comPorts);
+
+	// Remove any ports that do not match the filter
+	for (int i = 0; filter && (i < comPorts->length); ++i)
+		if (!portMatchesFilter(filter, comPorts->ports[i]->portPath))
+		{
+			removePort(comPorts, comPorts->ports[i]);
+			i--;
+		}
 
 #endif
+}
+
+// Generalized port enumeration function (must be called with the serial port listing locked)
+static void enumeratePorts(void)
+{
+	// Remember which port listing changes this enumeration will account for
+	unsigned int generation = __atomic_load_n(&portListingGeneration, __ATOMIC_ACQUIRE);
+
+	// Reset the enumerated flag on all serial ports that are not open or currently being opened
+	for (int i = 0; i < serialPorts.length; ++i)
+		serialPorts.ports[i]->enumerated = ((serialPorts.ports[i]->handle > 0) || serialPorts.ports[i]->opening);
+
+	// Enumerate serial ports on this machine
+	searchForMatchingPorts(&serialPorts, NULL);
 
 	// Remove all non-enumerated ports from the serial port listing
 	for (int i = 0; i < serialPorts.length; ++i)
@@ -128,19 +185,78 @@ static void enumeratePorts(void)
 			removePort(&serialPorts, serialPorts.ports[i]);
 			i--;
 		}
+	enumeratedGeneration = generation;
 	portsEnumerated = 1;
 }
 
+// Hotplug notification function
+static void portListingChanged(void)
+{
+	pthread_mutex_lock(&hotplugMutex);
+	__atomic_add_fetch(&portListingGeneration, 1, __ATOMIC_RELEASE);
+	pthread_cond_broadcast(&hotplugCondition);
+	pthread_mutex_unlock(&hotplugMutex);
+}
+
+// Monotonic clock function
+static inline long long getMonotonicTimeNS(void)
+{
+	struct timespec currentTime;
+	clock_gettime(CLOCK_MONOTONIC, &currentTime);
+	return ((long long)currentTime.tv_sec * 1000000000LL) + currentTime.tv_nsec;
+}
+
+// Native thread scheduling functionality
+static void applyPortThreadScheduling(serialPort *port)
+{
+	// Apply the requested scheduling to the calling thread, clearing any settings that could not be applied from the port status
+	if (port->threadAffinityMask || (port->threadPriority > 0))
+		__atomic_fetch_and(&port->threadSchedulingStatus, applyThreadScheduling(port->threadAffinityMask, port->threadPriority, port->threadRoundRobin), __ATOMIC_RELAXED);
+}
+
+// Per-port wakeup functionality
+static void clearWakePipe(int *wakePipe)
+{
+	// Discard all pending wakeups so that the pipe only becomes readable again once it is next signaled
+	char wakeBytes[64];
+	if (wakePipe[0] >= 0)
+		while (read(wakePipe[0], wakeBytes, sizeof(wakeBytes)) > 0);
+}
+
+static void prepareWakePipe(int *wakePipe)
+{
+	// Create the non-blocking self-pipe the first time it is needed, leaving it disabled if unavailable, and discard any previous wakeups
+	if ((wakePipe[0] < 0) && !pipe(wakePipe))
+		for (int i = 0; i < 2; ++i)
+		{
+			fcntl(wakePipe[i], F_SETFL, fcntl(wakePipe[i], F_GETFL) | O_NONBLOCK);
+			fcntl(wakePipe[i], F_SETFD, FD_CLOEXEC);
+		}
+	else if (wakePipe[0] < 0)
+		wakePipe[0] = wakePipe[1] = -1;
+	else
+		clearWakePipe(wakePipe);
+}
+
+static void signalWakePipe(int *wakePipe)
+{
+	// The pipe remains readable once signaled so that every current and future waiter is released until it is prepared again
+	char wakeByte = 0;
+	if ((wakePipe[1] >= 0) && (write(wakePipe[1], &wakeByte, 1) < 0))
+		errno = 0;
+}
+
 #if defined(__linux__) && !defined(__ANDROID__)
 
 // Event listening threads
 void* eventReadingThread1(void *serialPortPointer)
 {
-	// Make this thread immediately and asynchronously cancellable
+	// Make this thread cancellable, which is the only way to interrupt a modem line wait
 	int oldValue;
 	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	applyPortThreadScheduling(port);
 	pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, &oldValue);
-	pthread_setcanceltype(PTHREAD_CANCEL_ASYNCHRONOUS, &oldValue);
+	pthread_setcanceltype(PTHREAD_CANCEL_DEFERRED, &oldValue);
 
 	// Loop forever while open
 	struct serial_icounter_struct oldSerialLineInterrupts, newSerialLineInterrupts;
@@ -158,8 +274,12 @@ void* eventReadingThread1(void *serialPortPointer)
 		if (port->eventsMask & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_RING_INDICATOR)
 			mask |= TIOCM_RNG;
 
-		// Listen forever for a change in the modem lines
-		isSupported = !ioctl(port->handle, TIOCMIWAIT, mask) && !ioctl(port->handle, TIOCGICOUNT, &newSerialLineInterrupts);
+		// Listen forever for a change in the modem lines, only allowing asynchronous cancellation while no locks are held
+		pthread_setcanceltype(PTHREAD_CANCEL_ASYNCHRONOUS, &oldValue);
+		isSupported = !ioctl(port->handle, TIOCMIWAIT, mask);
+		pthread_setcanceltype(PTHREAD_CANCEL_DEFERRED, &oldValue);
+		isSupported = isSupported && !ioctl(port->handle, TIOCGICOUNT, &newSerialLineInterrupts);
+		long long eventTimeNS = getMonotonicTimeNS();
 
 		// Return the detected port events
 		if (isSupported)
@@ -175,7 +295,11 @@ void* eventReadingThread1(void *serialPortPointer)
 				port->event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_RING_INDICATOR;
 			memcpy(&oldSerialLineInterrupts, &newSerialLineInterrupts, sizeof(newSerialLineInterrupts));
 			if (port->event)
+			{
+				if (!port->pendingEventTimestampNS)
+					port->pendingEventTimestampNS = eventTimeNS;
 				pthread_cond_signal(&port->eventReceived);
+			}
 			pthread_mutex_unlock(&port->eventMutex);
 		}
 	}
@@ -184,11 +308,9 @@ void* eventReadingThread1(void *serialPortPointer)
 
 void* eventReadingThread2(void *serialPortPointer)
 {
-	// Make this thread immediately and asynchronously cancellable
-	int oldValue;
+	// Retrieve the initial line error counters
 	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
-	pthread_setcancelstate(PTHREAD_CANCEL_ENABLE, &oldValue);
-	pthread_setcanceltype(PTHREAD_CANCEL_ASYNCHRONOUS, &oldValue);
+	applyPortThreadScheduling(port);
 	struct serial_icounter_struct oldSerialLineInterrupts, newSerialLineInterrupts;
 	ioctl(port->handle, TIOCGICOUNT, &oldSerialLineInterrupts);
 
@@ -198,23 +320,26 @@ void* eventReadingThread2(void *serialPortPointer)
 		// Initialize the polling variables
 		int pollResult;
 		short pollEventsMask = ((port->eventsMask & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_AVAILABLE) || (port->eventsMask & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_RECEIVED)) ? (POLLIN | POLLERR) : POLLERR;
-		struct pollfd waitingSet = { port->handle, pollEventsMask, 0 };
+		struct pollfd waitingSet[2] = { { port->handle, pollEventsMask, 0 }, { port->listenerWakePipe[0], POLLIN, 0 } };
 
-		// Wait for a serial port event
+		// Wait for a serial port event or for the listener to be stopped
 		do
 		{
-			waitingSet.revents = 0;
-			pollResult = poll(&waitingSet, 1, 1000);
+			waitingSet[0].revents = waitingSet[1].revents = 0;
+			pollResult = poll(waitingSet, 2, 1000);
 		}
 		while ((pollResult == 0) && port->eventListenerRunning && port->eventListenerUsesThreads);
+		if (waitingSet[1].revents)
+			break;
+		long long eventTimeNS = getMonotonicTimeNS();
 
 		// Return the detected port events
 		pthread_mutex_lock(&port->eventMutex);
-		if (waitingSet.revents & POLLHUP)
+		if (waitingSet[0].revents & POLLHUP)
 			port->event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_PORT_DISCONNECTED;
-		else if (waitingSet.revents & POLLIN)
+		else if (waitingSet[0].revents & POLLIN)
 			port->event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_AVAILABLE;
-		if (waitingSet.revents & POLLERR)
+		if (waitingSet[0].revents & POLLERR)
 			if (!ioctl(port->handle, TIOCGICOUNT, &newSerialLineInterrupts))
 			{
 				if (oldSerialLineInterrupts.frame != newSerialLineInterrupts.frame)
@@ -230,7 +355,11 @@ void* eventReadingThread2(void *serialPortPointer)
 				memcpy(&oldSerialLineInterrupts, &newSerialLineInterrupts, sizeof(newSerialLineInterrupts));
 			}
 		if (port->event)
+		{
+			if (!port->pendingEventTimestampNS)
+				port->pendingEventTimestampNS = eventTimeNS;
 			pthread_cond_signal(&port->eventReceived);
+		}
 		pthread_mutex_unlock(&port->eventMutex);
 	}
 	return NULL;
@@ -238,754 +367,3303 @@ void* eventReadingThread2(void *serialPortPointer)
 
 #endif // #if defined(__linux__)
 
-JNIEXPORT jobjectArray JNICALL Java_com_fazecast_jSerialComm_SerialPort_getCommPorts(JNIEnv *env, jclass serialComm)
+// Performance statistics functions
+static inline void addStatistic(unsigned long long *counter, unsigned long long amount)
 {
-	// Enumerate all ports on the current system
-	enumeratePorts();
-
-	// Create a Java-based port listing
-	jobjectArray arrayObject = (*env)->NewObjectArray(env, serialPorts.length, serialCommClass, 0);
-	if (checkJniError(env, __LINE__ - 1)) return arrayObject;
-	for (int i = 0; i < serialPorts.length; ++i)
-	{
-		// Create a new SerialComm object containing the enumerated values
-		jobject serialCommObject = (*env)->NewObject(env, serialCommClass, serialCommConstructor);
-		if (checkJniError(env, __LINE__ - 1)) return arrayObject;
-		(*env)->SetObjectField(env, serialCommObject, portDescriptionField, (*env)->NewStringUTF(env, serialPorts.ports[i]->portDescription));
-		if (checkJniError(env, __LINE__ - 1)) return arrayObject;
-		(*env)->SetObjectField(env, serialCommObject, friendlyNameField, (*env)->NewStringUTF(env, serialPorts.ports[i]->friendlyName));
-		if (checkJniError(env, __LINE__ - 1)) return arrayObject;
-		(*env)->SetObjectField(env, serialCommObject, comPortField, (*env)->NewStringUTF(env, serialPorts.ports[i]->portPath));
-		if (checkJniError(env, __LINE__ - 1)) return arrayObject;
-		(*env)->SetObjectField(env, serialCommObject, portLocationField, (*env)->NewStringUTF(env, serialPorts.ports[i]->portLocation));
-		if (checkJniError(env, __LINE__ - 1)) return arrayObject;
-
-		// Add new SerialComm object to array
-		(*env)->SetObjectArrayElement(env, arrayObject, i, serialCommObject);
-		if (checkJniError(env, __LINE__ - 1)) return arrayObject;
-	}
-	return arrayObject;
+	__atomic_fetch_add(counter, amount, __ATOMIC_RELAXED);
 }
 
-JNIEXPORT void JNICALL Java_com_fazecast_jSerialComm_SerialPort_initializeLibrary(JNIEnv *env, jclass serialComm)
+static void recordHistogram(unsigned long long *histogram, long long elapsedNS)
 {
-	// Cache class and method ID as global references
-	jniErrorClass = (*env)->FindClass(env, "java/lang/Exception");
-	serialCommClass = (jclass)(*env)->NewGlobalRef(env, serialComm);
-	if (checkJniError(env, __LINE__ - 1)) return;
-	serialCommConstructor = (*env)->GetMethodID(env, serialCommClass, "<init>", "()V");
-	if (checkJniError(env, __LINE__ - 1)) return;
-
-	// Cache Java fields as global references
-	serialPortFdField = (*env)->GetFieldID(env, serialCommClass, "portHandle", "J");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	comPortField = (*env)->GetFieldID(env, serialCommClass, "comPort", "Ljava/lang/String;");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	friendlyNameField = (*env)->GetFieldID(env, serialCommClass, "friendlyName", "Ljava/lang/String;");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	portDescriptionField = (*env)->GetFieldID(env, serialCommClass, "portDescription", "Ljava/lang/String;");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	portLocationField = (*env)->GetFieldID(env, serialCommClass, "portLocation", "Ljava/lang/String;");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	eventListenerRunningField = (*env)->GetFieldID(env, serialCommClass, "eventListenerRunning", "Z");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	disableConfigField = (*env)->GetFieldID(env, serialCommClass, "disableConfig", "Z");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	isDtrEnabledField = (*env)->GetFieldID(env, serialCommClass, "isDtrEnabled", "Z");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	isRtsEnabledField = (*env)->GetFieldID(env, serialCommClass, "isRtsEnabled", "Z");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	autoFlushIOBuffersField = (*env)->GetFieldID(env, serialCommClass, "autoFlushIOBuffers", "Z");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	baudRateField = (*env)->GetFieldID(env, serialCommClass, "baudRate", "I");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	dataBitsField = (*env)->GetFieldID(env, serialCommClass, "dataBits", "I");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	stopBitsField = (*env)->GetFieldID(env, serialCommClass, "stopBits", "I");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	parityField = (*env)->GetFieldID(env, serialCommClass, "parity", "I");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	flowControlField = (*env)->GetFieldID(env, serialCommClass, "flowControl", "I");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	sendDeviceQueueSizeField = (*env)->GetFieldID(env, serialCommClass, "sendDeviceQueueSize", "I");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	receiveDeviceQueueSizeField = (*env)->GetFieldID(env, serialCommClass, "receiveDeviceQueueSize", "I");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	disableExclusiveLockField = (*env)->GetFieldID(env, serialCommClass, "disableExclusiveLock", "Z");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	requestElevatedPermissionsField = (*env)->GetFieldID(env, serialCommClass, "requestElevatedPermissions", "Z");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	rs485ModeField = (*env)->GetFieldID(env, serialCommClass, "rs485Mode", "Z");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	rs485ActiveHighField = (*env)->GetFieldID(env, serialCommClass, "rs485ActiveHigh", "Z");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	rs485EnableTerminationField = (*env)->GetFieldID(env, serialCommClass, "rs485EnableTermination", "Z");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	rs485RxDuringTxField = (*env)->GetFieldID(env, serialCommClass, "rs485RxDuringTx", "Z");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	rs485DelayBeforeField = (*env)->GetFieldID(env, serialCommClass, "rs485DelayBefore", "I");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	rs485DelayAfterField = (*env)->GetFieldID(env, serialCommClass, "rs485DelayAfter", "I");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	xonStartCharField = (*env)->GetFieldID(env, serialCommClass, "xonStartChar", "B");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	xoffStopCharField = (*env)->GetFieldID(env, serialCommClass, "xoffStopChar", "B");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	timeoutModeField = (*env)->GetFieldID(env, serialCommClass, "timeoutMode", "I");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	readTimeoutField = (*env)->GetFieldID(env, serialCommClass, "readTimeout", "I");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	writeTimeoutField = (*env)->GetFieldID(env, serialCommClass, "writeTimeout", "I");
-	if (checkJniError(env, __LINE__ - 1)) return;
-	eventFlagsField = (*env)->GetFieldID(env, serialCommClass, "eventFlags", "I");
-	if (checkJniError(env, __LINE__ - 1)) return;
-
-	// Disable handling of various POSIX signals
-	sigset_t blockMask;
-	memset(&blockMask, 0, sizeof(blockMask));
-	struct sigaction ignoreAction = { 0 };
-	ignoreAction.sa_handler = SIG_IGN;
-	ignoreAction.sa_mask = blockMask;
-	sigaction(SIGIO, &ignoreAction, NULL);
-	sigaction(SIGHUP, &ignoreAction, NULL);
-	sigaction(SIGTERM, &ignoreAction, NULL);
-	sigaction(SIGCONT, &ignoreAction, NULL);
-	sigaction(SIGUSR1, &ignoreAction, NULL);
-	sigaction(SIGUSR2, &ignoreAction, NULL);
-	sigaction(SIGTTOU, &ignoreAction, NULL);
-	sigaction(SIGTTIN, &ignoreAction, NULL);
+	// Place the elapsed time into a logarithmic microsecond bucket
+	int bucket = 0;
+	unsigned long long elapsedUS = (unsigned long long)elapsedNS / 1000ULL;
+	while ((elapsedUS >>= 1) && (bucket < (STATISTICS_HISTOGRAM_BUCKETS - 1)))
+		++bucket;
+	addStatistic(histogram + bucket, 1);
 }
 
-JNIEXPORT void JNICALL Java_com_fazecast_jSerialComm_SerialPort_uninitializeLibrary(JNIEnv *env, jclass serialComm)
+static inline void recordLatency(unsigned long long *histogram, long long startTimeNS)
 {
-	// Close all open ports
-	for (int i = 0; i < serialPorts.length; ++i)
-		if (serialPorts.ports[i]->handle > 0)
-			Java_com_fazecast_jSerialComm_SerialPort_closePortNative(env, serialComm, (jlong)(intptr_t)serialPorts.ports[i]);
+	recordHistogram(histogram, getMonotonicTimeNS() - startTimeNS);
+}
 
-	// Delete the cached global reference
-	(*env)->DeleteGlobalRef(env, serialCommClass);
-	checkJniError(env, __LINE__ - 1);
+static void resetStatistics(serialPort *port)
+{
+	// Clear each counter atomically since background threads may be updating them, then remember the current driver line error counts as a baseline
+	unsigned long long *counters[] = { &port->statistics.bytesRead, &port->statistics.bytesWritten, &port->statistics.readCalls, &port->statistics.writeCalls,
+			&port->statistics.readSyscalls, &port->statistics.writeSyscalls, &port->statistics.shortReads, &port->statistics.readTimeouts, &port->statistics.writeRetries,
+			&port->statistics.drainTimeNS, &port->statistics.rs485Transmissions, &port->statistics.rs485TurnaroundNS, &port->statistics.rs485MaxTurnaroundNS };
+	for (size_t i = 0; i < (sizeof(counters) / sizeof(counters[0])); ++i)
+		__atomic_store_n(counters[i], 0, __ATOMIC_RELAXED);
+	for (int i = 0; i < STATISTICS_HISTOGRAM_BUCKETS; ++i)
+	{
+		__atomic_store_n(port->statistics.readLatency + i, 0, __ATOMIC_RELAXED);
+		__atomic_store_n(port->statistics.writeLatency + i, 0, __ATOMIC_RELAXED);
+		__atomic_store_n(port->statistics.rs485Turnaround + i, 0, __ATOMIC_RELAXED);
+	}
+	port->statistics.lineErrorsSupported = 0;
+#if defined(__linux__)
+	struct serial_icounter_struct serialLineInterrupts;
+	port->statistics.lineErrorsSupported = !ioctl(port->handle, TIOCGICOUNT, &serialLineInterrupts);
+	if (port->statistics.lineErrorsSupported)
+	{
+		port->statistics.lineErrorBaseline[0] = serialLineInterrupts.frame;
+		port->statistics.lineErrorBaseline[1] = serialLineInterrupts.overrun;
+		port->statistics.lineErrorBaseline[2] = serialLineInterrupts.parity;
+		port->statistics.lineErrorBaseline[3] = serialLineInterrupts.buf_overrun;
+	}
+#endif
 }
 
-JNIEXPORT void JNICALL Java_com_fazecast_jSerialComm_SerialPort_retrievePortDetails(JNIEnv *env, jobject obj)
+// Condition variable deadline calculation function
+static void getConditionDeadline(struct timespec *deadline, int timeoutMS)
 {
-	// Retrieve the serial port parameter fields
-	jstring portNameJString = (jstring)(*env)->GetObjectField(env, obj, comPortField);
-	if (checkJniError(env, __LINE__ - 1)) return;
-	const char *portName = (*env)->GetStringUTFChars(env, portNameJString, NULL);
-	if (checkJniError(env, __LINE__ - 1)) return;
+#if defined(__APPLE__) || defined(__OpenBSD__)
+	clock_gettime(CLOCK_REALTIME, deadline);
+#else
+	clock_gettime(CLOCK_MONOTONIC, deadline);
+#endif
+	deadline->tv_sec += (timeoutMS / 1000);
+	deadline->tv_nsec += (long)(timeoutMS % 1000) * 1000000L;
+	if (deadline->tv_nsec >= 1000000000L)
+	{
+		deadline->tv_sec += 1;
+		deadline->tv_nsec -= 1000000000L;
+	}
+}
 
-	// Ensure that the serial port exists
-	if (!portsEnumerated)
-		enumeratePorts();
-	serialPort *port = fetchPort(&serialPorts, portName);
-	if (!port)
+// Traffic recording functions
+static inline void recordTraffic(serialPort *port, unsigned short direction, long long timestampNS, const char *data, int length)
+{
+	// Only take the lock when a recording is active and interested in this direction
+	if (port->recordingEnabled && (length > 0) && ((direction == RECORDING_DIRECTION_RECEIVED) || port->recordTransmitted))
 	{
-		(*env)->ReleaseStringUTFChars(env, portNameJString, portName);
-		checkJniError(env, __LINE__ - 1);
-		return;
+		pthread_mutex_lock(&port->recordingMutex);
+		if (port->recording)
+			appendRecording(port->recording, direction, (timestampNS > 0) ? timestampNS : getMonotonicTimeNS(), data, length);
+		pthread_mutex_unlock(&port->recordingMutex);
 	}
+}
 
-	// Fill in the Java-side port details
-	(*env)->SetObjectField(env, obj, portDescriptionField, (*env)->NewStringUTF(env, port->portDescription));
-	if (checkJniError(env, __LINE__ - 1)) return;
-	(*env)->SetObjectField(env, obj, friendlyNameField, (*env)->NewStringUTF(env, port->friendlyName));
-	if (checkJniError(env, __LINE__ - 1)) return;
-	(*env)->SetObjectField(env, obj, portLocationField, (*env)->NewStringUTF(env, port->portLocation));
-	if (checkJniError(env, __LINE__ - 1)) return;
+static void stopRecording(serialPort *port)
+{
+	// Unmap the recording file, leaving the kernel to write out any remaining dirty pages
+	pthread_mutex_lock(&port->recordingMutex);
+	port->recordingEnabled = 0;
+	if (port->recording)
+	{
+		munmap(port->recording, port->recordingLength);
+		port->recording = NULL;
+		port->recordingLength = 0;
+	}
+	pthread_mutex_unlock(&port->recordingMutex);
+}
 
-	// Release all JNI structures
-	(*env)->ReleaseStringUTFChars(env, portNameJString, portName);
-	checkJniError(env, __LINE__ - 1);
+// Ring buffer consumer functionality, noting that only the consumer may ever advance the tail
+static void discardRingBuffer(serialPort *port)
+{
+	// Ask the consumer to skip everything received up to now, leaving any data that arrives afterward intact
+	__atomic_store_n(&port->ringDiscardHead, __atomic_load_n(&port->ringHead, __ATOMIC_ACQUIRE), __ATOMIC_RELEASE);
+	__atomic_store_n(&port->ringDiscardPending, 1, __ATOMIC_RELEASE);
 }
 
-JNIEXPORT jlong JNICALL Java_com_fazecast_jSerialComm_SerialPort_openPortNative(JNIEnv *env, jobject obj)
+static unsigned int peekRingTail(serialPort *port)
 {
-	// Retrieve the serial port parameter fields
-	jstring portNameJString = (jstring)(*env)->GetObjectField(env, obj, comPortField);
-	if (checkJniError(env, __LINE__ - 1)) return 0;
-	const char *portName = (*env)->GetStringUTFChars(env, portNameJString, NULL);
-	if (checkJniError(env, __LINE__ - 1)) return 0;
-	unsigned char disableExclusiveLock = (*env)->GetBooleanField(env, obj, disableExclusiveLockField);
-	if (checkJniError(env, __LINE__ - 1)) return 0;
-	unsigned char requestElevatedPermissions = (*env)->GetBooleanField(env, obj, requestElevatedPermissionsField);
-	if (checkJniError(env, __LINE__ - 1)) return 0;
-	unsigned char disableAutoConfig = (*env)->GetBooleanField(env, obj, disableConfigField);
-	if (checkJniError(env, __LINE__ - 1)) return 0;
-	unsigned char autoFlushIOBuffers = (*env)->GetBooleanField(env, obj, autoFlushIOBuffersField);
-	if (checkJniError(env, __LINE__ - 1)) return 0;
+	// Return the tail as it will be once the consumer has applied any pending discard
+	unsigned int tail = __atomic_load_n(&port->ringTail, __ATOMIC_ACQUIRE);
+	if (__atomic_load_n(&port->ringDiscardPending, __ATOMIC_ACQUIRE))
+	{
+		unsigned int discardHead = __atomic_load_n(&port->ringDiscardHead, __ATOMIC_ACQUIRE);
+		if ((int)(discardHead - tail) > 0)
+			tail = discardHead;
+	}
+	return tail;
+}
 
-	// Ensure that the serial port still exists and is not already open
-	serialPort *port = fetchPort(&serialPorts, portName);
-	if (!port)
+static void advanceRingTail(serialPort *port, unsigned int tail)
+{
+	// Publish the new tail and wake the background reader only if it is waiting for room in the ring buffer
+	__atomic_store_n(&port->ringTail, tail, __ATOMIC_SEQ_CST);
+	if (__atomic_load_n(&port->ringSpaceWaiting, __ATOMIC_SEQ_CST))
 	{
-		// Create port representation and add to serial port listing
-		port = pushBack(&serialPorts, portName, "User-Specified Port", "User-Specified Port", "0-0");
+		pthread_mutex_lock(&port->eventMutex);
+		pthread_cond_signal(&port->ringSpaceAvailable);
+		pthread_mutex_unlock(&port->eventMutex);
 	}
-	if (!port || (port->handle > 0))
+}
+
+static unsigned int consumeRingDiscard(serialPort *port)
+{
+	// Apply any discard requested by another thread, returning the resulting tail
+	unsigned int tail = __atomic_load_n(&port->ringTail, __ATOMIC_RELAXED);
+	if (__atomic_exchange_n(&port->ringDiscardPending, 0, __ATOMIC_ACQ_REL))
 	{
-		(*env)->ReleaseStringUTFChars(env, portNameJString, portName);
-		checkJniError(env, __LINE__ - 1);
-		lastErrorLineNumber = __LINE__ - 3;
-		lastErrorNumber = (!port ? 1 : 2);
-		return 0;
+		unsigned int discardHead = __atomic_load_n(&port->ringDiscardHead, __ATOMIC_ACQUIRE);
+		if ((int)(discardHead - tail) > 0)
+		{
+			tail = discardHead;
+			advanceRingTail(port, tail);
+		}
 	}
+	return tail;
+}
 
-	// Fix user permissions so that they can open the port, if allowed
-	if (requestElevatedPermissions)
-		verifyAndSetUserPortGroup(portName);
+// Background ring buffer reading functionality
+static void* ringReaderThread(void *serialPortPointer)
+{
+	// Initialize the polling variables
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	struct pollfd waitingSet[2] = { { port->handle, POLLIN | POLLERR, 0 }, { port->closingPipe[0], POLLIN, 0 } };
+	applyPortThreadScheduling(port);
+#if defined(__linux__)
+	struct serial_icounter_struct oldSerialLineInterrupts, newSerialLineInterrupts;
+	ioctl(port->handle, TIOCGICOUNT, &oldSerialLineInterrupts);
+#endif // #if defined(__linux__)
 
-	// Try to open the serial port with read/write access
-	port->errorLineNumber = lastErrorLineNumber = __LINE__ + 1;
-	if ((port->handle = open(portName, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC)) > 0)
+	// Continuously drain the device into the ring buffer until told to stop
+	while (port->ringReaderRunning)
 	{
-		// Ensure that multiple root users cannot access the device simultaneously
-		if (!disableExclusiveLock && flock(port->handle, LOCK_EX | LOCK_NB))
+		// Only the consumer advances the tail, so wait for it to make room if the ring buffer is full
+		unsigned int head = __atomic_load_n(&port->ringHead, __ATOMIC_RELAXED);
+		unsigned int freeSpace = port->ringBufferLength - (head - __atomic_load_n(&port->ringTail, __ATOMIC_ACQUIRE));
+		if (!freeSpace)
 		{
-			port->errorLineNumber = lastErrorLineNumber = __LINE__ - 2;
-			port->errorNumber = lastErrorNumber = errno;
-			while (close(port->handle) && (errno == EINTR))
-				errno = 0;
-			port->handle = -1;
-		}
-		else if (!disableAutoConfig && !Java_com_fazecast_jSerialComm_SerialPort_configPort(env, obj, (jlong)(intptr_t)port))
+			// Announce that we are waiting before re-checking so that the consumer cannot miss waking us
+			pthread_mutex_lock(&port->eventMutex);
+			__atomic_store_n(&port->ringSpaceWaiting, 1, __ATOMIC_SEQ_CST);
+			if (((head - __atomic_load_n(&port->ringTail, __ATOMIC_SEQ_CST)) == port->ringBufferLength) && port->ringReaderRunning)
+				pthread_cond_wait(&port->ringSpaceAvailable, &port->eventMutex);
+			__atomic_store_n(&port->ringSpaceWaiting, 0, __ATOMIC_SEQ_CST);
+			pthread_mutex_unlock(&port->eventMutex);
+			continue;
+		}
+
+		// Wait for incoming data or a line error, stopping immediately if the port is being closed
+		waitingSet[0].revents = waitingSet[1].revents = 0;
+		if (poll(waitingSet, 2, 100) <= 0)
+			continue;
+		if (waitingSet[1].revents)
 		{
-			// Close the port if there was a problem setting the parameters
-			fcntl(port->handle, F_SETFL, O_NONBLOCK);
-			while (close(port->handle) && (errno == EINTR))
-				errno = 0;
-			port->handle = -1;
+			port->ringReaderRunning = 0;
+			break;
 		}
-		else if (autoFlushIOBuffers)
+		long long arrivalTimeNS = getMonotonicTimeNS();
+
+		// Read only what is already available so that the current termios timeouts can never block this thread
+		int event = 0, numBytesAvailable = 0, numBytesRead;
+		if (waitingSet[0].revents & (POLLHUP | POLLNVAL))
+			event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_PORT_DISCONNECTED;
+		else if (waitingSet[0].revents & POLLIN)
 		{
-			// Sleep to workaround kernel bug about flushing immediately after opening
-			const struct timespec sleep_time = { 0, 10000000 };
-			nanosleep(&sleep_time, NULL);
-			Java_com_fazecast_jSerialComm_SerialPort_flushRxTxBuffers(env, obj, (jlong)(intptr_t)port);
+			if (ioctl(port->handle, FIONREAD, &numBytesAvailable) == -1)
+				event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_PORT_DISCONNECTED;
+			else if (numBytesAvailable > 0)
+			{
+				unsigned int offset = head & (port->ringBufferLength - 1), contiguousSpace = port->ringBufferLength - offset;
+				if (contiguousSpace > freeSpace)
+					contiguousSpace = freeSpace;
+				if ((unsigned int)numBytesAvailable > contiguousSpace)
+					numBytesAvailable = contiguousSpace;
+				do { errno = 0; numBytesRead = read(port->handle, port->ringBuffer + offset, numBytesAvailable); addStatistic(&port->statistics.readSyscalls, 1); } while ((numBytesRead < 0) && (errno == EINTR));
+				if (numBytesRead > 0)
+				{
+					// Record the data before it can be consumed and remember when the oldest unread data arrived if the ring buffer was previously empty
+					if (head == peekRingTail(port))
+						__atomic_store_n(&port->ringTimestampNS, arrivalTimeNS, __ATOMIC_RELAXED);
+					recordTraffic(port, RECORDING_DIRECTION_RECEIVED, arrivalTimeNS, port->ringBuffer + offset, numBytesRead);
+					__atomic_store_n(&port->ringHead, head + numBytesRead, __ATOMIC_SEQ_CST);
+					event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_AVAILABLE;
+
+					// Wake up any multi-port readers polling for ring buffer data
+					if (__atomic_load_n(&port->ringPollWaiting, __ATOMIC_SEQ_CST))
+						signalWakePipe(port->ringDataPipe);
+				}
+				else if ((numBytesRead < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK))
+					event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_PORT_DISCONNECTED;
+			}
+		}
+#if defined(__linux__)
+		if ((waitingSet[0].revents & POLLERR) && !ioctl(port->handle, TIOCGICOUNT, &newSerialLineInterrupts))
+		{
+			if (oldSerialLineInterrupts.frame != newSerialLineInterrupts.frame)
+				event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_FRAMING_ERROR;
+			if (oldSerialLineInterrupts.brk != newSerialLineInterrupts.brk)
+				event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_BREAK_INTERRUPT;
+			if (oldSerialLineInterrupts.overrun != newSerialLineInterrupts.overrun)
+				event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_FIRMWARE_OVERRUN_ERROR;
+			if (oldSerialLineInterrupts.parity != newSerialLineInterrupts.parity)
+				event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_PARITY_ERROR;
+			if (oldSerialLineInterrupts.buf_overrun != newSerialLineInterrupts.buf_overrun)
+				event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_SOFTWARE_OVERRUN_ERROR;
+			memcpy(&oldSerialLineInterrupts, &newSerialLineInterrupts, sizeof(newSerialLineInterrupts));
+		}
+#endif // #if defined(__linux__)
+
+		// Stop reading if the device has gone away, and back off from an error condition that reported no data instead of spinning on it
+		if (event & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_PORT_DISCONNECTED)
+			port->ringReaderRunning = 0;
+		else if ((waitingSet[0].revents & POLLERR) && !(waitingSet[0].revents & POLLIN) && !event)
+		{
+			waitingSet[1].revents = 0;
+			if ((poll(waitingSet + 1, 1, RING_READER_ERROR_BACKOFF_MS) > 0) && waitingSet[1].revents)
+				port->ringReaderRunning = 0;
+		}
+
+		// Only take the lock when a reader or event listener is actually waiting to be notified
+		if (event && (port->eventListenerRunning || __atomic_load_n(&port->ringReaderWaiting, __ATOMIC_SEQ_CST)))
+		{
+			pthread_mutex_lock(&port->eventMutex);
+			if (port->eventListenerRunning)
+			{
+				if (!port->event)
+					port->pendingEventTimestampNS = arrivalTimeNS;
+				port->event |= event;
+				pthread_cond_signal(&port->eventReceived);
+			}
+			pthread_cond_broadcast(&port->ringDataReceived);
+			pthread_mutex_unlock(&port->eventMutex);
+		}
+	}
+
+	// Wake up any readers still waiting for data
+	pthread_mutex_lock(&port->eventMutex);
+	pthread_cond_broadcast(&port->ringDataReceived);
+	pthread_mutex_unlock(&port->eventMutex);
+	signalWakePipe(port->ringDataPipe);
+	return NULL;
+}
+
+static void stopRingReader(serialPort *port)
+{
+	// Signal the background reader to exit and wait for it to finish using the port
+	port->ringBufferEnabled = 0;
+	port->ringReaderRunning = 0;
+	pthread_mutex_lock(&port->eventMutex);
+	pthread_cond_signal(&port->ringSpaceAvailable);
+	pthread_mutex_unlock(&port->eventMutex);
+	if (port->ringReaderThread)
+	{
+		pthread_join(port->ringReaderThread, NULL);
+		port->ringReaderThread = 0;
+	}
+}
+
+// Waits for the port to become ready for reading or writing until the specified monotonic deadline (or forever if negative) or until it is closed
+static int waitForPortReady(serialPort *port, short pollEvents, long long deadlineNS)
+{
+	int pollResult;
+	struct pollfd waitingSet[2] = { { port->handle, pollEvents, 0 }, { port->closingPipe[0], POLLIN, 0 } };
+	do
+	{
+		// Round the remaining time up so that poll() never returns before the deadline
+		int timeoutMS = -1;
+		if (deadlineNS >= 0)
+		{
+			long long remainingNS = deadlineNS - getMonotonicTimeNS();
+			if (remainingNS <= 0)
+				return 0;
+			timeoutMS = (int)((remainingNS + 999999LL) / 1000000LL);
+		}
+		waitingSet[0].revents = waitingSet[1].revents = 0;
+		port->errorLineNumber = __LINE__ + 1;
+		do { errno = 0; pollResult = poll(waitingSet, 2, timeoutMS); port->errorNumber = errno; } while ((pollResult < 0) && (errno == EINTR));
+	} while (pollResult == 0);
+
+	// Treat closing of the port, a hangup, or any other condition without the requested readiness as a device error
+	if ((pollResult > 0) && (waitingSet[1].revents || !(waitingSet[0].revents & pollEvents)))
+	{
+		port->errorLineNumber = __LINE__ - 2;
+		port->errorNumber = EIO;
+		pollResult = -1;
+	}
+	return (pollResult < 0) ? -1 : 1;
+}
+
+// Waits for incoming data until the specified monotonic deadline (or forever if negative) with sub-millisecond precision
+static int waitForReadablePrecise(serialPort *port, long long deadlineNS)
+{
+	// Fall back to millisecond precision if the port cannot be represented in a descriptor set
+	int wakeDescriptor = port->closingPipe[0];
+	if ((port->handle >= FD_SETSIZE) || (wakeDescriptor >= FD_SETSIZE))
+		return waitForPortReady(port, POLLIN, deadlineNS);
+
+	int selectResult;
+	fd_set readSet;
+	do
+	{
+		struct timespec timeout, *timeoutPointer = NULL;
+		if (deadlineNS >= 0)
+		{
+			long long remainingNS = deadlineNS - getMonotonicTimeNS();
+			if (remainingNS <= 0)
+				return 0;
+			timeout.tv_sec = (time_t)(remainingNS / 1000000000LL);
+			timeout.tv_nsec = (long)(remainingNS % 1000000000LL);
+			timeoutPointer = &timeout;
+		}
+		FD_ZERO(&readSet);
+		FD_SET(port->handle, &readSet);
+		if (wakeDescriptor >= 0)
+			FD_SET(wakeDescriptor, &readSet);
+		port->errorLineNumber = __LINE__ + 1;
+		do { errno = 0; selectResult = pselect(((wakeDescriptor > port->handle) ? wakeDescriptor : port->handle) + 1, &readSet, NULL, NULL, timeoutPointer, NULL); port->errorNumber = errno; } while ((selectResult < 0) && (errno == EINTR));
+	} while (selectResult == 0);
+
+	// Treat closing of the port as a device error
+	if ((selectResult > 0) && (wakeDescriptor >= 0) && FD_ISSET(wakeDescriptor, &readSet))
+	{
+		port->errorLineNumber = __LINE__ - 2;
+		port->errorNumber = EIO;
+		selectResult = -1;
+	}
+	return (selectResult < 0) ? -1 : 1;
+}
+
+// Software RS-485 direction control functionality
+static void setCharacterTime(serialPort *port, int baudRate, int byteSize, int stopBits, int parity)
+{
+	// Calculate the time needed to transmit a single character, counting in half bits to account for 1.5 stop bits
+	int numHalfBits = (2 * (1 + byteSize + ((parity != com_fazecast_jSerialComm_SerialPort_NO_PARITY) ? 1 : 0))) +
+			((stopBits == com_fazecast_jSerialComm_SerialPort_TWO_STOP_BITS) ? 4 : (stopBits == com_fazecast_jSerialComm_SerialPort_ONE_POINT_FIVE_STOP_BITS) ? 3 : 2);
+	port->characterTimeNS = (baudRate > 0) ? ((numHalfBits * 500000000LL) / baudRate) : 0;
+}
+
+static void sleepUntil(long long deadlineNS)
+{
+	long long remainingNS = deadlineNS - getMonotonicTimeNS();
+	if (remainingNS > 0)
+	{
+		struct timespec sleepTime = { (time_t)(remainingNS / 1000000000LL), (long)(remainingNS % 1000000000LL) };
+		while (nanosleep(&sleepTime, &sleepTime) && (errno == EINTR));
+	}
+}
+
+static long long waitUntilPrecise(long long deadlineNS)
+{
+	// Sleep until shortly before the deadline, then spin through the remainder to avoid any scheduler wake-up latency
+	long long currentTimeNS;
+	sleepUntil(deadlineNS - PRECISE_WAIT_SPIN_NS);
+	while ((currentTimeNS = getMonotonicTimeNS()) < deadlineNS);
+	return currentTimeNS;
+}
+
+static void setRs485Transmitting(serialPort *port, int transmitting)
+{
+	int modemLines = TIOCM_RTS;
+	ioctl(port->handle, (!transmitting == !port->rs485ActiveHigh) ? TIOCMBIS : TIOCMBIC, &modemLines);
+}
+
+static int getTransmitterStatus(serialPort *port)
+{
+	// Returns 1 if the UART shift register is known to be empty, 0 while still transmitting, or -1 if only the driver queue is known to be empty
+#if defined(__linux__)
+	unsigned int lineStatus = 0;
+	if (port->rs485LineStatusSupported)
+		return ioctl(port->handle, TIOCSERGETLSR, &lineStatus) ? -1 : ((lineStatus & TIOCSER_TEMT) ? 1 : 0);
+#endif
+#if defined(TIOCOUTQ)
+	int numBytesQueued = 0;
+	if (!ioctl(port->handle, TIOCOUTQ, &numBytesQueued) && (numBytesQueued > 0))
+		return 0;
+#endif
+	return -1;
+}
+
+// Returns the monotonic deadline for a write started at the specified time, or -1 if writes may block forever
+static inline long long getWriteDeadline(serialPort *port, long long startTimeNS)
+{
+	return (port->writeTimeout > 0) ? (startTimeNS + (port->writeTimeout * 1000000LL)) : -1;
+}
+
+static long long waitForTransmitterEmpty(serialPort *port, long long expectedEndNS, long long deadlineNS)
+{
+	// Sleep through most of the transmission based on the line rate, then poll the device until it stops transmitting, giving up on a stalled
+	//   transmitter once the write deadline passes but never before the line rate permits
+	int transmitterStatus;
+	long long giveUpTimeNS = expectedEndNS + TRANSMITTER_TIMEOUT_NS;
+	if ((deadlineNS >= 0) && (deadlineNS < giveUpTimeNS))
+		giveUpTimeNS = (deadlineNS > expectedEndNS) ? deadlineNS : expectedEndNS;
+	sleepUntil(expectedEndNS - PRECISE_WAIT_SPIN_NS);
+	long long currentTimeNS = getMonotonicTimeNS();
+	while (!(transmitterStatus = getTransmitterStatus(port)) && (currentTimeNS < giveUpTimeNS))
+	{
+		// Stop spinning if the transmission is taking much longer than expected, such as while stalled by flow control
+		if (currentTimeNS > (expectedEndNS + TRANSMITTER_SPIN_NS))
+			sleepUntil(currentTimeNS + TRANSMITTER_POLL_INTERVAL_NS);
+		currentTimeNS = getMonotonicTimeNS();
+	}
+
+	// Without access to the line status, allow the final character to leave the device but never finish earlier than the line rate permits
+	if (transmitterStatus < 0)
+		currentTimeNS = waitUntilPrecise(((currentTimeNS + port->characterTimeNS) > expectedEndNS) ? (currentTimeNS + port->characterTimeNS) : expectedEndNS);
+	return currentTimeNS;
+}
+
+static long long beginRs485Transmission(serialPort *port)
+{
+	// Serialize all transmissions, switch the bus into transmit mode, and wait out the requested setup time
+	pthread_mutex_lock(&port->rs485Mutex);
+	setRs485Transmitting(port, 1);
+	return waitUntilPrecise(getMonotonicTimeNS() + port->rs485DelayBeforeNS);
+}
+
+static void endRs485Transmission(serialPort *port, long long startTimeNS, int numBytesWritten, long long deadlineNS)
+{
+	// Wait for the last bit to leave the device plus the requested hold time before switching the bus back into receive mode
+	if (numBytesWritten > 0)
+	{
+		long long emptyTimeNS = waitForTransmitterEmpty(port, startTimeNS + (numBytesWritten * port->characterTimeNS), deadlineNS);
+		waitUntilPrecise(emptyTimeNS + port->rs485DelayAfterNS);
+		setRs485Transmitting(port, 0);
+		long long turnaroundNS = getMonotonicTimeNS() - emptyTimeNS;
+
+		// Update the achieved turnaround statistics
+		addStatistic(&port->statistics.rs485Transmissions, 1);
+		addStatistic(&port->statistics.rs485TurnaroundNS, turnaroundNS);
+		if ((unsigned long long)turnaroundNS > __atomic_load_n(&port->statistics.rs485MaxTurnaroundNS, __ATOMIC_RELAXED))
+			__atomic_store_n(&port->statistics.rs485MaxTurnaroundNS, turnaroundNS, __ATOMIC_RELAXED);
+		recordHistogram(port->statistics.rs485Turnaround, turnaroundNS);
+
+		// Discard anything received while transmitting, such as the local echo of a half-duplex transceiver
+		if (!port->rs485RxDuringTx)
+		{
+			tcflush(port->handle, TCIFLUSH);
+			if (port->ringBufferEnabled)
+				discardRingBuffer(port);
 		}
 	}
 	else
-		port->errorNumber = lastErrorNumber = errno;
+		setRs485Transmitting(port, 0);
+	pthread_mutex_unlock(&port->rs485Mutex);
+}
+
+// Background transmit queue writing functionality
+static void* txWriterThread(void *serialPortPointer)
+{
+	// Continuously write out all queued data until told to stop and the queue is empty
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	applyPortThreadScheduling(port);
+	pthread_mutex_lock(&port->txMutex);
+	while (1)
+	{
+		// Wait for data to be queued
+		if (port->txDiscard)
+			port->txTail = port->txHead;
+		if (port->txHead == port->txTail)
+		{
+			if (!port->txWriterRunning)
+				break;
+			pthread_cond_wait(&port->txDataQueued, &port->txMutex);
+			continue;
+		}
+
+		// Coalesce everything queued so far into a single write, up to the end of the ring buffer
+		unsigned int offset = port->txTail & (port->txBufferLength - 1), numBytesToWrite = port->txHead - port->txTail;
+		if (numBytesToWrite > (port->txBufferLength - offset))
+			numBytesToWrite = port->txBufferLength - offset;
+		pthread_mutex_unlock(&port->txMutex);
+
+		// Write without holding the lock, periodically checking whether the queue is being discarded while the device cannot accept more data,
+		//   and releasing the bus after each write timeout under software RS-485 control so that other writers are never locked out indefinitely
+		int result, rs485SoftwareControl = port->rs485SoftwareControl;
+		long long rs485StartTimeNS = rs485SoftwareControl ? beginRs485Transmission(port) : 0;
+		long long rs485DeadlineNS = rs485SoftwareControl ? getWriteDeadline(port, rs485StartTimeNS) : -1;
+		while (1)
+		{
+			port->errorLineNumber = __LINE__ + 1;
+			do { errno = 0; result = write(port->handle, port->txBuffer + offset, numBytesToWrite); port->errorNumber = errno; addStatistic(&port->statistics.writeSyscalls, 1); } while ((result < 0) && (errno == EINTR));
+			if ((result >= 0) || ((errno != EAGAIN) && (errno != EWOULDBLOCK)) || port->txDiscard)
+				break;
+			addStatistic(&port->statistics.writeRetries, 1);
+			long long wakeTimeNS = getMonotonicTimeNS() + 100000000LL;
+			if ((rs485DeadlineNS >= 0) && (rs485DeadlineNS < wakeTimeNS))
+				wakeTimeNS = rs485DeadlineNS;
+			int waitResult = waitForPortReady(port, POLLOUT, wakeTimeNS);
+			if (waitResult < 0)
+				break;
+			else if (!waitResult && (rs485DeadlineNS >= 0) && (getMonotonicTimeNS() >= rs485DeadlineNS))
+			{
+				result = 0;
+				break;
+			}
+		}
+		if (rs485SoftwareControl)
+			endRs485Transmission(port, rs485StartTimeNS, result, rs485DeadlineNS);
+
+		// Discard all queued data upon failure so that any waiting writers and barriers are released
+		pthread_mutex_lock(&port->txMutex);
+		if ((result < 0) && !port->txDiscard)
+			port->txFailed = 1;
+		if ((result < 0) || port->txDiscard)
+			port->txTail = port->txHead;
+		else
+		{
+			recordTraffic(port, RECORDING_DIRECTION_TRANSMITTED, 0, port->txBuffer + offset, result);
+			port->txTail += result;
+		}
+		pthread_cond_broadcast(&port->txSpaceAvailable);
+	}
+	pthread_cond_broadcast(&port->txSpaceAvailable);
+	pthread_mutex_unlock(&port->txMutex);
+	return NULL;
+}
+
+static void stopTxWriter(serialPort *port, int discardQueuedData)
+{
+	// Signal the background writer to exit once the queue is empty, or as soon as possible if queued data is to be discarded
+	pthread_mutex_lock(&port->txMutex);
+	port->txQueueEnabled = port->txWriterRunning = 0;
+	if (discardQueuedData)
+		port->txDiscard = 1;
+	pthread_cond_broadcast(&port->txDataQueued);
+	pthread_cond_broadcast(&port->txSpaceAvailable);
+	pthread_mutex_unlock(&port->txMutex);
+
+	// Wait for the writer to finish using the port
+	if (port->txWriterThread)
+	{
+		pthread_join(port->txWriterThread, NULL);
+		port->txWriterThread = 0;
+	}
+}
+
+// Virtual port functionality
+static int getVirtualModemLines(serialPort *port)
+{
+	// Loopback ports wire RTS to CTS and DTR to DSR and DCD, while replayed devices always assert their outputs
+	int modemLines = __atomic_load_n(&port->virtualModemLines, __ATOMIC_SEQ_CST);
+	if (port->virtualReplay)
+		modemLines |= (TIOCM_CTS | TIOCM_DSR | TIOCM_CAR);
+	else
+	{
+		if (modemLines & TIOCM_RTS)
+			modemLines |= TIOCM_CTS;
+		if (modemLines & TIOCM_DTR)
+			modemLines |= (TIOCM_DSR | TIOCM_CAR);
+	}
+	return modemLines;
+}
+
+static int getModemLines(serialPort *port, int *modemLines)
+{
+	if (port->virtualDevice < 0)
+		return ioctl(port->handle, TIOCMGET, modemLines);
+	*modemLines = getVirtualModemLines(port);
+	return 0;
+}
+
+static int changeModemLines(serialPort *port, int setLines, int modemLines)
+{
+	// Directly change the modem lines of physical ports
+	if (port->virtualDevice < 0)
+		return ioctl(port->handle, setLines ? TIOCMBIS : TIOCMBIC, &modemLines);
+
+	// Emulate the modem lines of virtual ports
+	long long eventTimeNS = getMonotonicTimeNS();
+	int oldModemLines = getVirtualModemLines(port), event = 0;
+	if (setLines)
+		__atomic_fetch_or(&port->virtualModemLines, modemLines, __ATOMIC_SEQ_CST);
+	else
+		__atomic_fetch_and(&port->virtualModemLines, ~modemLines, __ATOMIC_SEQ_CST);
+	int changedModemLines = oldModemLines ^ getVirtualModemLines(port);
+	if (changedModemLines & TIOCM_CTS)
+		event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_CTS;
+	if (changedModemLines & TIOCM_DSR)
+		event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DSR;
+	if (changedModemLines & TIOCM_CAR)
+		event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_CARRIER_DETECT;
+
+	// Notify any threaded event listener of the resulting input line changes
+	if (event && port->eventListenerRunning && port->eventListenerUsesThreads)
+	{
+		pthread_mutex_lock(&port->eventMutex);
+		if (!port->event)
+			port->pendingEventTimestampNS = eventTimeNS;
+		port->event |= event;
+		pthread_cond_signal(&port->eventReceived);
+		pthread_mutex_unlock(&port->eventMutex);
+	}
+	return 0;
+}
+
+static int writeToVirtualDevice(serialPort *port, const char *buffer, int length)
+{
+	// Feed data into the port, waiting whenever its input buffer is full
+	struct pollfd waitingSet = { port->virtualDevice, POLLOUT, 0 };
+	int numBytesWritten = 0;
+	while ((numBytesWritten < length) && port->virtualDeviceRunning)
+	{
+		int result = write(port->virtualDevice, buffer + numBytesWritten, length - numBytesWritten);
+		if (result > 0)
+			numBytesWritten += result;
+		else if ((result < 0) && (errno == EAGAIN || errno == EWOULDBLOCK))
+			poll(&waitingSet, 1, 100);
+		else if ((result < 0) && (errno != EINTR))
+			return -1;
+	}
+	return numBytesWritten;
+}
+
+static const recordingEntry* getNextReplayEntry(serialPort *port, unsigned long long *position)
+{
+	// Find the next entry containing received data, skipping padding and transmitted data
+	const recordingHeader *header = (const recordingHeader*)port->virtualReplay;
+	const char *dataRegion = port->virtualReplay + sizeof(recordingHeader);
+	while (*position < header->writePosition)
+	{
+		unsigned long long offset = *position % header->dataLength, remaining = header->dataLength - offset;
+		if (remaining < sizeof(recordingEntry))
+		{
+			*position += remaining;
+			continue;
+		}
+		const recordingEntry *entry = (const recordingEntry*)(dataRegion + offset);
+		unsigned long long entrySize = sizeof(recordingEntry) + ((entry->length + 7ULL) & ~7ULL);
+		if (entrySize > remaining)
+			break;
+		*position += entrySize;
+		if (entry->direction == RECORDING_DIRECTION_RECEIVED)
+			return entry;
+	}
+	return NULL;
+}
+
+static void* virtualDeviceThread(void *serialPortPointer)
+{
+	// Locate the first entry to replay, if any
+	char buffer[4096];
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	struct pollfd waitingSet = { port->virtualDevice, POLLIN, 0 };
+	unsigned long long replayPosition = port->virtualReplay ? ((const recordingHeader*)port->virtualReplay)->oldestPosition : 0;
+	const recordingEntry *replayEntry = port->virtualReplay ? getNextReplayEntry(port, &replayPosition) : NULL;
+	applyPortThreadScheduling(port);
+	long long firstEntryTimestampNS = replayEntry ? replayEntry->timestampNS : 0, replayStartTimeNS = getMonotonicTimeNS();
+
+	// Service the device end of the port until it is closed
+	while (port->virtualDeviceRunning)
+	{
+		// Wait for data to be written to the port or until the next replayed entry is due, scaling the recorded timing by the replay speed
+		int waitTimeMS = 100;
+		long long dueTimeNS = 0;
+		if (replayEntry)
+		{
+			if (port->virtualReplaySpeed > 0.0)
+				dueTimeNS = replayStartTimeNS + (long long)((double)(replayEntry->timestampNS - firstEntryTimestampNS) / port->virtualReplaySpeed);
+			long long remainingNS = dueTimeNS - getMonotonicTimeNS();
+			waitTimeMS = (remainingNS <= 0) ? 0 : ((remainingNS >= 100000000LL) ? 100 : (int)((remainingNS + 999999LL) / 1000000LL));
+		}
+		waitingSet.revents = 0;
+		if (poll(&waitingSet, 1, waitTimeMS) > 0)
+		{
+			// Loop written data back into the port, or discard it while replaying
+			if (waitingSet.revents & POLLIN)
+			{
+				int numBytesRead = read(port->virtualDevice, buffer, sizeof(buffer));
+				if ((numBytesRead > 0) && !port->virtualReplay && (writeToVirtualDevice(port, buffer, numBytesRead) < 0))
+					break;
+			}
+			else if (waitingSet.revents & (POLLHUP | POLLERR))
+				break;
+		}
+
+		// Feed the next replayed entry into the port once it is due
+		if (replayEntry && (getMonotonicTimeNS() >= dueTimeNS))
+		{
+			if (writeToVirtualDevice(port, (const char*)(replayEntry + 1), (int)replayEntry->length) < 0)
+				break;
+			replayEntry = getNextReplayEntry(port, &replayPosition);
+		}
+	}
+	return NULL;
+}
+
+static void closeVirtualPort(serialPort *port)
+{
+	// Stop servicing the device end and release all virtual device resources
+	port->virtualDeviceRunning = 0;
+	if (port->virtualDeviceThread)
+	{
+		pthread_join(port->virtualDeviceThread, NULL);
+		port->virtualDeviceThread = 0;
+	}
+	if (port->virtualDevice >= 0)
+	{
+		close(port->virtualDevice);
+		port->virtualDevice = -1;
+	}
+	if (port->virtualReplay)
+	{
+		munmap(port->virtualReplay, port->virtualReplayLength);
+		port->virtualReplay = NULL;
+		port->virtualReplayLength = 0;
+	}
+}
+
+static int openVirtualPort(serialPort *port, const char *portName)
+{
+	// Map and validate the capture file to be replayed, if requested
+	if (!strncmp(portName, VIRTUAL_REPLAY_PREFIX, strlen(VIRTUAL_REPLAY_PREFIX)))
+	{
+		char *fileName = NULL;
+		const char *speed = strchr(portName + strlen(VIRTUAL_REPLAY_PREFIX), ':');
+		port->virtualReplaySpeed = speed ? strtod(speed + 1, &fileName) : 0.0;
+		if (!speed || (fileName == (speed + 1)) || (*fileName != ':'))
+		{
+			errno = EINVAL;
+			return -1;
+		}
+		int replayFD = open(fileName + 1, O_RDONLY | O_CLOEXEC);
+		if (replayFD < 0)
+			return -1;
+		struct stat fileInfo;
+		void *replay = MAP_FAILED;
+		memset(&fileInfo, 0, sizeof(fileInfo));
+		if (!fstat(replayFD, &fileInfo) && (fileInfo.st_size >= (off_t)sizeof(recordingHeader)))
+			replay = mmap(NULL, (size_t)fileInfo.st_size, PROT_READ, MAP_PRIVATE, replayFD, 0);
+		close(replayFD);
+		const recordingHeader *header = (const recordingHeader*)replay;
+		if ((replay == MAP_FAILED) || memcmp(header->magic, RECORDING_MAGIC, sizeof(header->magic)) || (header->byteOrderMark != RECORDING_BYTE_ORDER_MARK) ||
+				(header->version != RECORDING_VERSION) || !header->dataLength || (header->dataLength % 8) || ((sizeof(recordingHeader) + header->dataLength) > (unsigned long long)fileInfo.st_size) ||
+				(header->writePosition < header->oldestPosition) || ((header->writePosition - header->oldestPosition) > header->dataLength))
+		{
+			if (replay != MAP_FAILED)
+				munmap(replay, (size_t)fileInfo.st_size);
+			errno = EINVAL;
+			return -1;
+		}
+		port->virtualReplay = (char*)replay;
+		port->virtualReplayLength = (unsigned long long)fileInfo.st_size;
+	}
+	else if (strncmp(portName, VIRTUAL_LOOPBACK_PREFIX, strlen(VIRTUAL_LOOPBACK_PREFIX)))
+	{
+		errno = EINVAL;
+		return -1;
+	}
+
+	// Create a pseudo-terminal whose terminal end becomes the port handle, keeping the device end for the servicing thread
+	int portFD = -1, errorNumber;
+	char terminalPath[PATH_MAX] = { 0 };
+	port->virtualDevice = posix_openpt(O_RDWR | O_NOCTTY);
+	if ((port->virtualDevice >= 0) && !grantpt(port->virtualDevice) && !unlockpt(port->virtualDevice))
+	{
+#if defined(__linux__)
+		if (ptsname_r(port->virtualDevice, terminalPath, sizeof(terminalPath)))
+			terminalPath[0] = '\0';
+#else
+		pthread_mutex_lock(&serialPortsMutex);
+		const char *terminalName = ptsname(port->virtualDevice);
+		if (terminalName)
+			strncpy(terminalPath, terminalName, sizeof(terminalPath) - 1);
+		pthread_mutex_unlock(&serialPortsMutex);
+#endif
+		fcntl(port->virtualDevice, F_SETFD, FD_CLOEXEC);
+		fcntl(port->virtualDevice, F_SETFL, O_NONBLOCK);
+		if (terminalPath[0])
+			portFD = open(terminalPath, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+	}
+	if (portFD < 0)
+	{
+		errorNumber = errno ? errno : ENOENT;
+		closeVirtualPort(port);
+		errno = errorNumber;
+		return -1;
+	}
+
+	// Assert the output modem lines as a physical port would upon opening and start servicing the device end
+	port->virtualModemLines = TIOCM_RTS | TIOCM_DTR;
+	port->virtualDeviceRunning = 1;
+	if ((errorNumber = pthread_create(&port->virtualDeviceThread, NULL, virtualDeviceThread, port)) != 0)
+	{
+		port->virtualDeviceThread = 0;
+		close(portFD);
+		closeVirtualPort(port);
+		errno = errorNumber;
+		return -1;
+	}
+	return portFD;
+}
+
+// Java-based port listing creation function
+static jobjectArray createPortListing(JNIEnv *env, serialPortVector *comPorts)
+{
+	jobjectArray arrayObject = (*env)->NewObjectArray(env, comPorts->length, serialCommClass, 0);
+	if (checkJniError(env, __LINE__ - 1)) return arrayObject;
+	for (int i = 0; i < comPorts->length; ++i)
+	{
+		// Create a new SerialComm object containing the enumerated values
+		jobject serialCommObject = (*env)->NewObject(env, serialCommClass, serialCommConstructor);
+		if (checkJniError(env, __LINE__ - 1)) return arrayObject;
+		(*env)->SetObjectField(env, serialCommObject, portDescriptionField, (*env)->NewStringUTF(env, comPorts->ports[i]->portDescription));
+		if (checkJniError(env, __LINE__ - 1)) return arrayObject;
+		(*env)->SetObjectField(env, serialCommObject, friendlyNameField, (*env)->NewStringUTF(env, comPorts->ports[i]->friendlyName));
+		if (checkJniError(env, __LINE__ - 1)) return arrayObject;
+		(*env)->SetObjectField(env, serialCommObject, comPortField, (*env)->NewStringUTF(env, comPorts->ports[i]->portPath));
+		if (checkJniError(env, __LINE__ - 1)) return arrayObject;
+		(*env)->SetObjectField(env, serialCommObject, portLocationField, (*env)->NewStringUTF(env, comPorts->ports[i]->portLocation));
+		if (checkJniError(env, __LINE__ - 1)) return arrayObject;
+
+		// Add new SerialComm object to array
+		(*env)->SetObjectArrayElement(env, arrayObject, i, serialCommObject);
+		if (checkJniError(env, __LINE__ - 1)) return arrayObject;
+	}
+	return arrayObject;
+}
+
+JNIEXPORT jobjectArray JNICALL Java_com_fazecast_jSerialComm_SerialPort_getCommPorts(JNIEnv *env, jclass serialComm)
+{
+	// Lock the serial port listing for the duration of the enumeration
+	pthread_mutex_lock(&serialPortsMutex);
+
+	// Start listening for hotplug events before the first enumeration so that no changes can be missed
+	if (!hotplugMonitorStatus)
+		hotplugMonitorStatus = startHotplugMonitor(portListingChanged) ? 1 : -1;
+
+	// Only re-enumerate all ports on the current system if the listing may have changed
+	if ((hotplugMonitorStatus < 0) || !portsEnumerated || (enumeratedGeneration != __atomic_load_n(&portListingGeneration, __ATOMIC_ACQUIRE)))
+		enumeratePorts();
+
+	// Create a Java-based port listing
+	jobjectArray arrayObject = createPortListing(env, &serialPorts);
+	pthread_mutex_unlock(&serialPortsMutex);
+	return arrayObject;
+}
+
+JNIEXPORT jobjectArray JNICALL Java_com_fazecast_jSerialComm_SerialPort_getCommPortsFiltered(JNIEnv *env, jclass serialComm, jstring pathPattern, jint vendorID, jint productID, jstring driverName)
+{
+	// Retrieve the filter criteria
+	portFilter filter = { NULL, NULL, vendorID, productID };
+	if (pathPattern)
+	{
+		filter.pathPattern = (*env)->GetStringUTFChars(env, pathPattern, NULL);
+		if (checkJniError(env, __LINE__ - 1)) return NULL;
+	}
+	if (driverName)
+	{
+		filter.driverName = (*env)->GetStringUTFChars(env, driverName, NULL);
+		if (checkJniError(env, __LINE__ - 1)) { if (filter.pathPattern) (*env)->ReleaseStringUTFChars(env, pathPattern, filter.pathPattern); return NULL; }
+	}
+
+	// Search for matching ports using a temporary listing so that the cached full listing remains intact
+	serialPortVector matchingPorts = { NULL, 0, 0 };
+	searchForMatchingPorts(&matchingPorts, &filter);
+	jobjectArray arrayObject = createPortListing(env, &matchingPorts);
+
+	// Clean up memory
+	while (matchingPorts.length)
+		removePort(&matchingPorts, matchingPorts.ports[0]);
+	if (matchingPorts.ports)
+		free(matchingPorts.ports);
+	if (filter.driverName)
+		(*env)->ReleaseStringUTFChars(env, driverName, filter.driverName);
+	if (filter.pathPattern)
+		(*env)->ReleaseStringUTFChars(env, pathPattern, filter.pathPattern);
+	return arrayObject;
+}
+
+JNIEXPORT void JNICALL Java_com_fazecast_jSerialComm_SerialPort_initializeLibrary(JNIEnv *env, jclass serialComm)
+{
+	// Cache class and method ID as global references
+	jniErrorClass = (*env)->FindClass(env, "java/lang/Exception");
+	serialCommClass = (jclass)(*env)->NewGlobalRef(env, serialComm);
+	if (checkJniError(env, __LINE__ - 1)) return;
+	serialCommConstructor = (*env)->GetMethodID(env, serialCommClass, "<init>", "()V");
+	if (checkJniError(env, __LINE__ - 1)) return;
+
+	// Cache Java fields as global references
+	serialPortFdField = (*env)->GetFieldID(env, serialCommClass, "portHandle", "J");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	comPortField = (*env)->GetFieldID(env, serialCommClass, "comPort", "Ljava/lang/String;");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	friendlyNameField = (*env)->GetFieldID(env, serialCommClass, "friendlyName", "Ljava/lang/String;");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	portDescriptionField = (*env)->GetFieldID(env, serialCommClass, "portDescription", "Ljava/lang/String;");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	portLocationField = (*env)->GetFieldID(env, serialCommClass, "portLocation", "Ljava/lang/String;");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	eventListenerRunningField = (*env)->GetFieldID(env, serialCommClass, "eventListenerRunning", "Z");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	disableConfigField = (*env)->GetFieldID(env, serialCommClass, "disableConfig", "Z");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	isDtrEnabledField = (*env)->GetFieldID(env, serialCommClass, "isDtrEnabled", "Z");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	isRtsEnabledField = (*env)->GetFieldID(env, serialCommClass, "isRtsEnabled", "Z");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	autoFlushIOBuffersField = (*env)->GetFieldID(env, serialCommClass, "autoFlushIOBuffers", "Z");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	baudRateField = (*env)->GetFieldID(env, serialCommClass, "baudRate", "I");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	dataBitsField = (*env)->GetFieldID(env, serialCommClass, "dataBits", "I");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	stopBitsField = (*env)->GetFieldID(env, serialCommClass, "stopBits", "I");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	parityField = (*env)->GetFieldID(env, serialCommClass, "parity", "I");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	flowControlField = (*env)->GetFieldID(env, serialCommClass, "flowControl", "I");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	sendDeviceQueueSizeField = (*env)->GetFieldID(env, serialCommClass, "sendDeviceQueueSize", "I");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	receiveDeviceQueueSizeField = (*env)->GetFieldID(env, serialCommClass, "receiveDeviceQueueSize", "I");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	disableExclusiveLockField = (*env)->GetFieldID(env, serialCommClass, "disableExclusiveLock", "Z");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	requestElevatedPermissionsField = (*env)->GetFieldID(env, serialCommClass, "requestElevatedPermissions", "Z");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	rs485ModeField = (*env)->GetFieldID(env, serialCommClass, "rs485Mode", "Z");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	rs485ActiveHighField = (*env)->GetFieldID(env, serialCommClass, "rs485ActiveHigh", "Z");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	rs485EnableTerminationField = (*env)->GetFieldID(env, serialCommClass, "rs485EnableTermination", "Z");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	rs485RxDuringTxField = (*env)->GetFieldID(env, serialCommClass, "rs485RxDuringTx", "Z");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	rs485DelayBeforeField = (*env)->GetFieldID(env, serialCommClass, "rs485DelayBefore", "I");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	rs485DelayAfterField = (*env)->GetFieldID(env, serialCommClass, "rs485DelayAfter", "I");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	rs485SoftwareControlField = (*env)->GetFieldID(env, serialCommClass, "rs485SoftwareControl", "Z");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	xonStartCharField = (*env)->GetFieldID(env, serialCommClass, "xonStartChar", "B");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	xoffStopCharField = (*env)->GetFieldID(env, serialCommClass, "xoffStopChar", "B");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	timeoutModeField = (*env)->GetFieldID(env, serialCommClass, "timeoutMode", "I");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	readTimeoutField = (*env)->GetFieldID(env, serialCommClass, "readTimeout", "I");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	writeTimeoutField = (*env)->GetFieldID(env, serialCommClass, "writeTimeout", "I");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	eventFlagsField = (*env)->GetFieldID(env, serialCommClass, "eventFlags", "I");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	lowLatencyModeField = (*env)->GetFieldID(env, serialCommClass, "lowLatencyMode", "Z");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	interByteTimeoutField = (*env)->GetFieldID(env, serialCommClass, "interByteTimeout", "I");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	threadAffinityMaskField = (*env)->GetFieldID(env, serialCommClass, "threadAffinityMask", "J");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	threadPriorityField = (*env)->GetFieldID(env, serialCommClass, "threadPriority", "I");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	threadRoundRobinField = (*env)->GetFieldID(env, serialCommClass, "threadRoundRobin", "Z");
+	if (checkJniError(env, __LINE__ - 1)) return;
+
+	// Initialize the hotplug notification mutex and condition variable
+	pthread_mutex_init(&hotplugMutex, NULL);
+	pthread_condattr_t conditionVariableAttributes;
+	pthread_condattr_init(&conditionVariableAttributes);
+#if !defined(__APPLE__) && !defined(__OpenBSD__)
+	pthread_condattr_setclock(&conditionVariableAttributes, CLOCK_MONOTONIC);
+#endif
+	pthread_cond_init(&hotplugCondition, &conditionVariableAttributes);
+	pthread_condattr_destroy(&conditionVariableAttributes);
+
+	// Disable handling of various POSIX signals
+	sigset_t blockMask;
+	memset(&blockMask, 0, sizeof(blockMask));
+	struct sigaction ignoreAction = { 0 };
+	ignoreAction.sa_handler = SIG_IGN;
+	ignoreAction.sa_mask = blockMask;
+	sigaction(SIGIO, &ignoreAction, NULL);
+	sigaction(SIGHUP, &ignoreAction, NULL);
+	sigaction(SIGTERM, &ignoreAction, NULL);
+	sigaction(SIGCONT, &ignoreAction, NULL);
+	sigaction(SIGUSR1, &ignoreAction, NULL);
+	sigaction(SIGUSR2, &ignoreAction, NULL);
+	sigaction(SIGTTOU, &ignoreAction, NULL);
+	sigaction(SIGTTIN, &ignoreAction, NULL);
+}
+
+JNIEXPORT void JNICALL Java_com_fazecast_jSerialComm_SerialPort_uninitializeLibrary(JNIEnv *env, jclass serialComm)
+{
+	// Close all open ports
+	pthread_mutex_lock(&serialPortsMutex);
+	for (int i = 0; i < serialPorts.length; ++i)
+		if (serialPorts.ports[i]->handle > 0)
+		{
+			// Open ports are never removed from the listing, so the port remains valid while the listing is unlocked
+			serialPort *port = serialPorts.ports[i];
+			pthread_mutex_unlock(&serialPortsMutex);
+			Java_com_fazecast_jSerialComm_SerialPort_closePortNative(env, serialComm, (jlong)(intptr_t)port, JNI_FALSE);
+			pthread_mutex_lock(&serialPortsMutex);
+		}
+	pthread_mutex_unlock(&serialPortsMutex);
+
+	// Stop listening for hotplug events
+	if (hotplugMonitorStatus > 0)
+		stopHotplugMonitor();
+	hotplugMonitorStatus = 0;
+
+	// Delete the cached global reference
+	(*env)->DeleteGlobalRef(env, serialCommClass);
+	checkJniError(env, __LINE__ - 1);
+}
+
+JNIEXPORT void JNICALL Java_com_fazecast_jSerialComm_SerialPort_retrievePortDetails(JNIEnv *env, jobject obj)
+{
+	// Retrieve the serial port parameter fields
+	jstring portNameJString = (jstring)(*env)->GetObjectField(env, obj, comPortField);
+	if (checkJniError(env, __LINE__ - 1)) return;
+	const char *portName = (*env)->GetStringUTFChars(env, portNameJString, NULL);
+	if (checkJniError(env, __LINE__ - 1)) return;
+
+	// Ensure that the serial port exists
+	pthread_mutex_lock(&serialPortsMutex);
+	if (!portsEnumerated)
+		enumeratePorts();
+	serialPort *port = fetchPort(&serialPorts, portName);
+	if (!port)
+	{
+		pthread_mutex_unlock(&serialPortsMutex);
+		(*env)->ReleaseStringUTFChars(env, portNameJString, portName);
+		checkJniError(env, __LINE__ - 1);
+		return;
+	}
+
+	// Fill in the Java-side port details
+	(*env)->SetObjectField(env, obj, portDescriptionField, (*env)->NewStringUTF(env, port->portDescription));
+	if (checkJniError(env, __LINE__ - 1)) { pthread_mutex_unlock(&serialPortsMutex); return; }
+	(*env)->SetObjectField(env, obj, friendlyNameField, (*env)->NewStringUTF(env, port->friendlyName));
+	if (checkJniError(env, __LINE__ - 1)) { pthread_mutex_unlock(&serialPortsMutex); return; }
+	(*env)->SetObjectField(env, obj, portLocationField, (*env)->NewStringUTF(env, port->portLocation));
+	if (checkJniError(env, __LINE__ - 1)) { pthread_mutex_unlock(&serialPortsMutex); return; }
+	pthread_mutex_unlock(&serialPortsMutex);
+
+	// Release all JNI structures
+	(*env)->ReleaseStringUTFChars(env, portNameJString, portName);
+	checkJniError(env, __LINE__ - 1);
+}
+
+JNIEXPORT jlong JNICALL Java_com_fazecast_jSerialComm_SerialPort_openPortNative(JNIEnv *env, jobject obj)
+{
+	// Retrieve the serial port parameter fields
+	jstring portNameJString = (jstring)(*env)->GetObjectField(env, obj, comPortField);
+	if (checkJniError(env, __LINE__ - 1)) return 0;
+	const char *portName = (*env)->GetStringUTFChars(env, portNameJString, NULL);
+	if (checkJniError(env, __LINE__ - 1)) return 0;
+	unsigned char disableExclusiveLock = (*env)->GetBooleanField(env, obj, disableExclusiveLockField);
+	if (checkJniError(env, __LINE__ - 1)) return 0;
+	unsigned char requestElevatedPermissions = (*env)->GetBooleanField(env, obj, requestElevatedPermissionsField);
+	if (checkJniError(env, __LINE__ - 1)) return 0;
+	unsigned char disableAutoConfig = (*env)->GetBooleanField(env, obj, disableConfigField);
+	if (checkJniError(env, __LINE__ - 1)) return 0;
+	unsigned char autoFlushIOBuffers = (*env)->GetBooleanField(env, obj, autoFlushIOBuffersField);
+	if (checkJniError(env, __LINE__ - 1)) return 0;
+	long long threadAffinityMask = (long long)(*env)->GetLongField(env, obj, threadAffinityMaskField);
+	if (checkJniError(env, __LINE__ - 1)) return 0;
+	int threadPriority = (*env)->GetIntField(env, obj, threadPriorityField);
+	if (checkJniError(env, __LINE__ - 1)) return 0;
+	unsigned char threadRoundRobin = (*env)->GetBooleanField(env, obj, threadRoundRobinField);
+	if (checkJniError(env, __LINE__ - 1)) return 0;
+
+	// Ensure that the serial port still exists and is not already open or being opened by another thread
+	pthread_mutex_lock(&serialPortsMutex);
+	serialPort *port = fetchPort(&serialPorts, portName);
+	if (!port)
+	{
+		// Create port representation and add to serial port listing
+		port = pushBack(&serialPorts, portName, "User-Specified Port", "User-Specified Port", "0-0");
+	}
+	if (!port || (port->handle > 0) || port->opening)
+	{
+		pthread_mutex_unlock(&serialPortsMutex);
+		(*env)->ReleaseStringUTFChars(env, portNameJString, portName);
+		checkJniError(env, __LINE__ - 1);
+		lastErrorLineNumber = __LINE__ - 4;
+		lastErrorNumber = (!port ? 1 : 2);
+		return 0;
+	}
+
+	// Claim the port so that it cannot be removed from the listing while it is being opened without the lock held
+	port->opening = 1;
+	pthread_mutex_unlock(&serialPortsMutex);
+
+	// Create the wakeup pipe used to release all waiting threads when the port is closed
+	prepareWakePipe(port->closingPipe);
+
+	// Store the requested thread scheduling so that each native thread belonging to the port can apply it to itself, with no settings applied yet
+	port->threadAffinityMask = threadAffinityMask;
+	port->threadPriority = threadPriority;
+	port->threadRoundRobin = threadRoundRobin;
+	port->threadSchedulingStatus = -1;
+
+	// Fix user permissions so that they can open the port, if allowed
+	int isVirtualPort = !strncmp(portName, VIRTUAL_PORT_PREFIX, strlen(VIRTUAL_PORT_PREFIX));
+	if (requestElevatedPermissions && !isVirtualPort)
+		verifyAndSetUserPortGroup(portName);
+
+	// Try to open the serial port with read/write access, creating the backing pseudo-terminal for virtual ports
+	port->errorLineNumber = lastErrorLineNumber = __LINE__ + 1;
+	if ((port->handle = isVirtualPort ? openVirtualPort(port, portName) : open(portName, O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC)) > 0)
+	{
+		// Start a fresh set of performance statistics for this session
+		resetStatistics(port);
+
+		// Ensure that multiple root users cannot access the device simultaneously
+		if (!disableExclusiveLock && flock(port->handle, LOCK_EX | LOCK_NB))
+		{
+			port->errorLineNumber = lastErrorLineNumber = __LINE__ - 2;
+			port->errorNumber = lastErrorNumber = errno;
+			while (close(port->handle) && (errno == EINTR))
+				errno = 0;
+			port->handle = -1;
+		}
+		else if (!disableAutoConfig && !Java_com_fazecast_jSerialComm_SerialPort_configPort(env, obj, (jlong)(intptr_t)port))
+		{
+			// Close the port if there was a problem setting the parameters
+			fcntl(port->handle, F_SETFL, O_NONBLOCK);
+			while (close(port->handle) && (errno == EINTR))
+				errno = 0;
+			port->handle = -1;
+		}
+		else if (autoFlushIOBuffers)
+		{
+			// Sleep to workaround kernel bug about flushing immediately after opening
+			const struct timespec sleep_time = { 0, 10000000 };
+			nanosleep(&sleep_time, NULL);
+			Java_com_fazecast_jSerialComm_SerialPort_flushRxTxBuffers(env, obj, (jlong)(intptr_t)port);
+		}
+	}
+	else
+		port->errorNumber = lastErrorNumber = errno;
+
+	// Release any virtual device resources if the port could not be opened
+	if (port->handle <= 0)
+		closeVirtualPort(port);
+
+	// Release the claim on the port, after which an unopened port may be removed from the listing
+	pthread_mutex_lock(&serialPortsMutex);
+	jlong portPointer = (port->handle > 0) ? (jlong)(intptr_t)port : 0;
+	port->opening = 0;
+	pthread_mutex_unlock(&serialPortsMutex);
+
+	// Return a pointer to the serial port data structure
+	(*env)->ReleaseStringUTFChars(env, portNameJString, portName);
+	checkJniError(env, __LINE__ - 1);
+	return portPointer;
+}
+
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_configPort(JNIEnv *env, jobject obj, jlong serialPortPointer)
+{
+	// Retrieve port parameters from the Java class
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	baud_rate baudRate = (*env)->GetIntField(env, obj, baudRateField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	int byteSizeInt = (*env)->GetIntField(env, obj, dataBitsField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	int stopBitsInt = (*env)->GetIntField(env, obj, stopBitsField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	int parityInt = (*env)->GetIntField(env, obj, parityField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	int flowControl = (*env)->GetIntField(env, obj, flowControlField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	int sendDeviceQueueSize = (*env)->GetIntField(env, obj, sendDeviceQueueSizeField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	int receiveDeviceQueueSize = (*env)->GetIntField(env, obj, receiveDeviceQueueSizeField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	int rs485DelayBefore = (*env)->GetIntField(env, obj, rs485DelayBeforeField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	int rs485DelayAfter = (*env)->GetIntField(env, obj, rs485DelayAfterField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	unsigned char rs485SoftwareControl = (*env)->GetBooleanField(env, obj, rs485SoftwareControlField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	int timeoutMode = (*env)->GetIntField(env, obj, timeoutModeField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	int readTimeout = (*env)->GetIntField(env, obj, readTimeoutField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	int writeTimeout = (*env)->GetIntField(env, obj, writeTimeoutField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	int eventsToMonitor = (*env)->GetIntField(env, obj, eventFlagsField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	unsigned char rs485ModeEnabled = (*env)->GetBooleanField(env, obj, rs485ModeField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	unsigned char rs485ActiveHigh = (*env)->GetBooleanField(env, obj, rs485ActiveHighField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	unsigned char rs485EnableTermination = (*env)->GetBooleanField(env, obj, rs485EnableTerminationField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	unsigned char rs485RxDuringTx = (*env)->GetBooleanField(env, obj, rs485RxDuringTxField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	unsigned char isDtrEnabled = (*env)->GetBooleanField(env, obj, isDtrEnabledField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	unsigned char isRtsEnabled = (*env)->GetBooleanField(env, obj, isRtsEnabledField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	unsigned char lowLatencyMode = (*env)->GetBooleanField(env, obj, lowLatencyModeField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	char xonStartChar = (*env)->GetByteField(env, obj, xonStartCharField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	char xoffStopChar = (*env)->GetByteField(env, obj, xoffStopCharField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+
+	// Clear any serial port flags and set up raw non-canonical port parameters
+	struct termios options = { 0 };
+	tcgetattr(port->handle, &options);
+	options.c_cc[VSTART] = (unsigned char)xonStartChar;
+	options.c_cc[VSTOP] = (unsigned char)xoffStopChar;
+	options.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | INPCK | IGNPAR | IGNCR | ICRNL | IXON | IXOFF);
+	options.c_oflag &= ~OPOST;
+	options.c_lflag &= ~(ECHO | ECHONL | ICANON | ISIG | IEXTEN);
+	options.c_cflag &= ~(CSIZE | PARENB | CMSPAR | PARODD | CSTOPB | CRTSCTS);
+
+	// Update the user-specified port parameters
+	tcflag_t byteSize = (byteSizeInt == 5) ? CS5 : (byteSizeInt == 6) ? CS6 : (byteSizeInt == 7) ? CS7 : CS8;
+	tcflag_t parity = (parityInt == com_fazecast_jSerialComm_SerialPort_NO_PARITY) ? 0 : (parityInt == com_fazecast_jSerialComm_SerialPort_ODD_PARITY) ? (PARENB | PARODD) : (parityInt == com_fazecast_jSerialComm_SerialPort_EVEN_PARITY) ? PARENB : (parityInt == com_fazecast_jSerialComm_SerialPort_MARK_PARITY) ? (PARENB | CMSPAR | PARODD) : (PARENB | CMSPAR);
+	options.c_cflag |= (byteSize | parity | CLOCAL | CREAD);
+	if (!isDtrEnabled || !isRtsEnabled)
+		options.c_cflag &= ~HUPCL;
+	if (!rs485ModeEnabled)
+		options.c_iflag |= BRKINT;
+	if (stopBitsInt == com_fazecast_jSerialComm_SerialPort_TWO_STOP_BITS)
+		options.c_cflag |= CSTOPB;
+	if (((flowControl & com_fazecast_jSerialComm_SerialPort_FLOW_CONTROL_CTS_ENABLED) > 0) || ((flowControl & com_fazecast_jSerialComm_SerialPort_FLOW_CONTROL_RTS_ENABLED) > 0))
+		options.c_cflag |= CRTSCTS;
+	if (byteSizeInt < 8)
+		options.c_iflag |= ISTRIP;
+	if (parityInt != 0)
+		options.c_iflag |= (INPCK | IGNPAR);
+	if ((flowControl & com_fazecast_jSerialComm_SerialPort_FLOW_CONTROL_XONXOFF_IN_ENABLED) > 0)
+		options.c_iflag |= IXOFF;
+	if ((flowControl & com_fazecast_jSerialComm_SerialPort_FLOW_CONTROL_XONXOFF_OUT_ENABLED) > 0)
+		options.c_iflag |= IXON;
+
+	// Set the baud rate and apply all changes
+	baud_rate baudRateCode = getBaudRateCode(baudRate);
+	if (!baudRateCode)
+		baudRateCode = B38400;
+	cfsetispeed(&options, baudRateCode);
+	cfsetospeed(&options, baudRateCode);
+	if (tcsetattr(port->handle, TCSANOW, &options) || tcsetattr(port->handle, TCSANOW, &options))
+	{
+		port->errorLineNumber = lastErrorLineNumber = __LINE__ - 2;
+		port->errorNumber = lastErrorNumber = errno;
+		return JNI_FALSE;
+	}
+
+#if defined(__linux__)
+
+	// Attempt to set the transmit buffer size, closing wait time, and latency flags
+	struct serial_struct serInfo = { 0 };
+	if (!ioctl(port->handle, TIOCGSERIAL, &serInfo))
+	{
+		serInfo.closing_wait = 250;
+		serInfo.xmit_fifo_size = sendDeviceQueueSize;
+		if (lowLatencyMode)
+			serInfo.flags |= ASYNC_LOW_LATENCY;
+		else
+			serInfo.flags &= ~ASYNC_LOW_LATENCY;
+		ioctl(port->handle, TIOCSSERIAL, &serInfo);
+	}
+
+	// Retrieve the driver-reported transmit buffer size
+	if (!ioctl(port->handle, TIOCGSERIAL, &serInfo))
+		sendDeviceQueueSize = serInfo.xmit_fifo_size;
+	receiveDeviceQueueSize = sendDeviceQueueSize;
+	(*env)->SetIntField(env, obj, sendDeviceQueueSizeField, sendDeviceQueueSize);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	(*env)->SetIntField(env, obj, receiveDeviceQueueSizeField, receiveDeviceQueueSize);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+
+	// Attempt to set the requested RS-485 mode
+	struct serial_rs485 rs485Conf = { 0 };
+	if (!ioctl(port->handle, TIOCGRS485, &rs485Conf))
+	{
+		if (rs485ModeEnabled && !rs485SoftwareControl)
+			rs485Conf.flags |= SER_RS485_ENABLED;
+		else
+			rs485Conf.flags &= ~SER_RS485_ENABLED;
+		if (rs485ActiveHigh)
+		{
+			rs485Conf.flags |= SER_RS485_RTS_ON_SEND;
+			rs485Conf.flags &= ~(SER_RS485_RTS_AFTER_SEND);
+		}
+		else
+		{
+			rs485Conf.flags &= ~(SER_RS485_RTS_ON_SEND);
+			rs485Conf.flags |= SER_RS485_RTS_AFTER_SEND;
+		}
+		if (rs485RxDuringTx)
+			rs485Conf.flags |= SER_RS485_RX_DURING_TX;
+		else
+			rs485Conf.flags &= ~(SER_RS485_RX_DURING_TX);
+		if (rs485EnableTermination)
+			rs485Conf.flags |= SER_RS485_TERMINATE_BUS;
+		else
+			rs485Conf.flags &= ~(SER_RS485_TERMINATE_BUS);
+		rs485Conf.delay_rts_before_send = rs485DelayBefore / 1000;
+		rs485Conf.delay_rts_after_send = rs485DelayAfter / 1000;
+		ioctl(port->handle, TIOCSRS485, &rs485Conf);
+	}
+
+#else
+
+	(*env)->SetIntField(env, obj, sendDeviceQueueSizeField, sysconf(_SC_PAGESIZE));
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	(*env)->SetIntField(env, obj, receiveDeviceQueueSizeField, sysconf(_SC_PAGESIZE));
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+
+#endif
+
+	// Set up software RS-485 direction control for physical ports and leave the bus in receive mode
+	pthread_mutex_lock(&port->rs485Mutex);
+	port->rs485SoftwareControl = rs485ModeEnabled && rs485SoftwareControl && (port->virtualDevice < 0);
+	port->rs485ActiveHigh = rs485ActiveHigh;
+	port->rs485RxDuringTx = rs485RxDuringTx;
+	port->rs485DelayBeforeNS = (rs485DelayBefore > 0) ? (rs485DelayBefore * 1000LL) : 0;
+	port->rs485DelayAfterNS = (rs485DelayAfter > 0) ? (rs485DelayAfter * 1000LL) : 0;
+	setCharacterTime(port, baudRate, byteSizeInt, stopBitsInt, parityInt);
+#if defined(__linux__)
+	unsigned int lineStatus;
+	port->rs485LineStatusSupported = !ioctl(port->handle, TIOCSERGETLSR, &lineStatus);
+#endif
+	if (port->rs485SoftwareControl)
+		setRs485Transmitting(port, 0);
+	pthread_mutex_unlock(&port->rs485Mutex);
+
+	// Configure the serial port read and write timeouts
+	return Java_com_fazecast_jSerialComm_SerialPort_configTimeouts(env, obj, serialPortPointer, timeoutMode, readTimeout, writeTimeout, eventsToMonitor);
+}
+
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_configTimeouts(JNIEnv *env, jobject obj, jlong serialPortPointer, jint timeoutMode, jint readTimeout, jint writeTimeout, jint eventsToMonitor)
+{
+	// Retrieve the existing port configuration
+	struct termios options = { 0 };
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	baud_rate baudRate = (*env)->GetIntField(env, obj, baudRateField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	int interByteTimeout = (*env)->GetIntField(env, obj, interByteTimeoutField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	tcgetattr(port->handle, &options);
+
+	// Set up the requested event flags and remember the write timeout for writes that must wait
+	port->eventsMask = eventsToMonitor;
+	port->writeTimeout = writeTimeout;
+
+	// All read timeouts are handled by the poll()-based read engine, so the port always remains non-blocking
+	int flags = O_NONBLOCK;
+	port->interByteTimeout = interByteTimeout;
+	options.c_cc[VMIN] = 0;
+	options.c_cc[VTIME] = 0;
+
+	// Apply changes
+	if (fcntl(port->handle, F_SETFL, flags))
+	{
+		port->errorLineNumber = lastErrorLineNumber = __LINE__ - 2;
+		port->errorNumber = lastErrorNumber = errno;
+		return JNI_FALSE;
+	}
+	if (tcsetattr(port->handle, TCSANOW, &options) || tcsetattr(port->handle, TCSANOW, &options))
+	{
+		port->errorLineNumber = lastErrorLineNumber = __LINE__ - 2;
+		port->errorNumber = lastErrorNumber = errno;
+		return JNI_FALSE;
+	}
+	if (!getBaudRateCode(baudRate) && setBaudRateCustom(port->handle, baudRate))
+	{
+		port->errorLineNumber = lastErrorLineNumber = __LINE__ - 2;
+		port->errorNumber = lastErrorNumber = errno;
+		return JNI_FALSE;
+	}
+	return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_setFrameParameters(JNIEnv *env, jobject obj, jlong serialPortPointer, jint baudRate, jint byteSizeInt, jint stopBitsInt, jint parityInt)
+{
+	// Retrieve the existing port configuration
+	struct termios options = { 0 };
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	if (tcgetattr(port->handle, &options))
+	{
+		port->errorLineNumber = lastErrorLineNumber = __LINE__ - 2;
+		port->errorNumber = lastErrorNumber = errno;
+		return JNI_FALSE;
+	}
+
+	// Update only the word framing parameters, leaving all other settings intact
+	tcflag_t byteSize = (byteSizeInt == 5) ? CS5 : (byteSizeInt == 6) ? CS6 : (byteSizeInt == 7) ? CS7 : CS8;
+	tcflag_t parity = (parityInt == com_fazecast_jSerialComm_SerialPort_NO_PARITY) ? 0 : (parityInt == com_fazecast_jSerialComm_SerialPort_ODD_PARITY) ? (PARENB | PARODD) : (parityInt == com_fazecast_jSerialComm_SerialPort_EVEN_PARITY) ? PARENB : (parityInt == com_fazecast_jSerialComm_SerialPort_MARK_PARITY) ? (PARENB | CMSPAR | PARODD) : (PARENB | CMSPAR);
+	options.c_cflag &= ~(CSIZE | PARENB | CMSPAR | PARODD | CSTOPB);
+	options.c_iflag &= ~(ISTRIP | INPCK | IGNPAR);
+	options.c_cflag |= (byteSize | parity);
+	if (stopBitsInt == com_fazecast_jSerialComm_SerialPort_TWO_STOP_BITS)
+		options.c_cflag |= CSTOPB;
+	if (byteSizeInt < 8)
+		options.c_iflag |= ISTRIP;
+	if (parityInt != 0)
+		options.c_iflag |= (INPCK | IGNPAR);
+
+	// Apply the framing parameters together with the new baud rate in as few driver updates as possible
+	baud_rate baudRateCode = getBaudRateCode(baudRate);
+#if defined(__linux__)
+	if (!baudRateCode)
+	{
+		port->errorLineNumber = lastErrorLineNumber = __LINE__ + 1;
+		if (setTermiosFlagsCustomBaudRate(port->handle, baudRate, options.c_iflag, options.c_cflag))
+		{
+			port->errorNumber = lastErrorNumber = errno;
+			return JNI_FALSE;
+		}
+		setCharacterTime(port, baudRate, byteSizeInt, stopBitsInt, parityInt);
+		return JNI_TRUE;
+	}
+#endif
+	cfsetispeed(&options, baudRateCode ? baudRateCode : B38400);
+	cfsetospeed(&options, baudRateCode ? baudRateCode : B38400);
+	if (tcsetattr(port->handle, TCSANOW, &options))
+	{
+		port->errorLineNumber = lastErrorLineNumber = __LINE__ - 2;
+		port->errorNumber = lastErrorNumber = errno;
+		return JNI_FALSE;
+	}
+	if (!baudRateCode && setBaudRateCustom(port->handle, baudRate))
+	{
+		port->errorLineNumber = lastErrorLineNumber = __LINE__ - 2;
+		port->errorNumber = lastErrorNumber = errno;
+		return JNI_FALSE;
+	}
+	setCharacterTime(port, baudRate, byteSizeInt, stopBitsInt, parityInt);
+	return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_flushRxTxBuffers(JNIEnv *env, jobject obj, jlong serialPortPointer)
+{
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	if (tcflush(port->handle, TCIOFLUSH))
+	{
+		port->errorLineNumber = __LINE__ - 2;
+		port->errorNumber = errno;
+		return JNI_FALSE;
+	}
+
+	// Discard any data already drained into the background ring buffer
+	if (port->ringBufferEnabled)
+		discardRingBuffer(port);
+	return JNI_TRUE;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_waitForEvent(JNIEnv *env, jobject obj, jlong serialPortPointer)
+{
+	// Initialize local variables
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	jint event = com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_TIMED_OUT;
+
+	// Wait for events differently based on the use of threads
+	if (port->eventListenerUsesThreads || port->ringReaderRunning)
+	{
+		pthread_mutex_lock(&port->eventMutex);
+		if ((port->event & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_AVAILABLE) && !Java_com_fazecast_jSerialComm_SerialPort_bytesAvailable(env, obj, serialPortPointer))
+			port->event &= ~com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_AVAILABLE;
+		if (port->event)
+		{
+			event = port->event;
+			port->event = 0;
+			port->eventTimestampNS = port->pendingEventTimestampNS;
+		}
+		else if (port->eventListenerRunning)
+		{
+			struct timespec timeoutTime;
+			clock_gettime(CLOCK_MONOTONIC, &timeoutTime);
+			timeoutTime.tv_sec += 1;
+			pthread_cond_timedwait(&port->eventReceived, &port->eventMutex, &timeoutTime);
+			if (port->event)
+			{
+				event = port->event;
+				port->event = 0;
+				port->eventTimestampNS = port->pendingEventTimestampNS;
+			}
+		}
+		port->pendingEventTimestampNS = port->event ? port->pendingEventTimestampNS : 0;
+		pthread_mutex_unlock(&port->eventMutex);
+	}
+	else
+	{
+		// Initialize the local variables
+		int pollResult;
+		short pollEventsMask = ((port->eventsMask & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_AVAILABLE) || (port->eventsMask & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_RECEIVED)) ? (POLLIN | POLLERR) : POLLERR;
+		struct pollfd waitingSet[2] = { { port->handle, pollEventsMask, 0 }, { port->listenerWakePipe[0], POLLIN, 0 } };
+#if defined(__linux__)
+		struct serial_icounter_struct oldSerialLineInterrupts, newSerialLineInterrupts;
+		ioctl(port->handle, TIOCGICOUNT, &oldSerialLineInterrupts);
+#endif // #if defined(__linux__)
+
+		// Wait for a serial port event or for the listener to be stopped
+		do
+		{
+			waitingSet[0].revents = waitingSet[1].revents = 0;
+			pollResult = poll(waitingSet, 2, 500);
+		}
+		while ((pollResult == 0) && port->eventListenerRunning);
+		if (waitingSet[1].revents)
+			return event;
+		if (pollResult > 0)
+			port->eventTimestampNS = getMonotonicTimeNS();
+
+		// Return the detected port events
+		if (waitingSet[0].revents & POLLHUP)
+			event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_PORT_DISCONNECTED;
+		else if (waitingSet[0].revents & POLLIN)
+			event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_AVAILABLE;
+#if defined(__linux__)
+		if (waitingSet[0].revents & POLLERR)
+			if (!ioctl(port->handle, TIOCGICOUNT, &newSerialLineInterrupts))
+			{
+				if (oldSerialLineInterrupts.frame != newSerialLineInterrupts.frame)
+					event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_FRAMING_ERROR;
+				if (oldSerialLineInterrupts.brk != newSerialLineInterrupts.brk)
+					event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_BREAK_INTERRUPT;
+				if (oldSerialLineInterrupts.overrun != newSerialLineInterrupts.overrun)
+					event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_FIRMWARE_OVERRUN_ERROR;
+				if (oldSerialLineInterrupts.parity != newSerialLineInterrupts.parity)
+					event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_PARITY_ERROR;
+				if (oldSerialLineInterrupts.buf_overrun != newSerialLineInterrupts.buf_overrun)
+					event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_SOFTWARE_OVERRUN_ERROR;
+			}
+#endif // #if defined(__linux__)
+	}
+	return event;
+}
+
+JNIEXPORT jlong JNICALL Java_com_fazecast_jSerialComm_SerialPort_closePortNative(JNIEnv *env, jobject obj, jlong serialPortPointer, jboolean immediate)
+{
+	// Stop any background writer, first writing out any data that is still queued unless closing immediately
+	struct termios options = { 0 };
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	if (immediate)
+		signalWakePipe(port->closingPipe);
+	stopTxWriter(port, immediate);
+
+	// Release every thread still waiting on the port and stop the background reader before it loses access to the port
+	signalWakePipe(port->closingPipe);
+	stopRingReader(port);
+	stopRecording(port);
+
+	// Force the port to enter non-blocking mode to ensure that any current reads return
+	tcgetattr(port->handle, &options);
+	options.c_cc[VMIN] = 0;
+	options.c_cc[VTIME] = 0;
+	fcntl(port->handle, F_SETFL, O_NONBLOCK);
+	tcsetattr(port->handle, TCSANOW, &options);
+
+	// Unblock, unlock, and close the port, discarding any data still waiting for flow control if closing immediately
+	if (!immediate)
+	{
+		fsync(port->handle);
+		tcdrain(port->handle);
+	}
+	tcflush(port->handle, TCIOFLUSH);
+	flock(port->handle, LOCK_UN | LOCK_NB);
+	port->rs485SoftwareControl = 0;
+	while (close(port->handle) && (errno == EINTR))
+		errno = 0;
+	closeVirtualPort(port);
+
+	// Ensure that user-specified or unplugged ports are dropped from the next port listing
+	pthread_mutex_lock(&serialPortsMutex);
+	port->handle = -1;
+	portsEnumerated = 0;
+	pthread_mutex_unlock(&serialPortsMutex);
+	return 0;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_bytesAvailable(JNIEnv *env, jobject obj, jlong serialPortPointer)
+{
+	// Retrieve bytes available to read from the background ring buffer or the device
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	if (port->ringBufferEnabled)
+		return (jint)(__atomic_load_n(&port->ringHead, __ATOMIC_ACQUIRE) - peekRingTail(port));
+	int numBytesAvailable = -1;
+	port->errorLineNumber = __LINE__ + 1;
+	ioctl(port->handle, FIONREAD, &numBytesAvailable);
+	port->errorNumber = errno;
+	return numBytesAvailable;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_bytesAwaitingWrite(JNIEnv *env, jobject obj, jlong serialPortPointer)
+{
+	// Retrieve bytes awaiting write
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	int numBytesToWrite = -1;
+	port->errorLineNumber = __LINE__ + 1;
+	ioctl(port->handle, TIOCOUTQ, &numBytesToWrite);
+	port->errorNumber = errno;
+
+	// Include any data still waiting in the background transmit queue
+	if ((numBytesToWrite >= 0) && port->txQueueEnabled)
+	{
+		pthread_mutex_lock(&port->txMutex);
+		numBytesToWrite += (int)(port->txHead - port->txTail);
+		pthread_mutex_unlock(&port->txMutex);
+	}
+	return numBytesToWrite;
+}
+
+// Background ring buffer consuming function
+static int readFromRing(serialPort *port, char *readBuffer, int bytesToRead, int timeoutMode, int readTimeout)
+{
+	// Determine whether to wait for all requested bytes, any bytes, or none at all
+	struct timespec deadline;
+	int numBytesReadTotal = 0, timedOut = 0;
+	int waitForAll = ((timeoutMode & com_fazecast_jSerialComm_SerialPort_TIMEOUT_READ_BLOCKING) > 0);
+	int waitForAny = waitForAll || ((timeoutMode & (com_fazecast_jSerialComm_SerialPort_TIMEOUT_READ_SEMI_BLOCKING | com_fazecast_jSerialComm_SerialPort_TIMEOUT_SCANNER)) > 0);
+	if (readTimeout > 0)
+		getConditionDeadline(&deadline, readTimeout);
+
+	// Copy data out of the ring buffer until the current timeout mode is satisfied
+	while ((numBytesReadTotal < bytesToRead) && !timedOut)
+	{
+		unsigned int tail = consumeRingDiscard(port);
+		unsigned int numBytesAvailable = __atomic_load_n(&port->ringHead, __ATOMIC_ACQUIRE) - tail;
+		if (numBytesAvailable)
+		{
+			unsigned int numBytesToCopy = (unsigned int)(bytesToRead - numBytesReadTotal), offset = tail & (port->ringBufferLength - 1);
+			if (numBytesToCopy > numBytesAvailable)
+				numBytesToCopy = numBytesAvailable;
+			unsigned int firstSegment = (numBytesToCopy > (port->ringBufferLength - offset)) ? (port->ringBufferLength - offset) : numBytesToCopy;
+			if (!numBytesReadTotal)
+				port->readTimestampNS = __atomic_load_n(&port->ringTimestampNS, __ATOMIC_RELAXED);
+			memcpy(readBuffer + numBytesReadTotal, port->ringBuffer + offset, firstSegment);
+			memcpy(readBuffer + numBytesReadTotal + firstSegment, port->ringBuffer, numBytesToCopy - firstSegment);
+			advanceRingTail(port, tail + numBytesToCopy);
+			numBytesReadTotal += numBytesToCopy;
+			if (!waitForAll)
+				break;
+		}
+		else if (!waitForAny || !port->ringReaderRunning)
+			break;
+		else
+		{
+			// Announce that we are waiting before re-checking so that the reader cannot miss the wakeup
+			pthread_mutex_lock(&port->eventMutex);
+			__atomic_fetch_add(&port->ringReaderWaiting, 1, __ATOMIC_SEQ_CST);
+			if ((__atomic_load_n(&port->ringHead, __ATOMIC_SEQ_CST) == tail) && port->ringReaderRunning)
+			{
+				if (readTimeout > 0)
+				{
+					timedOut = (pthread_cond_timedwait(&port->ringDataReceived, &port->eventMutex, &deadline) == ETIMEDOUT);
+					if (timedOut)
+						addStatistic(&port->statistics.readTimeouts, 1);
+				}
+				else
+					pthread_cond_wait(&port->ringDataReceived, &port->eventMutex);
+			}
+			__atomic_fetch_sub(&port->ringReaderWaiting, 1, __ATOMIC_SEQ_CST);
+			pthread_mutex_unlock(&port->eventMutex);
+		}
+	}
+
+	// Report an error only if the reader stopped due to a device problem and no data remains
+	if (!numBytesReadTotal && (bytesToRead > 0) && !port->ringReaderRunning)
+	{
+		port->errorLineNumber = __LINE__ - 2;
+		port->errorNumber = EIO;
+		return -1;
+	}
+	return numBytesReadTotal;
+}
+
+// Waits for space in the driver's transmit buffer after a write would have blocked, returning 0 if the deadline expires first
+static inline int waitForWritable(serialPort *port, long long deadlineNS)
+{
+	addStatistic(&port->statistics.writeRetries, 1);
+	return waitForPortReady(port, POLLOUT, deadlineNS);
+}
+
+// Waits for all transmitted data to drain from the driver until the specified monotonic deadline (or forever if negative)
+static int drainPort(serialPort *port, long long deadlineNS)
+{
+	int drained = 1;
+	long long startTimeNS = getMonotonicTimeNS();
+#if defined(TIOCOUTQ)
+	int numBytesQueued = 0;
+	if (deadlineNS >= 0)
+	{
+		// Sleep for roughly the time needed to transmit whatever is still queued, never past the deadline
+		while (!ioctl(port->handle, TIOCOUTQ, &numBytesQueued) && (numBytesQueued > 0) && (drained = (getMonotonicTimeNS() < deadlineNS)))
+		{
+			long long wakeTimeNS = getMonotonicTimeNS() + ((port->characterTimeNS * numBytesQueued > TRANSMITTER_POLL_INTERVAL_NS) ? (port->characterTimeNS * numBytesQueued) : TRANSMITTER_POLL_INTERVAL_NS);
+			sleepUntil((wakeTimeNS < deadlineNS) ? wakeTimeNS : deadlineNS);
+		}
+	}
+	else
+#endif
+		tcdrain(port->handle);
+	addStatistic(&port->statistics.drainTimeNS, getMonotonicTimeNS() - startTimeNS);
+	return drained;
+}
+
+// Direct device reading function
+static int readFromDevice(serialPort *port, char *readBuffer, int bytesToRead, int timeoutMode, int readTimeout)
+{
+	// Determine whether to wait for all requested bytes, any bytes, or none at all
+	int isScanner = ((timeoutMode & (com_fazecast_jSerialComm_SerialPort_TIMEOUT_READ_BLOCKING | com_fazecast_jSerialComm_SerialPort_TIMEOUT_READ_SEMI_BLOCKING)) == 0) && ((timeoutMode & com_fazecast_jSerialComm_SerialPort_TIMEOUT_SCANNER) > 0);
+	int waitForAll = ((timeoutMode & com_fazecast_jSerialComm_SerialPort_TIMEOUT_READ_BLOCKING) > 0);
+	int waitForAny = waitForAll || isScanner || ((timeoutMode & com_fazecast_jSerialComm_SerialPort_TIMEOUT_READ_SEMI_BLOCKING) > 0);
+	int interByteTimeout = waitForAll ? 0 : (isScanner ? 100 : port->interByteTimeout);
+	long long deadlineNS = (waitForAny && !isScanner && (readTimeout > 0)) ? (getMonotonicTimeNS() + (readTimeout * 1000000LL)) : -1;
+
+	// Keep reading whatever is available until the current timeout mode is satisfied
+	int numBytesRead, numBytesReadTotal = 0, ioctlResult = 0;
+	while (numBytesReadTotal < bytesToRead)
+	{
+		port->errorLineNumber = __LINE__ + 1;
+		do { errno = 0; numBytesRead = read(port->handle, readBuffer + numBytesReadTotal, bytesToRead - numBytesReadTotal); port->errorNumber = errno; addStatistic(&port->statistics.readSyscalls, 1); } while ((numBytesRead < 0) && (errno == EINTR));
+		if (((numBytesRead < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK)) || ((numBytesRead == 0) && (ioctl(port->handle, FIONREAD, &ioctlResult) == -1)))
+		{
+			// An incomplete infinitely blocking read is always an error, otherwise return any bytes that were read
+			numBytesRead = -1;
+			break;
+		}
+		if (numBytesRead > 0)
+		{
+			if (!numBytesReadTotal)
+				port->readTimestampNS = getMonotonicTimeNS();
+			recordTraffic(port, RECORDING_DIRECTION_RECEIVED, numBytesReadTotal ? 0 : port->readTimestampNS, readBuffer + numBytesReadTotal, numBytesRead);
+			numBytesReadTotal += numBytesRead;
+		}
+		else
+			numBytesRead = 0;
+		if (!waitForAny || (numBytesReadTotal >= bytesToRead) || (numBytesReadTotal && !waitForAll && !interByteTimeout))
+			break;
+
+		// Wait for more data, limiting the wait to the inter-byte timeout once the first byte has arrived
+		long long waitDeadlineNS = deadlineNS;
+		if (numBytesReadTotal && interByteTimeout)
+		{
+			long long gapDeadlineNS = getMonotonicTimeNS() + (interByteTimeout * 1000000LL);
+			if ((waitDeadlineNS < 0) || (gapDeadlineNS < waitDeadlineNS))
+				waitDeadlineNS = gapDeadlineNS;
+		}
+		int waitResult = waitForPortReady(port, POLLIN, waitDeadlineNS);
+		if (waitResult < 0)
+			numBytesRead = -1;
+		else if ((waitResult == 0) && (waitDeadlineNS == deadlineNS))
+			addStatistic(&port->statistics.readTimeouts, 1);
+		if (waitResult <= 0)
+			break;
+	}
+
+	// Return number of bytes read if successful
+	if ((numBytesRead == -1) && (!numBytesReadTotal || (waitForAll && (readTimeout <= 0))))
+		return -1;
+	return numBytesReadTotal;
+}
+
+// Generalized port reading function
+static int readFromPort(serialPort *port, char *readBuffer, int bytesToRead, int timeoutMode, int readTimeout)
+{
+	// Serve all reads from the background ring buffer if it is enabled
+	long long startTimeNS = getMonotonicTimeNS();
+	int numBytesRead = port->ringBufferEnabled ? readFromRing(port, readBuffer, bytesToRead, timeoutMode, readTimeout) : readFromDevice(port, readBuffer, bytesToRead, timeoutMode, readTimeout);
+
+	// Update the port statistics
+	addStatistic(&port->statistics.readCalls, 1);
+	if (numBytesRead >= 0)
+		addStatistic(&port->statistics.bytesRead, numBytesRead);
+	if ((numBytesRead >= 0) && (numBytesRead < bytesToRead))
+		addStatistic(&port->statistics.shortReads, 1);
+	recordLatency(port->statistics.readLatency, startTimeNS);
+	return numBytesRead;
+}
+
+// Intermediate read buffer allocation function
+static int reserveReadBuffer(serialPort *port, int bytesToRead)
+{
+	if (bytesToRead > port->readBufferLength)
+	{
+		port->errorLineNumber = __LINE__ + 1;
+		char *newMemory = (char*)realloc(port->readBuffer, bytesToRead);
+		if (!newMemory)
+		{
+			port->errorNumber = errno;
+			return 0;
+		}
+		port->readBuffer = newMemory;
+		port->readBufferLength = bytesToRead;
+	}
+	return 1;
+}
+
+// Background transmit queue writing function
+static int writeToQueue(serialPort *port, const char *writeBuffer, int bytesToWrite, long long deadlineNS)
+{
+	// Copy as much data as possible into the transmit queue, waiting until the deadline for space to become available if backpressure is enabled
+	struct timespec deadline;
+	int numBytesQueued = 0;
+	if (deadlineNS >= 0)
+	{
+		long long remainingNS = deadlineNS - getMonotonicTimeNS();
+		getConditionDeadline(&deadline, (remainingNS > 0) ? (int)((remainingNS + 999999LL) / 1000000LL) : 0);
+	}
+	pthread_mutex_lock(&port->txMutex);
+	while ((numBytesQueued < bytesToWrite) && port->txWriterRunning && !port->txFailed)
+	{
+		unsigned int freeSpace = port->txBufferLength - (port->txHead - port->txTail);
+		if (!freeSpace)
+		{
+			if (!port->txBlockWhenFull)
+				break;
+			if (deadlineNS < 0)
+				pthread_cond_wait(&port->txSpaceAvailable, &port->txMutex);
+			else if (pthread_cond_timedwait(&port->txSpaceAvailable, &port->txMutex, &deadline) == ETIMEDOUT)
+				break;
+			continue;
+		}
+		unsigned int offset = port->txHead & (port->txBufferLength - 1), numBytesToCopy = port->txBufferLength - offset;
+		if (numBytesToCopy > freeSpace)
+			numBytesToCopy = freeSpace;
+		if (numBytesToCopy > (unsigned int)(bytesToWrite - numBytesQueued))
+			numBytesToCopy = bytesToWrite - numBytesQueued;
+		memcpy(port->txBuffer + offset, writeBuffer + numBytesQueued, numBytesToCopy);
+		port->txHead += numBytesToCopy;
+		numBytesQueued += numBytesToCopy;
+		pthread_cond_signal(&port->txDataQueued);
+	}
+
+	// Report any failure of the background writer that prevented data from being queued
+	if (!numBytesQueued && port->txFailed)
+		numBytesQueued = -1;
+	pthread_mutex_unlock(&port->txMutex);
+	return numBytesQueued;
+}
+
+// Generalized port writing function
+static int writeToPort(serialPort *port, const char *writeBuffer, int bytesToWrite, int timeoutMode, long long deadlineNS)
+{
+	// Hand the data over to the background writer if the transmit queue is enabled
+	long long startTimeNS = getMonotonicTimeNS();
+	int numBytesWritten = 0, result, waitResult = 1;
+	if (port->txQueueEnabled)
+		numBytesWritten = writeToQueue(port, writeBuffer, bytesToWrite, deadlineNS);
+	else
+	{
+		// Write to the port, waiting until the deadline for space in the driver's transmit buffer and writing everything in write-blocking mode
+		int writeAll = ((timeoutMode & com_fazecast_jSerialComm_SerialPort_TIMEOUT_WRITE_BLOCKING) > 0);
+		int rs485SoftwareControl = port->rs485SoftwareControl;
+		long long rs485StartTimeNS = rs485SoftwareControl ? beginRs485Transmission(port) : 0;
+		do {
+			do {
+				errno = 0;
+				port->errorLineNumber = __LINE__ + 1;
+				result = write(port->handle, writeBuffer + numBytesWritten, bytesToWrite - numBytesWritten);
+				port->errorNumber = errno;
+				addStatistic(&port->statistics.writeSyscalls, 1);
+			} while ((result < 0) && ((errno == EINTR) || (((errno == EAGAIN) || (errno == EWOULDBLOCK)) && ((waitResult = waitForWritable(port, deadlineNS)) > 0))));
+			if (result > 0)
+			{
+				recordTraffic(port, RECORDING_DIRECTION_TRANSMITTED, 0, writeBuffer + numBytesWritten, result);
+				numBytesWritten += result;
+			}
+			else if (!waitResult)
+				result = 0;
+		} while (writeAll && (result > 0) && (numBytesWritten < bytesToWrite));
+		if (rs485SoftwareControl)
+			endRs485Transmission(port, rs485StartTimeNS, numBytesWritten, deadlineNS);
+		if ((result < 0) && !numBytesWritten)
+			numBytesWritten = -1;
+
+		// Wait until all bytes were written in write-blocking mode
+		if (writeAll && (numBytesWritten > 0))
+			drainPort(port, deadlineNS);
+	}
+
+	// Update the port statistics
+	addStatistic(&port->statistics.writeCalls, 1);
+	if (numBytesWritten > 0)
+		addStatistic(&port->statistics.bytesWritten, numBytesWritten);
+	recordLatency(port->statistics.writeLatency, startTimeNS);
+	return numBytesWritten;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_readBytes(JNIEnv *env, jobject obj, jlong serialPortPointer, jbyteArray buffer, jlong bytesToRead, jlong offset, jint timeoutMode, jint readTimeout)
+{
+	// Ensure that the allocated read buffer is large enough
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	if (!reserveReadBuffer(port, bytesToRead))
+		return -1;
+
+	// Read from the port and return number of bytes read if successful
+	int numBytesRead = readFromPort(port, port->readBuffer, bytesToRead, timeoutMode, readTimeout);
+	if (numBytesRead > 0)
+	{
+		(*env)->SetByteArrayRegion(env, buffer, offset, numBytesRead, (jbyte*)port->readBuffer);
+		checkJniError(env, __LINE__ - 1);
+	}
+	return numBytesRead;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_readBytesTimestamped(JNIEnv *env, jobject obj, jlong serialPortPointer, jbyteArray buffer, jlong bytesToRead, jlong offset, jint timeoutMode, jint readTimeout, jlongArray receiveTimestamp)
+{
+	// Ensure that the allocated read buffer is large enough
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	if (!reserveReadBuffer(port, bytesToRead))
+		return -1;
+
+	// Read from the port and capture the arrival time of the returned data before any other read can replace it
+	int numBytesRead = readFromPort(port, port->readBuffer, bytesToRead, timeoutMode, readTimeout);
+	if (numBytesRead > 0)
+	{
+		jlong timestampNS = (jlong)port->readTimestampNS;
+		(*env)->SetByteArrayRegion(env, buffer, offset, numBytesRead, (jbyte*)port->readBuffer);
+		if (checkJniError(env, __LINE__ - 1)) return -1;
+		(*env)->SetLongArrayRegion(env, receiveTimestamp, 0, 1, &timestampNS);
+		if (checkJniError(env, __LINE__ - 1)) return -1;
+	}
+	return numBytesRead;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_readBytesDirect(JNIEnv *env, jobject obj, jlong serialPortPointer, jobject buffer, jlong bytesToRead, jlong offset, jint timeoutMode, jint readTimeout)
+{
+	// Retrieve the native memory address backing the direct buffer
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	char *readBuffer = (char*)(*env)->GetDirectBufferAddress(env, buffer);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	if (!readBuffer)
+	{
+		port->errorLineNumber = __LINE__ - 4;
+		port->errorNumber = EINVAL;
+		return -1;
+	}
+
+	// Read from the port directly into the buffer memory
+	return readFromPort(port, readBuffer + offset, bytesToRead, timeoutMode, readTimeout);
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_readBytesAhead(JNIEnv *env, jobject obj, jlong serialPortPointer, jbyteArray buffer, jlong bufferSize, jint timeoutMode, jint readTimeout)
+{
+	// Ensure that the allocated read buffer is large enough
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	if (!reserveReadBuffer(port, bufferSize))
+		return -1;
+
+	// Wait for the first byte according to the current timeout mode, then collect any data that has already arrived without waiting
+	int numBytesRead = readFromPort(port, port->readBuffer, 1, timeoutMode, readTimeout);
+	if ((numBytesRead > 0) && (bufferSize > 1))
+	{
+		long long firstByteTimestampNS = port->readTimestampNS;
+		int numAdditionalBytesRead = readFromPort(port, port->readBuffer + 1, bufferSize - 1, com_fazecast_jSerialComm_SerialPort_TIMEOUT_NONBLOCKING, 0);
+		if (numAdditionalBytesRead > 0)
+			numBytesRead += numAdditionalBytesRead;
+		port->readTimestampNS = firstByteTimestampNS;
+	}
+
+	// Return the data and number of bytes read if successful
+	if (numBytesRead > 0)
+	{
+		(*env)->SetByteArrayRegion(env, buffer, 0, numBytesRead, (jbyte*)port->readBuffer);
+		checkJniError(env, __LINE__ - 1);
+	}
+	return numBytesRead;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_writeBytes(JNIEnv *env, jobject obj, jlong serialPortPointer, jbyteArray buffer, jlong bytesToWrite, jlong offset, jint timeoutMode)
+{
+	// Retrieve port parameters from the Java class
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	jbyte *writeBuffer = (*env)->GetByteArrayElements(env, buffer, 0);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+
+	// Write to the port and return the number of bytes written if successful
+	int numBytesWritten = writeToPort(port, (const char*)(writeBuffer + offset), bytesToWrite, timeoutMode, getWriteDeadline(port, getMonotonicTimeNS()));
+	(*env)->ReleaseByteArrayElements(env, buffer, writeBuffer, JNI_ABORT);
+	checkJniError(env, __LINE__ - 1);
+	return numBytesWritten;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_writeBytesDirect(JNIEnv *env, jobject obj, jlong serialPortPointer, jobject buffer, jlong bytesToWrite, jlong offset, jint timeoutMode)
+{
+	// Retrieve the native memory address backing the direct buffer
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	const char *writeBuffer = (const char*)(*env)->GetDirectBufferAddress(env, buffer);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	if (!writeBuffer)
+	{
+		port->errorLineNumber = __LINE__ - 4;
+		port->errorNumber = EINVAL;
+		return -1;
+	}
+
+	// Write to the port directly from the buffer memory
+	return writeToPort(port, writeBuffer + offset, bytesToWrite, timeoutMode, getWriteDeadline(port, getMonotonicTimeNS()));
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_writeBytesGather(JNIEnv *env, jobject obj, jlong serialPortPointer, jobjectArray directBuffers, jobjectArray arrayBuffers, jintArray offsets, jintArray lengths, jint timeoutMode)
+{
+	// Allocate space for the I/O vectors and any pinned array references
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	jint numSegments = (*env)->GetArrayLength(env, lengths);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	if (numSegments <= 0)
+		return 0;
+	struct iovec *segments = (struct iovec*)malloc(numSegments * (sizeof(struct iovec) + sizeof(jbyteArray) + sizeof(jbyte*) + (2 * sizeof(jint))));
+	if (!segments)
+	{
+		port->errorLineNumber = __LINE__ - 3;
+		port->errorNumber = errno;
+		return -1;
+	}
+	jbyteArray *arrayRefs = (jbyteArray*)(segments + numSegments);
+	jbyte **arrayElements = (jbyte**)(arrayRefs + numSegments);
+	jint *segmentOffsets = (jint*)(arrayElements + numSegments), *segmentLengths = segmentOffsets + numSegments;
+	memset(arrayRefs, 0, numSegments * (sizeof(jbyteArray) + sizeof(jbyte*)));
+
+	// Point each I/O vector directly at its direct buffer memory or pinned array contents
+	int numBytesWritten = 0, segmentIndex = 0, result = 0, jniFailure = 0;
+	(*env)->GetIntArrayRegion(env, offsets, 0, numSegments, segmentOffsets);
+	jniFailure = checkJniError(env, __LINE__ - 1);
+	(*env)->GetIntArrayRegion(env, lengths, 0, numSegments, segmentLengths);
+	jniFailure = jniFailure || checkJniError(env, __LINE__ - 1);
+	for (jint i = 0; !jniFailure && (i < numSegments); ++i)
+	{
+		char *segmentBase = NULL;
+		jobject directBuffer = (*env)->GetObjectArrayElement(env, directBuffers, i);
+		if ((jniFailure = checkJniError(env, __LINE__ - 1)) != 0)
+			break;
+		if (directBuffer)
+		{
+			segmentBase = (char*)(*env)->GetDirectBufferAddress(env, directBuffer);
+			jniFailure = checkJniError(env, __LINE__ - 1);
+			(*env)->DeleteLocalRef(env, directBuffer);
+		}
+		else
+		{
+			arrayRefs[i] = (jbyteArray)(*env)->GetObjectArrayElement(env, arrayBuffers, i);
+			if (!(jniFailure = checkJniError(env, __LINE__ - 1)))
+			{
+				arrayElements[i] = (*env)->GetByteArrayElements(env, arrayRefs[i], NULL);
+				jniFailure = checkJniError(env, __LINE__ - 1);
+				segmentBase = (char*)arrayElements[i];
+			}
+		}
+		if (!segmentBase && !jniFailure)
+		{
+			port->errorLineNumber = __LINE__ - 2;
+			port->errorNumber = EINVAL;
+			jniFailure = 1;
+		}
+		segments[i].iov_base = segmentBase + segmentOffsets[i];
+		segments[i].iov_len = segmentLengths[i];
+	}
+
+	// Queue all segments in order if the transmit queue is enabled
+	long long startTimeNS = getMonotonicTimeNS(), deadlineNS = getWriteDeadline(port, startTimeNS);
+	int useQueue = port->txQueueEnabled;
+	for (; !jniFailure && useQueue && (segmentIndex < numSegments); ++segmentIndex)
+	{
+		if ((result = writeToQueue(port, (const char*)segments[segmentIndex].iov_base, (int)segments[segmentIndex].iov_len, deadlineNS)) > 0)
+			numBytesWritten += result;
+		if (result < (int)segments[segmentIndex].iov_len)
+			break;
+	}
+
+	// Otherwise, write all segments using as few system calls as possible, giving up once the write timeout expires
+	int waitResult = 1, rs485SoftwareControl = !jniFailure && !useQueue && port->rs485SoftwareControl;
+	long long rs485StartTimeNS = rs485SoftwareControl ? beginRs485Transmission(port) : 0;
+	while (!jniFailure && !useQueue && (segmentIndex < numSegments))
+	{
+		int numSegmentsToWrite = ((numSegments - segmentIndex) > IOV_MAX) ? IOV_MAX : (numSegments - segmentIndex);
+		do {
+			errno = 0;
+			port->errorLineNumber = __LINE__ + 1;
+			result = writev(port->handle, segments + segmentIndex, numSegmentsToWrite);
+			port->errorNumber = errno;
+			addStatistic(&port->statistics.writeSyscalls, 1);
+		} while ((result < 0) && ((errno == EINTR) || (((errno == EAGAIN) || (errno == EWOULDBLOCK)) && ((waitResult = waitForWritable(port, deadlineNS)) > 0))));
+		if (result < 0)
+		{
+			if (!waitResult)
+				result = 0;
+			break;
+		}
+
+		// Skip past all fully written segments and adjust any partially written one
+		numBytesWritten += result;
+		while ((segmentIndex < numSegments) && ((size_t)result >= segments[segmentIndex].iov_len))
+		{
+			recordTraffic(port, RECORDING_DIRECTION_TRANSMITTED, 0, (const char*)segments[segmentIndex].iov_base, (int)segments[segmentIndex].iov_len);
+			result -= (int)segments[segmentIndex++].iov_len;
+		}
+		if (segmentIndex < numSegments)
+		{
+			recordTraffic(port, RECORDING_DIRECTION_TRANSMITTED, 0, (const char*)segments[segmentIndex].iov_base, result);
+			segments[segmentIndex].iov_base = (char*)segments[segmentIndex].iov_base + result;
+			segments[segmentIndex].iov_len -= result;
+		}
+	}
+	if (rs485SoftwareControl)
+		endRs485Transmission(port, rs485StartTimeNS, numBytesWritten, deadlineNS);
+
+	// Release any pinned arrays without copying back their unmodified contents
+	for (jint i = 0; i < numSegments; ++i)
+		if (arrayRefs[i])
+		{
+			if (arrayElements[i])
+				(*env)->ReleaseByteArrayElements(env, arrayRefs[i], arrayElements[i], JNI_ABORT);
+			(*env)->DeleteLocalRef(env, arrayRefs[i]);
+		}
+	free(segments);
+
+	// Wait until all bytes were written in write-blocking mode and update the port statistics
+	if (!useQueue && ((timeoutMode & com_fazecast_jSerialComm_SerialPort_TIMEOUT_WRITE_BLOCKING) > 0) && (numBytesWritten > 0))
+		drainPort(port, deadlineNS);
+	addStatistic(&port->statistics.writeCalls, 1);
+	addStatistic(&port->statistics.bytesWritten, numBytesWritten);
+	recordLatency(port->statistics.writeLatency, startTimeNS);
+	return (jniFailure || ((result < 0) && !numBytesWritten)) ? -1 : numBytesWritten;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_transact(JNIEnv *env, jobject obj, jlong serialPortPointer, jbyteArray request, jlong requestLength, jbyteArray response, jlong responseLength, jint expectedLength, jint terminator, jint silenceGapMicros, jint timeoutMS)
+{
+	// Ensure that the allocated read buffer is large enough for the response
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	long long deadlineNS = (timeoutMS > 0) ? (getMonotonicTimeNS() + (timeoutMS * 1000000LL)) : -1;
+	if ((expectedLength > 0) && (expectedLength < responseLength))
+		responseLength = expectedLength;
+	if (!reserveReadBuffer(port, responseLength))
+		return -1;
+
+	// Discard any stale input so that it cannot be mistaken for the response
+	tcflush(port->handle, TCIFLUSH);
+	if (port->ringBufferEnabled)
+		discardRingBuffer(port);
+
+	// Transmit the complete request and wait for it to physically leave the device, all within the transaction deadline or else the write timeout
+	long long writeDeadlineNS = (deadlineNS >= 0) ? deadlineNS : getWriteDeadline(port, getMonotonicTimeNS());
+	jbyte *writeBuffer = (*env)->GetByteArrayElements(env, request, 0);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	int numBytesWritten = writeToPort(port, (const char*)writeBuffer, requestLength, com_fazecast_jSerialComm_SerialPort_TIMEOUT_WRITE_BLOCKING, writeDeadlineNS);
+	(*env)->ReleaseByteArrayElements(env, request, writeBuffer, JNI_ABORT);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	if (numBytesWritten != requestLength)
+	{
+		if (numBytesWritten >= 0)
+		{
+			port->errorLineNumber = __LINE__ - 7;
+			port->errorNumber = ETIMEDOUT;
+		}
+		return -1;
+	}
+	if (port->txQueueEnabled)
+	{
+		long long remainingNS = (writeDeadlineNS >= 0) ? (writeDeadlineNS - getMonotonicTimeNS()) : 0;
+		int remainingMS = (writeDeadlineNS < 0) ? 0 : (remainingNS > 1000000LL) ? (int)((remainingNS + 999999LL) / 1000000LL) : 1;
+		if (!Java_com_fazecast_jSerialComm_SerialPort_flushTransmitQueue(env, obj, serialPortPointer, remainingMS, JNI_TRUE))
+			return -1;
+	}
+
+	// Read the response until it is complete, the line goes silent, or the deadline expires
+	int numBytesReceived = 0, responseComplete = 0;
+	long long lastByteTimeNS = 0;
+	while (!responseComplete && (numBytesReceived < responseLength))
+	{
+		// Limit the wait to the inter-character silence gap once the response has started
+		long long waitDeadlineNS = deadlineNS;
+		if (numBytesReceived && (silenceGapMicros > 0))
+		{
+			long long gapDeadlineNS = lastByteTimeNS + (silenceGapMicros * 1000LL);
+			if ((waitDeadlineNS < 0) || (gapDeadlineNS < waitDeadlineNS))
+				waitDeadlineNS = gapDeadlineNS;
+		}
+
+		// Wait for and read any newly received data
+		int numBytesRead;
+		if (port->ringBufferEnabled)
+		{
+			long long remainingNS = (waitDeadlineNS >= 0) ? (waitDeadlineNS - getMonotonicTimeNS()) : 0;
+			if ((waitDeadlineNS >= 0) && (remainingNS <= 0))
+				break;
+			numBytesRead = readFromPort(port, port->readBuffer + numBytesReceived, responseLength - numBytesReceived, com_fazecast_jSerialComm_SerialPort_TIMEOUT_READ_SEMI_BLOCKING, (int)((remainingNS + 999999LL) / 1000000LL));
+		}
+		else
+		{
+			int waitResult = waitForReadablePrecise(port, waitDeadlineNS);
+			if (waitResult <= 0)
+			{
+				if (waitResult < 0)
+					numBytesReceived = -1;
+				break;
+			}
+			numBytesRead = readFromPort(port, port->readBuffer + numBytesReceived, responseLength - numBytesReceived, com_fazecast_jSerialComm_SerialPort_TIMEOUT_NONBLOCKING, 0);
+		}
+		if (numBytesRead < 0)
+		{
+			numBytesReceived = -1;
+			break;
+		}
+		else if (numBytesRead == 0)
+			continue;
+		lastByteTimeNS = getMonotonicTimeNS();
+
+		// Check whether the response is now complete
+		if ((terminator >= 0) && (terminator <= 255))
+		{
+			char *terminatorLocation = (char*)memchr(port->readBuffer + numBytesReceived, terminator, numBytesRead);
+			if (terminatorLocation)
+			{
+				numBytesRead = (int)(terminatorLocation - (port->readBuffer + numBytesReceived)) + 1;
+				responseComplete = 1;
+			}
+		}
+		numBytesReceived += numBytesRead;
+		if ((expectedLength > 0) && (numBytesReceived >= expectedLength))
+			responseComplete = 1;
+	}
+
+	// Return the response data and number of bytes received if successful
+	if (numBytesReceived > 0)
+	{
+		(*env)->SetByteArrayRegion(env, response, 0, numBytesReceived, (jbyte*)port->readBuffer);
+		checkJniError(env, __LINE__ - 1);
+	}
+	return numBytesReceived;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_readAvailable(JNIEnv *env, jclass serialComm, jlongArray portHandles, jobjectArray directBuffers, jobjectArray arrayBuffers, jintArray offsets, jintArray lengths, jintArray results, jint timeoutMS)
+{
+	// Allocate space for the port handles, buffer extents, and polling structures
+	jint numPorts = (*env)->GetArrayLength(env, portHandles), numReady = 0;
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	if (numPorts <= 0)
+		return 0;
+	jlong *handles = (jlong*)malloc(numPorts * (sizeof(jlong) + (2 * sizeof(struct pollfd)) + (4 * sizeof(jint))));
+	if (!handles)
+	{
+		lastErrorLineNumber = __LINE__ - 3;
+		lastErrorNumber = errno;
+		return -1;
+	}
+	struct pollfd *waitingSet = (struct pollfd*)(handles + numPorts), *ringWaitingSet = waitingSet + numPorts;
+	jint *bufferOffsets = (jint*)(ringWaitingSet + numPorts), *bufferLengths = bufferOffsets + numPorts, *numBytesRead = bufferLengths + numPorts, *ringWaiters = numBytesRead + numPorts;
+
+	// Retrieve the port handles and buffer extents
+	(*env)->GetLongArrayRegion(env, portHandles, 0, numPorts, handles);
+	if (checkJniError(env, __LINE__ - 1)) { free(handles); return -1; }
+	(*env)->GetIntArrayRegion(env, offsets, 0, numPorts, bufferOffsets);
+	if (checkJniError(env, __LINE__ - 1)) { free(handles); return -1; }
+	(*env)->GetIntArrayRegion(env, lengths, 0, numPorts, bufferLengths);
+	if (checkJniError(env, __LINE__ - 1)) { free(handles); return -1; }
+
+	// Poll every device directly, except those whose data is being drained into a background ring buffer, which wake us up through their data pipes instead
+	int hasRingPorts = 0, hasUnpollableRingPorts = 0, pollResult;
+	for (jint i = 0; i < numPorts; ++i)
+	{
+		serialPort *port = (serialPort*)(intptr_t)handles[i];
+		numBytesRead[i] = ringWaiters[i] = 0;
+		waitingSet[i].fd = (port && !port->ringBufferEnabled) ? port->handle : -1;
+		ringWaitingSet[i].fd = (port && port->ringBufferEnabled) ? port->ringDataPipe[0] : -1;
+		waitingSet[i].events = ringWaitingSet[i].events = POLLIN;
+		waitingSet[i].revents = ringWaitingSet[i].revents = 0;
+		if (port && port->ringBufferEnabled)
+		{
+			// Announce that we are waiting before checking for data so that the ring reader cannot miss waking us
+			ringWaiters[i] = hasRingPorts = 1;
+			hasUnpollableRingPorts |= (port->ringDataPipe[0] < 0);
+			__atomic_fetch_add(&port->ringPollWaiting, 1, __ATOMIC_SEQ_CST);
+		}
+	}
+
+	// Wait for any port to become ready, only falling back to periodically re-checking any ring buffers that have no data pipe
+	struct timespec currentTime;
+	clock_gettime(CLOCK_MONOTONIC, &currentTime);
+	long long remainingMS = timeoutMS, deadlineMS = (currentTime.tv_sec * 1000LL) + (currentTime.tv_nsec / 1000000) + timeoutMS;
+	while (1)
+	{
+		// Discard stale wakeups before checking the ring buffers, stopping if any has data or its reader has stopped
+		int ringReady = 0;
+		for (jint i = 0; hasRingPorts && (i < numPorts); ++i)
+			if (ringWaiters[i])
+			{
+				serialPort *port = (serialPort*)(intptr_t)handles[i];
+				clearWakePipe(port->ringDataPipe);
+				ringReady |= !port->ringReaderRunning || (Java_com_fazecast_jSerialComm_SerialPort_bytesAvailable(env, NULL, handles[i]) > 0);
+			}
+		if (ringReady)
+			break;
+
+		// Poll the devices and ring buffer data pipes together
+		int sliceMS = (hasUnpollableRingPorts && ((remainingMS < 0) || (remainingMS > 10))) ? 10 : (int)remainingMS;
+		do { pollResult = poll(waitingSet, 2 * numPorts, sliceMS); } while ((pollResult < 0) && (errno == EINTR));
+		if (pollResult < 0)
+		{
+			lastErrorLineNumber = __LINE__ - 3;
+			lastErrorNumber = errno;
+			for (jint i = 0; i < numPorts; ++i)
+				if (ringWaiters[i])
+					__atomic_fetch_sub(&((serialPort*)(intptr_t)handles[i])->ringPollWaiting, 1, __ATOMIC_SEQ_CST);
+			free(handles);
+			return -1;
+		}
+		int deviceReady = 0;
+		for (jint i = 0; (pollResult > 0) && !deviceReady && (i < numPorts); ++i)
+			deviceReady = (waitingSet[i].revents != 0);
+		if (deviceReady || (remainingMS == 0))
+			break;
+		if (timeoutMS > 0)
+		{
+			clock_gettime(CLOCK_MONOTONIC, &currentTime);
+			remainingMS = deadlineMS - ((currentTime.tv_sec * 1000LL) + (currentTime.tv_nsec / 1000000));
+			if (remainingMS < 0)
+				remainingMS = 0;
+		}
+	}
+	for (jint i = 0; i < numPorts; ++i)
+		if (ringWaiters[i])
+			__atomic_fetch_sub(&((serialPort*)(intptr_t)handles[i])->ringPollWaiting, 1, __ATOMIC_SEQ_CST);
+
+	// Read only the data that is already available from each ready port
+	for (jint i = 0; i < numPorts; ++i)
+	{
+		serialPort *port = (serialPort*)(intptr_t)handles[i];
+		if (!port || (!port->ringBufferEnabled && !waitingSet[i].revents))
+			continue;
+		else if (!port->ringBufferEnabled && !(waitingSet[i].revents & POLLIN))
+		{
+			numBytesRead[i] = -1;
+			continue;
+		}
+		int numBytesAvailable = Java_com_fazecast_jSerialComm_SerialPort_bytesAvailable(env, NULL, handles[i]);
+		if (numBytesAvailable > bufferLengths[i])
+			numBytesAvailable = bufferLengths[i];
+		if (numBytesAvailable <= 0)
+		{
+			numBytesRead[i] = ((numBytesAvailable < 0) || (port->ringBufferEnabled && !port->ringReaderRunning)) ? -1 : 0;
+			continue;
+		}
+
+		// Read straight into direct buffers, or through the intermediate buffer for heap arrays
+		jobject directBuffer = (*env)->GetObjectArrayElement(env, directBuffers, i);
+		if (checkJniError(env, __LINE__ - 1)) { free(handles); return -1; }
+		if (directBuffer)
+		{
+			char *readBuffer = (char*)(*env)->GetDirectBufferAddress(env, directBuffer);
+			if (checkJniError(env, __LINE__ - 1)) { free(handles); return -1; }
+			numBytesRead[i] = readBuffer ? readFromPort(port, readBuffer + bufferOffsets[i], numBytesAvailable, com_fazecast_jSerialComm_SerialPort_TIMEOUT_NONBLOCKING, 0) : -1;
+			(*env)->DeleteLocalRef(env, directBuffer);
+		}
+		else if (reserveReadBuffer(port, numBytesAvailable))
+		{
+			jbyteArray arrayBuffer = (jbyteArray)(*env)->GetObjectArrayElement(env, arrayBuffers, i);
+			if (checkJniError(env, __LINE__ - 1)) { free(handles); return -1; }
+			numBytesRead[i] = readFromPort(port, port->readBuffer, numBytesAvailable, com_fazecast_jSerialComm_SerialPort_TIMEOUT_NONBLOCKING, 0);
+			if (numBytesRead[i] > 0)
+			{
+				(*env)->SetByteArrayRegion(env, arrayBuffer, bufferOffsets[i], numBytesRead[i], (jbyte*)port->readBuffer);
+				if (checkJniError(env, __LINE__ - 1)) { free(handles); return -1; }
+			}
+			(*env)->DeleteLocalRef(env, arrayBuffer);
+		}
+		else
+			numBytesRead[i] = -1;
+		if (numBytesRead[i] > 0)
+			++numReady;
+	}
+
+	// Return the number of bytes read from each port
+	(*env)->SetIntArrayRegion(env, results, 0, numPorts, numBytesRead);
+	free(handles);
+	if (checkJniError(env, __LINE__ - 2)) return -1;
+	return numReady;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_setCurrentThreadScheduling(JNIEnv *env, jclass serialComm, jlong cpuAffinityMask, jint realTimePriority, jboolean roundRobin)
+{
+	// Apply the requested scheduling to the calling Java thread
+	return applyThreadScheduling((long long)cpuAffinityMask, realTimePriority, roundRobin);
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_findMessageBoundaries(JNIEnv *env, jclass serialComm, jbyteArray data, jint length, jbyteArray delimiters, jintArray delimiterState, jintArray boundaries)
+{
+	// Retrieve the partial delimiter match carried over from the previous chunk
+	jint delimiterIndex = 0, numBoundaries = 0, numDelimiters = (*env)->GetArrayLength(env, delimiters);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	(*env)->GetIntArrayRegion(env, delimiterState, 0, 1, &delimiterIndex);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	if ((numDelimiters <= 0) || (length <= 0))
+		return 0;
+
+	// Access the array contents without copying them, noting that no other JNI calls are allowed until they are released
+	const unsigned char *dataBytes = (const unsigned char*)(*env)->GetPrimitiveArrayCritical(env, data, NULL);
+	const unsigned char *delimiterBytes = dataBytes ? (const unsigned char*)(*env)->GetPrimitiveArrayCritical(env, delimiters, NULL) : NULL;
+	jint *boundaryOffsets = delimiterBytes ? (jint*)(*env)->GetPrimitiveArrayCritical(env, boundaries, NULL) : NULL;
+	if (!boundaryOffsets)
+	{
+		if (delimiterBytes)
+			(*env)->ReleasePrimitiveArrayCritical(env, delimiters, (void*)delimiterBytes, JNI_ABORT);
+		if (dataBytes)
+			(*env)->ReleasePrimitiveArrayCritical(env, data, (void*)dataBytes, JNI_ABORT);
+		checkJniError(env, __LINE__ - 8);
+		return -1;
+	}
+
+	// Use the vectorized C library search to skip directly to each candidate first delimiter byte
+	jint offset = 0;
+	while (offset < length)
+	{
+		if (delimiterIndex == 0)
+		{
+			const unsigned char *candidate = (const unsigned char*)memchr(dataBytes + offset, delimiterBytes[0], length - offset);
+			if (!candidate)
+				break;
+			offset = (jint)(candidate - dataBytes);
+		}
+
+		// Confirm or reject the multi-byte delimiter one byte at a time
+		if (dataBytes[offset] == delimiterBytes[delimiterIndex])
+		{
+			if (++delimiterIndex == numDelimiters)
+			{
+				boundaryOffsets[numBoundaries++] = offset + 1;
+				delimiterIndex = 0;
+			}
+		}
+		else
+			delimiterIndex = (dataBytes[offset] == delimiterBytes[0]) ? 1 : 0;
+		++offset;
+	}
+
+	// Release the arrays and store the partial delimiter match for the next chunk
+	(*env)->ReleasePrimitiveArrayCritical(env, boundaries, boundaryOffsets, 0);
+	(*env)->ReleasePrimitiveArrayCritical(env, delimiters, (void*)delimiterBytes, JNI_ABORT);
+	(*env)->ReleasePrimitiveArrayCritical(env, data, (void*)dataBytes, JNI_ABORT);
+	(*env)->SetIntArrayRegion(env, delimiterState, 0, 1, &delimiterIndex);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	return numBoundaries;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_readFrames(JNIEnv *env, jobject obj, jlong serialPortPointer, jint bytesToRead, jint timeoutMode, jint readTimeout, jintArray decoderState, jbyteArray frameBuffer, jintArray boundaries)
+{
+	// Retrieve the decoder state and ensure that the frame buffer can hold all decoded bytes
+	jint state[FRAME_STATE_LENGTH];
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	(*env)->GetIntArrayRegion(env, decoderState, 0, FRAME_STATE_LENGTH, state);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	jint frameBufferLength = (*env)->GetArrayLength(env, frameBuffer);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	if ((state[FRAME_STATE_FRAME_LENGTH] + bytesToRead) > frameBufferLength)
+	{
+		port->errorLineNumber = lastErrorLineNumber = __LINE__ - 2;
+		port->errorNumber = lastErrorNumber = EINVAL;
+		return -1;
+	}
+
+	// Read the raw bytes into the native intermediate buffer
+	if (!reserveReadBuffer(port, bytesToRead))
+		return -1;
+	int numBytesRead = readFromPort(port, port->readBuffer, bytesToRead, timeoutMode, readTimeout);
+	if (numBytesRead <= 0)
+		return numBytesRead;
+
+	// Decode the bytes directly into the Java frame buffer, noting that no other JNI calls are allowed until it is released
+	unsigned char *frames = (unsigned char*)(*env)->GetPrimitiveArrayCritical(env, frameBuffer, NULL);
+	jint *frameBoundaries = frames ? (jint*)(*env)->GetPrimitiveArrayCritical(env, boundaries, NULL) : NULL;
+	if (!frameBoundaries)
+	{
+		if (frames)
+			(*env)->ReleasePrimitiveArrayCritical(env, frameBuffer, frames, JNI_ABORT);
+		checkJniError(env, __LINE__ - 5);
+		return -1;
+	}
+	int numFrames = decodeFrames((const unsigned char*)port->readBuffer, numBytesRead, state, frames, frameBoundaries);
+	(*env)->ReleasePrimitiveArrayCritical(env, boundaries, frameBoundaries, 0);
+	(*env)->ReleasePrimitiveArrayCritical(env, frameBuffer, frames, 0);
+
+	// Store the updated decoder state for the next chunk
+	(*env)->SetIntArrayRegion(env, decoderState, 0, FRAME_STATE_LENGTH, state);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	return numFrames;
+}
+
+JNIEXPORT void JNICALL Java_com_fazecast_jSerialComm_SerialPort_setEventListeningStatus(JNIEnv *env, jobject obj, jlong serialPortPointer, jboolean eventListenerRunning)
+{
+	// Discard any stale wakeups before listening, or immediately release any threads still waiting for events when stopping
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	if (eventListenerRunning)
+		prepareWakePipe(port->listenerWakePipe);
+	port->eventListenerRunning = eventListenerRunning;
+	if (!eventListenerRunning)
+	{
+		signalWakePipe(port->listenerWakePipe);
+		pthread_mutex_lock(&port->eventMutex);
+		pthread_cond_broadcast(&port->eventReceived);
+		pthread_mutex_unlock(&port->eventMutex);
+	}
+
+	// Create or stop separate event listening threads if required
+#if defined(__linux__) && !defined(__ANDROID__)
+	if (eventListenerRunning && ((port->eventsMask & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_CARRIER_DETECT) || (port->eventsMask & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_CTS) ||
+			(port->eventsMask & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DSR) || (port->eventsMask & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_RING_INDICATOR)))
+	{
+		port->event = 0;
+		port->pendingEventTimestampNS = 0;
+		if (!port->eventsThread1)
+		{
+			if (!pthread_create(&port->eventsThread1, NULL, eventReadingThread1, port))
+				pthread_detach(port->eventsThread1);
+			else
+				port->eventsThread1 = 0;
+		}
+		if (!port->eventsThread2 && pthread_create(&port->eventsThread2, NULL, eventReadingThread2, port))
+			port->eventsThread2 = 0;
+		port->eventListenerUsesThreads = 1;
+	}
+	else if (port->eventListenerUsesThreads)
+	{
+		// The modem line thread can only be cancelled, but the polling thread has already been woken up and can be joined
+		port->eventListenerUsesThreads = 0;
+		if (port->eventsThread1)
+			pthread_cancel(port->eventsThread1);
+		port->eventsThread1 = 0;
+		if (port->eventsThread2)
+			pthread_join(port->eventsThread2, NULL);
+		port->eventsThread2 = 0;
+	}
+#endif // #if defined(__linux__)
+}
+
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_setBackgroundReading(JNIEnv *env, jobject obj, jlong serialPortPointer, jint bufferSize)
+{
+	// Stop any currently running background reader
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	stopRingReader(port);
+	if (bufferSize <= 0)
+		return JNI_TRUE;
+
+	// Round the ring buffer capacity up to a power of two so that indices can wrap freely
+	unsigned int capacity = 64;
+	while ((capacity < (unsigned int)bufferSize) && (capacity < 0x40000000))
+		capacity <<= 1;
+	if (capacity != port->ringBufferLength)
+	{
+		port->errorLineNumber = __LINE__ + 1;
+		char *newMemory = (char*)realloc(port->ringBuffer, capacity);
+		if (!newMemory)
+		{
+			port->errorNumber = errno;
+			return JNI_FALSE;
+		}
+		port->ringBuffer = newMemory;
+		port->ringBufferLength = capacity;
+	}
+
+	// Start the background reader thread along with the pipe it uses to wake up multi-port readers
+	prepareWakePipe(port->ringDataPipe);
+	port->ringHead = port->ringTail = port->ringReaderWaiting = port->ringSpaceWaiting = port->ringDiscardHead = port->ringDiscardPending = 0;
+	port->ringBufferEnabled = port->ringReaderRunning = 1;
+	port->errorLineNumber = __LINE__ + 1;
+	if ((port->errorNumber = pthread_create(&port->ringReaderThread, NULL, ringReaderThread, port)) != 0)
+	{
+		port->ringReaderThread = 0;
+		port->ringBufferEnabled = port->ringReaderRunning = 0;
+		return JNI_FALSE;
+	}
+	return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_setTransmitQueue(JNIEnv *env, jobject obj, jlong serialPortPointer, jint bufferSize, jboolean blockWhenFull)
+{
+	// Stop any currently running background writer once it has written out all queued data
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	stopTxWriter(port, 0);
+	if (bufferSize <= 0)
+		return JNI_TRUE;
+
+	// Round the queue capacity up to a power of two so that indices can wrap freely
+	unsigned int capacity = 64;
+	while ((capacity < (unsigned int)bufferSize) && (capacity < 0x40000000))
+		capacity <<= 1;
+	if (capacity != port->txBufferLength)
+	{
+		port->errorLineNumber = __LINE__ + 1;
+		char *newMemory = (char*)realloc(port->txBuffer, capacity);
+		if (!newMemory)
+		{
+			port->errorNumber = errno;
+			return JNI_FALSE;
+		}
+		port->txBuffer = newMemory;
+		port->txBufferLength = capacity;
+	}
 
-	// Return a pointer to the serial port data structure
-	(*env)->ReleaseStringUTFChars(env, portNameJString, portName);
-	checkJniError(env, __LINE__ - 1);
-	return (port->handle > 0) ? (jlong)(intptr_t)port : 0;
+	// Start the background writer thread
+	port->txHead = port->txTail = 0;
+	port->txDiscard = port->txFailed = 0;
+	port->txBlockWhenFull = blockWhenFull;
+	port->txQueueEnabled = port->txWriterRunning = 1;
+	port->errorLineNumber = __LINE__ + 1;
+	if ((port->errorNumber = pthread_create(&port->txWriterThread, NULL, txWriterThread, port)) != 0)
+	{
+		port->txWriterThread = 0;
+		port->txQueueEnabled = port->txWriterRunning = 0;
+		return JNI_FALSE;
+	}
+	return JNI_TRUE;
 }
 
-JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_configPort(JNIEnv *env, jobject obj, jlong serialPortPointer)
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_flushTransmitQueue(JNIEnv *env, jobject obj, jlong serialPortPointer, jint timeoutMS, jboolean drainDevice)
 {
-	// Retrieve port parameters from the Java class
+	// Wait until the background writer has handed all queued data to the device driver
+	struct timespec deadline;
 	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
-	baud_rate baudRate = (*env)->GetIntField(env, obj, baudRateField);
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
-	int byteSizeInt = (*env)->GetIntField(env, obj, dataBitsField);
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
-	int stopBitsInt = (*env)->GetIntField(env, obj, stopBitsField);
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
-	int parityInt = (*env)->GetIntField(env, obj, parityField);
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
-	int flowControl = (*env)->GetIntField(env, obj, flowControlField);
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
-	int sendDeviceQueueSize = (*env)->GetIntField(env, obj, sendDeviceQueueSizeField);
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
-	int receiveDeviceQueueSize = (*env)->GetIntField(env, obj, receiveDeviceQueueSizeField);
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
-	int rs485DelayBefore = (*env)->GetIntField(env, obj, rs485DelayBeforeField);
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
-	int rs485DelayAfter = (*env)->GetIntField(env, obj, rs485DelayAfterField);
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
-	int timeoutMode = (*env)->GetIntField(env, obj, timeoutModeField);
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
-	int readTimeout = (*env)->GetIntField(env, obj, readTimeoutField);
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
-	int writeTimeout = (*env)->GetIntField(env, obj, writeTimeoutField);
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
-	int eventsToMonitor = (*env)->GetIntField(env, obj, eventFlagsField);
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
-	unsigned char rs485ModeEnabled = (*env)->GetBooleanField(env, obj, rs485ModeField);
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
-	unsigned char rs485ActiveHigh = (*env)->GetBooleanField(env, obj, rs485ActiveHighField);
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
-	unsigned char rs485EnableTermination = (*env)->GetBooleanField(env, obj, rs485EnableTerminationField);
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
-	unsigned char rs485RxDuringTx = (*env)->GetBooleanField(env, obj, rs485RxDuringTxField);
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
-	unsigned char isDtrEnabled = (*env)->GetBooleanField(env, obj, isDtrEnabledField);
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
-	unsigned char isRtsEnabled = (*env)->GetBooleanField(env, obj, isRtsEnabledField);
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
-	char xonStartChar = (*env)->GetByteField(env, obj, xonStartCharField);
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
-	char xoffStopChar = (*env)->GetByteField(env, obj, xoffStopCharField);
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
-
-	// Clear any serial port flags and set up raw non-canonical port parameters
-	struct termios options = { 0 };
-	tcgetattr(port->handle, &options);
-	options.c_cc[VSTART] = (unsigned char)xonStartChar;
-	options.c_cc[VSTOP] = (unsigned char)xoffStopChar;
-	options.c_iflag &= ~(IGNBRK | BRKINT | PARMRK | ISTRIP | INLCR | INPCK | IGNPAR | IGNCR | ICRNL | IXON | IXOFF);
-	options.c_oflag &= ~OPOST;
-	options.c_lflag &= ~(ECHO | ECHONL | ICANON | ISIG | IEXTEN);
-	options.c_cflag &= ~(CSIZE | PARENB | CMSPAR | PARODD | CSTOPB | CRTSCTS);
+	long long deadlineNS = (timeoutMS > 0) ? (getMonotonicTimeNS() + (timeoutMS * 1000000LL)) : -1;
+	getConditionDeadline(&deadline, timeoutMS);
+	pthread_mutex_lock(&port->txMutex);
+	int waitResult = 0;
+	while ((port->txHead != port->txTail) && !waitResult)
+		waitResult = (timeoutMS > 0) ? pthread_cond_timedwait(&port->txSpaceAvailable, &port->txMutex, &deadline) : pthread_cond_wait(&port->txSpaceAvailable, &port->txMutex);
+	int queueFlushed = (port->txHead == port->txTail) && !port->txFailed;
+	pthread_mutex_unlock(&port->txMutex);
+	if (!queueFlushed)
+	{
+		port->errorLineNumber = __LINE__ - 5;
+		port->errorNumber = waitResult ? waitResult : EIO;
+		return JNI_FALSE;
+	}
 
-	// Update the user-specified port parameters
-	tcflag_t byteSize = (byteSizeInt == 5) ? CS5 : (byteSizeInt == 6) ? CS6 : (byteSizeInt == 7) ? CS7 : CS8;
-	tcflag_t parity = (parityInt == com_fazecast_jSerialComm_SerialPort_NO_PARITY) ? 0 : (parityInt == com_fazecast_jSerialComm_SerialPort_ODD_PARITY) ? (PARENB | PARODD) : (parityInt == com_fazecast_jSerialComm_SerialPort_EVEN_PARITY) ? PARENB : (parityInt == com_fazecast_jSerialComm_SerialPort_MARK_PARITY) ? (PARENB | CMSPAR | PARODD) : (PARENB | CMSPAR);
-	options.c_cflag |= (byteSize | parity | CLOCAL | CREAD);
-	if (!isDtrEnabled || !isRtsEnabled)
-		options.c_cflag &= ~HUPCL;
-	if (!rs485ModeEnabled)
-		options.c_iflag |= BRKINT;
-	if (stopBitsInt == com_fazecast_jSerialComm_SerialPort_TWO_STOP_BITS)
-		options.c_cflag |= CSTOPB;
-	if (((flowControl & com_fazecast_jSerialComm_SerialPort_FLOW_CONTROL_CTS_ENABLED) > 0) || ((flowControl & com_fazecast_jSerialComm_SerialPort_FLOW_CONTROL_RTS_ENABLED) > 0))
-		options.c_cflag |= CRTSCTS;
-	if (byteSizeInt < 8)
-		options.c_iflag |= ISTRIP;
-	if (parityInt != 0)
-		options.c_iflag |= (INPCK | IGNPAR);
-	if ((flowControl & com_fazecast_jSerialComm_SerialPort_FLOW_CONTROL_XONXOFF_IN_ENABLED) > 0)
-		options.c_iflag |= IXOFF;
-	if ((flowControl & com_fazecast_jSerialComm_SerialPort_FLOW_CONTROL_XONXOFF_OUT_ENABLED) > 0)
-		options.c_iflag |= IXON;
+	// Additionally wait for the device to physically transmit all data within the same timeout if requested
+	if (drainDevice && !drainPort(port, deadlineNS))
+	{
+		port->errorLineNumber = __LINE__ - 2;
+		port->errorNumber = ETIMEDOUT;
+		return JNI_FALSE;
+	}
+	return JNI_TRUE;
+}
 
-	// Set the baud rate and apply all changes
-	baud_rate baudRateCode = getBaudRateCode(baudRate);
-	if (!baudRateCode)
-		baudRateCode = B38400;
-	cfsetispeed(&options, baudRateCode);
-	cfsetospeed(&options, baudRateCode);
-	if (tcsetattr(port->handle, TCSANOW, &options) || tcsetattr(port->handle, TCSANOW, &options))
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_setRecording(JNIEnv *env, jobject obj, jlong serialPortPointer, jstring fileName, jlong fileLength, jboolean includeTransmitted)
+{
+	// Stop any existing recording
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	stopRecording(port);
+	if (!fileName)
+		return JNI_TRUE;
+	if (fileLength < (jlong)(sizeof(recordingHeader) + RECORDING_MINIMUM_LENGTH))
 	{
 		port->errorLineNumber = lastErrorLineNumber = __LINE__ - 2;
+		port->errorNumber = lastErrorNumber = EINVAL;
+		return JNI_FALSE;
+	}
+
+	// Create the recording file at its full size and map it into memory
+	const char *recordingFileName = (*env)->GetStringUTFChars(env, fileName, NULL);
+	if (checkJniError(env, __LINE__ - 1) || !recordingFileName) return JNI_FALSE;
+	port->errorLineNumber = lastErrorLineNumber = __LINE__ + 1;
+	int recordingFD = open(recordingFileName, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+	(*env)->ReleaseStringUTFChars(env, fileName, recordingFileName);
+	if (recordingFD < 0)
+	{
+		port->errorNumber = lastErrorNumber = errno;
+		return JNI_FALSE;
+	}
+	void *recording = MAP_FAILED;
+	port->errorLineNumber = lastErrorLineNumber = __LINE__ + 1;
+	if (!ftruncate(recordingFD, (off_t)fileLength))
+		recording = mmap(NULL, (size_t)fileLength, PROT_READ | PROT_WRITE, MAP_SHARED, recordingFD, 0);
+	if (recording == MAP_FAILED)
+	{
 		port->errorNumber = lastErrorNumber = errno;
+		close(recordingFD);
 		return JNI_FALSE;
 	}
+	close(recordingFD);
+
+	// Initialize the file header, recording the wall clock time that corresponds to the native timestamps
+	struct timespec wallClockTime;
+	clock_gettime(CLOCK_REALTIME, &wallClockTime);
+	initializeRecording((char*)recording, (unsigned long long)fileLength, getMonotonicTimeNS(), (wallClockTime.tv_sec * 1000000000LL) + wallClockTime.tv_nsec);
+
+	// Start feeding all transferred data into the recording
+	pthread_mutex_lock(&port->recordingMutex);
+	port->recording = (char*)recording;
+	port->recordingLength = (unsigned long long)fileLength;
+	port->recordTransmitted = includeTransmitted;
+	port->recordingEnabled = 1;
+	pthread_mutex_unlock(&port->recordingMutex);
+	return JNI_TRUE;
+}
+
+#if defined(__linux__)
+
+// Shared event engine line error tracking
+static int updateEventEngineLineErrors(serialPort *port)
+{
+	// Compare the current line error counters to those previously seen by the event engine
+	int event = 0;
+	struct serial_icounter_struct serialLineInterrupts;
+	if (!ioctl(port->handle, TIOCGICOUNT, &serialLineInterrupts))
+	{
+		if (port->eventEngineLineErrors[0] != serialLineInterrupts.frame)
+			event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_FRAMING_ERROR;
+		if (port->eventEngineLineErrors[1] != serialLineInterrupts.brk)
+			event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_BREAK_INTERRUPT;
+		if (port->eventEngineLineErrors[2] != serialLineInterrupts.overrun)
+			event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_FIRMWARE_OVERRUN_ERROR;
+		if (port->eventEngineLineErrors[3] != serialLineInterrupts.parity)
+			event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_PARITY_ERROR;
+		if (port->eventEngineLineErrors[4] != serialLineInterrupts.buf_overrun)
+			event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_SOFTWARE_OVERRUN_ERROR;
+		port->eventEngineLineErrors[0] = serialLineInterrupts.frame;
+		port->eventEngineLineErrors[1] = serialLineInterrupts.brk;
+		port->eventEngineLineErrors[2] = serialLineInterrupts.overrun;
+		port->eventEngineLineErrors[3] = serialLineInterrupts.parity;
+		port->eventEngineLineErrors[4] = serialLineInterrupts.buf_overrun;
+	}
+	return event;
+}
+
+#endif // #if defined(__linux__)
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_configLowLatency(JNIEnv *env, jobject obj, jlong serialPortPointer, jboolean enabled)
+{
+	// Apply or revert all available driver-level latency optimizations
+	int appliedSettings = 0;
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
 
 #if defined(__linux__)
 
-	// Attempt to set the transmit buffer size, closing wait time, and latency flags
+	// Toggle the low-latency flag in the serial driver and verify that it was accepted
 	struct serial_struct serInfo = { 0 };
+	port->errorLineNumber = lastErrorLineNumber = __LINE__ + 1;
 	if (!ioctl(port->handle, TIOCGSERIAL, &serInfo))
 	{
-		serInfo.closing_wait = 250;
-		serInfo.xmit_fifo_size = sendDeviceQueueSize;
-		serInfo.flags |= ASYNC_LOW_LATENCY;
-		ioctl(port->handle, TIOCSSERIAL, &serInfo);
+		if (enabled)
+			serInfo.flags |= ASYNC_LOW_LATENCY;
+		else
+			serInfo.flags &= ~ASYNC_LOW_LATENCY;
+		port->errorLineNumber = lastErrorLineNumber = __LINE__ + 1;
+		if (ioctl(port->handle, TIOCSSERIAL, &serInfo))
+			port->errorNumber = lastErrorNumber = errno;
+		else if (!ioctl(port->handle, TIOCGSERIAL, &serInfo) && (((serInfo.flags & ASYNC_LOW_LATENCY) > 0) == (enabled != JNI_FALSE)))
+			appliedSettings |= com_fazecast_jSerialComm_SerialPort_LOW_LATENCY_DRIVER_FLAG;
 	}
+	else
+		port->errorNumber = lastErrorNumber = errno;
 
-	// Retrieve the driver-reported transmit buffer size
-	if (!ioctl(port->handle, TIOCGSERIAL, &serInfo))
-		sendDeviceQueueSize = serInfo.xmit_fifo_size;
-	receiveDeviceQueueSize = sendDeviceQueueSize;
-	(*env)->SetIntField(env, obj, sendDeviceQueueSizeField, sendDeviceQueueSize);
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
-	(*env)->SetIntField(env, obj, receiveDeviceQueueSizeField, receiveDeviceQueueSize);
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	// Set the USB-serial device latency timer to its minimum value or back to the driver default
+	if (setLatencyTimer(port->portPath, enabled ? 1 : 16))
+		appliedSettings |= com_fazecast_jSerialComm_SerialPort_LOW_LATENCY_DEVICE_TIMER;
 
-	// Attempt to set the requested RS-485 mode
-	struct serial_rs485 rs485Conf = { 0 };
-	if (!ioctl(port->handle, TIOCGRS485, &rs485Conf))
+#endif
+
+	return appliedSettings;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_waitForPortListChange(JNIEnv *env, jclass serialComm, jint lastGeneration, jint timeoutMS)
+{
+	// Make sure that hotplug monitoring has been started
+	if (!hotplugMonitorStatus)
+		hotplugMonitorStatus = startHotplugMonitor(portListingChanged) ? 1 : -1;
+
+	// Fall back to periodic re-enumeration if hotplug notifications are not available
+	if (hotplugMonitorStatus < 0)
 	{
-		if (rs485ModeEnabled)
-			rs485Conf.flags |= SER_RS485_ENABLED;
-		else
-			rs485Conf.flags &= ~SER_RS485_ENABLED;
-		if (rs485ActiveHigh)
+		if (timeoutMS > 0)
 		{
-			rs485Conf.flags |= SER_RS485_RTS_ON_SEND;
-			rs485Conf.flags &= ~(SER_RS485_RTS_AFTER_SEND);
+			const struct timespec sleepTime = { timeoutMS / 1000, (long)(timeoutMS % 1000) * 1000000L };
+			nanosleep(&sleepTime, NULL);
 		}
-		else
+		return lastGeneration + 1;
+	}
+
+	// Wait until the port listing changes or the timeout expires
+	int waitResult = 0;
+	struct timespec deadline;
+	getConditionDeadline(&deadline, (timeoutMS > 0) ? timeoutMS : 0);
+	pthread_mutex_lock(&hotplugMutex);
+	while ((timeoutMS > 0) && ((jint)portListingGeneration == lastGeneration) && (waitResult != ETIMEDOUT))
+		waitResult = pthread_cond_timedwait(&hotplugCondition, &hotplugMutex, &deadline);
+	jint generation = (jint)portListingGeneration;
+	pthread_mutex_unlock(&hotplugMutex);
+	return generation;
+}
+
+JNIEXPORT jlong JNICALL Java_com_fazecast_jSerialComm_SerialPort_createEventEngine(JNIEnv *env, jclass serialComm)
+{
+	// Create a single kernel event queue to be shared by all registered ports
+	int engineHandle = -1;
+#if defined(__linux__)
+	lastErrorLineNumber = __LINE__ + 1;
+	engineHandle = epoll_create1(EPOLL_CLOEXEC);
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__)
+	lastErrorLineNumber = __LINE__ + 1;
+	if ((engineHandle = kqueue()) >= 0)
+		fcntl(engineHandle, F_SETFD, FD_CLOEXEC);
+#else
+	lastErrorLineNumber = __LINE__ + 1;
+	errno = ENOTSUP;
+#endif
+	if (engineHandle < 0)
+		lastErrorNumber = errno;
+	return engineHandle;
+}
+
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_addToEventEngine(JNIEnv *env, jclass serialComm, jlong engineHandle, jlong serialPortPointer, jboolean rearm)
+{
+	// Register or re-arm the port for a single notification from the event engine, never re-registering a port that was removed
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+#if defined(__linux__)
+	struct epoll_event portEvent = { 0 };
+	portEvent.events = EPOLLONESHOT | EPOLLERR | EPOLLHUP;
+	if ((port->eventsMask & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_AVAILABLE) || (port->eventsMask & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_RECEIVED))
+		portEvent.events |= EPOLLIN;
+	portEvent.data.ptr = port;
+	if (!rearm)
+	{
+		// Take a snapshot of the current line error counters upon initial registration
+		updateEventEngineLineErrors(port);
+		port->errorLineNumber = __LINE__ + 1;
+		if (epoll_ctl((int)engineHandle, EPOLL_CTL_ADD, port->handle, &portEvent))
 		{
-			rs485Conf.flags &= ~(SER_RS485_RTS_ON_SEND);
-			rs485Conf.flags |= SER_RS485_RTS_AFTER_SEND;
+			port->errorNumber = errno;
+			return JNI_FALSE;
 		}
-		if (rs485RxDuringTx)
-			rs485Conf.flags |= SER_RS485_RX_DURING_TX;
-		else
-			rs485Conf.flags &= ~(SER_RS485_RX_DURING_TX);
-		if (rs485EnableTermination)
-			rs485Conf.flags |= SER_RS485_TERMINATE_BUS;
-		else
-			rs485Conf.flags &= ~(SER_RS485_TERMINATE_BUS);
-		rs485Conf.delay_rts_before_send = rs485DelayBefore / 1000;
-		rs485Conf.delay_rts_after_send = rs485DelayAfter / 1000;
-		ioctl(port->handle, TIOCSRS485, &rs485Conf);
 	}
+	else if (epoll_ctl((int)engineHandle, EPOLL_CTL_MOD, port->handle, &portEvent))
+	{
+		// A missing registration means that the port was removed from the engine and must stay that way
+		port->errorLineNumber = __LINE__ - 3;
+		port->errorNumber = errno;
+		return JNI_FALSE;
+	}
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__)
+	// Read filters cannot report disconnections without also reporting data, so only data listeners are supported here
+	struct kevent portEvent;
+#ifdef EV_DISPATCH
+	// Dispatched filters are only disabled after firing, so re-arming can enable them without ever adding a removed port back
+	EV_SET(&portEvent, port->handle, EVFILT_READ, rearm ? EV_ENABLE : (EV_ADD | EV_DISPATCH), 0, 0, port);
+#else
+	EV_SET(&portEvent, port->handle, EVFILT_READ, EV_ADD | EV_ONESHOT, 0, 0, port);
+#endif
+	if (!(port->eventsMask & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_AVAILABLE) && !(port->eventsMask & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_RECEIVED))
+	{
+		port->errorLineNumber = __LINE__ - 2;
+		port->errorNumber = ENOTSUP;
+		return JNI_FALSE;
+	}
+	port->errorLineNumber = __LINE__ + 1;
+	if (kevent((int)engineHandle, &portEvent, 1, NULL, 0, NULL) < 0)
+	{
+		port->errorNumber = errno;
+		return JNI_FALSE;
+	}
+#else
+	port->errorLineNumber = __LINE__;
+	port->errorNumber = ENOTSUP;
+	return JNI_FALSE;
+#endif
+	return JNI_TRUE;
+}
 
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_removeFromEventEngine(JNIEnv *env, jclass serialComm, jlong engineHandle, jlong serialPortPointer)
+{
+	// Stop receiving event engine notifications for the port
+	int result = -1;
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+#if defined(__linux__)
+	struct epoll_event portEvent = { 0 };
+	port->errorLineNumber = __LINE__ + 1;
+	result = epoll_ctl((int)engineHandle, EPOLL_CTL_DEL, port->handle, &portEvent);
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__)
+	struct kevent portEvent;
+	EV_SET(&portEvent, port->handle, EVFILT_READ, EV_DELETE, 0, 0, port);
+	port->errorLineNumber = __LINE__ + 1;
+	result = kevent((int)engineHandle, &portEvent, 1, NULL, 0, NULL);
 #else
+	port->errorLineNumber = __LINE__;
+	errno = ENOTSUP;
+#endif
+	if (result && (errno != ENOENT))
+	{
+		port->errorNumber = errno;
+		return JNI_FALSE;
+	}
+	return JNI_TRUE;
+}
 
-	(*env)->SetIntField(env, obj, sendDeviceQueueSizeField, sysconf(_SC_PAGESIZE));
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
-	(*env)->SetIntField(env, obj, receiveDeviceQueueSizeField, sysconf(_SC_PAGESIZE));
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_waitForEventEngine(JNIEnv *env, jclass serialComm, jlong engineHandle, jlongArray portHandles, jintArray events, jint timeoutMS)
+{
+	// Determine the maximum number of ready ports to return
+	jlong readyPorts[MAX_EVENT_ENGINE_EVENTS];
+	jint readyEvents[MAX_EVENT_ENGINE_EVENTS];
+	int numReady, maxReady = (*env)->GetArrayLength(env, portHandles);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	if (maxReady > MAX_EVENT_ENGINE_EVENTS)
+		maxReady = MAX_EVENT_ENGINE_EVENTS;
 
+	// Wait for any registered port to become ready and translate its events
+#if defined(__linux__)
+	struct epoll_event portEvents[MAX_EVENT_ENGINE_EVENTS];
+	lastErrorLineNumber = __LINE__ + 1;
+	numReady = epoll_wait((int)engineHandle, portEvents, maxReady, timeoutMS);
+	long long eventTimeNS = getMonotonicTimeNS();
+	for (int i = 0; i < numReady; ++i)
+	{
+		serialPort *port = (serialPort*)portEvents[i].data.ptr;
+		readyPorts[i] = (jlong)(intptr_t)port;
+		port->eventTimestampNS = eventTimeNS;
+		readyEvents[i] = com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_TIMED_OUT;
+		if (portEvents[i].events & EPOLLHUP)
+			readyEvents[i] |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_PORT_DISCONNECTED;
+		else if (portEvents[i].events & EPOLLIN)
+			readyEvents[i] |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_AVAILABLE;
+		if (portEvents[i].events & EPOLLERR)
+			readyEvents[i] |= updateEventEngineLineErrors(port);
+	}
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__)
+	struct kevent portEvents[MAX_EVENT_ENGINE_EVENTS];
+	struct timespec timeout = { timeoutMS / 1000, (timeoutMS % 1000) * 1000000 };
+	lastErrorLineNumber = __LINE__ + 1;
+	numReady = kevent((int)engineHandle, NULL, 0, portEvents, maxReady, (timeoutMS < 0) ? NULL : &timeout);
+	long long eventTimeNS = getMonotonicTimeNS();
+	for (int i = 0; i < numReady; ++i)
+	{
+		readyPorts[i] = (jlong)(intptr_t)portEvents[i].udata;
+		((serialPort*)portEvents[i].udata)->eventTimestampNS = eventTimeNS;
+		readyEvents[i] = com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_TIMED_OUT;
+		if ((portEvents[i].flags & EV_EOF) || (portEvents[i].flags & EV_ERROR))
+			readyEvents[i] |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_PORT_DISCONNECTED;
+		else if (portEvents[i].data > 0)
+			readyEvents[i] |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_AVAILABLE;
+	}
+#else
+	numReady = -1;
+	errno = ENOTSUP;
 #endif
 
-	// Configure the serial port read and write timeouts
-	return Java_com_fazecast_jSerialComm_SerialPort_configTimeouts(env, obj, serialPortPointer, timeoutMode, readTimeout, writeTimeout, eventsToMonitor);
+	// Return the ready ports and their corresponding events
+	if (numReady < 0)
+	{
+		lastErrorNumber = errno;
+		return (errno == EINTR) ? 0 : -1;
+	}
+	(*env)->SetLongArrayRegion(env, portHandles, 0, numReady, readyPorts);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	(*env)->SetIntArrayRegion(env, events, 0, numReady, readyEvents);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	return numReady;
 }
 
-JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_configTimeouts(JNIEnv *env, jobject obj, jlong serialPortPointer, jint timeoutMode, jint readTimeout, jint writeTimeout, jint eventsToMonitor)
+// Asynchronous I/O engine functionality
+static void completeAsyncOperation(asyncEngine *engine, asyncOperation *operation, int result)
 {
-	// Retrieve the existing port configuration
-	int flags = 0;
-	struct termios options = { 0 };
-	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
-	baud_rate baudRate = (*env)->GetIntField(env, obj, baudRateField);
-	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
-	tcgetattr(port->handle, &options);
+	// Detach the operation from its port and queue it to be reported by the next engine wait
+	serialPort *port = operation->port;
+	if (port->asyncRead == operation)
+		port->asyncRead = NULL;
+	else if (port->asyncWrite == operation)
+		port->asyncWrite = NULL;
+	addStatistic(operation->isWrite ? &port->statistics.writeCalls : &port->statistics.readCalls, 1);
+	if (result > 0)
+		addStatistic(operation->isWrite ? &port->statistics.bytesWritten : &port->statistics.bytesRead, result);
+	operation->result = result;
+	operation->next = engine->completed;
+	engine->completed = operation;
+}
 
-	// Set up the requested event flags
-	port->eventsMask = eventsToMonitor;
+static int armAsyncOperations(asyncEngine *engine, serialPort *port)
+{
+	// Request a single readiness notification for each direction with an outstanding operation
+#if defined(__linux__)
+	struct epoll_event portEvent = { 0 };
+	portEvent.events = EPOLLONESHOT | (port->asyncRead ? EPOLLIN : 0) | (port->asyncWrite ? EPOLLOUT : 0);
+	portEvent.data.ptr = port;
+	return !epoll_ctl(engine->queue, EPOLL_CTL_MOD, port->handle, &portEvent) || ((errno == ENOENT) && !epoll_ctl(engine->queue, EPOLL_CTL_ADD, port->handle, &portEvent));
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__)
+	int numEvents = 0;
+	struct kevent portEvents[2];
+	if (port->asyncRead)
+		EV_SET(&portEvents[numEvents++], port->handle, EVFILT_READ, EV_ADD | EV_ONESHOT, 0, 0, port);
+	if (port->asyncWrite)
+		EV_SET(&portEvents[numEvents++], port->handle, EVFILT_WRITE, EV_ADD | EV_ONESHOT, 0, 0, port);
+	return !numEvents || (kevent(engine->queue, portEvents, numEvents, NULL, 0, NULL) >= 0);
+#else
+	errno = ENOTSUP;
+	return 0;
+#endif
+}
 
-	// Set updated port timeouts
-	if ((eventsToMonitor & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_RECEIVED) > 0)
-	{
-		// Force specific read timeouts if we are monitoring data received
-		options.c_cc[VMIN] = 0;
-		options.c_cc[VTIME] = 10;
-	}
-	else if (((timeoutMode & com_fazecast_jSerialComm_SerialPort_TIMEOUT_READ_SEMI_BLOCKING) > 0) && (readTimeout > 0))	// Read Semi-blocking with timeout
+static void performAsyncOperation(asyncEngine *engine, asyncOperation *operation, int hangup)
+{
+	// Transfer as much data as the device currently allows without blocking
+	int numBytesTransferred;
+	serialPort *port = operation->port;
+	port->errorLineNumber = __LINE__ + 4;
+	do
 	{
-		options.c_cc[VMIN] = 0;
-		options.c_cc[VTIME] = readTimeout / 100;
-	}
-	else if ((timeoutMode & com_fazecast_jSerialComm_SerialPort_TIMEOUT_READ_SEMI_BLOCKING) > 0)						// Read Semi-blocking without timeout
+		errno = 0;
+		numBytesTransferred = operation->isWrite ? write(port->handle, operation->buffer + operation->numBytesTransferred, operation->length - operation->numBytesTransferred) :
+				read(port->handle, operation->buffer, operation->length);
+		port->errorNumber = errno;
+		addStatistic(operation->isWrite ? &port->statistics.writeSyscalls : &port->statistics.readSyscalls, 1);
+	} while ((numBytesTransferred < 0) && (errno == EINTR));
+
+	// Complete the operation once it is satisfied or the device has failed, otherwise leave it waiting for the next notification
+	if (numBytesTransferred > 0)
 	{
-		options.c_cc[VMIN] = 1;
-		options.c_cc[VTIME] = 0;
+		recordTraffic(port, operation->isWrite ? RECORDING_DIRECTION_TRANSMITTED : RECORDING_DIRECTION_RECEIVED, 0, operation->buffer + (operation->isWrite ? operation->numBytesTransferred : 0), numBytesTransferred);
+		operation->numBytesTransferred += numBytesTransferred;
+		if (!operation->isWrite || (operation->numBytesTransferred == operation->length))
+			completeAsyncOperation(engine, operation, operation->numBytesTransferred);
 	}
-	else if (((timeoutMode & com_fazecast_jSerialComm_SerialPort_TIMEOUT_READ_BLOCKING) > 0) && (readTimeout > 0))		// Read Blocking with timeout
+	else if (((numBytesTransferred < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK)) || hangup)
 	{
-		options.c_cc[VMIN] = 0;
-		options.c_cc[VTIME] = readTimeout / 100;
+		if (!port->errorNumber)
+			port->errorNumber = EIO;
+		completeAsyncOperation(engine, operation, -1);
 	}
-	else if ((timeoutMode & com_fazecast_jSerialComm_SerialPort_TIMEOUT_READ_BLOCKING) > 0)								// Read Blocking without timeout
+}
+
+JNIEXPORT jlong JNICALL Java_com_fazecast_jSerialComm_SerialPort_createAsyncEngine(JNIEnv *env, jclass serialComm)
+{
+	// Allocate the engine structure
+	asyncEngine *engine = (asyncEngine*)malloc(sizeof(asyncEngine));
+	if (!engine)
 	{
-		options.c_cc[VMIN] = 1;
-		options.c_cc[VTIME] = 0;
+		lastErrorLineNumber = __LINE__ - 3;
+		lastErrorNumber = errno;
+		return 0;
 	}
-	else if ((timeoutMode & com_fazecast_jSerialComm_SerialPort_TIMEOUT_SCANNER) > 0)									// Scanner Mode
+	memset(engine, 0, sizeof(asyncEngine));
+
+	// Create a kernel event queue along with a non-blocking pipe that can be used to interrupt it
+	lastErrorLineNumber = __LINE__ + 1;
+	if (pipe(engine->wakePipe))
 	{
-		options.c_cc[VMIN] = 1;
-		options.c_cc[VTIME] = 1;
+		lastErrorNumber = errno;
+		free(engine);
+		return 0;
 	}
-	else																												// Non-blocking
+	for (int i = 0; i < 2; ++i)
 	{
-		flags = O_NONBLOCK;
-		options.c_cc[VMIN] = 0;
-		options.c_cc[VTIME] = 0;
+		fcntl(engine->wakePipe[i], F_SETFL, fcntl(engine->wakePipe[i], F_GETFL) | O_NONBLOCK);
+		fcntl(engine->wakePipe[i], F_SETFD, FD_CLOEXEC);
 	}
-
-	// Apply changes
-	if (fcntl(port->handle, F_SETFL, flags))
+#if defined(__linux__)
+	struct epoll_event wakeEvent = { 0 };
+	wakeEvent.events = EPOLLIN;
+	wakeEvent.data.ptr = NULL;
+	lastErrorLineNumber = __LINE__ + 1;
+	engine->queue = epoll_create1(EPOLL_CLOEXEC);
+	if ((engine->queue >= 0) && epoll_ctl(engine->queue, EPOLL_CTL_ADD, engine->wakePipe[0], &wakeEvent))
 	{
-		port->errorLineNumber = lastErrorLineNumber = __LINE__ - 2;
-		port->errorNumber = lastErrorNumber = errno;
-		return JNI_FALSE;
+		lastErrorLineNumber = __LINE__ - 2;
+		close(engine->queue);
+		engine->queue = -1;
 	}
-	if (tcsetattr(port->handle, TCSANOW, &options) || tcsetattr(port->handle, TCSANOW, &options))
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__)
+	struct kevent wakeEvent;
+	EV_SET(&wakeEvent, engine->wakePipe[0], EVFILT_READ, EV_ADD, 0, 0, NULL);
+	lastErrorLineNumber = __LINE__ + 1;
+	if ((engine->queue = kqueue()) >= 0)
 	{
-		port->errorLineNumber = lastErrorLineNumber = __LINE__ - 2;
-		port->errorNumber = lastErrorNumber = errno;
-		return JNI_FALSE;
+		fcntl(engine->queue, F_SETFD, FD_CLOEXEC);
+		lastErrorLineNumber = __LINE__ + 1;
+		if (kevent(engine->queue, &wakeEvent, 1, NULL, 0, NULL) < 0)
+		{
+			close(engine->queue);
+			engine->queue = -1;
+		}
 	}
-	if (!getBaudRateCode(baudRate) && setBaudRateCustom(port->handle, baudRate))
+#else
+	lastErrorLineNumber = __LINE__;
+	engine->queue = -1;
+	errno = ENOTSUP;
+#endif
+	if (engine->queue < 0)
 	{
-		port->errorLineNumber = lastErrorLineNumber = __LINE__ - 2;
-		port->errorNumber = lastErrorNumber = errno;
-		return JNI_FALSE;
+		lastErrorNumber = errno;
+		close(engine->wakePipe[0]);
+		close(engine->wakePipe[1]);
+		free(engine);
+		return 0;
 	}
-	return JNI_TRUE;
+	return (jlong)(intptr_t)engine;
 }
 
-JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_flushRxTxBuffers(JNIEnv *env, jobject obj, jlong serialPortPointer)
+JNIEXPORT jlong JNICALL Java_com_fazecast_jSerialComm_SerialPort_startAsyncIO(JNIEnv *env, jclass serialComm, jlong engineHandle, jlong serialPortPointer, jboolean write, jobject directBuffer, jbyteArray arrayBuffer, jint offset, jint length)
 {
+	// Allocate the operation and its private data buffer
+	asyncEngine *engine = (asyncEngine*)(intptr_t)engineHandle;
 	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
-	if (tcflush(port->handle, TCIOFLUSH))
+	asyncOperation *operation = (asyncOperation*)malloc(sizeof(asyncOperation));
+	char *buffer = operation ? (char*)malloc(length) : NULL;
+	if (!buffer || (write ? (port->asyncWrite || port->rs485SoftwareControl) : (port->asyncRead != NULL)))
 	{
-		port->errorLineNumber = __LINE__ - 2;
-		port->errorNumber = errno;
-		return JNI_FALSE;
+		port->errorLineNumber = __LINE__ - 3;
+		port->errorNumber = !buffer ? ENOMEM : (write && port->rs485SoftwareControl) ? EOPNOTSUPP : EBUSY;
+		free(buffer);
+		free(operation);
+		return 0;
 	}
-	return JNI_TRUE;
-}
-
-JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_waitForEvent(JNIEnv *env, jobject obj, jlong serialPortPointer)
-{
-	// Initialize local variables
-	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
-	jint event = com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_TIMED_OUT;
-
-	// Wait for events differently based on the use of threads
-	if (port->eventListenerUsesThreads)
+	memset(operation, 0, sizeof(asyncOperation));
+	operation->port = port;
+	operation->buffer = buffer;
+	operation->length = length;
+	operation->isWrite = write;
+
+	// Take a private copy of any data to be written so that the caller's buffer is never accessed from outside of a JNI call
+	if (write && directBuffer)
 	{
-		pthread_mutex_lock(&port->eventMutex);
-		if ((port->event & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_AVAILABLE) && !Java_com_fazecast_jSerialComm_SerialPort_bytesAvailable(env, obj, serialPortPointer))
-			port->event &= ~com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_AVAILABLE;
-		if (port->event)
-		{
-			event = port->event;
-			port->event = 0;
-		}
+		char *data = (char*)(*env)->GetDirectBufferAddress(env, directBuffer);
+		if (!checkJniError(env, __LINE__ - 1) && data)
+			memcpy(buffer, data + offset, length);
 		else
-		{
-			struct timespec timeoutTime;
-			clock_gettime(CLOCK_MONOTONIC, &timeoutTime);
-			timeoutTime.tv_sec += 1;
-			pthread_cond_timedwait(&port->eventReceived, &port->eventMutex, &timeoutTime);
-			if (port->event)
-			{
-				event = port->event;
-				port->event = 0;
-			}
-		}
-		pthread_mutex_unlock(&port->eventMutex);
+			length = -1;
 	}
-	else
+	else if (write)
 	{
-		// Initialize the local variables
-		int pollResult;
-		short pollEventsMask = ((port->eventsMask & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_AVAILABLE) || (port->eventsMask & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_RECEIVED)) ? (POLLIN | POLLERR) : POLLERR;
-		struct pollfd waitingSet = { port->handle, pollEventsMask, 0 };
-#if defined(__linux__)
-		struct serial_icounter_struct oldSerialLineInterrupts, newSerialLineInterrupts;
-		ioctl(port->handle, TIOCGICOUNT, &oldSerialLineInterrupts);
-#endif // #if defined(__linux__)
-
-		// Wait for a serial port event
-		do
-		{
-			waitingSet.revents = 0;
-			pollResult = poll(&waitingSet, 1, 500);
-		}
-		while ((pollResult == 0) && port->eventListenerRunning);
-
-		// Return the detected port events
-		if (waitingSet.revents & POLLHUP)
-			event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_PORT_DISCONNECTED;
-		else if (waitingSet.revents & POLLIN)
-			event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_AVAILABLE;
-#if defined(__linux__)
-		if (waitingSet.revents & POLLERR)
-			if (!ioctl(port->handle, TIOCGICOUNT, &newSerialLineInterrupts))
-			{
-				if (oldSerialLineInterrupts.frame != newSerialLineInterrupts.frame)
-					event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_FRAMING_ERROR;
-				if (oldSerialLineInterrupts.brk != newSerialLineInterrupts.brk)
-					event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_BREAK_INTERRUPT;
-				if (oldSerialLineInterrupts.overrun != newSerialLineInterrupts.overrun)
-					event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_FIRMWARE_OVERRUN_ERROR;
-				if (oldSerialLineInterrupts.parity != newSerialLineInterrupts.parity)
-					event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_PARITY_ERROR;
-				if (oldSerialLineInterrupts.buf_overrun != newSerialLineInterrupts.buf_overrun)
-					event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_SOFTWARE_OVERRUN_ERROR;
-			}
-#endif // #if defined(__linux__)
+		(*env)->GetByteArrayRegion(env, arrayBuffer, offset, length, (jbyte*)buffer);
+		if (checkJniError(env, __LINE__ - 1))
+			length = -1;
 	}
-	return event;
-}
-
-JNIEXPORT jlong JNICALL Java_com_fazecast_jSerialComm_SerialPort_closePortNative(JNIEnv *env, jobject obj, jlong serialPortPointer)
-{
-	// Force the port to enter non-blocking mode to ensure that any current reads return
-	struct termios options = { 0 };
-	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
-	tcgetattr(port->handle, &options);
-	options.c_cc[VMIN] = 0;
-	options.c_cc[VTIME] = 0;
-	fcntl(port->handle, F_SETFL, O_NONBLOCK);
-	tcsetattr(port->handle, TCSANOW, &options);
 
-	// Unblock, unlock, and close the port
-	fsync(port->handle);
-	tcdrain(port->handle);
-	tcflush(port->handle, TCIOFLUSH);
-	flock(port->handle, LOCK_UN | LOCK_NB);
-	while (close(port->handle) && (errno == EINTR))
-		errno = 0;
-	port->handle = -1;
+	// Attach the operation to its port and wait for the device to become ready
+	if (length >= 0)
+	{
+		if (write)
+			port->asyncWrite = operation;
+		else
+			port->asyncRead = operation;
+		port->errorLineNumber = __LINE__ + 1;
+		if (armAsyncOperations(engine, port))
+			return (jlong)(intptr_t)operation;
+		port->errorNumber = errno;
+		if (write)
+			port->asyncWrite = NULL;
+		else
+			port->asyncRead = NULL;
+		armAsyncOperations(engine, port);
+	}
+	free(buffer);
+	free(operation);
 	return 0;
 }
 
-JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_bytesAvailable(JNIEnv *env, jobject obj, jlong serialPortPointer)
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_cancelAsyncIO(JNIEnv *env, jclass serialComm, jlong engineHandle, jlong operationHandle)
 {
-	// Retrieve bytes available to read
-	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
-	int numBytesAvailable = -1;
-	port->errorLineNumber = __LINE__ + 1;
-	ioctl(port->handle, FIONREAD, &numBytesAvailable);
-	port->errorNumber = errno;
-	return numBytesAvailable;
+	// Complete the operation with whatever has been transferred so far if it is still outstanding
+	asyncEngine *engine = (asyncEngine*)(intptr_t)engineHandle;
+	asyncOperation *operation = (asyncOperation*)(intptr_t)operationHandle;
+	serialPort *port = operation->port;
+	if ((port->asyncRead == operation) || (port->asyncWrite == operation))
+	{
+		completeAsyncOperation(engine, operation, operation->numBytesTransferred);
+		armAsyncOperations(engine, port);
+	}
+	return JNI_TRUE;
 }
 
-JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_bytesAwaitingWrite(JNIEnv *env, jobject obj, jlong serialPortPointer)
+JNIEXPORT void JNICALL Java_com_fazecast_jSerialComm_SerialPort_wakeAsyncEngine(JNIEnv *env, jclass serialComm, jlong engineHandle)
 {
-	// Retrieve bytes awaiting write
-	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
-	int numBytesToWrite = -1;
-	port->errorLineNumber = __LINE__ + 1;
-	ioctl(port->handle, TIOCOUTQ, &numBytesToWrite);
-	port->errorNumber = errno;
-	return numBytesToWrite;
+	// Interrupt any in-progress engine wait
+	asyncEngine *engine = (asyncEngine*)(intptr_t)engineHandle;
+	char wakeByte = 0;
+	if (write(engine->wakePipe[1], &wakeByte, 1) < 0)
+		lastErrorNumber = errno;
 }
 
-JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_readBytes(JNIEnv *env, jobject obj, jlong serialPortPointer, jbyteArray buffer, jlong bytesToRead, jlong offset, jint timeoutMode, jint readTimeout)
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_waitForAsyncIO(JNIEnv *env, jclass serialComm, jlong engineHandle, jlongArray operations, jintArray results, jint timeoutMS)
 {
-	// Ensure that the allocated read buffer is large enough
-	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
-	int numBytesRead = -1, numBytesReadTotal = 0, bytesRemaining = bytesToRead, ioctlResult = 0;
-	if (bytesToRead > port->readBufferLength)
+	// Determine the maximum number of completed operations to return
+	asyncEngine *engine = (asyncEngine*)(intptr_t)engineHandle;
+	jlong completedOperations[MAX_EVENT_ENGINE_EVENTS];
+	jint completedResults[MAX_EVENT_ENGINE_EVENTS];
+	char wakeBytes[64];
+	int numReady, numCompleted = 0, maxCompleted = (*env)->GetArrayLength(env, operations);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	if (maxCompleted > MAX_EVENT_ENGINE_EVENTS)
+		maxCompleted = MAX_EVENT_ENGINE_EVENTS;
+
+	// Wait for any port to become ready only if no operations have already completed, then perform the corresponding transfers
+#if defined(__linux__)
+	struct epoll_event portEvents[MAX_EVENT_ENGINE_EVENTS];
+	lastErrorLineNumber = __LINE__ + 1;
+	numReady = epoll_wait(engine->queue, portEvents, MAX_EVENT_ENGINE_EVENTS, engine->completed ? 0 : timeoutMS);
+	for (int i = 0; i < numReady; ++i)
 	{
-		port->errorLineNumber = __LINE__ + 1;
-		char *newMemory = (char*)realloc(port->readBuffer, bytesToRead);
-		if (!newMemory)
+		serialPort *port = (serialPort*)portEvents[i].data.ptr;
+		if (!port)
 		{
-			port->errorNumber = errno;
-			return -1;
+			while (read(engine->wakePipe[0], wakeBytes, sizeof(wakeBytes)) > 0);
+			continue;
 		}
-		port->readBuffer = newMemory;
-		port->readBufferLength = bytesToRead;
+		int hangup = ((portEvents[i].events & (EPOLLERR | EPOLLHUP)) != 0);
+		if (port->asyncRead && ((portEvents[i].events & EPOLLIN) || hangup))
+			performAsyncOperation(engine, port->asyncRead, hangup);
+		if (port->asyncWrite && ((portEvents[i].events & EPOLLOUT) || hangup))
+			performAsyncOperation(engine, port->asyncWrite, hangup);
+		if (port->asyncRead || port->asyncWrite)
+			armAsyncOperations(engine, port);
 	}
-
-	// Infinite blocking mode specified, don't return until we have completely finished the read
-	if (((timeoutMode & com_fazecast_jSerialComm_SerialPort_TIMEOUT_READ_BLOCKING) > 0) && (readTimeout == 0))
+#elif defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__)
+	struct kevent portEvents[MAX_EVENT_ENGINE_EVENTS];
+	struct timespec timeout = { 0, 0 };
+	if (!engine->completed)
 	{
-		// While there are more bytes we are supposed to read
-		while (bytesRemaining > 0)
-		{
-			// Attempt to read some number of bytes from the serial port
-			port->errorLineNumber = __LINE__ + 1;
-			do { errno = 0; numBytesRead = read(port->handle, port->readBuffer + numBytesReadTotal, bytesRemaining); port->errorNumber = errno; } while ((numBytesRead < 0) && (errno == EINTR));
-			if ((numBytesRead == -1) || ((numBytesRead == 0) && (ioctl(port->handle, FIONREAD, &ioctlResult) == -1)))
-			{
-				// If all bytes were not successfully read, it is an error
-				numBytesRead = -1;
-				break;
-			}
-
-			// Fix index variables
-			numBytesReadTotal += numBytesRead;
-			bytesRemaining -= numBytesRead;
-		}
+		timeout.tv_sec = timeoutMS / 1000;
+		timeout.tv_nsec = (timeoutMS % 1000) * 1000000;
 	}
-	else if ((timeoutMode & com_fazecast_jSerialComm_SerialPort_TIMEOUT_READ_BLOCKING) > 0)		// Blocking mode, but not indefinitely
+	lastErrorLineNumber = __LINE__ + 1;
+	numReady = kevent(engine->queue, NULL, 0, portEvents, MAX_EVENT_ENGINE_EVENTS, (!engine->completed && (timeoutMS < 0)) ? NULL : &timeout);
+	for (int i = 0; i < numReady; ++i)
 	{
-		// Get current system time
-		struct timeval expireTime = { 0 }, currTime = { 0 };
-		gettimeofday(&expireTime, NULL);
-		expireTime.tv_usec += (readTimeout * 1000);
-		if (expireTime.tv_usec > 1000000)
+		serialPort *port = (serialPort*)portEvents[i].udata;
+		if (!port)
 		{
-			expireTime.tv_sec += (expireTime.tv_usec * 0.000001);
-			expireTime.tv_usec = (expireTime.tv_usec % 1000000);
+			while (read(engine->wakePipe[0], wakeBytes, sizeof(wakeBytes)) > 0);
+			continue;
 		}
-
-		// While there are more bytes we are supposed to read and the timeout has not elapsed
-		do
+		int hangup = ((portEvents[i].flags & (EV_EOF | EV_ERROR)) != 0);
+		asyncOperation *operation = (portEvents[i].filter == EVFILT_READ) ? port->asyncRead : ((portEvents[i].filter == EVFILT_WRITE) ? port->asyncWrite : NULL);
+		if (operation)
 		{
-			port->errorLineNumber = __LINE__ + 1;
-			do { errno = 0; numBytesRead = read(port->handle, port->readBuffer + numBytesReadTotal, bytesRemaining); port->errorNumber = errno; } while ((numBytesRead < 0) && (errno == EINTR));
-			if ((numBytesRead == -1) || ((numBytesRead == 0) && (ioctl(port->handle, FIONREAD, &ioctlResult) == -1)))
-			{
-				// If any bytes were read, return those bytes
-				if (!numBytesReadTotal)
-					numBytesRead = -1;
-				break;
-			}
-
-			// Fix index variables
-			numBytesReadTotal += numBytesRead;
-			bytesRemaining -= numBytesRead;
-
-			// Get current system time
-			gettimeofday(&currTime, NULL);
-		} while ((bytesRemaining > 0) && ((expireTime.tv_sec > currTime.tv_sec) || ((expireTime.tv_sec == currTime.tv_sec) && (expireTime.tv_usec > currTime.tv_usec))));
+			performAsyncOperation(engine, operation, hangup);
+			if ((port->asyncRead == operation) || (port->asyncWrite == operation))
+				armAsyncOperations(engine, port);
+		}
 	}
-	else		// Semi- or non-blocking specified
+#else
+	numReady = -1;
+	errno = ENOTSUP;
+#endif
+	if ((numReady < 0) && (errno != EINTR))
 	{
-		// Read from the port
-		port->errorLineNumber = __LINE__ + 1;
-		do { errno = 0; numBytesRead = read(port->handle, port->readBuffer, bytesToRead); port->errorNumber = errno; } while ((numBytesRead < 0) && (errno == EINTR));
-		if ((numBytesRead == -1) || ((numBytesRead == 0) && (ioctl(port->handle, FIONREAD, &ioctlResult) == -1)))
-			numBytesRead = -1;
-		else
-			numBytesReadTotal = numBytesRead;
+		lastErrorNumber = errno;
+		return -1;
 	}
 
-	// Return number of bytes read if successful
-	(*env)->SetByteArrayRegion(env, buffer, offset, numBytesReadTotal, (jbyte*)port->readBuffer);
-	checkJniError(env, __LINE__ - 1);
-	return (numBytesRead == -1) ? -1 : numBytesReadTotal;
-}
-
-JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_writeBytes(JNIEnv *env, jobject obj, jlong serialPortPointer, jbyteArray buffer, jlong bytesToWrite, jlong offset, jint timeoutMode)
-{
-	// Retrieve port parameters from the Java class
-	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
-	int writeBlockingMode = (timeoutMode & com_fazecast_jSerialComm_SerialPort_TIMEOUT_WRITE_BLOCKING);
-	jbyte *writeBuffer = (*env)->GetByteArrayElements(env, buffer, 0);
+	// Return as many completed operations as will fit
+	while (engine->completed && (numCompleted < maxCompleted))
+	{
+		completedOperations[numCompleted] = (jlong)(intptr_t)engine->completed;
+		completedResults[numCompleted++] = engine->completed->result;
+		engine->completed = engine->completed->next;
+	}
+	(*env)->SetLongArrayRegion(env, operations, 0, numCompleted, completedOperations);
 	if (checkJniError(env, __LINE__ - 1)) return -1;
-
-	// Write to the port
-	int numBytesWritten;
-	do {
-		errno = 0;
-		port->errorLineNumber = __LINE__ + 1;
-		numBytesWritten = write(port->handle, writeBuffer + offset, bytesToWrite);
-		port->errorNumber = errno;
-	} while ((numBytesWritten < 0) && ((errno == EINTR) || (errno == EAGAIN) || (errno == EWOULDBLOCK)));
-
-	// Wait until all bytes were written in write-blocking mode
-	if ((writeBlockingMode > 0) && (numBytesWritten > 0))
-		tcdrain(port->handle);
-
-	// Return the number of bytes written if successful
-	(*env)->ReleaseByteArrayElements(env, buffer, writeBuffer, JNI_ABORT);
-	checkJniError(env, __LINE__ - 1);
-	return numBytesWritten;
+	(*env)->SetIntArrayRegion(env, results, 0, numCompleted, completedResults);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	return numCompleted;
 }
 
-JNIEXPORT void JNICALL Java_com_fazecast_jSerialComm_SerialPort_setEventListeningStatus(JNIEnv *env, jobject obj, jlong serialPortPointer, jboolean eventListenerRunning)
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_finishAsyncIO(JNIEnv *env, jclass serialComm, jlong operationHandle, jobject directBuffer, jbyteArray arrayBuffer, jint offset)
 {
-	// Create or cancel a separate event listening thread if required
-	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
-	port->eventListenerRunning = eventListenerRunning;
-#if defined(__linux__) && !defined(__ANDROID__)
-	if (eventListenerRunning && ((port->eventsMask & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_CARRIER_DETECT) || (port->eventsMask & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_CTS) ||
-			(port->eventsMask & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DSR) || (port->eventsMask & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_RING_INDICATOR)))
+	// Copy any data that was read into the caller's buffer, discarding it if no buffer was specified
+	asyncOperation *operation = (asyncOperation*)(intptr_t)operationHandle;
+	int result = operation->result;
+	if (!operation->isWrite && (result > 0) && directBuffer)
 	{
-		port->event = 0;
-		if (!port->eventsThread1)
-		{
-			if (!pthread_create(&port->eventsThread1, NULL, eventReadingThread1, port))
-				pthread_detach(port->eventsThread1);
-			else
-				port->eventsThread1 = 0;
-		}
-		if (!port->eventsThread2)
-		{
-			if (!pthread_create(&port->eventsThread2, NULL, eventReadingThread2, port))
-				pthread_detach(port->eventsThread2);
-			else
-				port->eventsThread2 = 0;
-		}
-		port->eventListenerUsesThreads = 1;
+		char *data = (char*)(*env)->GetDirectBufferAddress(env, directBuffer);
+		if (!checkJniError(env, __LINE__ - 1) && data)
+			memcpy(data + offset, operation->buffer, result);
+		else
+			result = -1;
 	}
-	else if (port->eventListenerUsesThreads)
+	else if (!operation->isWrite && (result > 0) && arrayBuffer)
 	{
-		port->eventListenerUsesThreads = 0;
-		pthread_cancel(port->eventsThread1);
-		port->eventsThread1 = 0;
-		pthread_cancel(port->eventsThread2);
-		port->eventsThread2 = 0;
+		(*env)->SetByteArrayRegion(env, arrayBuffer, offset, result, (jbyte*)operation->buffer);
+		if (checkJniError(env, __LINE__ - 1))
+			result = -1;
 	}
-#endif // #if defined(__linux__)
+
+	// Free the operation
+	free(operation->buffer);
+	free(operation);
+	return result;
 }
 
 JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_setBreak(JNIEnv *env, jobject obj, jlong serialPortPointer)
@@ -1014,10 +3692,9 @@ JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_clearBreak(J
 
 JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_setRTS(JNIEnv *env, jobject obj, jlong serialPortPointer)
 {
-	const int modemBits = TIOCM_RTS;
 	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
 	port->errorLineNumber = __LINE__ + 1;
-	if (ioctl(port->handle, TIOCMBIS, &modemBits))
+	if (changeModemLines(port, 1, TIOCM_RTS))
 	{
 		port->errorNumber = errno;
 		return JNI_FALSE;
@@ -1027,10 +3704,9 @@ JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_setRTS(JNIEn
 
 JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_clearRTS(JNIEnv *env, jobject obj, jlong serialPortPointer)
 {
-	const int modemBits = TIOCM_RTS;
 	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
 	port->errorLineNumber = __LINE__ + 1;
-	if (ioctl(port->handle, TIOCMBIC, &modemBits))
+	if (changeModemLines(port, 0, TIOCM_RTS))
 	{
 		port->errorNumber = errno;
 		return JNI_FALSE;
@@ -1082,10 +3758,9 @@ JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_preclearRTS(
 
 JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_setDTR(JNIEnv *env, jobject obj, jlong serialPortPointer)
 {
-	const int modemBits = TIOCM_DTR;
 	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
 	port->errorLineNumber = __LINE__ + 1;
-	if (ioctl(port->handle, TIOCMBIS, &modemBits))
+	if (changeModemLines(port, 1, TIOCM_DTR))
 	{
 		port->errorNumber = errno;
 		return JNI_FALSE;
@@ -1095,10 +3770,9 @@ JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_setDTR(JNIEn
 
 JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_clearDTR(JNIEnv *env, jobject obj, jlong serialPortPointer)
 {
-	const int modemBits = TIOCM_DTR;
 	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
 	port->errorLineNumber = __LINE__ + 1;
-	if (ioctl(port->handle, TIOCMBIC, &modemBits))
+	if (changeModemLines(port, 0, TIOCM_DTR))
 	{
 		port->errorNumber = errno;
 		return JNI_FALSE;
@@ -1151,37 +3825,37 @@ JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_preclearDTR(
 JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_getCTS(JNIEnv *env, jobject obj, jlong serialPortPointer)
 {
 	int modemBits = 0;
-	return (ioctl(((serialPort*)(intptr_t)serialPortPointer)->handle, TIOCMGET, &modemBits) == 0) && (modemBits & TIOCM_CTS);
+	return (getModemLines((serialPort*)(intptr_t)serialPortPointer, &modemBits) == 0) && (modemBits & TIOCM_CTS);
 }
 
 JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_getDSR(JNIEnv *env, jobject obj, jlong serialPortPointer)
 {
 	int modemBits = 0;
-	return (ioctl(((serialPort*)(intptr_t)serialPortPointer)->handle, TIOCMGET, &modemBits) == 0) && (modemBits & TIOCM_DSR);
+	return (getModemLines((serialPort*)(intptr_t)serialPortPointer, &modemBits) == 0) && (modemBits & TIOCM_DSR);
 }
 
 JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_getDCD(JNIEnv *env, jobject obj, jlong serialPortPointer)
 {
 	int modemBits = 0;
-	return (ioctl(((serialPort*)(intptr_t)serialPortPointer)->handle, TIOCMGET, &modemBits) == 0) && (modemBits & TIOCM_CAR);
+	return (getModemLines((serialPort*)(intptr_t)serialPortPointer, &modemBits) == 0) && (modemBits & TIOCM_CAR);
 }
 
 JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_getDTR(JNIEnv *env, jobject obj, jlong serialPortPointer)
 {
 	int modemBits = 0;
-	return (ioctl(((serialPort*)(intptr_t)serialPortPointer)->handle, TIOCMGET, &modemBits) == 0) && (modemBits & TIOCM_DTR);
+	return (getModemLines((serialPort*)(intptr_t)serialPortPointer, &modemBits) == 0) && (modemBits & TIOCM_DTR);
 }
 
 JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_getRTS(JNIEnv *env, jobject obj, jlong serialPortPointer)
 {
 	int modemBits = 0;
-	return (ioctl(((serialPort*)(intptr_t)serialPortPointer)->handle, TIOCMGET, &modemBits) == 0) && (modemBits & TIOCM_RTS);
+	return (getModemLines((serialPort*)(intptr_t)serialPortPointer, &modemBits) == 0) && (modemBits & TIOCM_RTS);
 }
 
 JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_getRI(JNIEnv *env, jobject obj, jlong serialPortPointer)
 {
 	int modemBits = 0;
-	return (ioctl(((serialPort*)(intptr_t)serialPortPointer)->handle, TIOCMGET, &modemBits) == 0) && (modemBits & TIOCM_RI);
+	return (getModemLines((serialPort*)(intptr_t)serialPortPointer, &modemBits) == 0) && (modemBits & TIOCM_RI);
 }
 
 JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_getLastErrorLocation(JNIEnv *env, jobject obj, jlong serialPortPointer)
@@ -1193,3 +3867,79 @@ JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_getLastErrorCode
 {
 	return serialPortPointer ? ((serialPort*)(intptr_t)serialPortPointer)->errorNumber : lastErrorNumber;
 }
+
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_getStatistics(JNIEnv *env, jobject obj, jlong serialPortPointer, jlongArray statistics, jboolean reset)
+{
+	// Copy the software counters and histograms into a native staging array
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	if (statistics)
+	{
+		jlong values[STATISTICS_ARRAY_LENGTH];
+		values[0] = (jlong)__atomic_load_n(&port->statistics.bytesRead, __ATOMIC_RELAXED);
+		values[1] = (jlong)__atomic_load_n(&port->statistics.bytesWritten, __ATOMIC_RELAXED);
+		values[2] = (jlong)__atomic_load_n(&port->statistics.readCalls, __ATOMIC_RELAXED);
+		values[3] = (jlong)__atomic_load_n(&port->statistics.writeCalls, __ATOMIC_RELAXED);
+		values[4] = (jlong)__atomic_load_n(&port->statistics.readSyscalls, __ATOMIC_RELAXED);
+		values[5] = (jlong)__atomic_load_n(&port->statistics.writeSyscalls, __ATOMIC_RELAXED);
+		values[6] = (jlong)__atomic_load_n(&port->statistics.shortReads, __ATOMIC_RELAXED);
+		values[7] = (jlong)__atomic_load_n(&port->statistics.readTimeouts, __ATOMIC_RELAXED);
+		values[8] = (jlong)__atomic_load_n(&port->statistics.writeRetries, __ATOMIC_RELAXED);
+		values[9] = (jlong)__atomic_load_n(&port->statistics.drainTimeNS, __ATOMIC_RELAXED);
+		values[10] = values[11] = values[12] = values[13] = -1;
+		for (int i = 0; i < STATISTICS_HISTOGRAM_BUCKETS; ++i)
+		{
+			values[14 + i] = (jlong)__atomic_load_n(port->statistics.readLatency + i, __ATOMIC_RELAXED);
+			values[14 + STATISTICS_HISTOGRAM_BUCKETS + i] = (jlong)__atomic_load_n(port->statistics.writeLatency + i, __ATOMIC_RELAXED);
+			values[17 + (2 * STATISTICS_HISTOGRAM_BUCKETS) + i] = (jlong)__atomic_load_n(port->statistics.rs485Turnaround + i, __ATOMIC_RELAXED);
+		}
+
+		// Report the software RS-485 turnaround counters only while software direction control is active
+		values[14 + (2 * STATISTICS_HISTOGRAM_BUCKETS)] = port->rs485SoftwareControl ? (jlong)__atomic_load_n(&port->statistics.rs485Transmissions, __ATOMIC_RELAXED) : -1;
+		values[15 + (2 * STATISTICS_HISTOGRAM_BUCKETS)] = port->rs485SoftwareControl ? (jlong)__atomic_load_n(&port->statistics.rs485TurnaroundNS, __ATOMIC_RELAXED) : -1;
+		values[16 + (2 * STATISTICS_HISTOGRAM_BUCKETS)] = port->rs485SoftwareControl ? (jlong)__atomic_load_n(&port->statistics.rs485MaxTurnaroundNS, __ATOMIC_RELAXED) : -1;
+
+		// Report the driver line error counters relative to the statistics baseline
+#if defined(__linux__)
+		struct serial_icounter_struct serialLineInterrupts;
+		if (port->statistics.lineErrorsSupported && !ioctl(port->handle, TIOCGICOUNT, &serialLineInterrupts))
+		{
+			values[10] = (jlong)(unsigned int)(serialLineInterrupts.frame - port->statistics.lineErrorBaseline[0]);
+			values[11] = (jlong)(unsigned int)(serialLineInterrupts.overrun - port->statistics.lineErrorBaseline[1]);
+			values[12] = (jlong)(unsigned int)(serialLineInterrupts.parity - port->statistics.lineErrorBaseline[2]);
+			values[13] = (jlong)(unsigned int)(serialLineInterrupts.buf_overrun - port->statistics.lineErrorBaseline[3]);
+		}
+#endif
+		(*env)->SetLongArrayRegion(env, statistics, 0, STATISTICS_ARRAY_LENGTH, values);
+		if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	}
+
+	// Reset the statistics if requested
+	if (reset)
+		resetStatistics(port);
+	return JNI_TRUE;
+}
+
+JNIEXPORT jlong JNICALL Java_com_fazecast_jSerialComm_SerialPort_getReceiveTimestamp(JNIEnv *env, jobject obj, jlong serialPortPointer, jboolean eventTimestamp)
+{
+	// Return the monotonic time at which the most recent event was detected or the first byte of the most recent read was received
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	return (jlong)(eventTimestamp ? port->eventTimestampNS : port->readTimestampNS);
+}
+
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_getFtdiDirectMode(JNIEnv *env, jobject obj, jlong serialPortPointer)
+{
+	// Direct FTDI driver access is only available on Windows
+	return JNI_FALSE;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_getThreadSchedulingStatus(JNIEnv *env, jobject obj, jlong serialPortPointer)
+{
+	// Return the scheduling settings that were successfully applied to every native thread of the port
+	return __atomic_load_n(&((serialPort*)(intptr_t)serialPortPointer)->threadSchedulingStatus, __ATOMIC_RELAXED);
+}
+
+JNIEXPORT jlong JNICALL Java_com_fazecast_jSerialComm_SerialPort_getNativeHandle(JNIEnv *env, jobject obj, jlong serialPortPointer)
+{
+	// Return the underlying file descriptor of the port
+	return (jlong)((serialPort*)(intptr_t)serialPortPointer)->handle;
+}
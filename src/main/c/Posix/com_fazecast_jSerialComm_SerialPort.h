@@ -75,6 +75,18 @@ extern "C" {
 #define com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_PARITY_ERROR 16777216L
 #undef com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_PORT_DISCONNECTED
 #define com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_PORT_DISCONNECTED 268435456L
+#undef com_fazecast_jSerialComm_SerialPort_LOW_LATENCY_DRIVER_FLAG
+#define com_fazecast_jSerialComm_SerialPort_LOW_LATENCY_DRIVER_FLAG 1L
+#undef com_fazecast_jSerialComm_SerialPort_LOW_LATENCY_DEVICE_TIMER
+#define com_fazecast_jSerialComm_SerialPort_LOW_LATENCY_DEVICE_TIMER 16L
+#undef com_fazecast_jSerialComm_SerialPort_LOW_LATENCY_INTER_BYTE_TIMEOUT
+#define com_fazecast_jSerialComm_SerialPort_LOW_LATENCY_INTER_BYTE_TIMEOUT 256L
+#undef com_fazecast_jSerialComm_SerialPort_THREAD_SCHEDULING_AFFINITY
+#define com_fazecast_jSerialComm_SerialPort_THREAD_SCHEDULING_AFFINITY 1L
+#undef com_fazecast_jSerialComm_SerialPort_THREAD_SCHEDULING_REAL_TIME
+#define com_fazecast_jSerialComm_SerialPort_THREAD_SCHEDULING_REAL_TIME 16L
+#undef com_fazecast_jSerialComm_SerialPort_THREAD_SCHEDULING_MMCSS
+#define com_fazecast_jSerialComm_SerialPort_THREAD_SCHEDULING_MMCSS 256L
 /*
  * Class:     com_fazecast_jSerialComm_SerialPort
  * Method:    getCommPorts
@@ -83,6 +95,14 @@ extern "C" {
 JNIEXPORT jobjectArray JNICALL Java_com_fazecast_jSerialComm_SerialPort_getCommPorts
   (JNIEnv *, jclass);
 
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    getCommPortsFiltered
+ * Signature: (Ljava/lang/String;IILjava/lang/String;)[Lcom/fazecast/jSerialComm/SerialPort;
+ */
+JNIEXPORT jobjectArray JNICALL Java_com_fazecast_jSerialComm_SerialPort_getCommPortsFiltered
+  (JNIEnv *, jclass, jstring, jint, jint, jstring);
+
 /*
  * Class:     com_fazecast_jSerialComm_SerialPort
  * Method:    initializeLibrary
@@ -118,10 +138,10 @@ JNIEXPORT jlong JNICALL Java_com_fazecast_jSerialComm_SerialPort_openPortNative
 /*
  * Class:     com_fazecast_jSerialComm_SerialPort
  * Method:    closePortNative
- * Signature: (J)J
+ * Signature: (JZ)J
  */
 JNIEXPORT jlong JNICALL Java_com_fazecast_jSerialComm_SerialPort_closePortNative
-  (JNIEnv *, jobject, jlong);
+  (JNIEnv *, jobject, jlong, jboolean);
 
 /*
  * Class:     com_fazecast_jSerialComm_SerialPort
@@ -139,6 +159,14 @@ JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_configPort
 JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_configTimeouts
   (JNIEnv *, jobject, jlong, jint, jint, jint, jint);
 
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    setFrameParameters
+ * Signature: (JIIII)Z
+ */
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_setFrameParameters
+  (JNIEnv *, jobject, jlong, jint, jint, jint, jint);
+
 /*
  * Class:     com_fazecast_jSerialComm_SerialPort
  * Method:    flushRxTxBuffers
@@ -179,6 +207,30 @@ JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_bytesAwaitingWri
 JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_readBytes
   (JNIEnv *, jobject, jlong, jbyteArray, jlong, jlong, jint, jint);
 
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    readBytesTimestamped
+ * Signature: (J[BJJII[J)I
+ */
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_readBytesTimestamped
+  (JNIEnv *, jobject, jlong, jbyteArray, jlong, jlong, jint, jint, jlongArray);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    readBytesDirect
+ * Signature: (JLjava/nio/ByteBuffer;JJII)I
+ */
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_readBytesDirect
+  (JNIEnv *, jobject, jlong, jobject, jlong, jlong, jint, jint);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    readBytesAhead
+ * Signature: (J[BJII)I
+ */
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_readBytesAhead
+  (JNIEnv *, jobject, jlong, jbyteArray, jlong, jint, jint);
+
 /*
  * Class:     com_fazecast_jSerialComm_SerialPort
  * Method:    writeBytes
@@ -187,6 +239,30 @@ JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_readBytes
 JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_writeBytes
   (JNIEnv *, jobject, jlong, jbyteArray, jlong, jlong, jint);
 
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    writeBytesDirect
+ * Signature: (JLjava/nio/ByteBuffer;JJI)I
+ */
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_writeBytesDirect
+  (JNIEnv *, jobject, jlong, jobject, jlong, jlong, jint);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    writeBytesGather
+ * Signature: (J[Ljava/nio/ByteBuffer;[[B[I[II)I
+ */
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_writeBytesGather
+  (JNIEnv *, jobject, jlong, jobjectArray, jobjectArray, jintArray, jintArray, jint);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    transact
+ * Signature: (J[BJ[BJIIII)I
+ */
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_transact
+  (JNIEnv *, jobject, jlong, jbyteArray, jlong, jbyteArray, jlong, jint, jint, jint, jint);
+
 /*
  * Class:     com_fazecast_jSerialComm_SerialPort
  * Method:    setEventListeningStatus
@@ -195,6 +271,54 @@ JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_writeBytes
 JNIEXPORT void JNICALL Java_com_fazecast_jSerialComm_SerialPort_setEventListeningStatus
   (JNIEnv *, jobject, jlong, jboolean);
 
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    setBackgroundReading
+ * Signature: (JI)Z
+ */
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_setBackgroundReading
+  (JNIEnv *, jobject, jlong, jint);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    setTransmitQueue
+ * Signature: (JIZ)Z
+ */
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_setTransmitQueue
+  (JNIEnv *, jobject, jlong, jint, jboolean);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    flushTransmitQueue
+ * Signature: (JIZ)Z
+ */
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_flushTransmitQueue
+  (JNIEnv *, jobject, jlong, jint, jboolean);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    setRecording
+ * Signature: (JLjava/lang/String;JZ)Z
+ */
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_setRecording
+  (JNIEnv *, jobject, jlong, jstring, jlong, jboolean);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    configLowLatency
+ * Signature: (JZ)I
+ */
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_configLowLatency
+  (JNIEnv *, jobject, jlong, jboolean);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    waitForPortListChange
+ * Signature: (II)I
+ */
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_waitForPortListChange
+  (JNIEnv *, jclass, jint, jint);
+
 /*
  * Class:     com_fazecast_jSerialComm_SerialPort
  * Method:    setBreak
@@ -323,6 +447,118 @@ JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_getRTS
 JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_getRI
   (JNIEnv *, jobject, jlong);
 
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    createEventEngine
+ * Signature: ()J
+ */
+JNIEXPORT jlong JNICALL Java_com_fazecast_jSerialComm_SerialPort_createEventEngine
+  (JNIEnv *, jclass);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    addToEventEngine
+ * Signature: (JJZ)Z
+ */
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_addToEventEngine
+  (JNIEnv *, jclass, jlong, jlong, jboolean);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    removeFromEventEngine
+ * Signature: (JJ)Z
+ */
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_removeFromEventEngine
+  (JNIEnv *, jclass, jlong, jlong);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    waitForEventEngine
+ * Signature: (J[J[II)I
+ */
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_waitForEventEngine
+  (JNIEnv *, jclass, jlong, jlongArray, jintArray, jint);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    createAsyncEngine
+ * Signature: ()J
+ */
+JNIEXPORT jlong JNICALL Java_com_fazecast_jSerialComm_SerialPort_createAsyncEngine
+  (JNIEnv *, jclass);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    startAsyncIO
+ * Signature: (JJZLjava/nio/ByteBuffer;[BII)J
+ */
+JNIEXPORT jlong JNICALL Java_com_fazecast_jSerialComm_SerialPort_startAsyncIO
+  (JNIEnv *, jclass, jlong, jlong, jboolean, jobject, jbyteArray, jint, jint);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    cancelAsyncIO
+ * Signature: (JJ)Z
+ */
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_cancelAsyncIO
+  (JNIEnv *, jclass, jlong, jlong);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    wakeAsyncEngine
+ * Signature: (J)V
+ */
+JNIEXPORT void JNICALL Java_com_fazecast_jSerialComm_SerialPort_wakeAsyncEngine
+  (JNIEnv *, jclass, jlong);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    waitForAsyncIO
+ * Signature: (J[J[II)I
+ */
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_waitForAsyncIO
+  (JNIEnv *, jclass, jlong, jlongArray, jintArray, jint);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    finishAsyncIO
+ * Signature: (JLjava/nio/ByteBuffer;[BI)I
+ */
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_finishAsyncIO
+  (JNIEnv *, jclass, jlong, jobject, jbyteArray, jint);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    readAvailable
+ * Signature: ([J[Ljava/nio/ByteBuffer;[[B[I[I[II)I
+ */
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_readAvailable
+  (JNIEnv *, jclass, jlongArray, jobjectArray, jobjectArray, jintArray, jintArray, jintArray, jint);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    setCurrentThreadScheduling
+ * Signature: (JIZ)I
+ */
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_setCurrentThreadScheduling
+  (JNIEnv *, jclass, jlong, jint, jboolean);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    findMessageBoundaries
+ * Signature: ([BI[B[I[I)I
+ */
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_findMessageBoundaries
+  (JNIEnv *, jclass, jbyteArray, jint, jbyteArray, jintArray, jintArray);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    readFrames
+ * Signature: (JIII[I[B[I)I
+ */
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_readFrames
+  (JNIEnv *, jobject, jlong, jint, jint, jint, jintArray, jbyteArray, jintArray);
+
 /*
  * Class:     com_fazecast_jSerialComm_SerialPort
  * Method:    getLastErrorLocation
@@ -339,6 +575,46 @@ JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_getLastErrorLoca
 JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_getLastErrorCode
   (JNIEnv *, jobject, jlong);
 
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    getStatistics
+ * Signature: (J[JZ)Z
+ */
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_getStatistics
+  (JNIEnv *, jobject, jlong, jlongArray, jboolean);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    getReceiveTimestamp
+ * Signature: (JZ)J
+ */
+JNIEXPORT jlong JNICALL Java_com_fazecast_jSerialComm_SerialPort_getReceiveTimestamp
+  (JNIEnv *, jobject, jlong, jboolean);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    getFtdiDirectMode
+ * Signature: (J)Z
+ */
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_getFtdiDirectMode
+  (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    getThreadSchedulingStatus
+ * Signature: (J)I
+ */
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_getThreadSchedulingStatus
+  (JNIEnv *, jobject, jlong);
+
+/*
+ * Class:     com_fazecast_jSerialComm_SerialPort
+ * Method:    getNativeHandle
+ * Signature: (J)J
+ */
+JNIEXPORT jlong JNICALL Java_com_fazecast_jSerialComm_SerialPort_getNativeHandle
+  (JNIEnv *, jobject, jlong);
+
 #ifdef __cplusplus
 }
 #endif
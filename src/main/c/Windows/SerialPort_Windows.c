@@ -36,6 +36,8 @@
 #include <ntddser.h>
 #include <stdlib.h>
 #include <string.h>
+#include <wctype.h>
+#include <mmsystem.h>
 #include <setupapi.h>
 #include <devpkey.h>
 #include <devguid.h>
@@ -65,22 +67,100 @@ jfieldID sendDeviceQueueSizeField;
 jfieldID receiveDeviceQueueSizeField;
 jfieldID requestElevatedPermissionsField;
 jfieldID rs485ModeField;
+jfieldID rs485ActiveHighField;
+jfieldID rs485RxDuringTxField;
 jfieldID rs485DelayBeforeField;
 jfieldID rs485DelayAfterField;
+jfieldID rs485SoftwareControlField;
 jfieldID xonStartCharField;
 jfieldID xoffStopCharField;
 jfieldID timeoutModeField;
 jfieldID readTimeoutField;
 jfieldID writeTimeoutField;
 jfieldID eventFlagsField;
+jfieldID lowLatencyModeField;
+jfieldID interByteTimeoutField;
+jfieldID ftdiDirectModeField;
+jfieldID ftdiTransferSizeField;
+jfieldID threadAffinityMaskField;
+jfieldID threadPriorityField;
+
+// Maximum number of ready ports returned by a single event engine wait
+#define MAX_EVENT_ENGINE_EVENTS 64
+
+// Longest time to wait for a D2XX driver notification before re-checking the device status
+#define FTDI_STATUS_POLL_INTERVAL_MS 10
+
+// Longest time the background ring buffer reader blocks in the standard driver waiting for data before re-checking the line status
+#define RING_READER_TIMEOUT_MS 100
+
+// Software RS-485 timing: a high-resolution waitable timer wakes up within tens of microseconds, so spin instead of sleeping within
+//   the first interval of a deadline, or within the second when only a standard timer running at a 1 ms system timer period is
+//   available, keep polling for an empty transmit queue without sleeping for this long past its expected end, then poll once per
+//   interval until giving up on a transmit queue that never empties
+#define PRECISE_WAIT_SPIN_NS 100000LL
+#define COARSE_WAIT_SPIN_NS 2000000LL
+#define TRANSMITTER_SPIN_NS 2000000LL
+#define TRANSMITTER_POLL_INTERVAL_NS 100000LL
+#define TRANSMITTER_TIMEOUT_NS 1000000000LL
+#ifndef CREATE_WAITABLE_TIMER_HIGH_RESOLUTION
+#define CREATE_WAITABLE_TIMER_HIGH_RESOLUTION 0x00000002
+#endif
+
+// Line status bits reported in the second byte of the D2XX modem status
+#define FTDI_LINE_OVERRUN_ERROR 0x0200
+#define FTDI_LINE_PARITY_ERROR 0x0400
+#define FTDI_LINE_FRAMING_ERROR 0x0800
+#define FTDI_LINE_BREAK_INTERRUPT 0x1000
 
 // Runtime-loadable DLL functions
 typedef int (__stdcall *FT_CreateDeviceInfoListFunction)(LPDWORD);
 typedef int (__stdcall *FT_GetDeviceInfoListFunction)(FT_DEVICE_LIST_INFO_NODE*, LPDWORD);
-
-// List of available serial ports
+typedef int (__stdcall *FT_OpenExFunction)(PVOID, DWORD, FT_HANDLE*);
+typedef int (__stdcall *FT_HandleFunction)(FT_HANDLE);
+typedef int (__stdcall *FT_TransferFunction)(FT_HANDLE, LPVOID, DWORD, LPDWORD);
+typedef int (__stdcall *FT_ULongFunction)(FT_HANDLE, ULONG);
+typedef int (__stdcall *FT_ULongPairFunction)(FT_HANDLE, ULONG, ULONG);
+typedef int (__stdcall *FT_SetDataCharacteristicsFunction)(FT_HANDLE, UCHAR, UCHAR, UCHAR);
+typedef int (__stdcall *FT_SetFlowControlFunction)(FT_HANDLE, USHORT, UCHAR, UCHAR);
+typedef int (__stdcall *FT_SetLatencyTimerFunction)(FT_HANDLE, UCHAR);
+typedef int (__stdcall *FT_SetEventNotificationFunction)(FT_HANDLE, DWORD, PVOID);
+typedef int (__stdcall *FT_GetModemStatusFunction)(FT_HANDLE, ULONG*);
+typedef int (__stdcall *FT_GetStatusFunction)(FT_HANDLE, DWORD*, DWORD*, DWORD*);
+
+// FTDI D2XX driver functions used for direct port access, loaded upon first use and kept until the library is uninitialized
+typedef struct ftdiDriverFunctions
+{
+	HINSTANCE library;
+	FT_CreateDeviceInfoListFunction CreateDeviceInfoList;
+	FT_GetDeviceInfoListFunction GetDeviceInfoList;
+	FT_OpenExFunction OpenEx;
+	FT_HandleFunction Close, SetDtr, ClrDtr, SetRts, ClrRts, SetBreakOn, SetBreakOff;
+	FT_TransferFunction Read, Write;
+	FT_ULongFunction SetBaudRate, Purge;
+	FT_ULongPairFunction SetTimeouts, SetUSBParameters;
+	FT_SetDataCharacteristicsFunction SetDataCharacteristics;
+	FT_SetFlowControlFunction SetFlowControl;
+	FT_SetLatencyTimerFunction SetLatencyTimer;
+	FT_SetEventNotificationFunction SetEventNotification;
+	FT_GetModemStatusFunction GetModemStatus;
+	FT_GetStatusFunction GetStatus;
+} ftdiDriverFunctions;
+ftdiDriverFunctions ftdiDriver = { 0 };
+
+// List of available serial ports, guarded by its own lock so that ports can be enumerated, opened, and closed concurrently
 char portsEnumerated = 0;
 serialPortVector serialPorts = { NULL, 0, 0 };
+SRWLOCK serialPortsLock = SRWLOCK_INIT;
+
+// Hotplug-driven port listing cache
+char hotplugMonitorStatus = 0;
+volatile LONG portListingGeneration = 0;
+LONG enumeratedGeneration = 0;
+HANDLE hotplugEvent = NULL;
+
+// Performance statistics clock
+LARGE_INTEGER performanceFrequency = { 0 };
 
 // JNI exception handler
 char jniErrorMessage[64] = { 0 };
@@ -99,15 +179,872 @@ static inline jboolean checkJniError(JNIEnv *env, int lineNumber)
 	return JNI_FALSE;
 }
 
-// Generalized port enumeration function
-static void enumeratePorts(void)
+// Reusable asynchronous I/O structure functions
+static BOOL createOverlappedEvents(serialPort *port)
 {
-	// Reset the enumerated flag on all non-open serial ports
-	for (int i = 0; i < serialPorts.length; ++i)
-		serialPorts.ports[i]->enumerated = (serialPorts.ports[i]->handle != INVALID_HANDLE_VALUE);
+	// Set the low-order bit of each event handle so that synchronous completions are never queued to an event engine completion port
+	memset(&port->readOverlapped, 0, sizeof(OVERLAPPED));
+	memset(&port->writeOverlapped, 0, sizeof(OVERLAPPED));
+	memset(&port->eventOverlapped, 0, sizeof(OVERLAPPED));
+	memset(&port->engineOverlapped, 0, sizeof(OVERLAPPED));
+	memset(&port->ringOverlapped, 0, sizeof(OVERLAPPED));
+	memset(&port->txOverlapped, 0, sizeof(OVERLAPPED));
+	port->ringDataEvent = port->ringSpaceEvent = NULL;
+	HANDLE readEvent = CreateEvent(NULL, TRUE, FALSE, NULL), writeEvent = CreateEvent(NULL, TRUE, FALSE, NULL), eventEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+	if (!readEvent || !writeEvent || !eventEvent)
+	{
+		port->errorLineNumber = lastErrorLineNumber = __LINE__ - 3;
+		port->errorNumber = lastErrorNumber = GetLastError();
+		if (readEvent)
+			CloseHandle(readEvent);
+		if (writeEvent)
+			CloseHandle(writeEvent);
+		if (eventEvent)
+			CloseHandle(eventEvent);
+		return FALSE;
+	}
+	port->readOverlapped.hEvent = (HANDLE)((ULONG_PTR)readEvent | 1);
+	port->writeOverlapped.hEvent = (HANDLE)((ULONG_PTR)writeEvent | 1);
+	port->eventOverlapped.hEvent = (HANDLE)((ULONG_PTR)eventEvent | 1);
+
+	// Create the event used to release any thread waiting for port events when listening stops, falling back to periodic checks if unavailable
+	port->listenerWakeEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+	return TRUE;
+}
+
+static void destroyOverlappedEvents(serialPort *port)
+{
+	if (port->readOverlapped.hEvent)
+		CloseHandle((HANDLE)((ULONG_PTR)port->readOverlapped.hEvent & ~(ULONG_PTR)1));
+	if (port->writeOverlapped.hEvent)
+		CloseHandle((HANDLE)((ULONG_PTR)port->writeOverlapped.hEvent & ~(ULONG_PTR)1));
+	if (port->eventOverlapped.hEvent)
+		CloseHandle((HANDLE)((ULONG_PTR)port->eventOverlapped.hEvent & ~(ULONG_PTR)1));
+	if (port->ringOverlapped.hEvent)
+		CloseHandle((HANDLE)((ULONG_PTR)port->ringOverlapped.hEvent & ~(ULONG_PTR)1));
+	if (port->txOverlapped.hEvent)
+		CloseHandle((HANDLE)((ULONG_PTR)port->txOverlapped.hEvent & ~(ULONG_PTR)1));
+	if (port->ringDataEvent)
+		CloseHandle(port->ringDataEvent);
+	if (port->ringSpaceEvent)
+		CloseHandle(port->ringSpaceEvent);
+	if (port->listenerWakeEvent)
+		CloseHandle(port->listenerWakeEvent);
+	port->readOverlapped.hEvent = port->writeOverlapped.hEvent = port->eventOverlapped.hEvent = port->ringOverlapped.hEvent = port->txOverlapped.hEvent = port->ringDataEvent = port->ringSpaceEvent = port->listenerWakeEvent = NULL;
+}
+
+static inline OVERLAPPED* resetOverlapped(OVERLAPPED *overlappedStruct)
+{
+	// Clear the results of any previous operation while retaining the event handle
+	HANDLE completionEvent = overlappedStruct->hEvent;
+	memset(overlappedStruct, 0, sizeof(OVERLAPPED));
+	overlappedStruct->hEvent = completionEvent;
+	return overlappedStruct;
+}
+
+// Performance statistics functions
+static inline BOOL isPortOpen(serialPort *port)
+{
+	// A port is open if either the standard driver or the D2XX driver owns it
+	return (port->handle != INVALID_HANDLE_VALUE) || port->ftdiHandle;
+}
+
+static inline LONGLONG getPerformanceCounter(void)
+{
+	LARGE_INTEGER currentTime;
+	QueryPerformanceCounter(&currentTime);
+	return currentTime.QuadPart;
+}
+
+static inline LONGLONG getMonotonicTimeUS(void)
+{
+	// Split the conversion to avoid overflowing the intermediate product
+	LONGLONG currentTime = getPerformanceCounter();
+	return ((currentTime / performanceFrequency.QuadPart) * 1000000LL) + (((currentTime % performanceFrequency.QuadPart) * 1000000LL) / performanceFrequency.QuadPart);
+}
+
+static inline LONGLONG getNanoseconds(LONGLONG counterValue)
+{
+	// Split the conversion to avoid overflowing the intermediate product
+	if (!performanceFrequency.QuadPart)
+		return 0;
+	return ((counterValue / performanceFrequency.QuadPart) * 1000000000LL) + (((counterValue % performanceFrequency.QuadPart) * 1000000000LL) / performanceFrequency.QuadPart);
+}
+
+static inline LONGLONG getMonotonicTimeNS(void)
+{
+	return getNanoseconds(getPerformanceCounter());
+}
+
+static inline void addStatistic(volatile LONGLONG *counter, LONGLONG amount)
+{
+	InterlockedExchangeAdd64(counter, amount);
+}
+
+static void recordHistogram(volatile LONGLONG *histogram, LONGLONG elapsedNS)
+{
+	// Place the elapsed time into a logarithmic microsecond bucket
+	int bucket = 0;
+	ULONGLONG elapsedUS = (ULONGLONG)elapsedNS / 1000ULL;
+	while ((elapsedUS >>= 1) && (bucket < (STATISTICS_HISTOGRAM_BUCKETS - 1)))
+		++bucket;
+	addStatistic(histogram + bucket, 1);
+}
+
+static inline void recordLatency(volatile LONGLONG *histogram, LONGLONG startTime)
+{
+	recordHistogram(histogram, getNanoseconds(getPerformanceCounter() - startTime));
+}
+
+static void resetStatistics(serialPort *port)
+{
+	// Clear each counter atomically since background threads may be updating them
+	volatile LONGLONG *counters[] = { &port->statistics.bytesRead, &port->statistics.bytesWritten, &port->statistics.readCalls, &port->statistics.writeCalls,
+			&port->statistics.readSyscalls, &port->statistics.writeSyscalls, &port->statistics.shortReads, &port->statistics.readTimeouts, &port->statistics.writeRetries,
+			&port->statistics.drainTimeNS, &port->statistics.rs485Transmissions, &port->statistics.rs485TurnaroundNS, &port->statistics.rs485MaxTurnaroundNS };
+	for (size_t i = 0; i < (sizeof(counters) / sizeof(counters[0])); ++i)
+		InterlockedExchange64(counters[i], 0);
+	for (int i = 0; i < STATISTICS_HISTOGRAM_BUCKETS; ++i)
+	{
+		InterlockedExchange64(port->statistics.readLatency + i, 0);
+		InterlockedExchange64(port->statistics.writeLatency + i, 0);
+		InterlockedExchange64(port->statistics.rs485Turnaround + i, 0);
+	}
+}
+
+// Traffic recording functions
+static inline void recordTraffic(serialPort *port, unsigned short direction, LONGLONG timestamp, const char *data, DWORD length)
+{
+	// Only take the lock when a recording is active and interested in this direction
+	if (port->recordingEnabled && length && ((direction == RECORDING_DIRECTION_RECEIVED) || port->recordTransmitted))
+	{
+		EnterCriticalSection(&port->recordingLock);
+		if (port->recording)
+			appendRecording(port->recording, direction, getNanoseconds(timestamp ? timestamp : getPerformanceCounter()), data, (int)length);
+		LeaveCriticalSection(&port->recordingLock);
+	}
+}
+
+static void stopRecording(serialPort *port)
+{
+	// Unmap the recording file, leaving the system to write out any remaining dirty pages
+	EnterCriticalSection(&port->recordingLock);
+	port->recordingEnabled = 0;
+	if (port->recording)
+	{
+		UnmapViewOfFile(port->recording);
+		CloseHandle(port->recordingMapping);
+		port->recording = NULL;
+		port->recordingMapping = NULL;
+	}
+	LeaveCriticalSection(&port->recordingLock);
+}
+
+// FTDI D2XX direct access functionality
+static BOOL ftdiSucceeded(int status)
+{
+	// Translate D2XX status codes into the closest system error codes so that all port errors are reported consistently
+	switch (status)
+	{
+		case FT_OK:
+			return TRUE;
+		case FT_INVALID_HANDLE:
+			SetLastError(ERROR_INVALID_HANDLE);
+			break;
+		case FT_DEVICE_NOT_FOUND:
+		case FT_DEVICE_NOT_OPENED:
+			SetLastError(ERROR_DEVICE_NOT_CONNECTED);
+			break;
+		case FT_IO_ERROR:
+			SetLastError(ERROR_IO_DEVICE);
+			break;
+		case FT_INSUFFICIENT_RESOURCES:
+			SetLastError(ERROR_NOT_ENOUGH_MEMORY);
+			break;
+		case FT_INVALID_PARAMETER:
+		case FT_INVALID_BAUD_RATE:
+		case FT_INVALID_ARGS:
+			SetLastError(ERROR_INVALID_PARAMETER);
+			break;
+		case FT_NOT_SUPPORTED:
+			SetLastError(ERROR_NOT_SUPPORTED);
+			break;
+		default:
+			SetLastError(ERROR_GEN_FAILURE);
+			break;
+	}
+	return FALSE;
+}
+
+static BOOL loadFtdiDriver(void)
+{
+	// Load the D2XX library and all required functions upon first use (must be called with the serial port listing locked)
+	if (ftdiDriver.library)
+		return TRUE;
+	HINSTANCE library = LoadLibrary(TEXT("ftd2xx.dll"));
+	if (!library)
+		return FALSE;
+	ftdiDriver.CreateDeviceInfoList = (FT_CreateDeviceInfoListFunction)GetProcAddress(library, "FT_CreateDeviceInfoList");
+	ftdiDriver.GetDeviceInfoList = (FT_GetDeviceInfoListFunction)GetProcAddress(library, "FT_GetDeviceInfoList");
+	ftdiDriver.OpenEx = (FT_OpenExFunction)GetProcAddress(library, "FT_OpenEx");
+	ftdiDriver.Close = (FT_HandleFunction)GetProcAddress(library, "FT_Close");
+	ftdiDriver.SetDtr = (FT_HandleFunction)GetProcAddress(library, "FT_SetDtr");
+	ftdiDriver.ClrDtr = (FT_HandleFunction)GetProcAddress(library, "FT_ClrDtr");
+	ftdiDriver.SetRts = (FT_HandleFunction)GetProcAddress(library, "FT_SetRts");
+	ftdiDriver.ClrRts = (FT_HandleFunction)GetProcAddress(library, "FT_ClrRts");
+	ftdiDriver.SetBreakOn = (FT_HandleFunction)GetProcAddress(library, "FT_SetBreakOn");
+	ftdiDriver.SetBreakOff = (FT_HandleFunction)GetProcAddress(library, "FT_SetBreakOff");
+	ftdiDriver.Read = (FT_TransferFunction)GetProcAddress(library, "FT_Read");
+	ftdiDriver.Write = (FT_TransferFunction)GetProcAddress(library, "FT_Write");
+	ftdiDriver.SetBaudRate = (FT_ULongFunction)GetProcAddress(library, "FT_SetBaudRate");
+	ftdiDriver.Purge = (FT_ULongFunction)GetProcAddress(library, "FT_Purge");
+	ftdiDriver.SetTimeouts = (FT_ULongPairFunction)GetProcAddress(library, "FT_SetTimeouts");
+	ftdiDriver.SetUSBParameters = (FT_ULongPairFunction)GetProcAddress(library, "FT_SetUSBParameters");
+	ftdiDriver.SetDataCharacteristics = (FT_SetDataCharacteristicsFunction)GetProcAddress(library, "FT_SetDataCharacteristics");
+	ftdiDriver.SetFlowControl = (FT_SetFlowControlFunction)GetProcAddress(library, "FT_SetFlowControl");
+	ftdiDriver.SetLatencyTimer = (FT_SetLatencyTimerFunction)GetProcAddress(library, "FT_SetLatencyTimer");
+	ftdiDriver.SetEventNotification = (FT_SetEventNotificationFunction)GetProcAddress(library, "FT_SetEventNotification");
+	ftdiDriver.GetModemStatus = (FT_GetModemStatusFunction)GetProcAddress(library, "FT_GetModemStatus");
+	ftdiDriver.GetStatus = (FT_GetStatusFunction)GetProcAddress(library, "FT_GetStatus");
+
+	// Only use the library if it provides every function needed for direct access
+	if (!ftdiDriver.CreateDeviceInfoList || !ftdiDriver.GetDeviceInfoList || !ftdiDriver.OpenEx || !ftdiDriver.Close || !ftdiDriver.SetDtr || !ftdiDriver.ClrDtr ||
+			!ftdiDriver.SetRts || !ftdiDriver.ClrRts || !ftdiDriver.SetBreakOn || !ftdiDriver.SetBreakOff || !ftdiDriver.Read || !ftdiDriver.Write ||
+			!ftdiDriver.SetBaudRate || !ftdiDriver.Purge || !ftdiDriver.SetTimeouts || !ftdiDriver.SetUSBParameters || !ftdiDriver.SetDataCharacteristics ||
+			!ftdiDriver.SetFlowControl || !ftdiDriver.SetLatencyTimer || !ftdiDriver.SetEventNotification || !ftdiDriver.GetModemStatus || !ftdiDriver.GetStatus)
+	{
+		memset(&ftdiDriver, 0, sizeof(ftdiDriver));
+		FreeLibrary(library);
+		return FALSE;
+	}
+	ftdiDriver.library = library;
+	return TRUE;
+}
+
+static BOOL findFtdiSerialNumber(serialPort *port)
+{
+	// Search the D2XX device list for the device whose virtual COM port corresponds to this port
+	DWORD numDevs = 0;
+	BOOL found = FALSE;
+	wchar_t comPort[128];
+	if ((ftdiDriver.CreateDeviceInfoList(&numDevs) != FT_OK) || !numDevs)
+		return FALSE;
+	FT_DEVICE_LIST_INFO_NODE *devInfo = (FT_DEVICE_LIST_INFO_NODE*)malloc(sizeof(FT_DEVICE_LIST_INFO_NODE)*numDevs);
+	if (devInfo && (ftdiDriver.GetDeviceInfoList(devInfo, &numDevs) == FT_OK))
+		for (DWORD i = 0; !found && (i < numDevs); ++i)
+			if (strlen(devInfo[i].SerialNumber) && getPortPathFromSerial(comPort, devInfo[i].SerialNumber) && (wcscmp(port->portPath + 4, comPort) == 0))
+			{
+				memcpy(port->serialNumber, devInfo[i].SerialNumber, sizeof(port->serialNumber));
+				found = TRUE;
+			}
+	free(devInfo);
+	return found;
+}
+
+static VOID CALLBACK ftdiEventSignaled(PVOID serialPortPointer, BOOLEAN timedOut)
+{
+	// Fan the single D2XX notification out to every type of waiter so that no waiter can consume a wakeup meant for another
+	serialPort *port = (serialPort*)serialPortPointer;
+	SetEvent(port->ftdiReadEvent);
+	SetEvent(port->ftdiListenerEvent);
+	SetEvent(port->ftdiRingEvent);
+}
+
+static void closeFtdiEvents(serialPort *port)
+{
+	// Wait for any in-progress notification callback before releasing the notification and waiter events
+	if (port->ftdiWait)
+		UnregisterWaitEx(port->ftdiWait, INVALID_HANDLE_VALUE);
+	if (port->ftdiEvent)
+		CloseHandle(port->ftdiEvent);
+	if (port->ftdiReadEvent)
+		CloseHandle(port->ftdiReadEvent);
+	if (port->ftdiListenerEvent)
+		CloseHandle(port->ftdiListenerEvent);
+	if (port->ftdiRingEvent)
+		CloseHandle(port->ftdiRingEvent);
+	port->ftdiWait = port->ftdiEvent = port->ftdiReadEvent = port->ftdiListenerEvent = port->ftdiRingEvent = NULL;
+}
+
+static BOOL openFtdiEvents(serialPort *port)
+{
+	// Create the auto-reset driver notification event along with a separate auto-reset event for each type of waiter
+	port->ftdiEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+	port->ftdiReadEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+	port->ftdiListenerEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+	port->ftdiRingEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+	if (!port->ftdiEvent || !port->ftdiReadEvent || !port->ftdiListenerEvent || !port->ftdiRingEvent ||
+			!RegisterWaitForSingleObject(&port->ftdiWait, port->ftdiEvent, ftdiEventSignaled, port, INFINITE, WT_EXECUTEDEFAULT))
+	{
+		port->ftdiWait = NULL;
+		closeFtdiEvents(port);
+		return FALSE;
+	}
+	return TRUE;
+}
+
+static BOOL openFtdiPort(serialPort *port, DWORD usbTransferSize, BOOL lowLatencyMode)
+{
+	// Identify the FTDI device behind this port if that did not already happen during enumeration (failures are not errors, since the standard driver is used instead)
+	if (!port->serialNumber[0] && !findFtdiSerialNumber(port))
+		return FALSE;
+
+	// Open the device by its serial number along with the events that the driver will signal upon received data or status changes
+	FT_HANDLE ftdiHandle = NULL;
+	if (!openFtdiEvents(port))
+		return FALSE;
+	if (!ftdiSucceeded(ftdiDriver.OpenEx(port->serialNumber, FT_OPEN_BY_SERIAL_NUMBER, &ftdiHandle)))
+	{
+		closeFtdiEvents(port);
+		return FALSE;
+	}
+
+	// Apply the requested USB transfer size and latency timer directly, then enable driver event notifications
+	if ((usbTransferSize && !ftdiSucceeded(ftdiDriver.SetUSBParameters(ftdiHandle, usbTransferSize, usbTransferSize))) ||
+			(lowLatencyMode && !ftdiSucceeded(ftdiDriver.SetLatencyTimer(ftdiHandle, 2))) ||
+			!ftdiSucceeded(ftdiDriver.SetEventNotification(ftdiHandle, FT_EVENT_RXCHAR | FT_EVENT_MODEM_STATUS | FT_EVENT_LINE_STATUS, port->ftdiEvent)))
+	{
+		ftdiDriver.Close(ftdiHandle);
+		closeFtdiEvents(port);
+		return FALSE;
+	}
+
+	// The port handle remains invalid while the D2XX driver owns the port so that any unrouted system call fails harmlessly
+	ULONG modemStatus = 0;
+	ftdiDriver.GetModemStatus(ftdiHandle, &modemStatus);
+	port->ftdiModemStatus = modemStatus & (MS_CTS_ON | MS_DSR_ON | MS_RING_ON | MS_RLSD_ON);
+	port->ftdiReceivedBytes = 0;
+	port->ftdiTxPending = 0;
+	port->ftdiHandle = ftdiHandle;
+	return TRUE;
+}
+
+static BOOL closeFtdiPort(serialPort *port)
+{
+	// Wake any waiting threads before releasing the driver handle and its notification events
+	SetEvent(port->ftdiReadEvent);
+	SetEvent(port->ftdiListenerEvent);
+	SetEvent(port->ftdiRingEvent);
+	BOOL result = ftdiSucceeded(ftdiDriver.Close(port->ftdiHandle));
+	DWORD errorNumber = GetLastError();
+	closeFtdiEvents(port);
+	SetLastError(errorNumber);
+	return result;
+}
+
+static BOOL getDeviceStatus(serialPort *port, DWORD *errorMask, DWORD *numBytesQueuedIn, DWORD *numBytesQueuedOut)
+{
+	// Retrieve the driver queue levels and any pending line errors from whichever driver owns the port
+	if (port->ftdiHandle)
+	{
+		DWORD eventStatus = 0;
+		ULONG lineStatus = 0;
+		if (!ftdiSucceeded(ftdiDriver.GetStatus(port->ftdiHandle, numBytesQueuedIn, numBytesQueuedOut, &eventStatus)) ||
+				(errorMask && !ftdiSucceeded(ftdiDriver.GetModemStatus(port->ftdiHandle, &lineStatus))))
+			return FALSE;
+		if (errorMask)
+			*errorMask = ((lineStatus & FTDI_LINE_OVERRUN_ERROR) ? CE_OVERRUN : 0) | ((lineStatus & FTDI_LINE_PARITY_ERROR) ? CE_RXPARITY : 0) |
+					((lineStatus & FTDI_LINE_FRAMING_ERROR) ? CE_FRAME : 0) | ((lineStatus & FTDI_LINE_BREAK_INTERRUPT) ? CE_BREAK : 0);
+		return TRUE;
+	}
+	COMSTAT commInfo;
+	memset(&commInfo, 0, sizeof(COMSTAT));
+	if (!ClearCommError(port->handle, errorMask, &commInfo))
+		return FALSE;
+	*numBytesQueuedIn = commInfo.cbInQue;
+	*numBytesQueuedOut = commInfo.cbOutQue;
+	return TRUE;
+}
+
+static BOOL getModemStatus(serialPort *port, DWORD *modemStatus)
+{
+	// The low byte of the D2XX modem status uses the same bit layout as the system modem status
+	ULONG ftdiModemStatus = 0;
+	if (!port->ftdiHandle)
+		return GetCommModemStatus(port->handle, modemStatus);
+	else if (!ftdiSucceeded(ftdiDriver.GetModemStatus(port->ftdiHandle, &ftdiModemStatus)))
+		return FALSE;
+	*modemStatus = ftdiModemStatus & (MS_CTS_ON | MS_DSR_ON | MS_RING_ON | MS_RLSD_ON);
+	return TRUE;
+}
+
+static BOOL purgeDevice(serialPort *port, DWORD purgeFlags)
+{
+	// Discard buffered data in whichever driver owns the port
+	if (!port->ftdiHandle)
+		return PurgeComm(port->handle, purgeFlags);
+	return ftdiSucceeded(ftdiDriver.Purge(port->ftdiHandle, ((purgeFlags & PURGE_RXCLEAR) ? FT_PURGE_RX : 0) | ((purgeFlags & PURGE_TXCLEAR) ? FT_PURGE_TX : 0)));
+}
+
+static BOOL drainDevice(serialPort *port, LONGLONG deadlineNS)
+{
+	// Neither the D2XX driver nor a bounded drain can block in the driver, so wait for the transmit queue to empty instead
+	DWORD errorMask = 0, numBytesQueuedIn = 0, numBytesQueuedOut = 0;
+	if (!port->ftdiHandle && (deadlineNS < 0))
+		return FlushFileBuffers(port->handle);
+	while (getDeviceStatus(port, &errorMask, &numBytesQueuedIn, &numBytesQueuedOut))
+	{
+		// Retain any line errors reported while polling, and sleep for roughly the time needed to transmit the remaining data
+		if (errorMask)
+			InterlockedOr(&port->ringErrorMask, (LONG)errorMask);
+		if (!numBytesQueuedOut)
+			return TRUE;
+		LONGLONG currentTimeNS = getMonotonicTimeNS(), waitTimeNS = numBytesQueuedOut * port->characterTimeNS;
+		if ((deadlineNS >= 0) && (currentTimeNS >= deadlineNS))
+		{
+			SetLastError(ERROR_TIMEOUT);
+			return FALSE;
+		}
+		if ((deadlineNS >= 0) && (waitTimeNS > (deadlineNS - currentTimeNS)))
+			waitTimeNS = deadlineNS - currentTimeNS;
+		Sleep((waitTimeNS > 1000000LL) ? (DWORD)(waitTimeNS / 1000000LL) : 1);
+	}
+	return FALSE;
+}
+
+static BOOL applyPortTimeouts(serialPort *port)
+{
+	// Apply the configured timeouts, except that the background reader needs reads to return as soon as any data has arrived or a short timeout expires
+	COMMTIMEOUTS timeouts = port->configuredTimeouts;
+	if (port->ringBufferEnabled)
+	{
+		timeouts.ReadIntervalTimeout = MAXDWORD;
+		timeouts.ReadTotalTimeoutMultiplier = MAXDWORD;
+		timeouts.ReadTotalTimeoutConstant = RING_READER_TIMEOUT_MS;
+	}
+	return SetCommTimeouts(port->handle, &timeouts);
+}
+
+// Ring buffer consumer functionality, noting that only the consumer may ever advance the tail
+static void discardRingBuffer(serialPort *port)
+{
+	// Ask the consumer to skip everything received up to now, leaving any data that arrives afterward intact
+	InterlockedExchange(&port->ringDiscardHead, InterlockedCompareExchange(&port->ringHead, 0, 0));
+	InterlockedExchange(&port->ringDiscardPending, 1);
+}
+
+static LONG peekRingTail(serialPort *port)
+{
+	// Return the tail as it will be once the consumer has applied any pending discard
+	LONG tail = InterlockedCompareExchange(&port->ringTail, 0, 0);
+	if (InterlockedCompareExchange(&port->ringDiscardPending, 0, 0))
+	{
+		LONG discardHead = InterlockedCompareExchange(&port->ringDiscardHead, 0, 0);
+		if ((LONG)(discardHead - tail) > 0)
+			tail = discardHead;
+	}
+	return tail;
+}
+
+static void advanceRingTail(serialPort *port, LONG tail)
+{
+	// Publish the new tail and wake the background reader only if it is waiting for room in the ring buffer
+	InterlockedExchange(&port->ringTail, tail);
+	if (InterlockedCompareExchange(&port->ringSpaceWaiting, 0, 0))
+		SetEvent(port->ringSpaceEvent);
+}
+
+static LONG consumeRingDiscard(serialPort *port)
+{
+	// Apply any discard requested by another thread, returning the resulting tail
+	LONG tail = port->ringTail;
+	if (InterlockedExchange(&port->ringDiscardPending, 0))
+	{
+		LONG discardHead = InterlockedCompareExchange(&port->ringDiscardHead, 0, 0);
+		if ((LONG)(discardHead - tail) > 0)
+		{
+			tail = discardHead;
+			advanceRingTail(port, tail);
+		}
+	}
+	return tail;
+}
+
+// Software RS-485 direction control functionality
+static void setCharacterTime(serialPort *port, int baudRate, int byteSize, int stopBits, int parity)
+{
+	// Calculate the time needed to transmit a single character, counting in half bits to account for 1.5 stop bits
+	int numHalfBits = (2 * (1 + byteSize + ((parity != com_fazecast_jSerialComm_SerialPort_NO_PARITY) ? 1 : 0))) +
+			((stopBits == com_fazecast_jSerialComm_SerialPort_TWO_STOP_BITS) ? 4 : (stopBits == com_fazecast_jSerialComm_SerialPort_ONE_POINT_FIVE_STOP_BITS) ? 3 : 2);
+	port->characterTimeNS = (baudRate > 0) ? ((numHalfBits * 500000000LL) / baudRate) : 0;
+}
+
+static void setRs485Timing(serialPort *port, BOOL enabled)
+{
+	// Prefer a high-resolution waitable timer (Windows 10 1803 and later), otherwise raise the system timer period to 1 ms for as long as software control is enabled
+	if (enabled && !port->rs485TimingEnabled)
+	{
+		port->rs485TimingEnabled = 1;
+		port->rs485Timer = CreateWaitableTimerExW(NULL, NULL, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
+		port->rs485PreciseTimer = (port->rs485Timer != NULL);
+		if (!port->rs485PreciseTimer)
+		{
+			port->rs485Timer = CreateWaitableTimerExW(NULL, NULL, 0, TIMER_ALL_ACCESS);
+			port->rs485TimerPeriodRaised = (timeBeginPeriod(1) == TIMERR_NOERROR);
+		}
+	}
+	else if (!enabled && port->rs485TimingEnabled)
+	{
+		if (port->rs485TimerPeriodRaised)
+			timeEndPeriod(1);
+		if (port->rs485Timer)
+			CloseHandle(port->rs485Timer);
+		port->rs485Timer = NULL;
+		port->rs485TimingEnabled = port->rs485PreciseTimer = port->rs485TimerPeriodRaised = 0;
+	}
+}
+
+static void sleepUntil(serialPort *port, LONGLONG deadlineNS)
+{
+	// Block on the port's waitable timer, falling back to a millisecond sleep if it could not be created or armed
+	LARGE_INTEGER dueTime;
+	LONGLONG remainingNS = deadlineNS - getMonotonicTimeNS();
+	if (remainingNS <= 0)
+		return;
+	dueTime.QuadPart = -((remainingNS + 99) / 100);
+	if (port->rs485Timer && SetWaitableTimer(port->rs485Timer, &dueTime, 0, NULL, NULL, FALSE))
+		WaitForSingleObject(port->rs485Timer, INFINITE);
+	else if (remainingNS >= 1000000LL)
+		Sleep((DWORD)(remainingNS / 1000000LL));
+}
+
+static LONGLONG waitUntilPrecise(serialPort *port, LONGLONG deadlineNS)
+{
+	// Sleep until shortly before the deadline, then spin through the remainder to avoid any scheduler wake-up latency
+	LONGLONG currentTimeNS;
+	sleepUntil(port, deadlineNS - (port->rs485PreciseTimer ? PRECISE_WAIT_SPIN_NS : COARSE_WAIT_SPIN_NS));
+	while ((currentTimeNS = getMonotonicTimeNS()) < deadlineNS)
+		YieldProcessor();
+	return currentTimeNS;
+}
+
+static void setRs485Transmitting(serialPort *port, BOOL transmitting)
+{
+	BOOL setRts = (!transmitting == !port->rs485ActiveHigh);
+	if (port->ftdiHandle)
+		ftdiSucceeded(setRts ? ftdiDriver.SetRts(port->ftdiHandle) : ftdiDriver.ClrRts(port->ftdiHandle));
+	else
+		EscapeCommFunction(port->handle, setRts ? SETRTS : CLRRTS);
+}
+
+static LONGLONG waitForTransmitterEmpty(serialPort *port, LONGLONG expectedEndNS)
+{
+	// Sleep through most of the transmission based on the line rate, then poll the driver until its transmit queue is empty
+	DWORD numBytesQueuedIn = 0, numBytesQueuedOut = 0;
+	sleepUntil(port, expectedEndNS - (port->rs485PreciseTimer ? PRECISE_WAIT_SPIN_NS : COARSE_WAIT_SPIN_NS));
+	LONGLONG currentTimeNS = getMonotonicTimeNS();
+	while (getDeviceStatus(port, NULL, &numBytesQueuedIn, &numBytesQueuedOut) && numBytesQueuedOut && (currentTimeNS < (expectedEndNS + TRANSMITTER_TIMEOUT_NS)))
+	{
+		// Stop spinning if the transmission is taking much longer than expected, such as while stalled by flow control
+		if (currentTimeNS > (expectedEndNS + TRANSMITTER_SPIN_NS))
+			sleepUntil(port, currentTimeNS + TRANSMITTER_POLL_INTERVAL_NS);
+		currentTimeNS = getMonotonicTimeNS();
+	}
+
+	// Neither driver exposes the UART line status, so allow the final character to leave the device but never finish earlier than the line rate permits
+	return waitUntilPrecise(port, ((currentTimeNS + port->characterTimeNS) > expectedEndNS) ? (currentTimeNS + port->characterTimeNS) : expectedEndNS);
+}
+
+static LONGLONG beginRs485Transmission(serialPort *port)
+{
+	// Serialize all transmissions, switch the bus into transmit mode, and wait out the requested setup time
+	EnterCriticalSection(&port->rs485Lock);
+	setRs485Transmitting(port, TRUE);
+	return waitUntilPrecise(port, getMonotonicTimeNS() + port->rs485DelayBeforeNS);
+}
+
+static void endRs485Transmission(serialPort *port, LONGLONG startTimeNS, DWORD numBytesWritten)
+{
+	// Wait for the last bit to leave the device plus the requested hold time before switching the bus back into receive mode
+	if (numBytesWritten)
+	{
+		LONGLONG emptyTimeNS = waitForTransmitterEmpty(port, startTimeNS + (numBytesWritten * port->characterTimeNS));
+		waitUntilPrecise(port, emptyTimeNS + port->rs485DelayAfterNS);
+		setRs485Transmitting(port, FALSE);
+		LONGLONG turnaroundNS = getMonotonicTimeNS() - emptyTimeNS;
+
+		// Update the achieved turnaround statistics
+		addStatistic(&port->statistics.rs485Transmissions, 1);
+		addStatistic(&port->statistics.rs485TurnaroundNS, turnaroundNS);
+		if (turnaroundNS > InterlockedCompareExchange64(&port->statistics.rs485MaxTurnaroundNS, 0, 0))
+			InterlockedExchange64(&port->statistics.rs485MaxTurnaroundNS, turnaroundNS);
+		recordHistogram(port->statistics.rs485Turnaround, turnaroundNS);
+
+		// Discard anything received while transmitting, such as the local echo of a half-duplex transceiver
+		if (!port->rs485RxDuringTx)
+		{
+			purgeDevice(port, PURGE_RXCLEAR);
+			if (port->ringBufferEnabled)
+				discardRingBuffer(port);
+		}
+	}
+	else
+		setRs485Transmitting(port, FALSE);
+	LeaveCriticalSection(&port->rs485Lock);
+}
+
+// Native thread scheduling functionality
+static void applyPortThreadScheduling(serialPort *port)
+{
+	// Apply the requested scheduling to the calling thread, clearing any settings that could not be applied from the port status
+	if (port->threadAffinityMask || (port->threadPriority > 0))
+		InterlockedAnd(&port->threadSchedulingStatus, applyThreadScheduling(port->threadAffinityMask, port->threadPriority));
+}
+
+// Background ring buffer reading functionality
+static DWORD WINAPI ringReaderThread(LPVOID serialPortPointer)
+{
+	// Continuously drain the device into the ring buffer until told to stop
+	serialPort *port = (serialPort*)serialPortPointer;
+	applyPortThreadScheduling(port);
+	while (port->ringReaderRunning)
+	{
+		// Retain any line errors for the event listener, and determine how much data is waiting in the D2XX driver
+		DWORD errorMask = 0, numBytesRead = 0, numBytesQueuedIn = 0, numBytesQueuedOut = 0;
+		if (!getDeviceStatus(port, &errorMask, &numBytesQueuedIn, &numBytesQueuedOut))
+		{
+			port->ringReaderRunning = 0;
+			break;
+		}
+		if (errorMask)
+			InterlockedOr(&port->ringErrorMask, (LONG)errorMask);
+
+		// Only the consumer advances the tail, so wait for it to make room if the ring buffer is full
+		LONG head = port->ringHead;
+		DWORD freeSpace = port->ringBufferLength - (DWORD)(head - InterlockedCompareExchange(&port->ringTail, 0, 0));
+		if (!freeSpace)
+		{
+			// Announce that we are waiting before re-checking so that the consumer cannot miss waking us
+			InterlockedExchange(&port->ringSpaceWaiting, 1);
+			if (((DWORD)(head - InterlockedCompareExchange(&port->ringTail, 0, 0)) == port->ringBufferLength) && port->ringReaderRunning)
+				WaitForSingleObject(port->ringSpaceEvent, INFINITE);
+			InterlockedExchange(&port->ringSpaceWaiting, 0);
+			continue;
+		}
+
+		// Sleep on the driver notification until a D2XX device has data queued
+		if (port->ftdiHandle && !numBytesQueuedIn)
+		{
+			WaitForSingleObject(port->ftdiRingEvent, FTDI_STATUS_POLL_INTERVAL_MS);
+			continue;
+		}
+		LONGLONG arrivalTime = getPerformanceCounter();
+
+		// Read only what is queued in the D2XX driver, while the ring buffer read timeouts let the standard driver block until any data arrives
+		DWORD offset = (DWORD)head & (port->ringBufferLength - 1), numBytesToRead = port->ringBufferLength - offset;
+		if (numBytesToRead > freeSpace)
+			numBytesToRead = freeSpace;
+		if (port->ftdiHandle && (numBytesToRead > numBytesQueuedIn))
+			numBytesToRead = numBytesQueuedIn;
+		OVERLAPPED *overlappedStruct = resetOverlapped(&port->ringOverlapped);
+		addStatistic(&port->statistics.readSyscalls, 1);
+		if (port->ftdiHandle ? !ftdiSucceeded(ftdiDriver.Read(port->ftdiHandle, port->ringBuffer + offset, numBytesToRead, &numBytesRead)) :
+				((!ReadFile(port->handle, port->ringBuffer + offset, numBytesToRead, NULL, overlappedStruct) && (GetLastError() != ERROR_IO_PENDING)) ||
+				!GetOverlappedResult(port->handle, overlappedStruct, &numBytesRead, TRUE)))
+		{
+			// A purge of pending reads cancels the current read without stopping the reader
+			if (!port->ftdiHandle && (GetLastError() == ERROR_OPERATION_ABORTED) && port->ringReaderRunning)
+				continue;
+			port->ringReaderRunning = 0;
+			break;
+		}
+		if (!port->ftdiHandle)
+			arrivalTime = getPerformanceCounter();
+
+		// Publish the new data and wake up any waiting reader
+		if (numBytesRead)
+		{
+			// Record the data before it can be consumed and remember when the oldest unread data arrived if the ring buffer was previously empty
+			if (head == peekRingTail(port))
+				InterlockedExchange64(&port->ringTimestamp, arrivalTime);
+			recordTraffic(port, RECORDING_DIRECTION_RECEIVED, arrivalTime, port->ringBuffer + offset, numBytesRead);
+			InterlockedExchange(&port->ringHead, head + (LONG)numBytesRead);
+			if (InterlockedCompareExchange(&port->ringReaderWaiting, 0, 0))
+				SetEvent(port->ringDataEvent);
+		}
+	}
+
+	// Wake up any readers still waiting for data
+	SetEvent(port->ringDataEvent);
+	return 0;
+}
+
+static void stopRingReader(serialPort *port)
+{
+	// Signal the background reader to exit and wait for it to finish using the port
+	BOOL wasEnabled = port->ringBufferEnabled;
+	port->ringBufferEnabled = 0;
+	port->ringReaderRunning = 0;
+	if (port->ftdiRingEvent)
+		SetEvent(port->ftdiRingEvent);
+	if (port->ringSpaceEvent)
+		SetEvent(port->ringSpaceEvent);
+	if (port->ringReaderThread)
+	{
+		if (!port->ftdiHandle)
+			CancelIoEx(port->handle, &port->ringOverlapped);
+		WaitForSingleObject(port->ringReaderThread, INFINITE);
+		CloseHandle(port->ringReaderThread);
+		port->ringReaderThread = NULL;
+	}
+
+	// Restore the configured read timeouts of the standard driver
+	if (wasEnabled && !port->ftdiHandle)
+		applyPortTimeouts(port);
+}
+
+// Background transmit queue writing functionality
+static DWORD WINAPI txWriterThread(LPVOID serialPortPointer)
+{
+	// Continuously write out all queued data until told to stop and the queue is empty
+	serialPort *port = (serialPort*)serialPortPointer;
+	applyPortThreadScheduling(port);
+	EnterCriticalSection(&port->txLock);
+	while (TRUE)
+	{
+		// Wait for data to be queued
+		if (port->txDiscard)
+			port->txTail = port->txHead;
+		if (port->txHead == port->txTail)
+		{
+			if (!port->txWriterRunning)
+				break;
+			SleepConditionVariableCS(&port->txDataQueued, &port->txLock, INFINITE);
+			continue;
+		}
+
+		// Coalesce everything queued so far into a single write, up to the end of the ring buffer
+		DWORD offset = port->txTail & (port->txBufferLength - 1), numBytesToWrite = port->txHead - port->txTail, numBytesWritten = 0;
+		if (numBytesToWrite > (port->txBufferLength - offset))
+			numBytesToWrite = port->txBufferLength - offset;
+		LeaveCriticalSection(&port->txLock);
+
+		// Write without holding the lock
+		OVERLAPPED *overlappedStruct = resetOverlapped(&port->txOverlapped);
+		BOOL rs485SoftwareControl = port->rs485SoftwareControl;
+		LONGLONG rs485StartTimeNS = rs485SoftwareControl ? beginRs485Transmission(port) : 0;
+		addStatistic(&port->statistics.writeSyscalls, 1);
+		BOOL result = port->ftdiHandle ? ftdiSucceeded(ftdiDriver.Write(port->ftdiHandle, port->txBuffer + offset, numBytesToWrite, &numBytesWritten)) :
+				((WriteFile(port->handle, port->txBuffer + offset, numBytesToWrite, NULL, overlappedStruct) || (GetLastError() == ERROR_IO_PENDING)) &&
+				GetOverlappedResult(port->handle, overlappedStruct, &numBytesWritten, TRUE));
+		if (!result)
+		{
+			port->errorLineNumber = __LINE__ - 5;
+			port->errorNumber = GetLastError();
+		}
+		if (rs485SoftwareControl)
+			endRs485Transmission(port, rs485StartTimeNS, result ? numBytesWritten : 0);
+
+		// Discard all queued data upon failure so that any waiting writers and barriers are released
+		EnterCriticalSection(&port->txLock);
+		if (!result && !port->txDiscard)
+			port->txFailed = 1;
+		if (!result || port->txDiscard)
+			port->txTail = port->txHead;
+		else
+		{
+			recordTraffic(port, RECORDING_DIRECTION_TRANSMITTED, 0, port->txBuffer + offset, numBytesWritten);
+			port->ftdiTxPending = (port->ftdiHandle != NULL);
+			port->txTail += numBytesWritten;
+		}
+		WakeAllConditionVariable(&port->txSpaceAvailable);
+	}
+	WakeAllConditionVariable(&port->txSpaceAvailable);
+	LeaveCriticalSection(&port->txLock);
+	return 0;
+}
+
+static void stopTxWriter(serialPort *port, BOOL discardQueuedData)
+{
+	// Signal the background writer to exit once the queue is empty, or immediately if queued data is to be discarded
+	EnterCriticalSection(&port->txLock);
+	port->txQueueEnabled = port->txWriterRunning = 0;
+	if (discardQueuedData)
+		port->txDiscard = 1;
+	WakeAllConditionVariable(&port->txDataQueued);
+	WakeAllConditionVariable(&port->txSpaceAvailable);
+	LeaveCriticalSection(&port->txLock);
+
+	// Wait for the writer to finish using the port
+	if (port->txWriterThread)
+	{
+		if (discardQueuedData && !port->ftdiHandle)
+			CancelIoEx(port->handle, &port->txOverlapped);
+		WaitForSingleObject(port->txWriterThread, INFINITE);
+		CloseHandle(port->txWriterThread);
+		port->txWriterThread = NULL;
+	}
+}
+
+// Case-insensitive wildcard matching function supporting '*' and '?'
+static BOOL wildcardMatch(const wchar_t *pattern, const wchar_t *string)
+{
+	const wchar_t *starPattern = NULL, *starString = NULL;
+	while (*string)
+	{
+		if ((*pattern == L'?') || ((*pattern != L'*') && (towupper(*pattern) == towupper(*string))))
+		{
+			++pattern;
+			++string;
+		}
+		else if (*pattern == L'*')
+		{
+			starPattern = pattern++;
+			starString = string;
+		}
+		else if (starPattern)
+		{
+			pattern = starPattern + 1;
+			string = ++starString;
+		}
+		else
+			return FALSE;
+	}
+	while (*pattern == L'*')
+		++pattern;
+	return (*pattern == L'\0');
+}
+
+// Port enumeration filtering function
+static BOOL portMatchesFilter(HDEVINFO devList, SP_DEVINFO_DATA *devInfoData, const wchar_t *portName, const portFilter *filter, BOOL *ftdiDeviceMatched)
+{
+	// Match the requested pattern against the full device path if it contains a backslash, otherwise against the port name only
+	wchar_t devicePath[160];
+	_snwprintf_s(devicePath, sizeof(devicePath) / sizeof(wchar_t), _TRUNCATE, L"\\\\.\\%s", portName);
+	if (filter->pathPattern && !wildcardMatch(filter->pathPattern, wcschr(filter->pathPattern, L'\\') ? devicePath : portName))
+		return FALSE;
+
+	// Compare the name of the service driving the device
+	if (filter->driverName)
+	{
+		wchar_t serviceName[128];
+		if (!SetupDiGetDeviceRegistryPropertyW(devList, devInfoData, SPDRP_SERVICE, NULL, (BYTE*)serviceName, sizeof(serviceName), NULL) || _wcsicmp(serviceName, filter->driverName))
+			return FALSE;
+	}
+
+	// Parse the USB vendor and product identifiers from the device instance ID (e.g. "USB\\VID_0403&PID_6001\\..." or "FTDIBUS\\VID_0403+PID_6001+...")
+	wchar_t instanceId[256];
+	BOOL instanceIdFound = SetupDiGetDeviceInstanceIdW(devList, devInfoData, instanceId, sizeof(instanceId) / sizeof(wchar_t), NULL);
+	if ((filter->vendorID >= 0) || (filter->productID >= 0))
+	{
+		const wchar_t *vendorString = instanceIdFound ? wcsstr(instanceId, L"VID_") : NULL, *productString = instanceIdFound ? wcsstr(instanceId, L"PID_") : NULL;
+		if (!vendorString || !productString || ((filter->vendorID >= 0) && (wcstol(vendorString + 4, NULL, 16) != filter->vendorID)) ||
+				((filter->productID >= 0) && (wcstol(productString + 4, NULL, 16) != filter->productID)))
+			return FALSE;
+	}
 
+	// Note whether the FTDI driver may be able to supply a better description for this port
+	if (instanceIdFound && (wcsstr(instanceId, L"VID_0403") || !wcsncmp(instanceId, L"FTDIBUS", 7)))
+		*ftdiDeviceMatched = TRUE;
+	return TRUE;
+}
+
+// Platform-specific port searching function
+static void searchForComPorts(serialPortVector *comPorts, const portFilter *filter)
+{
 	// Enumerate all serial ports present on the current system
 	wchar_t comPort[128];
+	BOOL ftdiDeviceMatched = FALSE;
 	const struct { GUID guid; DWORD flags; } setupClasses[] = {
 			{ .guid = GUID_DEVCLASS_PORTS, .flags = DIGCF_PRESENT },
 			{ .guid = GUID_DEVCLASS_MODEM, .flags = DIGCF_PRESENT },
@@ -138,6 +1075,10 @@ static void enumeratePorts(void)
 				if (!comPortString || wcsstr(comPortString, L"LPT"))
 					continue;
 
+				// Skip any port that does not match the requested filter before retrieving its details
+				if (filter && !portMatchesFilter(devList, &devInfoData, comPortString, filter, &ftdiDeviceMatched))
+					continue;
+
 				// Fetch the friendly name for this device
 				DWORD friendlyNameLength = 0;
 				wchar_t *friendlyNameString = NULL;
@@ -225,7 +1166,7 @@ static void enumeratePorts(void)
 				_snwprintf_s(locationString, 32, 32, L"%d-%d.%d", busNumber, hubNumber, portNumber);
 
 				// Check if port is already enumerated
-				serialPort *port = fetchPort(&serialPorts, comPortString);
+				serialPort *port = fetchPort(comPorts, comPortString);
 				if (port)
 				{
 					// See if device has changed locations
@@ -241,7 +1182,7 @@ static void enumeratePorts(void)
 						wcscpy_s(port->portLocation, 32, locationString);
 				}
 				else
-					pushBack(&serialPorts, comPortString, friendlyNameString, portDescriptionString, locationString);
+					pushBack(comPorts, comPortString, friendlyNameString, portDescriptionString, locationString);
 
 				// Clean up memory and reset device info structure
 				free(locationString);
@@ -253,8 +1194,8 @@ static void enumeratePorts(void)
 		}
 	}
 
-	// Attempt to locate any FTDI-specified port descriptions
-	HINSTANCE ftdiLibInstance = LoadLibrary(TEXT("ftd2xx.dll"));
+	// Attempt to locate any FTDI-specified port descriptions, unless no filtered ports belong to FTDI devices
+	HINSTANCE ftdiLibInstance = (!filter || ftdiDeviceMatched) ? LoadLibrary(TEXT("ftd2xx.dll")) : NULL;
 	if (ftdiLibInstance != NULL)
 	{
 		FT_CreateDeviceInfoListFunction FT_CreateDeviceInfoList = (FT_CreateDeviceInfoListFunction)GetProcAddress(ftdiLibInstance, "FT_CreateDeviceInfoList");
@@ -272,10 +1213,10 @@ static void enumeratePorts(void)
 						// Determine if the port is currently enumerated and already open
 						char isOpen = ((devInfo[i].Flags & FT_FLAGS_OPENED) || !strlen(devInfo[i].SerialNumber)) ? 1 : 0;
 						if (!isOpen)
-							for (int j = 0; j < serialPorts.length; ++j)
-								if ((memcmp(serialPorts.ports[j]->serialNumber, devInfo[i].SerialNumber, sizeof(serialPorts.ports[j]->serialNumber)) == 0) && (serialPorts.ports[j]->handle != INVALID_HANDLE_VALUE))
+							for (int j = 0; j < comPorts->length; ++j)
+								if ((memcmp(comPorts->ports[j]->serialNumber, devInfo[i].SerialNumber, sizeof(comPorts->ports[j]->serialNumber)) == 0) && isPortOpen(comPorts->ports[j]))
 								{
-									serialPorts.ports[j]->enumerated = 1;
+									comPorts->ports[j]->enumerated = 1;
 									isOpen = 1;
 									break;
 								}
@@ -284,19 +1225,19 @@ static void enumeratePorts(void)
 						if (!isOpen && getPortPathFromSerial(comPort, devInfo[i].SerialNumber))
 						{
 							// Check if actually connected and present in the port list
-							for (int j = 0; j < serialPorts.length; ++j)
-								if ((wcscmp(serialPorts.ports[j]->portPath + 4, comPort) == 0) && strlen(devInfo[i].Description))
+							for (int j = 0; j < comPorts->length; ++j)
+								if ((wcscmp(comPorts->ports[j]->portPath + 4, comPort) == 0) && strlen(devInfo[i].Description))
 								{
 									// Update the port description
-									serialPorts.ports[j]->enumerated = 1;
+									comPorts->ports[j]->enumerated = 1;
 									size_t descLength = 8 + strlen(devInfo[i].Description);
-									wchar_t *newMemory = (wchar_t*)realloc(serialPorts.ports[j]->portDescription, descLength*sizeof(wchar_t));
+									wchar_t *newMemory = (wchar_t*)realloc(comPorts->ports[j]->portDescription, descLength*sizeof(wchar_t));
 									if (newMemory)
 									{
-										serialPorts.ports[j]->portDescription = newMemory;
-										MultiByteToWideChar(CP_ACP, MB_PRECOMPOSED, devInfo[i].Description, -1, serialPorts.ports[j]->portDescription, descLength);
+										comPorts->ports[j]->portDescription = newMemory;
+										MultiByteToWideChar(CP_ACP, MB_PRECOMPOSED, devInfo[i].Description, -1, comPorts->ports[j]->portDescription, descLength);
 									}
-									memcpy(serialPorts.ports[j]->serialNumber, devInfo[i].SerialNumber, sizeof(serialPorts.ports[j]->serialNumber));
+									memcpy(comPorts->ports[j]->serialNumber, devInfo[i].SerialNumber, sizeof(comPorts->ports[j]->serialNumber));
 									break;
 								}
 						}
@@ -307,38 +1248,56 @@ static void enumeratePorts(void)
 		}
 		FreeLibrary(ftdiLibInstance);
 	}
+}
 
-	// Remove all non-enumerated ports from the serial port listing
-	for (int i = 0; i < serialPorts.length; ++i)
+// Generalized port enumeration function (must be called with the serial port listing locked)
+static void enumeratePorts(void)
+{
+	// Remember which port listing changes this enumeration will account for
+	LONG generation = InterlockedCompareExchange(&portListingGeneration, 0, 0);
+
+	// Reset the enumerated flag on all serial ports that are not open or currently being opened
+	for (int i = 0; i < serialPorts.length; ++i)
+		serialPorts.ports[i]->enumerated = (isPortOpen(serialPorts.ports[i]) || serialPorts.ports[i]->opening);
+
+	// Enumerate all serial ports present on the current system
+	searchForComPorts(&serialPorts, NULL);
+
+	// Remove all non-enumerated ports from the serial port listing
+	for (int i = 0; i < serialPorts.length; ++i)
 		if (!serialPorts.ports[i]->enumerated)
 		{
 			removePort(&serialPorts, serialPorts.ports[i]);
 			i--;
 		}
+	enumeratedGeneration = generation;
 	portsEnumerated = 1;
 }
 
-JNIEXPORT jobjectArray JNICALL Java_com_fazecast_jSerialComm_SerialPort_getCommPorts(JNIEnv *env, jclass serialComm)
+// Hotplug notification function
+static void portListingChanged(void)
 {
-	// Enumerate all ports on the current system
-	enumeratePorts();
+	InterlockedIncrement(&portListingGeneration);
+	SetEvent(hotplugEvent);
+}
 
-	// Get relevant SerialComm methods and fill in com port array
-	wchar_t comPort[128];
-	jobjectArray arrayObject = (*env)->NewObjectArray(env, serialPorts.length, serialCommClass, 0);
+// Java-based port listing creation function
+static jobjectArray createPortListing(JNIEnv *env, serialPortVector *comPorts)
+{
+	jobjectArray arrayObject = (*env)->NewObjectArray(env, comPorts->length, serialCommClass, 0);
 	if (checkJniError(env, __LINE__ - 1)) return arrayObject;
-	for (int i = 0; i < serialPorts.length; ++i)
+	for (int i = 0; i < comPorts->length; ++i)
 	{
 		// Create new SerialComm object containing the enumerated values
 		jobject serialCommObject = (*env)->NewObject(env, serialCommClass, serialCommConstructor);
 		if (checkJniError(env, __LINE__ - 1)) return arrayObject;
-		(*env)->SetObjectField(env, serialCommObject, comPortField, (*env)->NewString(env, (jchar*)serialPorts.ports[i]->portPath, wcslen(serialPorts.ports[i]->portPath)));
+		(*env)->SetObjectField(env, serialCommObject, comPortField, (*env)->NewString(env, (jchar*)comPorts->ports[i]->portPath, wcslen(comPorts->ports[i]->portPath)));
 		if (checkJniError(env, __LINE__ - 1)) return arrayObject;
-		(*env)->SetObjectField(env, serialCommObject, friendlyNameField, (*env)->NewString(env, (jchar*)serialPorts.ports[i]->friendlyName, wcslen(serialPorts.ports[i]->friendlyName)));
+		(*env)->SetObjectField(env, serialCommObject, friendlyNameField, (*env)->NewString(env, (jchar*)comPorts->ports[i]->friendlyName, wcslen(comPorts->ports[i]->friendlyName)));
 		if (checkJniError(env, __LINE__ - 1)) return arrayObject;
-		(*env)->SetObjectField(env, serialCommObject, portDescriptionField, (*env)->NewString(env, (jchar*)serialPorts.ports[i]->portDescription, wcslen(serialPorts.ports[i]->portDescription)));
+		(*env)->SetObjectField(env, serialCommObject, portDescriptionField, (*env)->NewString(env, (jchar*)comPorts->ports[i]->portDescription, wcslen(comPorts->ports[i]->portDescription)));
 		if (checkJniError(env, __LINE__ - 1)) return arrayObject;
-		(*env)->SetObjectField(env, serialCommObject, portLocationField, (*env)->NewString(env, (jchar*)serialPorts.ports[i]->portLocation, wcslen(serialPorts.ports[i]->portLocation)));
+		(*env)->SetObjectField(env, serialCommObject, portLocationField, (*env)->NewString(env, (jchar*)comPorts->ports[i]->portLocation, wcslen(comPorts->ports[i]->portLocation)));
 		if (checkJniError(env, __LINE__ - 1)) return arrayObject;
 
 		// Add new SerialComm object to array
@@ -348,6 +1307,57 @@ JNIEXPORT jobjectArray JNICALL Java_com_fazecast_jSerialComm_SerialPort_getCommP
 	return arrayObject;
 }
 
+JNIEXPORT jobjectArray JNICALL Java_com_fazecast_jSerialComm_SerialPort_getCommPorts(JNIEnv *env, jclass serialComm)
+{
+	// Lock the serial port listing for the duration of the enumeration
+	AcquireSRWLockExclusive(&serialPortsLock);
+
+	// Start listening for hotplug events before the first enumeration so that no changes can be missed
+	if (!hotplugMonitorStatus)
+		hotplugMonitorStatus = startHotplugMonitor(portListingChanged) ? 1 : -1;
+
+	// Only re-enumerate all ports on the current system if the listing may have changed
+	if ((hotplugMonitorStatus < 0) || !portsEnumerated || (enumeratedGeneration != InterlockedCompareExchange(&portListingGeneration, 0, 0)))
+		enumeratePorts();
+
+	// Get relevant SerialComm methods and fill in com port array
+	jobjectArray arrayObject = createPortListing(env, &serialPorts);
+	ReleaseSRWLockExclusive(&serialPortsLock);
+	return arrayObject;
+}
+
+JNIEXPORT jobjectArray JNICALL Java_com_fazecast_jSerialComm_SerialPort_getCommPortsFiltered(JNIEnv *env, jclass serialComm, jstring pathPattern, jint vendorID, jint productID, jstring driverName)
+{
+	// Retrieve the filter criteria
+	portFilter filter = { NULL, NULL, vendorID, productID };
+	if (pathPattern)
+	{
+		filter.pathPattern = (wchar_t*)(*env)->GetStringChars(env, pathPattern, NULL);
+		if (checkJniError(env, __LINE__ - 1)) return NULL;
+	}
+	if (driverName)
+	{
+		filter.driverName = (wchar_t*)(*env)->GetStringChars(env, driverName, NULL);
+		if (checkJniError(env, __LINE__ - 1)) { if (filter.pathPattern) (*env)->ReleaseStringChars(env, pathPattern, (const jchar*)filter.pathPattern); return NULL; }
+	}
+
+	// Search for matching ports using a temporary listing so that the cached full listing remains intact
+	serialPortVector matchingPorts = { NULL, 0, 0 };
+	searchForComPorts(&matchingPorts, &filter);
+	jobjectArray arrayObject = createPortListing(env, &matchingPorts);
+
+	// Clean up memory
+	while (matchingPorts.length)
+		removePort(&matchingPorts, matchingPorts.ports[0]);
+	if (matchingPorts.ports)
+		free(matchingPorts.ports);
+	if (filter.driverName)
+		(*env)->ReleaseStringChars(env, driverName, (const jchar*)filter.driverName);
+	if (filter.pathPattern)
+		(*env)->ReleaseStringChars(env, pathPattern, (const jchar*)filter.pathPattern);
+	return arrayObject;
+}
+
 JNIEXPORT void JNICALL Java_com_fazecast_jSerialComm_SerialPort_initializeLibrary(JNIEnv *env, jclass serialComm)
 {
 	// Cache class and method ID as global references
@@ -356,6 +1366,7 @@ JNIEXPORT void JNICALL Java_com_fazecast_jSerialComm_SerialPort_initializeLibrar
 	if (checkJniError(env, __LINE__ - 1)) return;
 	serialCommConstructor = (*env)->GetMethodID(env, serialCommClass, "<init>", "()V");
 	if (checkJniError(env, __LINE__ - 1)) return;
+	QueryPerformanceFrequency(&performanceFrequency);
 
 	// Cache Java fields as global references
 	serialPortHandleField = (*env)->GetFieldID(env, serialCommClass, "portHandle", "J");
@@ -396,10 +1407,16 @@ JNIEXPORT void JNICALL Java_com_fazecast_jSerialComm_SerialPort_initializeLibrar
 	if (checkJniError(env, __LINE__ - 1)) return;
 	rs485ModeField = (*env)->GetFieldID(env, serialCommClass, "rs485Mode", "Z");
 	if (checkJniError(env, __LINE__ - 1)) return;
+	rs485ActiveHighField = (*env)->GetFieldID(env, serialCommClass, "rs485ActiveHigh", "Z");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	rs485RxDuringTxField = (*env)->GetFieldID(env, serialCommClass, "rs485RxDuringTx", "Z");
+	if (checkJniError(env, __LINE__ - 1)) return;
 	rs485DelayBeforeField = (*env)->GetFieldID(env, serialCommClass, "rs485DelayBefore", "I");
 	if (checkJniError(env, __LINE__ - 1)) return;
 	rs485DelayAfterField = (*env)->GetFieldID(env, serialCommClass, "rs485DelayAfter", "I");
 	if (checkJniError(env, __LINE__ - 1)) return;
+	rs485SoftwareControlField = (*env)->GetFieldID(env, serialCommClass, "rs485SoftwareControl", "Z");
+	if (checkJniError(env, __LINE__ - 1)) return;
 	xonStartCharField = (*env)->GetFieldID(env, serialCommClass, "xonStartChar", "B");
 	if (checkJniError(env, __LINE__ - 1)) return;
 	xoffStopCharField = (*env)->GetFieldID(env, serialCommClass, "xoffStopChar", "B");
@@ -412,14 +1429,50 @@ JNIEXPORT void JNICALL Java_com_fazecast_jSerialComm_SerialPort_initializeLibrar
 	if (checkJniError(env, __LINE__ - 1)) return;
 	eventFlagsField = (*env)->GetFieldID(env, serialCommClass, "eventFlags", "I");
 	if (checkJniError(env, __LINE__ - 1)) return;
+	lowLatencyModeField = (*env)->GetFieldID(env, serialCommClass, "lowLatencyMode", "Z");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	interByteTimeoutField = (*env)->GetFieldID(env, serialCommClass, "interByteTimeout", "I");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	ftdiDirectModeField = (*env)->GetFieldID(env, serialCommClass, "ftdiDirectMode", "Z");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	ftdiTransferSizeField = (*env)->GetFieldID(env, serialCommClass, "ftdiTransferSize", "I");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	threadAffinityMaskField = (*env)->GetFieldID(env, serialCommClass, "threadAffinityMask", "J");
+	if (checkJniError(env, __LINE__ - 1)) return;
+	threadPriorityField = (*env)->GetFieldID(env, serialCommClass, "threadPriority", "I");
+	if (checkJniError(env, __LINE__ - 1)) return;
+
+	// Create the hotplug notification event
+	hotplugEvent = CreateEventW(NULL, FALSE, FALSE, NULL);
 }
 
 JNIEXPORT void JNICALL Java_com_fazecast_jSerialComm_SerialPort_uninitializeLibrary(JNIEnv *env, jclass serialComm)
 {
 	// Close all open ports
+	AcquireSRWLockExclusive(&serialPortsLock);
 	for (int i = 0; i < serialPorts.length; ++i)
-		if (serialPorts.ports[i]->handle != INVALID_HANDLE_VALUE)
-			Java_com_fazecast_jSerialComm_SerialPort_closePortNative(env, serialComm, (jlong)(intptr_t)serialPorts.ports[i]);
+		if (isPortOpen(serialPorts.ports[i]))
+		{
+			// Open ports are never removed from the listing, so the port remains valid while the listing is unlocked
+			serialPort *port = serialPorts.ports[i];
+			ReleaseSRWLockExclusive(&serialPortsLock);
+			Java_com_fazecast_jSerialComm_SerialPort_closePortNative(env, serialComm, (jlong)(intptr_t)port, JNI_FALSE);
+			AcquireSRWLockExclusive(&serialPortsLock);
+		}
+	ReleaseSRWLockExclusive(&serialPortsLock);
+
+	// Stop listening for hotplug events
+	if (hotplugMonitorStatus > 0)
+		stopHotplugMonitor();
+	hotplugMonitorStatus = 0;
+	if (hotplugEvent)
+		CloseHandle(hotplugEvent);
+	hotplugEvent = NULL;
+
+	// Unload the FTDI D2XX driver if it was used for direct port access
+	if (ftdiDriver.library)
+		FreeLibrary(ftdiDriver.library);
+	memset(&ftdiDriver, 0, sizeof(ftdiDriver));
 
 	// Delete the cached global reference
 	(*env)->DeleteGlobalRef(env, serialCommClass);
@@ -435,11 +1488,13 @@ JNIEXPORT void JNICALL Java_com_fazecast_jSerialComm_SerialPort_retrievePortDeta
 	if (checkJniError(env, __LINE__ - 1)) return;
 
 	// Ensure that the serial port exists
+	AcquireSRWLockExclusive(&serialPortsLock);
 	if (!portsEnumerated)
 		enumeratePorts();
 	serialPort *port = fetchPort(&serialPorts, portName);
 	if (!port)
 	{
+		ReleaseSRWLockExclusive(&serialPortsLock);
 		(*env)->ReleaseStringChars(env, portNameJString, (const jchar*)portName);
 		checkJniError(env, __LINE__ - 1);
 		return;
@@ -447,11 +1502,12 @@ JNIEXPORT void JNICALL Java_com_fazecast_jSerialComm_SerialPort_retrievePortDeta
 
 	// Fill in the Java-side port details
 	(*env)->SetObjectField(env, obj, friendlyNameField, (*env)->NewString(env, (jchar*)port->friendlyName, wcslen(port->friendlyName)));
-	if (checkJniError(env, __LINE__ - 1)) return;
+	if (checkJniError(env, __LINE__ - 1)) { ReleaseSRWLockExclusive(&serialPortsLock); return; }
 	(*env)->SetObjectField(env, obj, portDescriptionField, (*env)->NewString(env, (jchar*)port->portDescription, wcslen(port->portDescription)));
-	if (checkJniError(env, __LINE__ - 1)) return;
+	if (checkJniError(env, __LINE__ - 1)) { ReleaseSRWLockExclusive(&serialPortsLock); return; }
 	(*env)->SetObjectField(env, obj, portLocationField, (*env)->NewString(env, (jchar*)port->portLocation, wcslen(port->portLocation)));
-	if (checkJniError(env, __LINE__ - 1)) return;
+	if (checkJniError(env, __LINE__ - 1)) { ReleaseSRWLockExclusive(&serialPortsLock); return; }
+	ReleaseSRWLockExclusive(&serialPortsLock);
 
 	// Release all JNI structures
 	(*env)->ReleaseStringChars(env, portNameJString, (const jchar*)portName);
@@ -467,56 +1523,107 @@ JNIEXPORT jlong JNICALL Java_com_fazecast_jSerialComm_SerialPort_openPortNative(
 	if (checkJniError(env, __LINE__ - 1)) return 0;
 	unsigned char requestElevatedPermissions = (*env)->GetBooleanField(env, obj, requestElevatedPermissionsField);
 	if (checkJniError(env, __LINE__ - 1)) return 0;
+	unsigned char lowLatencyMode = (*env)->GetBooleanField(env, obj, lowLatencyModeField);
+	if (checkJniError(env, __LINE__ - 1)) return 0;
 	unsigned char disableAutoConfig = (*env)->GetBooleanField(env, obj, disableConfigField);
 	if (checkJniError(env, __LINE__ - 1)) return 0;
 	unsigned char autoFlushIOBuffers = (*env)->GetBooleanField(env, obj, autoFlushIOBuffersField);
 	if (checkJniError(env, __LINE__ - 1)) return 0;
+	unsigned char ftdiDirectMode = (*env)->GetBooleanField(env, obj, ftdiDirectModeField);
+	if (checkJniError(env, __LINE__ - 1)) return 0;
+	DWORD ftdiTransferSize = (DWORD)(*env)->GetIntField(env, obj, ftdiTransferSizeField);
+	if (checkJniError(env, __LINE__ - 1)) return 0;
+	LONGLONG threadAffinityMask = (LONGLONG)(*env)->GetLongField(env, obj, threadAffinityMaskField);
+	if (checkJniError(env, __LINE__ - 1)) return 0;
+	int threadPriority = (*env)->GetIntField(env, obj, threadPriorityField);
+	if (checkJniError(env, __LINE__ - 1)) return 0;
 
-	// Ensure that the serial port still exists and is not already open
+	// Ensure that the serial port still exists and is not already open or being opened by another thread
+	AcquireSRWLockExclusive(&serialPortsLock);
 	serialPort *port = fetchPort(&serialPorts, portName);
 	if (!port)
 	{
 		// Create port representation and add to serial port listing
 		port = pushBack(&serialPorts, portName, L"User-Specified Port", L"User-Specified Port", L"0-0");
 	}
-	if (!port || (port->handle != INVALID_HANDLE_VALUE))
+	if (!port || isPortOpen(port) || port->opening)
 	{
+		ReleaseSRWLockExclusive(&serialPortsLock);
 		(*env)->ReleaseStringChars(env, portNameJString, (const jchar*)portName);
 		checkJniError(env, __LINE__ - 1);
-		lastErrorLineNumber = __LINE__ - 3;
+		lastErrorLineNumber = __LINE__ - 4;
 		lastErrorNumber = (!port ? 1 : 2);
 		return 0;
 	}
 
-	// Reduce the port's latency to its minimum value
-	reduceLatencyToMinimum(portName + 4, requestElevatedPermissions);
+	// Claim the port so that it cannot be removed from the listing while it is being opened without the lock held
+	port->opening = 1;
+	BOOL ftdiDriverLoaded = ftdiDirectMode && loadFtdiDriver();
+	ReleaseSRWLockExclusive(&serialPortsLock);
+
+	// Store the requested thread scheduling so that each native thread belonging to the port can apply it to itself, with no settings applied yet
+	port->threadAffinityMask = threadAffinityMask;
+	port->threadPriority = threadPriority;
+	port->threadSchedulingStatus = -1;
 
-	// Try to open the serial port with read/write access
-	if ((port->handle = CreateFileW(portName, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH | FILE_FLAG_OVERLAPPED, NULL)) != INVALID_HANDLE_VALUE)
+	// Start a fresh set of performance statistics for this session
+	resetStatistics(port);
+
+	// Open the port directly through the FTDI D2XX driver if requested and possible, otherwise fall back to the standard driver
+	if (ftdiDriverLoaded && openFtdiPort(port, ftdiTransferSize, lowLatencyMode))
 	{
 		// Configure the port parameters and timeouts
-		if (!disableAutoConfig && !Java_com_fazecast_jSerialComm_SerialPort_configPort(env, obj, (jlong)(intptr_t)port))
+		if (!createOverlappedEvents(port) || (!disableAutoConfig && !Java_com_fazecast_jSerialComm_SerialPort_configPort(env, obj, (jlong)(intptr_t)port)))
 		{
 			// Close the port if there was a problem setting the parameters
-			PurgeComm(port->handle, PURGE_RXABORT | PURGE_RXCLEAR | PURGE_TXABORT | PURGE_TXCLEAR);
-			CancelIoEx(port->handle, NULL);
-			SetCommMask(port->handle, 0);
-			CloseHandle(port->handle);
-			port->handle = INVALID_HANDLE_VALUE;
+			purgeDevice(port, PURGE_RXABORT | PURGE_RXCLEAR | PURGE_TXABORT | PURGE_TXCLEAR);
+			closeFtdiPort(port);
+			destroyOverlappedEvents(port);
+			port->ftdiHandle = NULL;
 		}
 		else if (autoFlushIOBuffers)
 			Java_com_fazecast_jSerialComm_SerialPort_flushRxTxBuffers(env, obj, (jlong)(intptr_t)port);
 	}
 	else
 	{
-		port->errorLineNumber = lastErrorLineNumber = __LINE__ - 15;
-		port->errorNumber = lastErrorNumber = GetLastError();
+		// Reduce the port's latency to its minimum value
+		if (lowLatencyMode)
+			setLatencyTimer(portName + 4, 2, 1, requestElevatedPermissions);
+
+		// Try to open the serial port with read/write access
+		if ((port->handle = CreateFileW(portName, GENERIC_READ | GENERIC_WRITE, 0, NULL, OPEN_EXISTING, FILE_FLAG_NO_BUFFERING | FILE_FLAG_WRITE_THROUGH | FILE_FLAG_OVERLAPPED, NULL)) != INVALID_HANDLE_VALUE)
+		{
+			// Configure the port parameters and timeouts
+			if (!createOverlappedEvents(port) || (!disableAutoConfig && !Java_com_fazecast_jSerialComm_SerialPort_configPort(env, obj, (jlong)(intptr_t)port)))
+			{
+				// Close the port if there was a problem setting the parameters
+				PurgeComm(port->handle, PURGE_RXABORT | PURGE_RXCLEAR | PURGE_TXABORT | PURGE_TXCLEAR);
+				CancelIoEx(port->handle, NULL);
+				SetCommMask(port->handle, 0);
+				CloseHandle(port->handle);
+				destroyOverlappedEvents(port);
+				port->handle = INVALID_HANDLE_VALUE;
+			}
+			else if (autoFlushIOBuffers)
+				Java_com_fazecast_jSerialComm_SerialPort_flushRxTxBuffers(env, obj, (jlong)(intptr_t)port);
+		}
+		else
+		{
+			port->errorLineNumber = lastErrorLineNumber = __LINE__ - 15;
+			port->errorNumber = lastErrorNumber = GetLastError();
+		}
 	}
 
+	// Release the claim on the port, after which an unopened port may be removed from the listing
+	AcquireSRWLockExclusive(&serialPortsLock);
+	jlong portPointer = isPortOpen(port) ? (jlong)(intptr_t)port : 0;
+	port->opening = 0;
+	ReleaseSRWLockExclusive(&serialPortsLock);
+
 	// Return a pointer to the serial port data structure
 	(*env)->ReleaseStringChars(env, portNameJString, (const jchar*)portName);
 	checkJniError(env, __LINE__ - 1);
-	return (port->handle != INVALID_HANDLE_VALUE) ? (jlong)(intptr_t)port : 0;
+	return portPointer;
 }
 
 JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_configPort(JNIEnv *env, jobject obj, jlong serialPortPointer)
@@ -551,6 +1658,16 @@ JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_configPort(J
 	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
 	BYTE rs485ModeEnabled = (BYTE)(*env)->GetBooleanField(env, obj, rs485ModeField);
 	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	BYTE rs485ActiveHigh = (BYTE)(*env)->GetBooleanField(env, obj, rs485ActiveHighField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	BYTE rs485RxDuringTx = (BYTE)(*env)->GetBooleanField(env, obj, rs485RxDuringTxField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	BYTE rs485SoftwareControl = (BYTE)(*env)->GetBooleanField(env, obj, rs485SoftwareControlField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	int rs485DelayBefore = (*env)->GetIntField(env, obj, rs485DelayBeforeField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	int rs485DelayAfter = (*env)->GetIntField(env, obj, rs485DelayAfterField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
 	BYTE isDtrEnabled = (*env)->GetBooleanField(env, obj, isDtrEnabledField);
 	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
 	BYTE isRtsEnabled = (*env)->GetBooleanField(env, obj, isRtsEnabledField);
@@ -563,11 +1680,46 @@ JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_configPort(J
 	BOOL DSREnabled = (((flowControl & com_fazecast_jSerialComm_SerialPort_FLOW_CONTROL_DSR_ENABLED) > 0) ||
 			((flowControl & com_fazecast_jSerialComm_SerialPort_FLOW_CONTROL_DTR_ENABLED) > 0));
 	BYTE DTRValue = ((flowControl & com_fazecast_jSerialComm_SerialPort_FLOW_CONTROL_DTR_ENABLED) > 0) ? DTR_CONTROL_HANDSHAKE : (isDtrEnabled ? DTR_CONTROL_ENABLE : DTR_CONTROL_DISABLE);
-	BYTE RTSValue = (rs485ModeEnabled ? RTS_CONTROL_TOGGLE :
+	BOOL rs485SoftwareEnabled = (rs485ModeEnabled && rs485SoftwareControl);
+	BYTE RTSValue = (rs485SoftwareEnabled ? (rs485ActiveHigh ? RTS_CONTROL_DISABLE : RTS_CONTROL_ENABLE) : rs485ModeEnabled ? RTS_CONTROL_TOGGLE :
 			(((flowControl & com_fazecast_jSerialComm_SerialPort_FLOW_CONTROL_RTS_ENABLED) > 0) ? RTS_CONTROL_HANDSHAKE : (isRtsEnabled ? RTS_CONTROL_ENABLE : RTS_CONTROL_DISABLE)));
 	BOOL XonXoffInEnabled = ((flowControl & com_fazecast_jSerialComm_SerialPort_FLOW_CONTROL_XONXOFF_IN_ENABLED) > 0);
 	BOOL XonXoffOutEnabled = ((flowControl & com_fazecast_jSerialComm_SerialPort_FLOW_CONTROL_XONXOFF_OUT_ENABLED) > 0);
 
+	// Set up software RS-485 direction control, which leaves the bus in receive mode through the idle RTS level configured below
+	EnterCriticalSection(&port->rs485Lock);
+	port->rs485SoftwareControl = rs485SoftwareEnabled;
+	setRs485Timing(port, rs485SoftwareEnabled);
+	port->rs485ActiveHigh = rs485ActiveHigh;
+	port->rs485RxDuringTx = rs485RxDuringTx;
+	port->rs485DelayBeforeNS = (rs485DelayBefore > 0) ? (rs485DelayBefore * 1000LL) : 0;
+	port->rs485DelayAfterNS = (rs485DelayAfter > 0) ? (rs485DelayAfter * 1000LL) : 0;
+	setCharacterTime(port, (int)baudRate, byteSize, stopBitsInt, parityInt);
+	LeaveCriticalSection(&port->rs485Lock);
+
+	// Apply the port parameters through the D2XX driver if it owns the port, which uses the same parity and stop bit values as the system driver
+	if (port->ftdiHandle)
+	{
+		USHORT ftdiFlowControl = CTSEnabled ? FT_FLOW_RTS_CTS : DSREnabled ? FT_FLOW_DTR_DSR : (XonXoffInEnabled || XonXoffOutEnabled) ? FT_FLOW_XON_XOFF : FT_FLOW_NONE;
+		if (rs485ModeEnabled && !rs485SoftwareEnabled)
+		{
+			// The D2XX driver cannot toggle RTS around transmissions by itself
+			port->errorLineNumber = lastErrorLineNumber = __LINE__ - 3;
+			port->errorNumber = lastErrorNumber = ERROR_NOT_SUPPORTED;
+			return JNI_FALSE;
+		}
+		if (!ftdiSucceeded(ftdiDriver.SetBaudRate(port->ftdiHandle, baudRate)) || !ftdiSucceeded(ftdiDriver.SetDataCharacteristics(port->ftdiHandle, byteSize, stopBits, parity)) ||
+				!ftdiSucceeded(ftdiDriver.SetFlowControl(port->ftdiHandle, ftdiFlowControl, (UCHAR)xonStartChar, (UCHAR)xoffStopChar)) ||
+				((DTRValue != DTR_CONTROL_HANDSHAKE) && !ftdiSucceeded((DTRValue == DTR_CONTROL_ENABLE) ? ftdiDriver.SetDtr(port->ftdiHandle) : ftdiDriver.ClrDtr(port->ftdiHandle))) ||
+				((RTSValue != RTS_CONTROL_HANDSHAKE) && !ftdiSucceeded((RTSValue == RTS_CONTROL_ENABLE) ? ftdiDriver.SetRts(port->ftdiHandle) : ftdiDriver.ClrRts(port->ftdiHandle))))
+		{
+			port->errorLineNumber = lastErrorLineNumber = __LINE__ - 5;
+			port->errorNumber = lastErrorNumber = GetLastError();
+			return JNI_FALSE;
+		}
+		return Java_com_fazecast_jSerialComm_SerialPort_configTimeouts(env, obj, serialPortPointer, timeoutMode, readTimeout, writeTimeout, eventsToMonitor);
+	}
+
 	// Retrieve existing port configuration
 	DCB dcbSerialParams;
 	memset(&dcbSerialParams, 0, sizeof(DCB));
@@ -617,6 +1769,9 @@ JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_configTimeou
 	// Get event flags from the Java class
 	int eventFlags = EV_ERR;
 	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	int interByteTimeout = (*env)->GetIntField(env, obj, interByteTimeoutField);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	port->writeTimeout = writeTimeout;
 	if ((eventsToMonitor & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_AVAILABLE) || (eventsToMonitor & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_RECEIVED))
 		eventFlags |= EV_RXCHAR;
 	if (eventsToMonitor & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_WRITTEN)
@@ -632,6 +1787,20 @@ JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_configTimeou
 	if (eventsToMonitor & com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_CARRIER_DETECT)
 		eventFlags |= EV_RLSD;
 
+	// Reads through the D2XX driver only ever consume queued data and apply their own timeouts, so only the write timeout is passed to the driver
+	if (port->ftdiHandle)
+	{
+		port->ftdiEventMask = eventFlags;
+		port->ftdiInterByteTimeout = (interByteTimeout > 0) ? interByteTimeout : 0;
+		if (!ftdiSucceeded(ftdiDriver.SetTimeouts(port->ftdiHandle, 0, (writeTimeout > 0) ? writeTimeout : 0)))
+		{
+			port->errorLineNumber = lastErrorLineNumber = __LINE__ - 2;
+			port->errorNumber = lastErrorNumber = GetLastError();
+			return JNI_FALSE;
+		}
+		return JNI_TRUE;
+	}
+
 	// Set updated port timeouts
 	COMMTIMEOUTS timeouts;
 	memset(&timeouts, 0, sizeof(COMMTIMEOUTS));
@@ -651,6 +1820,14 @@ JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_configTimeou
 		timeouts.ReadTotalTimeoutConstant = 0x0FFFFFFF;
 		timeouts.WriteTotalTimeoutConstant = writeTimeout;
 	}
+	else if ((timeoutMode & com_fazecast_jSerialComm_SerialPort_TIMEOUT_READ_SEMI_BLOCKING) && (interByteTimeout > 0))
+	{
+		// Return as soon as the line goes idle for the inter-byte timeout after the first byte
+		timeouts.ReadIntervalTimeout = interByteTimeout;
+		timeouts.ReadTotalTimeoutMultiplier = 0;
+		timeouts.ReadTotalTimeoutConstant = readTimeout;
+		timeouts.WriteTotalTimeoutConstant = writeTimeout;
+	}
 	else if (timeoutMode & com_fazecast_jSerialComm_SerialPort_TIMEOUT_READ_SEMI_BLOCKING)
 	{
 		timeouts.ReadIntervalTimeout = MAXDWORD;
@@ -673,8 +1850,9 @@ JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_configTimeou
 		timeouts.WriteTotalTimeoutConstant = writeTimeout;
 	}
 
-	// Apply changes
-	if (!SetCommTimeouts(port->handle, &timeouts) || !SetCommMask(port->handle, eventFlags))
+	// Apply changes, keeping the background reader's read timeouts in place while it is running
+	port->configuredTimeouts = timeouts;
+	if (!applyPortTimeouts(port) || !SetCommMask(port->handle, eventFlags))
 	{
 		port->errorLineNumber = lastErrorLineNumber = __LINE__ - 2;
 		port->errorNumber = lastErrorNumber = GetLastError();
@@ -683,63 +1861,78 @@ JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_configTimeou
 	return JNI_TRUE;
 }
 
-JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_flushRxTxBuffers(JNIEnv *env, jobject obj, jlong serialPortPointer)
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_setFrameParameters(JNIEnv *env, jobject obj, jlong serialPortPointer, jint baudRate, jint byteSizeInt, jint stopBitsInt, jint parityInt)
 {
+	// Update the baud rate and word framing parameters directly through the D2XX driver if it owns the port
 	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
-	if (PurgeComm(port->handle, PURGE_RXABORT | PURGE_RXCLEAR | PURGE_TXABORT | PURGE_TXCLEAR) == 0)
+	if (port->ftdiHandle)
 	{
-		port->errorLineNumber = __LINE__ - 2;
-		port->errorNumber = GetLastError();
+		UCHAR stopBits = (stopBitsInt == com_fazecast_jSerialComm_SerialPort_ONE_STOP_BIT) ? ONESTOPBIT : (stopBitsInt == com_fazecast_jSerialComm_SerialPort_ONE_POINT_FIVE_STOP_BITS) ? ONE5STOPBITS : TWOSTOPBITS;
+		UCHAR parity = (parityInt == com_fazecast_jSerialComm_SerialPort_NO_PARITY) ? NOPARITY : (parityInt == com_fazecast_jSerialComm_SerialPort_ODD_PARITY) ? ODDPARITY : (parityInt == com_fazecast_jSerialComm_SerialPort_EVEN_PARITY) ? EVENPARITY : (parityInt == com_fazecast_jSerialComm_SerialPort_MARK_PARITY) ? MARKPARITY : SPACEPARITY;
+		if (!ftdiSucceeded(ftdiDriver.SetBaudRate(port->ftdiHandle, (ULONG)baudRate)) || !ftdiSucceeded(ftdiDriver.SetDataCharacteristics(port->ftdiHandle, (UCHAR)byteSizeInt, stopBits, parity)))
+		{
+			port->errorLineNumber = lastErrorLineNumber = __LINE__ - 2;
+			port->errorNumber = lastErrorNumber = GetLastError();
+			return JNI_FALSE;
+		}
+		setCharacterTime(port, baudRate, byteSizeInt, stopBitsInt, parityInt);
+		return JNI_TRUE;
+	}
+
+	// Retrieve existing port configuration
+	DCB dcbSerialParams;
+	memset(&dcbSerialParams, 0, sizeof(DCB));
+	dcbSerialParams.DCBlength = sizeof(DCB);
+	if (!GetCommState(port->handle, &dcbSerialParams))
+	{
+		port->errorLineNumber = lastErrorLineNumber = __LINE__ - 2;
+		port->errorNumber = lastErrorNumber = GetLastError();
+		return JNI_FALSE;
+	}
+
+	// Update only the baud rate and word framing parameters, leaving all other settings intact
+	dcbSerialParams.BaudRate = (DWORD)baudRate;
+	dcbSerialParams.ByteSize = (BYTE)byteSizeInt;
+	dcbSerialParams.StopBits = (stopBitsInt == com_fazecast_jSerialComm_SerialPort_ONE_STOP_BIT) ? ONESTOPBIT : (stopBitsInt == com_fazecast_jSerialComm_SerialPort_ONE_POINT_FIVE_STOP_BITS) ? ONE5STOPBITS : TWOSTOPBITS;
+	dcbSerialParams.Parity = (parityInt == com_fazecast_jSerialComm_SerialPort_NO_PARITY) ? NOPARITY : (parityInt == com_fazecast_jSerialComm_SerialPort_ODD_PARITY) ? ODDPARITY : (parityInt == com_fazecast_jSerialComm_SerialPort_EVEN_PARITY) ? EVENPARITY : (parityInt == com_fazecast_jSerialComm_SerialPort_MARK_PARITY) ? MARKPARITY : SPACEPARITY;
+	dcbSerialParams.fParity = (parityInt == com_fazecast_jSerialComm_SerialPort_NO_PARITY) ? FALSE : TRUE;
+
+	// Apply all changes in a single update
+	if (!SetCommState(port->handle, &dcbSerialParams))
+	{
+		port->errorLineNumber = lastErrorLineNumber = __LINE__ - 2;
+		port->errorNumber = lastErrorNumber = GetLastError();
 		return JNI_FALSE;
 	}
+	setCharacterTime(port, baudRate, byteSizeInt, stopBitsInt, parityInt);
 	return JNI_TRUE;
 }
 
-JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_waitForEvent(JNIEnv *env, jobject obj, jlong serialPortPointer)
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_flushRxTxBuffers(JNIEnv *env, jobject obj, jlong serialPortPointer)
 {
-	// Create an asynchronous event structure
-	OVERLAPPED overlappedStruct;
-	memset(&overlappedStruct, 0, sizeof(OVERLAPPED));
 	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
-	overlappedStruct.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
-	jint event = com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_TIMED_OUT;
-	if (!overlappedStruct.hEvent)
+	if (purgeDevice(port, PURGE_RXABORT | PURGE_RXCLEAR | PURGE_TXABORT | PURGE_TXCLEAR) == 0)
 	{
+		port->errorLineNumber = __LINE__ - 2;
 		port->errorNumber = GetLastError();
-		port->errorLineNumber = __LINE__ - 5;
-		return event;
+		return JNI_FALSE;
 	}
 
-	// Wait for a serial port event
-	DWORD eventMask = 0, errorMask = 0, waitValue, numBytesTransferred;
-	if (!WaitCommEvent(port->handle, &eventMask, &overlappedStruct))
-	{
-		if ((GetLastError() == ERROR_IO_PENDING) || (GetLastError() == ERROR_INVALID_PARAMETER))
-		{
-			do { waitValue = WaitForSingleObject(overlappedStruct.hEvent, 500); }
-			while ((waitValue == WAIT_TIMEOUT) && port->eventListenerRunning);
-			if ((waitValue != WAIT_OBJECT_0) || !GetOverlappedResult(port->handle, &overlappedStruct, &numBytesTransferred, FALSE))
-			{
-				port->errorNumber = GetLastError();
-				port->errorLineNumber = __LINE__ - 3;
-				CloseHandle(overlappedStruct.hEvent);
-				return event;
-			}
-		}
-		else		// Problem occurred
-		{
-			event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_PORT_DISCONNECTED;
-			port->errorNumber = GetLastError();
-			port->errorLineNumber = __LINE__ - 18;
-			CloseHandle(overlappedStruct.hEvent);
-			return event;
-		}
-	}
+	// Discard any data already drained into the background ring buffer
+	if (port->ringBufferEnabled)
+		discardRingBuffer(port);
+	return JNI_TRUE;
+}
 
+// Serial event translation function
+static jint translateCommEvents(serialPort *port, DWORD eventMask)
+{
 	// Retrieve and clear any serial port errors
-	COMSTAT commInfo;
-	if (ClearCommError(port->handle, &errorMask, &commInfo))
+	DWORD errorMask = 0, numBytesQueuedIn = 0, numBytesQueuedOut = 0;
+	jint event = com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_TIMED_OUT;
+	if (getDeviceStatus(port, &errorMask, &numBytesQueuedIn, &numBytesQueuedOut))
 	{
+		errorMask |= (DWORD)InterlockedExchange(&port->ringErrorMask, 0);
 		if (errorMask & CE_BREAK)
 			event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_BREAK_INTERRUPT;
 		if (errorMask & CE_FRAME)
@@ -758,56 +1951,216 @@ JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_waitForEvent(JNI
 		event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_BREAK_INTERRUPT;
 	if (eventMask & EV_TXEMPTY)
 		event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_WRITTEN;
-	if ((eventMask & EV_RXCHAR) && (commInfo.cbInQue > 0))
+	if ((eventMask & EV_RXCHAR) && ((numBytesQueuedIn > 0) || (port->ringBufferEnabled && (port->ringHead != peekRingTail(port)))))
 		event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DATA_AVAILABLE;
-	if ((eventMask & EV_CTS) && GetCommModemStatus(port->handle, &modemStatus) && (modemStatus & MS_CTS_ON))
+	if ((eventMask & EV_CTS) && getModemStatus(port, &modemStatus) && (modemStatus & MS_CTS_ON))
 		event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_CTS;
-	if ((eventMask & EV_DSR) && GetCommModemStatus(port->handle, &modemStatus) && (modemStatus & MS_DSR_ON))
+	if ((eventMask & EV_DSR) && getModemStatus(port, &modemStatus) && (modemStatus & MS_DSR_ON))
 		event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_DSR;
-	if ((eventMask & EV_RING) && GetCommModemStatus(port->handle, &modemStatus) && (modemStatus & MS_RING_ON))
+	if ((eventMask & EV_RING) && getModemStatus(port, &modemStatus) && (modemStatus & MS_RING_ON))
 		event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_RING_INDICATOR;
-	if ((eventMask & EV_RLSD) && GetCommModemStatus(port->handle, &modemStatus) && (modemStatus & MS_RLSD_ON))
+	if ((eventMask & EV_RLSD) && getModemStatus(port, &modemStatus) && (modemStatus & MS_RLSD_ON))
 		event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_CARRIER_DETECT;
+	return event;
+}
+
+static jint waitForFtdiEvent(serialPort *port)
+{
+	// Derive the system event mask from changes in the D2XX device status, re-checking whenever the driver signals its notification event
+	DWORD eventMask = 0;
+	jint event = com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_TIMED_OUT;
+	while (!eventMask && port->eventListenerRunning)
+	{
+		DWORD errorMask = 0, numBytesQueuedIn = 0, numBytesQueuedOut = 0, modemStatus = 0;
+		if (!getDeviceStatus(port, &errorMask, &numBytesQueuedIn, &numBytesQueuedOut) || !getModemStatus(port, &modemStatus))
+		{
+			event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_PORT_DISCONNECTED;
+			port->errorNumber = GetLastError();
+			port->errorLineNumber = __LINE__ - 4;
+			return event;
+		}
+
+		// Retain any line errors for the event translation, and only report newly received data and modem lines that actually changed
+		DWORD changedLines = modemStatus ^ port->ftdiModemStatus;
+		port->ftdiModemStatus = modemStatus;
+		if (errorMask)
+		{
+			InterlockedOr(&port->ringErrorMask, (LONG)errorMask);
+			eventMask |= EV_ERR;
+		}
+		if (numBytesQueuedIn > port->ftdiReceivedBytes)
+			eventMask |= EV_RXCHAR;
+		port->ftdiReceivedBytes = numBytesQueuedIn;
+		if (port->ftdiTxPending && !numBytesQueuedOut)
+		{
+			port->ftdiTxPending = 0;
+			eventMask |= EV_TXEMPTY;
+		}
+		if (changedLines & MS_CTS_ON)
+			eventMask |= EV_CTS;
+		if (changedLines & MS_DSR_ON)
+			eventMask |= EV_DSR;
+		if (changedLines & MS_RING_ON)
+			eventMask |= EV_RING;
+		if (changedLines & MS_RLSD_ON)
+			eventMask |= EV_RLSD;
+		eventMask &= port->ftdiEventMask;
+		if (!eventMask)
+		{
+			HANDLE waitHandles[2] = { port->ftdiListenerEvent, port->listenerWakeEvent };
+			WaitForMultipleObjects(port->listenerWakeEvent ? 2 : 1, waitHandles, FALSE, FTDI_STATUS_POLL_INTERVAL_MS);
+		}
+	}
 
 	// Return the serial event type
-	CloseHandle(overlappedStruct.hEvent);
-	return event;
+	port->eventTimestamp = getPerformanceCounter();
+	return event | translateCommEvents(port, eventMask);
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_waitForEvent(JNIEnv *env, jobject obj, jlong serialPortPointer)
+{
+	// Wait for status changes reported by the D2XX driver if it owns the port
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	if (port->ftdiHandle)
+		return waitForFtdiEvent(port);
+
+	// Reuse the port's asynchronous event structure
+	OVERLAPPED *overlappedStruct = resetOverlapped(&port->eventOverlapped);
+	jint event = com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_TIMED_OUT;
+
+	// Wait for a serial port event
+	DWORD eventMask = 0, waitValue, numBytesTransferred;
+	if (!WaitCommEvent(port->handle, &eventMask, overlappedStruct))
+	{
+		if ((GetLastError() == ERROR_IO_PENDING) || (GetLastError() == ERROR_INVALID_PARAMETER))
+		{
+			// Wait for the event to occur or for the listener to be stopped, in which case the pending wait is cancelled
+			HANDLE waitHandles[2] = { (HANDLE)((ULONG_PTR)overlappedStruct->hEvent & ~(ULONG_PTR)1), port->listenerWakeEvent };
+			do { waitValue = WaitForMultipleObjects(port->listenerWakeEvent ? 2 : 1, waitHandles, FALSE, 500); }
+			while ((waitValue == WAIT_TIMEOUT) && port->eventListenerRunning);
+			if (waitValue != WAIT_OBJECT_0)
+			{
+				// Never leave the wait pending on the reusable structure, since the next call would reset it while the driver still owns it
+				DWORD waitError = GetLastError();
+				CancelIoEx(port->handle, overlappedStruct);
+				GetOverlappedResult(port->handle, overlappedStruct, &numBytesTransferred, TRUE);
+				if (waitValue == WAIT_FAILED)
+				{
+					port->errorNumber = waitError;
+					port->errorLineNumber = __LINE__ - 11;
+				}
+				return event;
+			}
+			if (!GetOverlappedResult(port->handle, overlappedStruct, &numBytesTransferred, FALSE))
+			{
+				port->errorNumber = GetLastError();
+				port->errorLineNumber = __LINE__ - 3;
+				return event;
+			}
+		}
+		else		// Problem occurred
+		{
+			event |= com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_PORT_DISCONNECTED;
+			port->errorNumber = GetLastError();
+			port->errorLineNumber = __LINE__ - 32;
+			return event;
+		}
+	}
+
+	// Return the serial event type
+	port->eventTimestamp = getPerformanceCounter();
+	return event | translateCommEvents(port, eventMask);
 }
 
-JNIEXPORT jlong JNICALL Java_com_fazecast_jSerialComm_SerialPort_closePortNative(JNIEnv *env, jobject obj, jlong serialPortPointer)
+JNIEXPORT jlong JNICALL Java_com_fazecast_jSerialComm_SerialPort_closePortNative(JNIEnv *env, jobject obj, jlong serialPortPointer, jboolean immediate)
 {
-	// Force the port to enter non-blocking mode to ensure that any current reads return
+	// Stop any background reader and writer before they lose access to the port, writing out any data that is still queued unless closing immediately
 	COMMTIMEOUTS timeouts;
 	memset(&timeouts, 0, sizeof(COMMTIMEOUTS));
 	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
-	timeouts.WriteTotalTimeoutMultiplier = 0;
-	timeouts.ReadIntervalTimeout = MAXDWORD;
-	timeouts.ReadTotalTimeoutMultiplier = 0;
-	timeouts.ReadTotalTimeoutConstant = 0;
-	timeouts.WriteTotalTimeoutConstant = 0;
-	SetCommTimeouts(port->handle, &timeouts);
-
-	// Purge any outstanding port operations
-	PurgeComm(port->handle, PURGE_RXABORT | PURGE_RXCLEAR | PURGE_TXABORT | PURGE_TXCLEAR);
-	CancelIoEx(port->handle, NULL);
-	FlushFileBuffers(port->handle);
-	SetCommMask(port->handle, 0);
-
-	// Close the port
-	port->eventListenerRunning = 0;
-	port->errorLineNumber = lastErrorLineNumber = __LINE__ + 1;
-	port->errorNumber = lastErrorNumber = (!CloseHandle(port->handle) ? GetLastError() : 0);
+	stopRingReader(port);
+	stopTxWriter(port, immediate);
+	stopRecording(port);
+	EnterCriticalSection(&port->rs485Lock);
+	port->rs485SoftwareControl = 0;
+	setRs485Timing(port, FALSE);
+	LeaveCriticalSection(&port->rs485Lock);
+
+	// Release the D2XX driver handle directly if it owns the port, which also wakes any threads waiting for its notifications
+	if (port->ftdiHandle)
+	{
+		port->eventListenerRunning = 0;
+		purgeDevice(port, PURGE_RXABORT | PURGE_RXCLEAR | PURGE_TXABORT | PURGE_TXCLEAR);
+		port->errorLineNumber = lastErrorLineNumber = __LINE__ + 1;
+		port->errorNumber = lastErrorNumber = (!closeFtdiPort(port) ? GetLastError() : 0);
+	}
+	else
+	{
+		// Force the port to enter non-blocking mode to ensure that any current reads return
+		timeouts.WriteTotalTimeoutMultiplier = 0;
+		timeouts.ReadIntervalTimeout = MAXDWORD;
+		timeouts.ReadTotalTimeoutMultiplier = 0;
+		timeouts.ReadTotalTimeoutConstant = 0;
+		timeouts.WriteTotalTimeoutConstant = 0;
+		SetCommTimeouts(port->handle, &timeouts);
+
+		// Purge any outstanding port operations
+		PurgeComm(port->handle, PURGE_RXABORT | PURGE_RXCLEAR | PURGE_TXABORT | PURGE_TXCLEAR);
+		CancelIoEx(port->handle, NULL);
+		if (!immediate)
+			FlushFileBuffers(port->handle);
+		SetCommMask(port->handle, 0);
+
+		// Close the port
+		port->eventListenerRunning = 0;
+		port->errorLineNumber = lastErrorLineNumber = __LINE__ + 1;
+		port->errorNumber = lastErrorNumber = (!CloseHandle(port->handle) ? GetLastError() : 0);
+	}
+	port->eventEngineHandle = NULL;
+	destroyOverlappedEvents(port);
+
+	// Ensure that user-specified or unplugged ports are dropped from the next port listing
+	AcquireSRWLockExclusive(&serialPortsLock);
 	port->handle = INVALID_HANDLE_VALUE;
+	port->ftdiHandle = NULL;
+	portsEnumerated = 0;
+	ReleaseSRWLockExclusive(&serialPortsLock);
 	return 0;
 }
 
 JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_bytesAvailable(JNIEnv *env, jobject obj, jlong serialPortPointer)
 {
-	// Retrieve bytes available to read
-	COMSTAT commInfo;
+	// Retrieve bytes available to read from the background ring buffer or the device
+	DWORD numBytesQueuedIn = 0, numBytesQueuedOut = 0;
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	if (port->ringBufferEnabled)
+		return (jint)(InterlockedCompareExchange(&port->ringHead, 0, 0) - peekRingTail(port));
+	if (getDeviceStatus(port, NULL, &numBytesQueuedIn, &numBytesQueuedOut))
+		return numBytesQueuedIn;
+	else
+	{
+		port->errorLineNumber = __LINE__ - 4;
+		port->errorNumber = GetLastError();
+	}
+	return -1;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_bytesAwaitingWrite(JNIEnv *env, jobject obj, jlong serialPortPointer)
+{
+	// Retrieve bytes awaiting write, including any data still waiting in the background transmit queue
+	DWORD numBytesQueuedIn = 0, numBytesQueuedOut = 0;
 	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
-	if (ClearCommError(port->handle, NULL, &commInfo))
-		return commInfo.cbInQue;
+	if (getDeviceStatus(port, NULL, &numBytesQueuedIn, &numBytesQueuedOut))
+	{
+		DWORD numBytesQueued = 0;
+		if (port->txQueueEnabled)
+		{
+			EnterCriticalSection(&port->txLock);
+			numBytesQueued = port->txHead - port->txTail;
+			LeaveCriticalSection(&port->txLock);
+		}
+		return (jint)(numBytesQueuedOut + numBytesQueued);
+	}
 	else
 	{
 		port->errorLineNumber = __LINE__ - 4;
@@ -816,119 +2169,1098 @@ JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_bytesAvailable(J
 	return -1;
 }
 
-JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_bytesAwaitingWrite(JNIEnv *env, jobject obj, jlong serialPortPointer)
-{
-	// Retrieve bytes awaiting write
-	COMSTAT commInfo;
-	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
-	if (ClearCommError(port->handle, NULL, &commInfo))
-		return commInfo.cbOutQue;
-	else
+// Background ring buffer consuming function
+static int readFromRing(serialPort *port, char *readBuffer, DWORD bytesToRead, int timeoutMode, int readTimeout)
+{
+	// Determine whether to wait for all requested bytes, any bytes, or none at all
+	DWORD numBytesReadTotal = 0;
+	ULONGLONG deadline = GetTickCount64() + (ULONGLONG)readTimeout;
+	int waitForAll = ((timeoutMode & com_fazecast_jSerialComm_SerialPort_TIMEOUT_READ_BLOCKING) > 0);
+	int waitForAny = waitForAll || ((timeoutMode & (com_fazecast_jSerialComm_SerialPort_TIMEOUT_READ_SEMI_BLOCKING | com_fazecast_jSerialComm_SerialPort_TIMEOUT_SCANNER)) > 0);
+
+	// Copy data out of the ring buffer until the current timeout mode is satisfied
+	while (numBytesReadTotal < bytesToRead)
+	{
+		LONG tail = consumeRingDiscard(port);
+		DWORD numBytesAvailable = (DWORD)(InterlockedCompareExchange(&port->ringHead, 0, 0) - tail);
+		if (numBytesAvailable)
+		{
+			DWORD numBytesToCopy = bytesToRead - numBytesReadTotal, offset = (DWORD)tail & (port->ringBufferLength - 1);
+			if (numBytesToCopy > numBytesAvailable)
+				numBytesToCopy = numBytesAvailable;
+			DWORD firstSegment = (numBytesToCopy > (port->ringBufferLength - offset)) ? (port->ringBufferLength - offset) : numBytesToCopy;
+			if (!numBytesReadTotal)
+				port->readTimestamp = InterlockedCompareExchange64(&port->ringTimestamp, 0, 0);
+			memcpy(readBuffer + numBytesReadTotal, port->ringBuffer + offset, firstSegment);
+			memcpy(readBuffer + numBytesReadTotal + firstSegment, port->ringBuffer, numBytesToCopy - firstSegment);
+			advanceRingTail(port, tail + (LONG)numBytesToCopy);
+			numBytesReadTotal += numBytesToCopy;
+			if (!waitForAll)
+				break;
+		}
+		else if (!waitForAny || !port->ringReaderRunning)
+			break;
+		else
+		{
+			// Announce that we are waiting before re-checking so that the reader cannot miss the wakeup
+			ULONGLONG currentTime = GetTickCount64();
+			if ((readTimeout > 0) && (currentTime >= deadline))
+			{
+				addStatistic(&port->statistics.readTimeouts, 1);
+				break;
+			}
+			ResetEvent(port->ringDataEvent);
+			InterlockedIncrement(&port->ringReaderWaiting);
+			if ((InterlockedCompareExchange(&port->ringHead, 0, 0) == tail) && port->ringReaderRunning)
+				WaitForSingleObject(port->ringDataEvent, (readTimeout > 0) ? (DWORD)(deadline - currentTime) : INFINITE);
+			InterlockedDecrement(&port->ringReaderWaiting);
+		}
+	}
+
+	// Report an error only if the reader stopped due to a device problem and no data remains
+	if (!numBytesReadTotal && bytesToRead && !port->ringReaderRunning)
+	{
+		port->errorLineNumber = __LINE__ - 2;
+		port->errorNumber = ERROR_OPERATION_ABORTED;
+		return -1;
+	}
+	return (int)numBytesReadTotal;
+}
+
+// Direct device reading function
+static int readFromDevice(serialPort *port, char *readBuffer, DWORD bytesToRead, int timeoutMode, int readTimeout)
+{
+	// Reuse the port's asynchronous read structure, holding it until the operation completes so that concurrent readers cannot share it
+	EnterCriticalSection(&port->readLock);
+	OVERLAPPED *overlappedStruct = resetOverlapped(&port->readOverlapped);
+
+	// Read from the serial port
+	BOOL result;
+	DWORD numBytesRead = 0;
+	addStatistic(&port->statistics.readSyscalls, 1);
+	if (((result = ReadFile(port->handle, readBuffer, bytesToRead, NULL, overlappedStruct)) == FALSE) && (GetLastError() != ERROR_IO_PENDING))
+	{
+		port->errorLineNumber = __LINE__ - 2;
+		port->errorNumber = GetLastError();
+	}
+	else if ((result = GetOverlappedResult(port->handle, overlappedStruct, &numBytesRead, TRUE)) == FALSE)
+	{
+		port->errorLineNumber = __LINE__ - 2;
+		port->errorNumber = GetLastError();
+	}
+	LeaveCriticalSection(&port->readLock);
+
+	// Note when the data was handed over by the driver
+	if ((result == TRUE) && numBytesRead)
+	{
+		port->readTimestamp = getPerformanceCounter();
+		recordTraffic(port, RECORDING_DIRECTION_RECEIVED, port->readTimestamp, readBuffer, numBytesRead);
+	}
+
+	// Count reads that returned early because the configured timeout expired
+	if ((result == TRUE) && (readTimeout > 0) && (numBytesRead < bytesToRead) &&
+			(((timeoutMode & com_fazecast_jSerialComm_SerialPort_TIMEOUT_READ_BLOCKING) > 0) || (((timeoutMode & com_fazecast_jSerialComm_SerialPort_TIMEOUT_READ_SEMI_BLOCKING) > 0) && !numBytesRead)))
+		addStatistic(&port->statistics.readTimeouts, 1);
+
+	// Return number of bytes read
+	return (result == TRUE) ? numBytesRead : -1;
+}
+
+// Direct D2XX device reading function
+static int readFromFtdiDevice(serialPort *port, char *readBuffer, DWORD bytesToRead, int timeoutMode, int readTimeout)
+{
+	// Determine whether to wait for all requested bytes, any bytes, or none at all, and for how long
+	DWORD numBytesReadTotal = 0;
+	ULONGLONG deadline = GetTickCount64() + (ULONGLONG)readTimeout, idleDeadline = 0;
+	int waitForAll = ((timeoutMode & com_fazecast_jSerialComm_SerialPort_TIMEOUT_READ_BLOCKING) > 0);
+	int waitForAny = waitForAll || ((timeoutMode & (com_fazecast_jSerialComm_SerialPort_TIMEOUT_READ_SEMI_BLOCKING | com_fazecast_jSerialComm_SerialPort_TIMEOUT_SCANNER)) > 0);
+	int waitForIdle = !waitForAll && ((timeoutMode & com_fazecast_jSerialComm_SerialPort_TIMEOUT_READ_SEMI_BLOCKING) > 0) && (port->ftdiInterByteTimeout > 0);
+	if ((readTimeout <= 0) || (timeoutMode & com_fazecast_jSerialComm_SerialPort_TIMEOUT_SCANNER))
+		deadline = ~0ULL;
+
+	// Read only what is already queued in the driver so that its timeouts can never block this call
+	while (numBytesReadTotal < bytesToRead)
+	{
+		DWORD numBytesQueuedIn = 0, numBytesQueuedOut = 0, numBytesRead = 0;
+		if (!getDeviceStatus(port, NULL, &numBytesQueuedIn, &numBytesQueuedOut))
+		{
+			port->errorLineNumber = __LINE__ - 2;
+			port->errorNumber = GetLastError();
+			return -1;
+		}
+		if (numBytesQueuedIn)
+		{
+			if (numBytesQueuedIn > (bytesToRead - numBytesReadTotal))
+				numBytesQueuedIn = bytesToRead - numBytesReadTotal;
+			addStatistic(&port->statistics.readSyscalls, 1);
+			if (!ftdiSucceeded(ftdiDriver.Read(port->ftdiHandle, readBuffer + numBytesReadTotal, numBytesQueuedIn, &numBytesRead)))
+			{
+				port->errorLineNumber = __LINE__ - 2;
+				port->errorNumber = GetLastError();
+				return -1;
+			}
+
+			// Note when the first data was handed over by the driver
+			if (numBytesRead)
+			{
+				LONGLONG arrivalTime = getPerformanceCounter();
+				if (!numBytesReadTotal)
+					port->readTimestamp = arrivalTime;
+				recordTraffic(port, RECORDING_DIRECTION_RECEIVED, arrivalTime, readBuffer + numBytesReadTotal, numBytesRead);
+				numBytesReadTotal += numBytesRead;
+				idleDeadline = GetTickCount64() + port->ftdiInterByteTimeout;
+			}
+			if (!waitForAll && !waitForIdle)
+				break;
+			continue;
+		}
+		else if (!waitForAny)
+			break;
+
+		// Wait for the driver to signal new data until the read timeout or the inter-byte idle timeout expires
+		ULONGLONG currentTime = GetTickCount64(), waitDeadline = (waitForIdle && numBytesReadTotal && (idleDeadline < deadline)) ? idleDeadline : deadline;
+		if (currentTime >= waitDeadline)
+			break;
+		WaitForSingleObject(port->ftdiReadEvent, ((waitDeadline - currentTime) < FTDI_STATUS_POLL_INTERVAL_MS) ? (DWORD)(waitDeadline - currentTime) : FTDI_STATUS_POLL_INTERVAL_MS);
+	}
+
+	// Count reads that returned early because the configured timeout expired
+	if ((readTimeout > 0) && (numBytesReadTotal < bytesToRead) &&
+			(((timeoutMode & com_fazecast_jSerialComm_SerialPort_TIMEOUT_READ_BLOCKING) > 0) || (((timeoutMode & com_fazecast_jSerialComm_SerialPort_TIMEOUT_READ_SEMI_BLOCKING) > 0) && !numBytesReadTotal)))
+		addStatistic(&port->statistics.readTimeouts, 1);
+	return (int)numBytesReadTotal;
+}
+
+// Generalized port reading function
+static int readFromPort(serialPort *port, char *readBuffer, DWORD bytesToRead, int timeoutMode, int readTimeout)
+{
+	// Serve all reads from the background ring buffer if it is enabled, or directly from the D2XX driver if it owns the port
+	LONGLONG startTime = getPerformanceCounter();
+	int numBytesRead = port->ringBufferEnabled ? readFromRing(port, readBuffer, bytesToRead, timeoutMode, readTimeout) :
+			port->ftdiHandle ? readFromFtdiDevice(port, readBuffer, bytesToRead, timeoutMode, readTimeout) : readFromDevice(port, readBuffer, bytesToRead, timeoutMode, readTimeout);
+
+	// Update the port statistics
+	addStatistic(&port->statistics.readCalls, 1);
+	if (numBytesRead >= 0)
+		addStatistic(&port->statistics.bytesRead, numBytesRead);
+	if ((numBytesRead >= 0) && ((DWORD)numBytesRead < bytesToRead))
+		addStatistic(&port->statistics.shortReads, 1);
+	recordLatency(port->statistics.readLatency, startTime);
+	return numBytesRead;
+}
+
+// Intermediate read buffer allocation function
+static BOOL reserveReadBuffer(serialPort *port, int bytesToRead)
+{
+	if (bytesToRead > port->readBufferLength)
+	{
+		port->errorLineNumber = __LINE__ + 1;
+		char *newMemory = (char*)realloc(port->readBuffer, bytesToRead);
+		if (!newMemory)
+		{
+			port->errorNumber = errno;
+			return FALSE;
+		}
+		port->readBuffer = newMemory;
+		port->readBufferLength = bytesToRead;
+	}
+	return TRUE;
+}
+
+// Background transmit queue writing function
+static int writeToQueue(serialPort *port, const char *writeBuffer, DWORD bytesToWrite, LONGLONG deadlineNS)
+{
+	// Copy as much data as possible into the transmit queue, waiting until the deadline for space to become available if backpressure is enabled
+	DWORD numBytesQueued = 0;
+	EnterCriticalSection(&port->txLock);
+	while ((numBytesQueued < bytesToWrite) && port->txWriterRunning && !port->txFailed)
+	{
+		DWORD freeSpace = port->txBufferLength - (port->txHead - port->txTail);
+		if (!freeSpace)
+		{
+			LONGLONG remainingNS = (deadlineNS >= 0) ? (deadlineNS - getMonotonicTimeNS()) : 0;
+			if (!port->txBlockWhenFull || ((deadlineNS >= 0) && (remainingNS <= 0)))
+				break;
+			SleepConditionVariableCS(&port->txSpaceAvailable, &port->txLock, (deadlineNS >= 0) ? (DWORD)((remainingNS + 999999LL) / 1000000LL) : INFINITE);
+			continue;
+		}
+		DWORD offset = port->txHead & (port->txBufferLength - 1), numBytesToCopy = port->txBufferLength - offset;
+		if (numBytesToCopy > freeSpace)
+			numBytesToCopy = freeSpace;
+		if (numBytesToCopy > (bytesToWrite - numBytesQueued))
+			numBytesToCopy = bytesToWrite - numBytesQueued;
+		memcpy(port->txBuffer + offset, writeBuffer + numBytesQueued, numBytesToCopy);
+		port->txHead += numBytesToCopy;
+		numBytesQueued += numBytesToCopy;
+		WakeConditionVariable(&port->txDataQueued);
+	}
+
+	// Report any failure of the background writer that prevented data from being queued
+	int result = (!numBytesQueued && port->txFailed) ? -1 : (int)numBytesQueued;
+	LeaveCriticalSection(&port->txLock);
+	return result;
+}
+
+// Returns the monotonic deadline for a write starting now, or -1 if writes may block forever
+static inline LONGLONG getWriteDeadline(serialPort *port)
+{
+	return (port->writeTimeout > 0) ? (getMonotonicTimeNS() + (port->writeTimeout * 1000000LL)) : -1;
+}
+
+// Waits for an overlapped operation to complete, cancelling it at the monotonic deadline (if not negative) while keeping any partial result
+static BOOL getOverlappedResultUntil(serialPort *port, OVERLAPPED *overlappedStruct, DWORD *numBytesTransferred, LONGLONG deadlineNS)
+{
+	if (deadlineNS >= 0)
+	{
+		LONGLONG remainingNS = deadlineNS - getMonotonicTimeNS();
+		HANDLE completionEvent = (HANDLE)((ULONG_PTR)overlappedStruct->hEvent & ~(ULONG_PTR)1);
+		if (WaitForSingleObject(completionEvent, (remainingNS > 0) ? (DWORD)((remainingNS + 999999LL) / 1000000LL) : 0) == WAIT_TIMEOUT)
+			CancelIoEx(port->handle, overlappedStruct);
+	}
+	return GetOverlappedResult(port->handle, overlappedStruct, numBytesTransferred, TRUE) || (GetLastError() == ERROR_OPERATION_ABORTED);
+}
+
+// Generalized port writing function
+static int writeToPort(serialPort *port, const char *writeBuffer, DWORD bytesToWrite, LONGLONG deadlineNS)
+{
+	// Hand the data over to the background writer if the transmit queue is enabled
+	LONGLONG startTime = getPerformanceCounter();
+	if (port->txQueueEnabled)
+	{
+		int numBytesQueued = writeToQueue(port, writeBuffer, bytesToWrite, deadlineNS);
+		addStatistic(&port->statistics.writeCalls, 1);
+		if (numBytesQueued > 0)
+			addStatistic(&port->statistics.bytesWritten, numBytesQueued);
+		recordLatency(port->statistics.writeLatency, startTime);
+		return numBytesQueued;
+	}
+
+	// Reuse the port's asynchronous write structure, holding it until the operation completes so that concurrent writers cannot share it
+	EnterCriticalSection(&port->writeLock);
+	OVERLAPPED *overlappedStruct = resetOverlapped(&port->writeOverlapped);
+
+	// Write to the serial port, switching the bus direction around the transmission if using software RS-485 control
+	BOOL result, rs485SoftwareControl = port->rs485SoftwareControl;
+	DWORD numBytesWritten = 0;
+	LONGLONG rs485StartTimeNS = rs485SoftwareControl ? beginRs485Transmission(port) : 0;
+	addStatistic(&port->statistics.writeSyscalls, 1);
+	if (port->ftdiHandle)
+	{
+		if ((result = ftdiSucceeded(ftdiDriver.Write(port->ftdiHandle, (LPVOID)writeBuffer, bytesToWrite, &numBytesWritten))) == FALSE)
+		{
+			port->errorLineNumber = __LINE__ - 2;
+			port->errorNumber = GetLastError();
+		}
+		port->ftdiTxPending = 1;
+	}
+	else if (((result = WriteFile(port->handle, writeBuffer, bytesToWrite, NULL, overlappedStruct)) == FALSE) && (GetLastError() != ERROR_IO_PENDING))
+	{
+		port->errorLineNumber = __LINE__ - 2;
+		port->errorNumber = GetLastError();
+	}
+	else if ((result = getOverlappedResultUntil(port, overlappedStruct, &numBytesWritten, deadlineNS)) == FALSE)
+	{
+		port->errorLineNumber = __LINE__ - 2;
+		port->errorNumber = GetLastError();
+	}
+	if (rs485SoftwareControl)
+		endRs485Transmission(port, rs485StartTimeNS, (result == TRUE) ? numBytesWritten : 0);
+	LeaveCriticalSection(&port->writeLock);
+
+	// Update the port statistics and return number of bytes written
+	addStatistic(&port->statistics.writeCalls, 1);
+	if (result == TRUE)
+	{
+		addStatistic(&port->statistics.bytesWritten, numBytesWritten);
+		recordTraffic(port, RECORDING_DIRECTION_TRANSMITTED, 0, writeBuffer, numBytesWritten);
+	}
+	recordLatency(port->statistics.writeLatency, startTime);
+	return (result == TRUE) ? numBytesWritten : -1;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_readBytes(JNIEnv *env, jobject obj, jlong serialPortPointer, jbyteArray buffer, jlong bytesToRead, jlong offset, jint timeoutMode, jint readTimeout)
+{
+	// Ensure that the allocated read buffer is large enough
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	if (!reserveReadBuffer(port, (int)bytesToRead))
+		return -1;
+
+	// Read from the serial port and return number of bytes read
+	int numBytesRead = readFromPort(port, port->readBuffer, (DWORD)bytesToRead, timeoutMode, readTimeout);
+	if (numBytesRead > 0)
+	{
+		(*env)->SetByteArrayRegion(env, buffer, offset, numBytesRead, (jbyte*)port->readBuffer);
+		checkJniError(env, __LINE__ - 1);
+	}
+	return numBytesRead;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_readBytesTimestamped(JNIEnv *env, jobject obj, jlong serialPortPointer, jbyteArray buffer, jlong bytesToRead, jlong offset, jint timeoutMode, jint readTimeout, jlongArray receiveTimestamp)
+{
+	// Ensure that the allocated read buffer is large enough
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	if (!reserveReadBuffer(port, (int)bytesToRead))
+		return -1;
+
+	// Read from the serial port and capture the arrival time of the returned data before any other read can replace it
+	int numBytesRead = readFromPort(port, port->readBuffer, (DWORD)bytesToRead, timeoutMode, readTimeout);
+	if (numBytesRead > 0)
+	{
+		jlong timestampNS = (jlong)getNanoseconds(port->readTimestamp);
+		(*env)->SetByteArrayRegion(env, buffer, offset, numBytesRead, (jbyte*)port->readBuffer);
+		if (checkJniError(env, __LINE__ - 1)) return -1;
+		(*env)->SetLongArrayRegion(env, receiveTimestamp, 0, 1, &timestampNS);
+		if (checkJniError(env, __LINE__ - 1)) return -1;
+	}
+	return numBytesRead;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_readBytesDirect(JNIEnv *env, jobject obj, jlong serialPortPointer, jobject buffer, jlong bytesToRead, jlong offset, jint timeoutMode, jint readTimeout)
+{
+	// Retrieve the native memory address backing the direct buffer
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	char *readBuffer = (char*)(*env)->GetDirectBufferAddress(env, buffer);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	if (!readBuffer)
+	{
+		port->errorLineNumber = __LINE__ - 4;
+		port->errorNumber = ERROR_INVALID_PARAMETER;
+		return -1;
+	}
+
+	// Read from the serial port directly into the buffer memory
+	return readFromPort(port, readBuffer + offset, (DWORD)bytesToRead, timeoutMode, readTimeout);
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_readBytesAhead(JNIEnv *env, jobject obj, jlong serialPortPointer, jbyteArray buffer, jlong bufferSize, jint timeoutMode, jint readTimeout)
+{
+	// Ensure that the allocated read buffer is large enough
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	if (!reserveReadBuffer(port, (int)bufferSize))
+		return -1;
+
+	// Wait for the first byte according to the current timeout mode, then collect only the data that is already queued so that the read cannot block again
+	int numBytesRead = readFromPort(port, port->readBuffer, 1, timeoutMode, readTimeout);
+	if ((numBytesRead > 0) && (bufferSize > 1))
+	{
+		LONGLONG firstByteTimestamp = port->readTimestamp;
+		int numBytesAvailable = Java_com_fazecast_jSerialComm_SerialPort_bytesAvailable(env, obj, serialPortPointer);
+		if (numBytesAvailable > (int)(bufferSize - 1))
+			numBytesAvailable = (int)(bufferSize - 1);
+		if (numBytesAvailable > 0)
+		{
+			int numAdditionalBytesRead = readFromPort(port, port->readBuffer + 1, (DWORD)numBytesAvailable, com_fazecast_jSerialComm_SerialPort_TIMEOUT_NONBLOCKING, 0);
+			if (numAdditionalBytesRead > 0)
+				numBytesRead += numAdditionalBytesRead;
+		}
+		port->readTimestamp = firstByteTimestamp;
+	}
+
+	// Return the data and number of bytes read if successful
+	if (numBytesRead > 0)
+	{
+		(*env)->SetByteArrayRegion(env, buffer, 0, numBytesRead, (jbyte*)port->readBuffer);
+		checkJniError(env, __LINE__ - 1);
+	}
+	return numBytesRead;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_writeBytes(JNIEnv *env, jobject obj, jlong serialPortPointer, jbyteArray buffer, jlong bytesToWrite, jlong offset, jint timeoutMode)
+{
+	// Retrieve the data to write from the Java array
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	jbyte *writeBuffer = (*env)->GetByteArrayElements(env, buffer, 0);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+
+	// Write to the serial port and return number of bytes written
+	int numBytesWritten = writeToPort(port, (const char*)(writeBuffer + offset), (DWORD)bytesToWrite, getWriteDeadline(port));
+	(*env)->ReleaseByteArrayElements(env, buffer, writeBuffer, JNI_ABORT);
+	checkJniError(env, __LINE__ - 1);
+	return numBytesWritten;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_writeBytesDirect(JNIEnv *env, jobject obj, jlong serialPortPointer, jobject buffer, jlong bytesToWrite, jlong offset, jint timeoutMode)
+{
+	// Retrieve the native memory address backing the direct buffer
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	const char *writeBuffer = (const char*)(*env)->GetDirectBufferAddress(env, buffer);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	if (!writeBuffer)
+	{
+		port->errorLineNumber = __LINE__ - 4;
+		port->errorNumber = ERROR_INVALID_PARAMETER;
+		return -1;
+	}
+
+	// Write to the serial port directly from the buffer memory
+	return writeToPort(port, writeBuffer + offset, (DWORD)bytesToWrite, getWriteDeadline(port));
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_transact(JNIEnv *env, jobject obj, jlong serialPortPointer, jbyteArray request, jlong requestLength, jbyteArray response, jlong responseLength, jint expectedLength, jint terminator, jint silenceGapMicros, jint timeoutMS)
+{
+	// Ensure that the allocated read buffer is large enough for the response
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	LONGLONG deadlineUS = (timeoutMS > 0) ? (getMonotonicTimeUS() + (timeoutMS * 1000LL)) : -1;
+	if ((expectedLength > 0) && (expectedLength < responseLength))
+		responseLength = expectedLength;
+	if (!reserveReadBuffer(port, (int)responseLength))
+		return -1;
+
+	// Discard any stale input so that it cannot be mistaken for the response
+	purgeDevice(port, PURGE_RXCLEAR);
+	if (port->ringBufferEnabled)
+		discardRingBuffer(port);
+
+	// Transmit the complete request and wait for it to physically leave the device, all within the transaction deadline or else the write timeout
+	LONGLONG deadlineNS = (deadlineUS >= 0) ? (deadlineUS * 1000LL) : getWriteDeadline(port);
+	jbyte *writeBuffer = (*env)->GetByteArrayElements(env, request, 0);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	int numBytesWritten = writeToPort(port, (const char*)writeBuffer, (DWORD)requestLength, deadlineNS);
+	(*env)->ReleaseByteArrayElements(env, request, writeBuffer, JNI_ABORT);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	if (numBytesWritten != (int)requestLength)
+	{
+		if (numBytesWritten >= 0)
+		{
+			port->errorLineNumber = __LINE__ - 7;
+			port->errorNumber = ERROR_TIMEOUT;
+		}
+		return -1;
+	}
+	if (port->txQueueEnabled)
+	{
+		LONGLONG remainingNS = (deadlineNS >= 0) ? (deadlineNS - getMonotonicTimeNS()) : 0;
+		int remainingMS = (deadlineNS < 0) ? 0 : (remainingNS > 1000000LL) ? (int)((remainingNS + 999999LL) / 1000000LL) : 1;
+		if (!Java_com_fazecast_jSerialComm_SerialPort_flushTransmitQueue(env, obj, serialPortPointer, remainingMS, JNI_TRUE))
+			return -1;
+	}
+	else if (!drainDevice(port, deadlineNS))
+	{
+		port->errorLineNumber = lastErrorLineNumber = __LINE__ - 2;
+		port->errorNumber = lastErrorNumber = GetLastError();
+		return -1;
+	}
+
+	// Let the driver time the inter-character gap directly unless a background reader or the D2XX driver owns the device
+	COMMTIMEOUTS originalTimeouts, timeouts;
+	BOOL useDriverTimeouts = !port->ringBufferEnabled && !port->ftdiHandle && GetCommTimeouts(port->handle, &originalTimeouts);
+	BOOL useTerminator = ((terminator >= 0) && (terminator <= 255)), responseComplete = FALSE;
+	DWORD silenceGapMS = (silenceGapMicros > 0) ? (DWORD)((silenceGapMicros + 999) / 1000) : 0;
+
+	// Read the response until it is complete, the line goes silent, or the deadline expires
+	int numBytesReceived = 0;
+	LONGLONG lastByteTimeUS = 0;
+	while (!responseComplete && (numBytesReceived < (int)responseLength))
+	{
+		// Limit the wait to the inter-character silence gap once the response has started
+		LONGLONG currentTimeUS = getMonotonicTimeUS(), waitDeadlineUS = deadlineUS;
+		if (numBytesReceived && (silenceGapMicros > 0) && ((waitDeadlineUS < 0) || ((lastByteTimeUS + silenceGapMicros) < waitDeadlineUS)))
+			waitDeadlineUS = lastByteTimeUS + silenceGapMicros;
+		if ((waitDeadlineUS >= 0) && (currentTimeUS >= waitDeadlineUS))
+			break;
+		DWORD waitTimeMS = (waitDeadlineUS >= 0) ? (DWORD)((waitDeadlineUS - currentTimeUS + 999) / 1000) : 0;
+
+		// Wait for and read any newly received data
+		if (useDriverTimeouts)
+		{
+			// Return as soon as any data arrives if a terminator must be checked, otherwise let the driver detect the end of the response
+			timeouts = originalTimeouts;
+			timeouts.ReadIntervalTimeout = useTerminator ? MAXDWORD : silenceGapMS;
+			timeouts.ReadTotalTimeoutMultiplier = useTerminator ? MAXDWORD : 0;
+			timeouts.ReadTotalTimeoutConstant = (useTerminator && !waitTimeMS) ? 0x0FFFFFFF : waitTimeMS;
+			if (!SetCommTimeouts(port->handle, &timeouts))
+			{
+				port->errorLineNumber = lastErrorLineNumber = __LINE__ - 2;
+				port->errorNumber = lastErrorNumber = GetLastError();
+				numBytesReceived = -1;
+				break;
+			}
+		}
+		int numBytesRead = readFromPort(port, port->readBuffer + numBytesReceived, (DWORD)(responseLength - numBytesReceived), com_fazecast_jSerialComm_SerialPort_TIMEOUT_READ_SEMI_BLOCKING, (int)waitTimeMS);
+		if (numBytesRead < 0)
+		{
+			numBytesReceived = -1;
+			break;
+		}
+		else if (numBytesRead == 0)
+			continue;
+		lastByteTimeUS = getMonotonicTimeUS();
+
+		// Check whether the response is now complete
+		if (useTerminator)
+		{
+			char *terminatorLocation = (char*)memchr(port->readBuffer + numBytesReceived, terminator, numBytesRead);
+			if (terminatorLocation)
+			{
+				numBytesRead = (int)(terminatorLocation - (port->readBuffer + numBytesReceived)) + 1;
+				responseComplete = TRUE;
+			}
+		}
+		else if (useDriverTimeouts && silenceGapMS)
+			responseComplete = TRUE;
+		numBytesReceived += numBytesRead;
+		if ((expectedLength > 0) && (numBytesReceived >= expectedLength))
+			responseComplete = TRUE;
+	}
+
+	// Restore the configured port timeouts
+	if (useDriverTimeouts)
+		SetCommTimeouts(port->handle, &originalTimeouts);
+
+	// Return the response data and number of bytes received if successful
+	if (numBytesReceived > 0)
+	{
+		(*env)->SetByteArrayRegion(env, response, 0, numBytesReceived, (jbyte*)port->readBuffer);
+		checkJniError(env, __LINE__ - 1);
+	}
+	return numBytesReceived;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_writeBytesGather(JNIEnv *env, jobject obj, jlong serialPortPointer, jobjectArray directBuffers, jobjectArray arrayBuffers, jintArray offsets, jintArray lengths, jint timeoutMode)
+{
+	// Retrieve the segment extents
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	jint numSegments = (*env)->GetArrayLength(env, lengths);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	if (numSegments <= 0)
+		return 0;
+	jint *segmentOffsets = (jint*)malloc(numSegments * 2 * sizeof(jint)), *segmentLengths = segmentOffsets + numSegments;
+	if (!segmentOffsets)
+	{
+		port->errorLineNumber = __LINE__ - 3;
+		port->errorNumber = errno;
+		return -1;
+	}
+	(*env)->GetIntArrayRegion(env, offsets, 0, numSegments, segmentOffsets);
+	if (checkJniError(env, __LINE__ - 1)) { free(segmentOffsets); return -1; }
+	(*env)->GetIntArrayRegion(env, lengths, 0, numSegments, segmentLengths);
+	if (checkJniError(env, __LINE__ - 1)) { free(segmentOffsets); return -1; }
+
+	// Ensure that the coalescing buffer is large enough to hold all segments
+	int totalLength = 0;
+	for (jint i = 0; i < numSegments; ++i)
+		totalLength += segmentLengths[i];
+	if (totalLength > port->writeBufferLength)
+	{
+		port->errorLineNumber = __LINE__ + 1;
+		char *newMemory = (char*)realloc(port->writeBuffer, totalLength);
+		if (!newMemory)
+		{
+			port->errorNumber = errno;
+			free(segmentOffsets);
+			return -1;
+		}
+		port->writeBuffer = newMemory;
+		port->writeBufferLength = totalLength;
+	}
+
+	// Coalesce all segments into a single contiguous native buffer
+	int writeOffset = 0;
+	for (jint i = 0; i < numSegments; ++i)
+	{
+		jobject directBuffer = (*env)->GetObjectArrayElement(env, directBuffers, i);
+		if (checkJniError(env, __LINE__ - 1)) { free(segmentOffsets); return -1; }
+		if (directBuffer)
+		{
+			const char *segmentBase = (const char*)(*env)->GetDirectBufferAddress(env, directBuffer);
+			if (checkJniError(env, __LINE__ - 1)) { free(segmentOffsets); return -1; }
+			if (!segmentBase)
+			{
+				port->errorLineNumber = __LINE__ - 4;
+				port->errorNumber = ERROR_INVALID_PARAMETER;
+				free(segmentOffsets);
+				return -1;
+			}
+			memcpy(port->writeBuffer + writeOffset, segmentBase + segmentOffsets[i], segmentLengths[i]);
+			(*env)->DeleteLocalRef(env, directBuffer);
+		}
+		else
+		{
+			jbyteArray arrayBuffer = (jbyteArray)(*env)->GetObjectArrayElement(env, arrayBuffers, i);
+			if (checkJniError(env, __LINE__ - 1)) { free(segmentOffsets); return -1; }
+			(*env)->GetByteArrayRegion(env, arrayBuffer, segmentOffsets[i], segmentLengths[i], (jbyte*)(port->writeBuffer + writeOffset));
+			if (checkJniError(env, __LINE__ - 1)) { free(segmentOffsets); return -1; }
+			(*env)->DeleteLocalRef(env, arrayBuffer);
+		}
+		writeOffset += segmentLengths[i];
+	}
+	free(segmentOffsets);
+
+	// Write the entire frame using a single overlapped operation
+	return totalLength ? writeToPort(port, port->writeBuffer, (DWORD)totalLength, getWriteDeadline(port)) : 0;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_readAvailable(JNIEnv *env, jclass serialComm, jlongArray portHandles, jobjectArray directBuffers, jobjectArray arrayBuffers, jintArray offsets, jintArray lengths, jintArray results, jint timeoutMS)
+{
+	// Allocate space for the port handles and buffer extents
+	jint numPorts = (*env)->GetArrayLength(env, portHandles), numReady = 0;
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	if (numPorts <= 0)
+		return 0;
+	jlong *handles = (jlong*)malloc(numPorts * (sizeof(jlong) + (5 * sizeof(jint))));
+	if (!handles)
+	{
+		lastErrorLineNumber = __LINE__ - 3;
+		lastErrorNumber = errno;
+		return -1;
+	}
+	jint *bufferOffsets = (jint*)(handles + numPorts), *bufferLengths = bufferOffsets + numPorts, *numBytesReady = bufferLengths + numPorts, *numBytesRead = numBytesReady + numPorts, *ringWaiters = numBytesRead + numPorts;
+
+	// Retrieve the port handles and buffer extents
+	(*env)->GetLongArrayRegion(env, portHandles, 0, numPorts, handles);
+	if (checkJniError(env, __LINE__ - 1)) { free(handles); return -1; }
+	(*env)->GetIntArrayRegion(env, offsets, 0, numPorts, bufferOffsets);
+	if (checkJniError(env, __LINE__ - 1)) { free(handles); return -1; }
+	(*env)->GetIntArrayRegion(env, lengths, 0, numPorts, bufferLengths);
+	if (checkJniError(env, __LINE__ - 1)) { free(handles); return -1; }
+
+	// Collect an event to wait on for each port that has one, since only the standard driver without a ring buffer has to be polled for new data
+	HANDLE waitHandles[MAXIMUM_WAIT_OBJECTS];
+	DWORD numWaitHandles = 0, pollInterval = INFINITE;
+	for (jint i = 0; i < numPorts; ++i)
+	{
+		serialPort *port = (serialPort*)(intptr_t)handles[i];
+		ringWaiters[i] = port && port->ringBufferEnabled && port->ringDataEvent;
+		HANDLE waitHandle = !port ? NULL : ringWaiters[i] ? port->ringDataEvent : port->ftdiHandle ? port->ftdiReadEvent : NULL;
+		if (ringWaiters[i])
+			InterlockedIncrement(&port->ringReaderWaiting);
+		if (waitHandle && (numWaitHandles < MAXIMUM_WAIT_OBJECTS))
+			waitHandles[numWaitHandles++] = waitHandle;
+		else if (port)
+			pollInterval = 1;
+		if (port && port->ftdiHandle && (pollInterval > FTDI_STATUS_POLL_INTERVAL_MS))
+			pollInterval = FTDI_STATUS_POLL_INTERVAL_MS;
+	}
+
+	// Scan the driver queues of all ports until at least one has data or the timeout elapses, resetting the ring events first so that no new data can be missed
+	BOOL anyReady = FALSE;
+	ULONGLONG deadline = GetTickCount64() + (ULONGLONG)((timeoutMS > 0) ? timeoutMS : 0);
+	while (1)
+	{
+		for (jint i = 0; i < numPorts; ++i)
+			if (ringWaiters[i])
+				ResetEvent(((serialPort*)(intptr_t)handles[i])->ringDataEvent);
+		for (jint i = 0; i < numPorts; ++i)
+		{
+			numBytesRead[i] = 0;
+			numBytesReady[i] = handles[i] ? Java_com_fazecast_jSerialComm_SerialPort_bytesAvailable(env, NULL, handles[i]) : 0;
+			serialPort *port = (serialPort*)(intptr_t)handles[i];
+			if (!numBytesReady[i] && ringWaiters[i] && !port->ringReaderRunning)
+			{
+				// Report a ring buffer whose background reader stopped due to a device problem instead of waiting for data that will never arrive
+				port->errorLineNumber = __LINE__ - 3;
+				port->errorNumber = ERROR_OPERATION_ABORTED;
+				numBytesReady[i] = -1;
+			}
+			anyReady |= (numBytesReady[i] != 0);
+		}
+		ULONGLONG currentTime = GetTickCount64();
+		if (anyReady || (timeoutMS == 0) || ((timeoutMS > 0) && (currentTime >= deadline)) || (!numWaitHandles && (pollInterval == INFINITE)))
+			break;
+
+		// Sleep until any port signals new data, waking periodically only if some port has to be polled
+		DWORD waitTime = ((timeoutMS > 0) && ((deadline - currentTime) < pollInterval)) ? (DWORD)(deadline - currentTime) : pollInterval;
+		if (numWaitHandles)
+			WaitForMultipleObjects(numWaitHandles, waitHandles, FALSE, waitTime);
+		else
+			Sleep(waitTime);
+	}
+	for (jint i = 0; i < numPorts; ++i)
+		if (ringWaiters[i])
+			InterlockedDecrement(&((serialPort*)(intptr_t)handles[i])->ringReaderWaiting);
+
+	// Read only the data that is already available from each ready port
+	for (jint i = 0; i < numPorts; ++i)
+	{
+		serialPort *port = (serialPort*)(intptr_t)handles[i];
+		int numBytesAvailable = (numBytesReady[i] > bufferLengths[i]) ? bufferLengths[i] : numBytesReady[i];
+		if (numBytesAvailable <= 0)
+		{
+			numBytesRead[i] = (numBytesAvailable < 0) ? -1 : 0;
+			continue;
+		}
+
+		// Read straight into direct buffers, or through the intermediate buffer for heap arrays
+		jobject directBuffer = (*env)->GetObjectArrayElement(env, directBuffers, i);
+		if (checkJniError(env, __LINE__ - 1)) { free(handles); return -1; }
+		if (directBuffer)
+		{
+			char *readBuffer = (char*)(*env)->GetDirectBufferAddress(env, directBuffer);
+			if (checkJniError(env, __LINE__ - 1)) { free(handles); return -1; }
+			numBytesRead[i] = readBuffer ? readFromPort(port, readBuffer + bufferOffsets[i], (DWORD)numBytesAvailable, com_fazecast_jSerialComm_SerialPort_TIMEOUT_NONBLOCKING, 0) : -1;
+			(*env)->DeleteLocalRef(env, directBuffer);
+		}
+		else if (reserveReadBuffer(port, numBytesAvailable))
+		{
+			jbyteArray arrayBuffer = (jbyteArray)(*env)->GetObjectArrayElement(env, arrayBuffers, i);
+			if (checkJniError(env, __LINE__ - 1)) { free(handles); return -1; }
+			numBytesRead[i] = readFromPort(port, port->readBuffer, (DWORD)numBytesAvailable, com_fazecast_jSerialComm_SerialPort_TIMEOUT_NONBLOCKING, 0);
+			if (numBytesRead[i] > 0)
+			{
+				(*env)->SetByteArrayRegion(env, arrayBuffer, bufferOffsets[i], numBytesRead[i], (jbyte*)port->readBuffer);
+				if (checkJniError(env, __LINE__ - 1)) { free(handles); return -1; }
+			}
+			(*env)->DeleteLocalRef(env, arrayBuffer);
+		}
+		else
+			numBytesRead[i] = -1;
+		if (numBytesRead[i] > 0)
+			++numReady;
+	}
+
+	// Return the number of bytes read from each port
+	(*env)->SetIntArrayRegion(env, results, 0, numPorts, numBytesRead);
+	free(handles);
+	if (checkJniError(env, __LINE__ - 2)) return -1;
+	return numReady;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_setCurrentThreadScheduling(JNIEnv *env, jclass serialComm, jlong cpuAffinityMask, jint realTimePriority, jboolean roundRobin)
+{
+	// Apply the requested scheduling to the calling Java thread, since Windows has no round-robin policy to select
+	return applyThreadScheduling((long long)cpuAffinityMask, realTimePriority);
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_findMessageBoundaries(JNIEnv *env, jclass serialComm, jbyteArray data, jint length, jbyteArray delimiters, jintArray delimiterState, jintArray boundaries)
+{
+	// Retrieve the partial delimiter match carried over from the previous chunk
+	jint delimiterIndex = 0, numBoundaries = 0, numDelimiters = (*env)->GetArrayLength(env, delimiters);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	(*env)->GetIntArrayRegion(env, delimiterState, 0, 1, &delimiterIndex);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	if ((numDelimiters <= 0) || (length <= 0))
+		return 0;
+
+	// Access the array contents without copying them, noting that no other JNI calls are allowed until they are released
+	const unsigned char *dataBytes = (const unsigned char*)(*env)->GetPrimitiveArrayCritical(env, data, NULL);
+	const unsigned char *delimiterBytes = dataBytes ? (const unsigned char*)(*env)->GetPrimitiveArrayCritical(env, delimiters, NULL) : NULL;
+	jint *boundaryOffsets = delimiterBytes ? (jint*)(*env)->GetPrimitiveArrayCritical(env, boundaries, NULL) : NULL;
+	if (!boundaryOffsets)
+	{
+		if (delimiterBytes)
+			(*env)->ReleasePrimitiveArrayCritical(env, delimiters, (void*)delimiterBytes, JNI_ABORT);
+		if (dataBytes)
+			(*env)->ReleasePrimitiveArrayCritical(env, data, (void*)dataBytes, JNI_ABORT);
+		checkJniError(env, __LINE__ - 8);
+		return -1;
+	}
+
+	// Use the vectorized C library search to skip directly to each candidate first delimiter byte
+	jint offset = 0;
+	while (offset < length)
+	{
+		if (delimiterIndex == 0)
+		{
+			const unsigned char *candidate = (const unsigned char*)memchr(dataBytes + offset, delimiterBytes[0], length - offset);
+			if (!candidate)
+				break;
+			offset = (jint)(candidate - dataBytes);
+		}
+
+		// Confirm or reject the multi-byte delimiter one byte at a time
+		if (dataBytes[offset] == delimiterBytes[delimiterIndex])
+		{
+			if (++delimiterIndex == numDelimiters)
+			{
+				boundaryOffsets[numBoundaries++] = offset + 1;
+				delimiterIndex = 0;
+			}
+		}
+		else
+			delimiterIndex = (dataBytes[offset] == delimiterBytes[0]) ? 1 : 0;
+		++offset;
+	}
+
+	// Release the arrays and store the partial delimiter match for the next chunk
+	(*env)->ReleasePrimitiveArrayCritical(env, boundaries, boundaryOffsets, 0);
+	(*env)->ReleasePrimitiveArrayCritical(env, delimiters, (void*)delimiterBytes, JNI_ABORT);
+	(*env)->ReleasePrimitiveArrayCritical(env, data, (void*)dataBytes, JNI_ABORT);
+	(*env)->SetIntArrayRegion(env, delimiterState, 0, 1, &delimiterIndex);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	return numBoundaries;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_readFrames(JNIEnv *env, jobject obj, jlong serialPortPointer, jint bytesToRead, jint timeoutMode, jint readTimeout, jintArray decoderState, jbyteArray frameBuffer, jintArray boundaries)
+{
+	// Retrieve the decoder state and ensure that the frame buffer can hold all decoded bytes
+	jint state[FRAME_STATE_LENGTH];
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	(*env)->GetIntArrayRegion(env, decoderState, 0, FRAME_STATE_LENGTH, state);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	jint frameBufferLength = (*env)->GetArrayLength(env, frameBuffer);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	if ((state[FRAME_STATE_FRAME_LENGTH] + bytesToRead) > frameBufferLength)
+	{
+		port->errorLineNumber = lastErrorLineNumber = __LINE__ - 2;
+		port->errorNumber = lastErrorNumber = ERROR_INVALID_PARAMETER;
+		return -1;
+	}
+
+	// Read the raw bytes into the native intermediate buffer
+	if (!reserveReadBuffer(port, bytesToRead))
+		return -1;
+	int numBytesRead = readFromPort(port, port->readBuffer, (DWORD)bytesToRead, timeoutMode, readTimeout);
+	if (numBytesRead <= 0)
+		return numBytesRead;
+
+	// Decode the bytes directly into the Java frame buffer, noting that no other JNI calls are allowed until it is released
+	unsigned char *frames = (unsigned char*)(*env)->GetPrimitiveArrayCritical(env, frameBuffer, NULL);
+	jint *frameBoundaries = frames ? (jint*)(*env)->GetPrimitiveArrayCritical(env, boundaries, NULL) : NULL;
+	if (!frameBoundaries)
+	{
+		if (frames)
+			(*env)->ReleasePrimitiveArrayCritical(env, frameBuffer, frames, JNI_ABORT);
+		checkJniError(env, __LINE__ - 5);
+		return -1;
+	}
+	int numFrames = decodeFrames((const unsigned char*)port->readBuffer, numBytesRead, state, frames, frameBoundaries);
+	(*env)->ReleasePrimitiveArrayCritical(env, boundaries, frameBoundaries, 0);
+	(*env)->ReleasePrimitiveArrayCritical(env, frameBuffer, frames, 0);
+
+	// Store the updated decoder state for the next chunk
+	(*env)->SetIntArrayRegion(env, decoderState, 0, FRAME_STATE_LENGTH, state);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	return numFrames;
+}
+
+JNIEXPORT void JNICALL Java_com_fazecast_jSerialComm_SerialPort_setEventListeningStatus(JNIEnv *env, jobject obj, jlong serialPortPointer, jboolean eventListenerRunning)
+{
+	// Discard any stale wakeup before listening, or immediately release any thread still waiting for events when stopping
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	if (eventListenerRunning && port->listenerWakeEvent)
+		ResetEvent(port->listenerWakeEvent);
+	port->eventListenerRunning = eventListenerRunning;
+	if (!eventListenerRunning && port->listenerWakeEvent)
+		SetEvent(port->listenerWakeEvent);
+}
+
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_setBackgroundReading(JNIEnv *env, jobject obj, jlong serialPortPointer, jint bufferSize)
+{
+	// Stop any currently running background reader
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	stopRingReader(port);
+	if (bufferSize <= 0)
+		return JNI_TRUE;
+
+	// Round the ring buffer capacity up to a power of two so that indices can wrap freely
+	DWORD capacity = 64;
+	while ((capacity < (DWORD)bufferSize) && (capacity < 0x40000000))
+		capacity <<= 1;
+	if (capacity != port->ringBufferLength)
+	{
+		port->errorLineNumber = __LINE__ + 1;
+		char *newMemory = (char*)realloc(port->ringBuffer, capacity);
+		if (!newMemory)
+		{
+			port->errorNumber = errno;
+			return JNI_FALSE;
+		}
+		port->ringBuffer = newMemory;
+		port->ringBufferLength = capacity;
+	}
+
+	// Create the reader synchronization events upon first use
+	if (!port->ringDataEvent)
+	{
+		HANDLE readEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+		port->ringDataEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+		port->ringSpaceEvent = CreateEvent(NULL, FALSE, FALSE, NULL);
+		if (!readEvent || !port->ringDataEvent || !port->ringSpaceEvent)
+		{
+			port->errorLineNumber = __LINE__ - 5;
+			port->errorNumber = GetLastError();
+			if (readEvent)
+				CloseHandle(readEvent);
+			if (port->ringDataEvent)
+				CloseHandle(port->ringDataEvent);
+			if (port->ringSpaceEvent)
+				CloseHandle(port->ringSpaceEvent);
+			port->ringDataEvent = port->ringSpaceEvent = NULL;
+			return JNI_FALSE;
+		}
+		port->ringOverlapped.hEvent = (HANDLE)((ULONG_PTR)readEvent | 1);
+	}
+
+	// Remember the timeouts to restore once the background reader stops, then switch the standard driver to its blocking ring buffer reads
+	port->ringHead = port->ringTail = port->ringReaderWaiting = port->ringSpaceWaiting = port->ringDiscardHead = port->ringDiscardPending = port->ringErrorMask = 0;
+	port->ringBufferEnabled = port->ringReaderRunning = 1;
+	if (!port->ftdiHandle && (!GetCommTimeouts(port->handle, &port->configuredTimeouts) || !applyPortTimeouts(port)))
+	{
+		port->errorLineNumber = __LINE__ - 2;
+		port->errorNumber = GetLastError();
+		port->ringBufferEnabled = port->ringReaderRunning = 0;
+		return JNI_FALSE;
+	}
+
+	// Start the background reader thread
+	port->errorLineNumber = __LINE__ + 1;
+	if ((port->ringReaderThread = CreateThread(NULL, 0, ringReaderThread, port, 0, NULL)) == NULL)
 	{
-		port->errorLineNumber = __LINE__ - 4;
 		port->errorNumber = GetLastError();
+		port->ringBufferEnabled = port->ringReaderRunning = 0;
+		if (!port->ftdiHandle)
+			applyPortTimeouts(port);
+		return JNI_FALSE;
 	}
-	return -1;
+	return JNI_TRUE;
 }
 
-JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_readBytes(JNIEnv *env, jobject obj, jlong serialPortPointer, jbyteArray buffer, jlong bytesToRead, jlong offset, jint timeoutMode, jint readTimeout)
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_setTransmitQueue(JNIEnv *env, jobject obj, jlong serialPortPointer, jint bufferSize, jboolean blockWhenFull)
 {
-	// Ensure that the allocated read buffer is large enough
+	// Stop any currently running background writer once it has written out all queued data
 	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
-	if (bytesToRead > port->readBufferLength)
+	stopTxWriter(port, FALSE);
+	if (bufferSize <= 0)
+		return JNI_TRUE;
+
+	// Round the queue capacity up to a power of two so that indices can wrap freely
+	DWORD capacity = 64;
+	while ((capacity < (DWORD)bufferSize) && (capacity < 0x40000000))
+		capacity <<= 1;
+	if (capacity != port->txBufferLength)
 	{
 		port->errorLineNumber = __LINE__ + 1;
-		char *newMemory = (char*)realloc(port->readBuffer, bytesToRead);
+		char *newMemory = (char*)realloc(port->txBuffer, capacity);
 		if (!newMemory)
 		{
 			port->errorNumber = errno;
-			return -1;
+			return JNI_FALSE;
 		}
-		port->readBuffer = newMemory;
-		port->readBufferLength = bytesToRead;
+		port->txBuffer = newMemory;
+		port->txBufferLength = capacity;
 	}
 
-	// Create an asynchronous result structure
-	OVERLAPPED overlappedStruct;
-	memset(&overlappedStruct, 0, sizeof(OVERLAPPED));
-	overlappedStruct.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
-	if (overlappedStruct.hEvent == NULL)
+	// Create the writer completion event upon first use
+	if (!port->txOverlapped.hEvent)
 	{
-		port->errorNumber = GetLastError();
-		port->errorLineNumber = __LINE__ - 4;
-		CloseHandle(overlappedStruct.hEvent);
-		return -1;
+		HANDLE writeEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+		if (!writeEvent)
+		{
+			port->errorLineNumber = __LINE__ - 3;
+			port->errorNumber = GetLastError();
+			return JNI_FALSE;
+		}
+		port->txOverlapped.hEvent = (HANDLE)((ULONG_PTR)writeEvent | 1);
 	}
 
-	// Read from the serial port
-	BOOL result;
-	DWORD numBytesRead = 0;
-	if (((result = ReadFile(port->handle, port->readBuffer, bytesToRead, NULL, &overlappedStruct)) == FALSE) && (GetLastError() != ERROR_IO_PENDING))
-	{
-		port->errorLineNumber = __LINE__ - 2;
-		port->errorNumber = GetLastError();
-	}
-	else if ((result = GetOverlappedResult(port->handle, &overlappedStruct, &numBytesRead, TRUE)) == FALSE)
+	// Start the background writer thread
+	port->txHead = port->txTail = 0;
+	port->txDiscard = port->txFailed = 0;
+	port->txBlockWhenFull = blockWhenFull;
+	port->txQueueEnabled = port->txWriterRunning = 1;
+	port->errorLineNumber = __LINE__ + 1;
+	if ((port->txWriterThread = CreateThread(NULL, 0, txWriterThread, port, 0, NULL)) == NULL)
 	{
-		port->errorLineNumber = __LINE__ - 2;
 		port->errorNumber = GetLastError();
+		port->txQueueEnabled = port->txWriterRunning = 0;
+		return JNI_FALSE;
 	}
-
-	// Return number of bytes read
-	CloseHandle(overlappedStruct.hEvent);
-	(*env)->SetByteArrayRegion(env, buffer, offset, numBytesRead, (jbyte*)port->readBuffer);
-	checkJniError(env, __LINE__ - 1);
-	return (result == TRUE) ? numBytesRead : -1;
+	return JNI_TRUE;
 }
 
-JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_writeBytes(JNIEnv *env, jobject obj, jlong serialPortPointer, jbyteArray buffer, jlong bytesToWrite, jlong offset, jint timeoutMode)
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_flushTransmitQueue(JNIEnv *env, jobject obj, jlong serialPortPointer, jint timeoutMS, jboolean drainRequested)
 {
-	// Create an asynchronous result structure
-	OVERLAPPED overlappedStruct;
-	memset(&overlappedStruct, 0, sizeof(OVERLAPPED));
+	// Wait until the background writer has handed all queued data to the device driver
+	BOOL timedOut = FALSE;
 	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
-	overlappedStruct.hEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
-	if (overlappedStruct.hEvent == NULL)
+	ULONGLONG deadline = GetTickCount64() + (ULONGLONG)((timeoutMS > 0) ? timeoutMS : 0);
+	LONGLONG deadlineNS = (timeoutMS > 0) ? (getMonotonicTimeNS() + (timeoutMS * 1000000LL)) : -1;
+	EnterCriticalSection(&port->txLock);
+	while ((port->txHead != port->txTail) && !timedOut)
 	{
-		port->errorNumber = GetLastError();
-		port->errorLineNumber = __LINE__ - 4;
-		CloseHandle(overlappedStruct.hEvent);
-		return -1;
+		ULONGLONG currentTime = GetTickCount64();
+		DWORD waitTime = (timeoutMS <= 0) ? INFINITE : ((currentTime < deadline) ? (DWORD)(deadline - currentTime) : 0);
+		timedOut = (!waitTime || !SleepConditionVariableCS(&port->txSpaceAvailable, &port->txLock, waitTime)) && (port->txHead != port->txTail);
 	}
-
-	// Write to the serial port
-	BOOL result;
-	DWORD numBytesWritten = 0;
-	jbyte *writeBuffer = (*env)->GetByteArrayElements(env, buffer, 0);
-	if (checkJniError(env, __LINE__ - 1))
-		return -1;
-	else if (((result = WriteFile(port->handle, writeBuffer+offset, bytesToWrite, NULL, &overlappedStruct)) == FALSE) && (GetLastError() != ERROR_IO_PENDING))
+	BOOL queueFlushed = (port->txHead == port->txTail) && !port->txFailed;
+	LeaveCriticalSection(&port->txLock);
+	if (!queueFlushed)
 	{
-		port->errorLineNumber = __LINE__ - 2;
-		port->errorNumber = GetLastError();
+		port->errorLineNumber = __LINE__ - 6;
+		port->errorNumber = timedOut ? ERROR_TIMEOUT : ERROR_WRITE_FAULT;
+		return JNI_FALSE;
 	}
-	else if ((result = GetOverlappedResult(port->handle, &overlappedStruct, &numBytesWritten, TRUE)) == FALSE)
+
+	// Additionally wait for the device to physically transmit all data within the same timeout if requested
+	if (drainRequested && !drainDevice(port, deadlineNS))
 	{
 		port->errorLineNumber = __LINE__ - 2;
 		port->errorNumber = GetLastError();
+		return JNI_FALSE;
 	}
-
-	// Return number of bytes written
-	CloseHandle(overlappedStruct.hEvent);
-	(*env)->ReleaseByteArrayElements(env, buffer, writeBuffer, JNI_ABORT);
-	checkJniError(env, __LINE__ - 1);
-	return (result == TRUE) ? numBytesWritten : -1;
+	return JNI_TRUE;
 }
 
-JNIEXPORT void JNICALL Java_com_fazecast_jSerialComm_SerialPort_setEventListeningStatus(JNIEnv *env, jobject obj, jlong serialPortPointer, jboolean eventListenerRunning)
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_setRecording(JNIEnv *env, jobject obj, jlong serialPortPointer, jstring fileName, jlong fileLength, jboolean includeTransmitted)
 {
-	((serialPort*)(intptr_t)serialPortPointer)->eventListenerRunning = eventListenerRunning;
+	// Stop any existing recording
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	stopRecording(port);
+	if (!fileName)
+		return JNI_TRUE;
+	if (fileLength < (jlong)(sizeof(recordingHeader) + RECORDING_MINIMUM_LENGTH))
+	{
+		port->errorLineNumber = lastErrorLineNumber = __LINE__ - 2;
+		port->errorNumber = lastErrorNumber = ERROR_INVALID_PARAMETER;
+		return JNI_FALSE;
+	}
+
+	// Copy the file name into a null-terminated wide string
+	jsize fileNameLength = (*env)->GetStringLength(env, fileName);
+	if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	wchar_t *recordingFileName = (wchar_t*)malloc((fileNameLength + 1) * sizeof(wchar_t));
+	if (!recordingFileName)
+	{
+		port->errorLineNumber = lastErrorLineNumber = __LINE__ - 3;
+		port->errorNumber = lastErrorNumber = ERROR_NOT_ENOUGH_MEMORY;
+		return JNI_FALSE;
+	}
+	(*env)->GetStringRegion(env, fileName, 0, fileNameLength, (jchar*)recordingFileName);
+	if (checkJniError(env, __LINE__ - 1)) { free(recordingFileName); return JNI_FALSE; }
+	recordingFileName[fileNameLength] = L'\0';
+
+	// Create the recording file at its full size and map it into memory
+	HANDLE recordingFile = CreateFileW(recordingFileName, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	free(recordingFileName);
+	if (recordingFile == INVALID_HANDLE_VALUE)
+	{
+		port->errorLineNumber = lastErrorLineNumber = __LINE__ - 4;
+		port->errorNumber = lastErrorNumber = GetLastError();
+		return JNI_FALSE;
+	}
+	HANDLE recordingMapping = CreateFileMappingW(recordingFile, NULL, PAGE_READWRITE, (DWORD)((ULONGLONG)fileLength >> 32), (DWORD)((ULONGLONG)fileLength & 0xFFFFFFFF), NULL);
+	char *recording = recordingMapping ? (char*)MapViewOfFile(recordingMapping, FILE_MAP_WRITE, 0, 0, (SIZE_T)fileLength) : NULL;
+	if (!recording)
+	{
+		port->errorLineNumber = lastErrorLineNumber = __LINE__ - 4;
+		port->errorNumber = lastErrorNumber = GetLastError();
+		if (recordingMapping)
+			CloseHandle(recordingMapping);
+		CloseHandle(recordingFile);
+		return JNI_FALSE;
+	}
+	CloseHandle(recordingFile);
+
+	// Initialize the file header, recording the wall clock time that corresponds to the native timestamps
+	FILETIME wallClockTime;
+	GetSystemTimeAsFileTime(&wallClockTime);
+	LONGLONG wallClockTicks = (LONGLONG)(((ULONGLONG)wallClockTime.dwHighDateTime << 32) | wallClockTime.dwLowDateTime) - 116444736000000000LL;
+	initializeRecording(recording, (unsigned long long)fileLength, getNanoseconds(getPerformanceCounter()), wallClockTicks * 100LL);
+
+	// Start feeding all transferred data into the recording
+	EnterCriticalSection(&port->recordingLock);
+	port->recording = recording;
+	port->recordingMapping = recordingMapping;
+	port->recordTransmitted = includeTransmitted;
+	port->recordingEnabled = 1;
+	LeaveCriticalSection(&port->recordingLock);
+	return JNI_TRUE;
 }
 
 JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_setBreak(JNIEnv *env, jobject obj, jlong serialPortPointer)
 {
 	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
-	if (!SetCommBreak(port->handle))
+	if (port->ftdiHandle ? !ftdiSucceeded(ftdiDriver.SetBreakOn(port->ftdiHandle)) : !SetCommBreak(port->handle))
 	{
 		port->errorLineNumber = __LINE__ - 2;
 		port->errorNumber = GetLastError();
@@ -940,7 +3272,7 @@ JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_setBreak(JNI
 JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_clearBreak(JNIEnv *env, jobject obj, jlong serialPortPointer)
 {
 	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
-	if (!ClearCommBreak(port->handle))
+	if (port->ftdiHandle ? !ftdiSucceeded(ftdiDriver.SetBreakOff(port->ftdiHandle)) : !ClearCommBreak(port->handle))
 	{
 		port->errorLineNumber = __LINE__ - 2;
 		port->errorNumber = GetLastError();
@@ -952,7 +3284,7 @@ JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_clearBreak(J
 JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_setRTS(JNIEnv *env, jobject obj, jlong serialPortPointer)
 {
 	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
-	if (!EscapeCommFunction(port->handle, SETRTS))
+	if (port->ftdiHandle ? !ftdiSucceeded(ftdiDriver.SetRts(port->ftdiHandle)) : !EscapeCommFunction(port->handle, SETRTS))
 	{
 		port->errorLineNumber = __LINE__ - 2;
 		port->errorNumber = GetLastError();
@@ -964,7 +3296,7 @@ JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_setRTS(JNIEn
 JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_clearRTS(JNIEnv *env, jobject obj, jlong serialPortPointer)
 {
 	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
-	if (!EscapeCommFunction(port->handle, CLRRTS))
+	if (port->ftdiHandle ? !ftdiSucceeded(ftdiDriver.ClrRts(port->ftdiHandle)) : !EscapeCommFunction(port->handle, CLRRTS))
 	{
 		port->errorLineNumber = __LINE__ - 2;
 		port->errorNumber = GetLastError();
@@ -1040,7 +3372,7 @@ JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_preclearRTS(
 JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_setDTR(JNIEnv *env, jobject obj, jlong serialPortPointer)
 {
 	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
-	if (!EscapeCommFunction(port->handle, SETDTR))
+	if (port->ftdiHandle ? !ftdiSucceeded(ftdiDriver.SetDtr(port->ftdiHandle)) : !EscapeCommFunction(port->handle, SETDTR))
 	{
 		port->errorLineNumber = __LINE__ - 2;
 		port->errorNumber = GetLastError();
@@ -1052,7 +3384,7 @@ JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_setDTR(JNIEn
 JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_clearDTR(JNIEnv *env, jobject obj, jlong serialPortPointer)
 {
 	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
-	if (!EscapeCommFunction(port->handle, CLRDTR))
+	if (port->ftdiHandle ? !ftdiSucceeded(ftdiDriver.ClrDtr(port->ftdiHandle)) : !EscapeCommFunction(port->handle, CLRDTR))
 	{
 		port->errorLineNumber = __LINE__ - 2;
 		port->errorNumber = GetLastError();
@@ -1128,19 +3460,19 @@ JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_preclearDTR(
 JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_getCTS(JNIEnv *env, jobject obj, jlong serialPortPointer)
 {
 	DWORD modemStatus = 0;
-	return GetCommModemStatus(((serialPort*)(intptr_t)serialPortPointer)->handle, &modemStatus) && (modemStatus & MS_CTS_ON);
+	return getModemStatus((serialPort*)(intptr_t)serialPortPointer, &modemStatus) && (modemStatus & MS_CTS_ON);
 }
 
 JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_getDSR(JNIEnv *env, jobject obj, jlong serialPortPointer)
 {
 	DWORD modemStatus = 0;
-	return GetCommModemStatus(((serialPort*)(intptr_t)serialPortPointer)->handle, &modemStatus) && (modemStatus & MS_DSR_ON);
+	return getModemStatus((serialPort*)(intptr_t)serialPortPointer, &modemStatus) && (modemStatus & MS_DSR_ON);
 }
 
 JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_getDCD(JNIEnv *env, jobject obj, jlong serialPortPointer)
 {
 	DWORD modemStatus = 0;
-	return GetCommModemStatus(((serialPort*)(intptr_t)serialPortPointer)->handle, &modemStatus) && (modemStatus & MS_RLSD_ON);
+	return getModemStatus((serialPort*)(intptr_t)serialPortPointer, &modemStatus) && (modemStatus & MS_RLSD_ON);
 }
 
 JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_getDTR(JNIEnv *env, jobject obj, jlong serialPortPointer)
@@ -1156,7 +3488,382 @@ JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_getRTS(JNIEn
 JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_getRI(JNIEnv *env, jobject obj, jlong serialPortPointer)
 {
 	DWORD modemStatus = 0;
-	return GetCommModemStatus(((serialPort*)(intptr_t)serialPortPointer)->handle, &modemStatus) && (modemStatus & MS_RING_ON);
+	return getModemStatus((serialPort*)(intptr_t)serialPortPointer, &modemStatus) && (modemStatus & MS_RING_ON);
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_configLowLatency(JNIEnv *env, jobject obj, jlong serialPortPointer, jboolean enabled)
+{
+	// Set the FTDI latency timer immediately if the D2XX driver owns the port
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	if (port->ftdiHandle)
+		return ftdiSucceeded(ftdiDriver.SetLatencyTimer(port->ftdiHandle, enabled ? 1 : 16)) ? com_fazecast_jSerialComm_SerialPort_LOW_LATENCY_DEVICE_TIMER : 0;
+
+	// Otherwise, set the FTDI latency timer to its minimum value or back to the driver default (applied by the driver on the next open)
+	unsigned char requestElevatedPermissions = (*env)->GetBooleanField(env, obj, requestElevatedPermissionsField);
+	if (checkJniError(env, __LINE__ - 1)) return 0;
+	return setLatencyTimer(port->portPath + 4, enabled ? 1 : 16, 0, requestElevatedPermissions) ? com_fazecast_jSerialComm_SerialPort_LOW_LATENCY_DEVICE_TIMER : 0;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_waitForPortListChange(JNIEnv *env, jclass serialComm, jint lastGeneration, jint timeoutMS)
+{
+	// Make sure that hotplug monitoring has been started
+	if (!hotplugMonitorStatus)
+		hotplugMonitorStatus = startHotplugMonitor(portListingChanged) ? 1 : -1;
+
+	// Fall back to periodic re-enumeration if hotplug notifications are not available
+	if ((hotplugMonitorStatus < 0) || !hotplugEvent)
+	{
+		if (timeoutMS > 0)
+			Sleep(timeoutMS);
+		return lastGeneration + 1;
+	}
+
+	// Wait until the port listing changes or the timeout expires
+	if ((timeoutMS > 0) && ((jint)InterlockedCompareExchange(&portListingGeneration, 0, 0) == lastGeneration))
+		WaitForSingleObject(hotplugEvent, timeoutMS);
+	return (jint)InterlockedCompareExchange(&portListingGeneration, 0, 0);
+}
+
+JNIEXPORT jlong JNICALL Java_com_fazecast_jSerialComm_SerialPort_createEventEngine(JNIEnv *env, jclass serialComm)
+{
+	// Create a single I/O completion port to be shared by all registered ports
+	HANDLE completionPort = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 0);
+	if (!completionPort)
+	{
+		lastErrorLineNumber = __LINE__ - 3;
+		lastErrorNumber = GetLastError();
+		return -1;
+	}
+	return (jlong)(intptr_t)completionPort;
+}
+
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_addToEventEngine(JNIEnv *env, jclass serialComm, jlong engineHandle, jlong serialPortPointer, jboolean rearm)
+{
+	// The D2XX driver does not support overlapped event waits
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	HANDLE completionPort = (HANDLE)(intptr_t)engineHandle;
+	if (port->ftdiHandle)
+	{
+		port->errorLineNumber = __LINE__ - 2;
+		port->errorNumber = ERROR_NOT_SUPPORTED;
+		return JNI_FALSE;
+	}
+
+	// Never restart the event wait for a port that has since been removed from the engine
+	if (rearm && !port->engineRegistered)
+	{
+		port->errorLineNumber = __LINE__ - 2;
+		port->errorNumber = ERROR_NOT_FOUND;
+		return JNI_FALSE;
+	}
+
+	// Associate the port handle with the completion port upon initial registration
+	if ((port->eventEngineHandle != completionPort) && !CreateIoCompletionPort(port->handle, completionPort, (ULONG_PTR)port, 0))
+	{
+		port->errorLineNumber = __LINE__ - 2;
+		port->errorNumber = GetLastError();
+		return JNI_FALSE;
+	}
+	port->eventEngineHandle = completionPort;
+	port->engineRegistered = 1;
+
+	// Start a single asynchronous serial event wait whose completion will be delivered to the completion port
+	memset(&port->engineOverlapped, 0, sizeof(OVERLAPPED));
+	if (!WaitCommEvent(port->handle, &port->engineEventMask, &port->engineOverlapped) && (GetLastError() != ERROR_IO_PENDING))
+	{
+		port->errorLineNumber = __LINE__ - 2;
+		port->errorNumber = GetLastError();
+		return JNI_FALSE;
+	}
+	return JNI_TRUE;
+}
+
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_removeFromEventEngine(JNIEnv *env, jclass serialComm, jlong engineHandle, jlong serialPortPointer)
+{
+	// Cancel any outstanding event wait, since handles cannot be disassociated from a completion port
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	port->engineRegistered = 0;
+	if (!port->ftdiHandle && !CancelIoEx(port->handle, &port->engineOverlapped) && (GetLastError() != ERROR_NOT_FOUND))
+	{
+		port->errorLineNumber = __LINE__ - 2;
+		port->errorNumber = GetLastError();
+		return JNI_FALSE;
+	}
+	return JNI_TRUE;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_waitForEventEngine(JNIEnv *env, jclass serialComm, jlong engineHandle, jlongArray portHandles, jintArray events, jint timeoutMS)
+{
+	// Determine the maximum number of ready ports to return
+	jlong readyPorts[MAX_EVENT_ENGINE_EVENTS];
+	jint readyEvents[MAX_EVENT_ENGINE_EVENTS];
+	OVERLAPPED_ENTRY completions[MAX_EVENT_ENGINE_EVENTS];
+	ULONG numCompletions = 0, maxReady = (*env)->GetArrayLength(env, portHandles);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	if (maxReady > MAX_EVENT_ENGINE_EVENTS)
+		maxReady = MAX_EVENT_ENGINE_EVENTS;
+
+	// Wait for any registered port to complete its serial event wait
+	HANDLE completionPort = (HANDLE)(intptr_t)engineHandle;
+	if (!GetQueuedCompletionStatusEx(completionPort, completions, maxReady, &numCompletions, (timeoutMS < 0) ? INFINITE : (DWORD)timeoutMS, FALSE))
+	{
+		if (GetLastError() == WAIT_TIMEOUT)
+			return 0;
+		lastErrorLineNumber = __LINE__ - 4;
+		lastErrorNumber = GetLastError();
+		return -1;
+	}
+
+	// Translate the events for all ports that are still open and registered with this engine
+	jint numReady = 0;
+	LONGLONG eventTime = getPerformanceCounter();
+	for (ULONG i = 0; i < numCompletions; ++i)
+	{
+		serialPort *port = NULL;
+		AcquireSRWLockShared(&serialPortsLock);
+		for (int j = 0; j < serialPorts.length; ++j)
+			if (serialPorts.ports[j] == (serialPort*)completions[i].lpCompletionKey)
+				port = serialPorts.ports[j];
+		if (!port || !isPortOpen(port) || (port->eventEngineHandle != completionPort) || (completions[i].lpOverlapped != &port->engineOverlapped))
+		{
+			ReleaseSRWLockShared(&serialPortsLock);
+			continue;
+		}
+		readyPorts[numReady] = (jlong)(intptr_t)port;
+		port->eventTimestamp = eventTime;
+		readyEvents[numReady++] = (port->engineOverlapped.Internal == 0) ? translateCommEvents(port, port->engineEventMask) :
+				(com_fazecast_jSerialComm_SerialPort_LISTENING_EVENT_PORT_DISCONNECTED | translateCommEvents(port, 0));
+		ReleaseSRWLockShared(&serialPortsLock);
+	}
+
+	// Return the ready ports and their corresponding events
+	(*env)->SetLongArrayRegion(env, portHandles, 0, numReady, readyPorts);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	(*env)->SetIntArrayRegion(env, events, 0, numReady, readyEvents);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	return numReady;
+}
+
+// Asynchronous I/O engine functionality
+static VOID CALLBACK asyncOperationSignaled(PVOID operationPointer, BOOLEAN timedOut)
+{
+	// Hand the completed operation over to the engine's completion port
+	asyncOperation *operation = (asyncOperation*)operationPointer;
+	PostQueuedCompletionStatus(operation->completionPort, 0, (ULONG_PTR)operation, NULL);
+}
+
+static void freeAsyncOperation(asyncOperation *operation)
+{
+	// Wait for any in-progress completion callback before releasing the operation resources
+	if (operation->waitHandle)
+		UnregisterWaitEx(operation->waitHandle, INVALID_HANDLE_VALUE);
+	if (operation->completionEvent)
+		CloseHandle(operation->completionEvent);
+	free(operation->buffer);
+	free(operation);
+}
+
+JNIEXPORT jlong JNICALL Java_com_fazecast_jSerialComm_SerialPort_createAsyncEngine(JNIEnv *env, jclass serialComm)
+{
+	// Create a private completion port that is never associated with any device handle
+	HANDLE completionPort = CreateIoCompletionPort(INVALID_HANDLE_VALUE, NULL, 0, 1);
+	if (!completionPort)
+	{
+		lastErrorLineNumber = __LINE__ - 3;
+		lastErrorNumber = GetLastError();
+		return 0;
+	}
+	return (jlong)(intptr_t)completionPort;
+}
+
+JNIEXPORT jlong JNICALL Java_com_fazecast_jSerialComm_SerialPort_startAsyncIO(JNIEnv *env, jclass serialComm, jlong engineHandle, jlong serialPortPointer, jboolean write, jobject directBuffer, jbyteArray arrayBuffer, jint offset, jint length)
+{
+	// The D2XX driver does not support overlapped transfers, and software RS-485 control cannot switch the bus direction around them
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	if (port->ftdiHandle || (write && port->rs485SoftwareControl))
+	{
+		port->errorLineNumber = __LINE__ - 2;
+		port->errorNumber = ERROR_NOT_SUPPORTED;
+		return 0;
+	}
+
+	// Allocate the operation and its private data buffer
+	asyncOperation *operation = (asyncOperation*)malloc(sizeof(asyncOperation));
+	char *buffer = operation ? (char*)malloc(length) : NULL;
+	if (!buffer)
+	{
+		port->errorLineNumber = __LINE__ - 3;
+		port->errorNumber = ERROR_NOT_ENOUGH_MEMORY;
+		free(operation);
+		return 0;
+	}
+	memset(operation, 0, sizeof(asyncOperation));
+	operation->port = port;
+	operation->buffer = buffer;
+	operation->length = (DWORD)length;
+	operation->isWrite = write;
+	operation->completionPort = (HANDLE)(intptr_t)engineHandle;
+
+	// Take a private copy of any data to be written so that the caller's buffer is never accessed from outside of a JNI call
+	if (write && directBuffer)
+	{
+		char *data = (char*)(*env)->GetDirectBufferAddress(env, directBuffer);
+		if (checkJniError(env, __LINE__ - 1) || !data)
+		{
+			freeAsyncOperation(operation);
+			return 0;
+		}
+		memcpy(buffer, data + offset, length);
+	}
+	else if (write)
+	{
+		(*env)->GetByteArrayRegion(env, arrayBuffer, offset, length, (jbyte*)buffer);
+		if (checkJniError(env, __LINE__ - 1))
+		{
+			freeAsyncOperation(operation);
+			return 0;
+		}
+	}
+
+	// Set the low-order bit of the completion event so that the operation is never queued to an event engine completion port
+	operation->completionEvent = CreateEvent(NULL, TRUE, FALSE, NULL);
+	if (!operation->completionEvent)
+	{
+		port->errorLineNumber = __LINE__ - 3;
+		port->errorNumber = GetLastError();
+		freeAsyncOperation(operation);
+		return 0;
+	}
+	operation->overlapped.hEvent = (HANDLE)((ULONG_PTR)operation->completionEvent | 1);
+
+	// Start the transfer and have the system thread pool report its completion once the event is signaled
+	BOOL result = write ? WriteFile(port->handle, buffer, (DWORD)length, NULL, &operation->overlapped) : ReadFile(port->handle, buffer, (DWORD)length, NULL, &operation->overlapped);
+	if (!result && (GetLastError() != ERROR_IO_PENDING))
+	{
+		port->errorLineNumber = __LINE__ - 3;
+		port->errorNumber = GetLastError();
+		freeAsyncOperation(operation);
+		return 0;
+	}
+	addStatistic(write ? &port->statistics.writeSyscalls : &port->statistics.readSyscalls, 1);
+	if (!RegisterWaitForSingleObject(&operation->waitHandle, operation->completionEvent, asyncOperationSignaled, operation, INFINITE, WT_EXECUTEONLYONCE))
+	{
+		DWORD numBytesTransferred;
+		port->errorLineNumber = __LINE__ - 3;
+		port->errorNumber = GetLastError();
+		CancelIoEx(port->handle, &operation->overlapped);
+		GetOverlappedResult(port->handle, &operation->overlapped, &numBytesTransferred, TRUE);
+		operation->waitHandle = NULL;
+		freeAsyncOperation(operation);
+		return 0;
+	}
+	return (jlong)(intptr_t)operation;
+}
+
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_cancelAsyncIO(JNIEnv *env, jclass serialComm, jlong engineHandle, jlong operationHandle)
+{
+	// Abort the transfer, which will still be reported as completed with whatever was transferred so far
+	asyncOperation *operation = (asyncOperation*)(intptr_t)operationHandle;
+	if (!CancelIoEx(operation->port->handle, &operation->overlapped) && (GetLastError() != ERROR_NOT_FOUND))
+	{
+		operation->port->errorLineNumber = __LINE__ - 2;
+		operation->port->errorNumber = GetLastError();
+		return JNI_FALSE;
+	}
+	return JNI_TRUE;
+}
+
+JNIEXPORT void JNICALL Java_com_fazecast_jSerialComm_SerialPort_wakeAsyncEngine(JNIEnv *env, jclass serialComm, jlong engineHandle)
+{
+	// Interrupt any in-progress engine wait
+	if (!PostQueuedCompletionStatus((HANDLE)(intptr_t)engineHandle, 0, 0, NULL))
+	{
+		lastErrorLineNumber = __LINE__ - 2;
+		lastErrorNumber = GetLastError();
+	}
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_waitForAsyncIO(JNIEnv *env, jclass serialComm, jlong engineHandle, jlongArray operations, jintArray results, jint timeoutMS)
+{
+	// Determine the maximum number of completed operations to return
+	jlong completedOperations[MAX_EVENT_ENGINE_EVENTS];
+	jint completedResults[MAX_EVENT_ENGINE_EVENTS];
+	OVERLAPPED_ENTRY completions[MAX_EVENT_ENGINE_EVENTS];
+	ULONG numCompletions = 0, maxCompleted = (*env)->GetArrayLength(env, operations);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	if (maxCompleted > MAX_EVENT_ENGINE_EVENTS)
+		maxCompleted = MAX_EVENT_ENGINE_EVENTS;
+
+	// Wait for any operation to complete
+	if (!GetQueuedCompletionStatusEx((HANDLE)(intptr_t)engineHandle, completions, maxCompleted, &numCompletions, (timeoutMS < 0) ? INFINITE : (DWORD)timeoutMS, FALSE))
+	{
+		if (GetLastError() == WAIT_TIMEOUT)
+			return 0;
+		lastErrorLineNumber = __LINE__ - 4;
+		lastErrorNumber = GetLastError();
+		return -1;
+	}
+
+	// Retrieve the results of all completed operations, ignoring any wakeup notifications
+	jint numCompleted = 0;
+	for (ULONG i = 0; i < numCompletions; ++i)
+	{
+		DWORD numBytesTransferred = 0;
+		asyncOperation *operation = (asyncOperation*)completions[i].lpCompletionKey;
+		if (!operation)
+			continue;
+		serialPort *port = operation->port;
+		if (GetOverlappedResult(port->handle, &operation->overlapped, &numBytesTransferred, FALSE))
+			operation->result = (int)numBytesTransferred;
+		else if (GetLastError() == ERROR_OPERATION_ABORTED)
+			operation->result = (int)operation->overlapped.InternalHigh;
+		else
+		{
+			port->errorLineNumber = __LINE__ - 6;
+			port->errorNumber = GetLastError();
+			operation->result = -1;
+		}
+		addStatistic(operation->isWrite ? &port->statistics.writeCalls : &port->statistics.readCalls, 1);
+		if (operation->result > 0)
+		{
+			addStatistic(operation->isWrite ? &port->statistics.bytesWritten : &port->statistics.bytesRead, operation->result);
+			recordTraffic(port, operation->isWrite ? RECORDING_DIRECTION_TRANSMITTED : RECORDING_DIRECTION_RECEIVED, 0, operation->buffer, (DWORD)operation->result);
+		}
+		completedOperations[numCompleted] = (jlong)(intptr_t)operation;
+		completedResults[numCompleted++] = operation->result;
+	}
+
+	// Return the completed operations
+	(*env)->SetLongArrayRegion(env, operations, 0, numCompleted, completedOperations);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	(*env)->SetIntArrayRegion(env, results, 0, numCompleted, completedResults);
+	if (checkJniError(env, __LINE__ - 1)) return -1;
+	return numCompleted;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_finishAsyncIO(JNIEnv *env, jclass serialComm, jlong operationHandle, jobject directBuffer, jbyteArray arrayBuffer, jint offset)
+{
+	// Copy any data that was read into the caller's buffer, discarding it if no buffer was specified
+	asyncOperation *operation = (asyncOperation*)(intptr_t)operationHandle;
+	int result = operation->result;
+	if (!operation->isWrite && (result > 0) && directBuffer)
+	{
+		char *data = (char*)(*env)->GetDirectBufferAddress(env, directBuffer);
+		if (!checkJniError(env, __LINE__ - 1) && data)
+			memcpy(data + offset, operation->buffer, result);
+		else
+			result = -1;
+	}
+	else if (!operation->isWrite && (result > 0) && arrayBuffer)
+	{
+		(*env)->SetByteArrayRegion(env, arrayBuffer, offset, result, (jbyte*)operation->buffer);
+		if (checkJniError(env, __LINE__ - 1))
+			result = -1;
+	}
+
+	// Free the operation
+	freeAsyncOperation(operation);
+	return result;
 }
 
 JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_getLastErrorLocation(JNIEnv *env, jobject obj, jlong serialPortPointer)
@@ -1169,4 +3876,71 @@ JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_getLastErrorCode
 	return serialPortPointer ? ((serialPort*)(intptr_t)serialPortPointer)->errorNumber : lastErrorNumber;
 }
 
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_getStatistics(JNIEnv *env, jobject obj, jlong serialPortPointer, jlongArray statistics, jboolean reset)
+{
+	// Copy the software counters and histograms into a native staging array
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	if (statistics)
+	{
+		jlong values[STATISTICS_ARRAY_LENGTH];
+		values[0] = InterlockedCompareExchange64(&port->statistics.bytesRead, 0, 0);
+		values[1] = InterlockedCompareExchange64(&port->statistics.bytesWritten, 0, 0);
+		values[2] = InterlockedCompareExchange64(&port->statistics.readCalls, 0, 0);
+		values[3] = InterlockedCompareExchange64(&port->statistics.writeCalls, 0, 0);
+		values[4] = InterlockedCompareExchange64(&port->statistics.readSyscalls, 0, 0);
+		values[5] = InterlockedCompareExchange64(&port->statistics.writeSyscalls, 0, 0);
+		values[6] = InterlockedCompareExchange64(&port->statistics.shortReads, 0, 0);
+		values[7] = InterlockedCompareExchange64(&port->statistics.readTimeouts, 0, 0);
+		values[8] = InterlockedCompareExchange64(&port->statistics.writeRetries, 0, 0);
+		values[9] = InterlockedCompareExchange64(&port->statistics.drainTimeNS, 0, 0);
+		for (int i = 0; i < STATISTICS_HISTOGRAM_BUCKETS; ++i)
+		{
+			values[14 + i] = InterlockedCompareExchange64(port->statistics.readLatency + i, 0, 0);
+			values[14 + STATISTICS_HISTOGRAM_BUCKETS + i] = InterlockedCompareExchange64(port->statistics.writeLatency + i, 0, 0);
+			values[17 + (2 * STATISTICS_HISTOGRAM_BUCKETS) + i] = InterlockedCompareExchange64(port->statistics.rs485Turnaround + i, 0, 0);
+		}
+
+		// Report the software RS-485 turnaround counters only while software direction control is active
+		values[14 + (2 * STATISTICS_HISTOGRAM_BUCKETS)] = port->rs485SoftwareControl ? InterlockedCompareExchange64(&port->statistics.rs485Transmissions, 0, 0) : -1;
+		values[15 + (2 * STATISTICS_HISTOGRAM_BUCKETS)] = port->rs485SoftwareControl ? InterlockedCompareExchange64(&port->statistics.rs485TurnaroundNS, 0, 0) : -1;
+		values[16 + (2 * STATISTICS_HISTOGRAM_BUCKETS)] = port->rs485SoftwareControl ? InterlockedCompareExchange64(&port->statistics.rs485MaxTurnaroundNS, 0, 0) : -1;
+
+		// Windows does not expose cumulative driver line error counters
+		values[10] = values[11] = values[12] = values[13] = -1;
+		(*env)->SetLongArrayRegion(env, statistics, 0, STATISTICS_ARRAY_LENGTH, values);
+		if (checkJniError(env, __LINE__ - 1)) return JNI_FALSE;
+	}
+
+	// Reset the statistics if requested
+	if (reset)
+		resetStatistics(port);
+	return JNI_TRUE;
+}
+
+JNIEXPORT jlong JNICALL Java_com_fazecast_jSerialComm_SerialPort_getReceiveTimestamp(JNIEnv *env, jobject obj, jlong serialPortPointer, jboolean eventTimestamp)
+{
+	// Convert the performance counter value of the most recent event or read into nanoseconds
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	return (jlong)getNanoseconds(eventTimestamp ? port->eventTimestamp : port->readTimestamp);
+}
+
+JNIEXPORT jboolean JNICALL Java_com_fazecast_jSerialComm_SerialPort_getFtdiDirectMode(JNIEnv *env, jobject obj, jlong serialPortPointer)
+{
+	// Report whether the D2XX driver owns the port
+	return ((serialPort*)(intptr_t)serialPortPointer)->ftdiHandle ? JNI_TRUE : JNI_FALSE;
+}
+
+JNIEXPORT jint JNICALL Java_com_fazecast_jSerialComm_SerialPort_getThreadSchedulingStatus(JNIEnv *env, jobject obj, jlong serialPortPointer)
+{
+	// Return the scheduling settings that were successfully applied to every native thread of the port
+	return ((serialPort*)(intptr_t)serialPortPointer)->threadSchedulingStatus;
+}
+
+JNIEXPORT jlong JNICALL Java_com_fazecast_jSerialComm_SerialPort_getNativeHandle(JNIEnv *env, jobject obj, jlong serialPortPointer)
+{
+	// Return the underlying device handle of the port, which is the D2XX driver handle if it owns the port
+	serialPort *port = (serialPort*)(intptr_t)serialPortPointer;
+	return (jlong)(intptr_t)(port->ftdiHandle ? port->ftdiHandle : port->handle);
+}
+
 #endif
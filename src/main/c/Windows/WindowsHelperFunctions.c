@@ -57,8 +57,15 @@ serialPort* pushBack(serialPortVector* vector, const wchar_t* key, const wchar_t
 	else
 		return NULL;
 
-	// Initialize the storage structure
+	// Initialize the storage structure and transmit queue synchronization primitives
 	memset(port, 0, sizeof(serialPort));
+	InitializeCriticalSection(&port->txLock);
+	InitializeCriticalSection(&port->recordingLock);
+	InitializeCriticalSection(&port->rs485Lock);
+	InitializeCriticalSection(&port->readLock);
+	InitializeCriticalSection(&port->writeLock);
+	InitializeConditionVariable(&port->txDataQueued);
+	InitializeConditionVariable(&port->txSpaceAvailable);
 	port->handle = (void*)-1;
 	port->enumerated = 1;
 	port->portPath = (wchar_t*)malloc((wcslen(key)+(containsSlashes ? 1 : 5))*sizeof(wchar_t));
@@ -101,6 +108,17 @@ void removePort(serialPortVector* vector, serialPort* port)
 	free(port->portDescription);
 	if (port->readBuffer)
 		free(port->readBuffer);
+	if (port->ringBuffer)
+		free(port->ringBuffer);
+	if (port->writeBuffer)
+		free(port->writeBuffer);
+	if (port->txBuffer)
+		free(port->txBuffer);
+	DeleteCriticalSection(&port->txLock);
+	DeleteCriticalSection(&port->recordingLock);
+	DeleteCriticalSection(&port->rs485Lock);
+	DeleteCriticalSection(&port->readLock);
+	DeleteCriticalSection(&port->writeLock);
 
 	// Move up all remaining ports in the serial port listing
 	for (int i = 0; i < vector->length; ++i)
@@ -117,9 +135,10 @@ void removePort(serialPortVector* vector, serialPort* port)
 }
 
 // Windows-specific functionality
-void reduceLatencyToMinimum(const wchar_t* portName, unsigned char requestElevatedPermissions)
+char setLatencyTimer(const wchar_t* portName, DWORD latency, unsigned char onlyIfLower, unsigned char requestElevatedPermissions)
 {
 	// Search for this port in all FTDI enumerated ports
+	char latencyApplied = 0;
 	HKEY key, paramKey = 0;
 	if (RegOpenKeyExW(HKEY_LOCAL_MACHINE, L"SYSTEM\\CurrentControlSet\\Enum\\FTDIBUS", 0, KEY_READ, &key) == ERROR_SUCCESS)
 	{
@@ -127,7 +146,8 @@ void reduceLatencyToMinimum(const wchar_t* portName, unsigned char requestElevat
 		wchar_t *subkey = (wchar_t*)malloc(subkeySize*sizeof(wchar_t)), *regPortName = (wchar_t*)malloc(portNameSize*sizeof(wchar_t));
 		while (RegEnumKeyExW(key, index++, subkey, &subkeySize, NULL, NULL, NULL, NULL) == ERROR_SUCCESS)
 		{
-			DWORD latency = 2, oldLatency = 2, oldLatencySize = sizeof(DWORD);
+			DWORD oldLatency = latency, oldLatencySize = sizeof(DWORD);
+			char portFound = 0;
 			char *subkeyString = (char*)malloc(subkeySize + 2);
 			memset(subkeyString, 0, subkeySize + 2);
 			wcstombs(subkeyString, subkey, subkeySize + 1);
@@ -138,14 +158,19 @@ void reduceLatencyToMinimum(const wchar_t* portName, unsigned char requestElevat
 			if (RegOpenKeyExW(key, subkey, 0, KEY_QUERY_VALUE, &paramKey) == ERROR_SUCCESS)
 			{
 				if ((RegQueryValueExW(paramKey, L"PortName", NULL, NULL, (LPBYTE)regPortName, &portNameSize) == ERROR_SUCCESS) && (wcscmp(portName, regPortName) == 0))
+				{
+					portFound = 1;
 					RegQueryValueExW(paramKey, L"LatencyTimer", NULL, NULL, (LPBYTE)&oldLatency, &oldLatencySize);
+				}
 				RegCloseKey(paramKey);
 			}
-			if (oldLatency > latency)
+			if (portFound && ((oldLatency == latency) || (onlyIfLower && (oldLatency < latency))))
+				latencyApplied = 1;
+			else if (portFound)
 			{
 				if (RegOpenKeyExW(key, subkey, 0, KEY_SET_VALUE, &paramKey) == ERROR_SUCCESS)
 				{
-					RegSetValueExW(paramKey, L"LatencyTimer", 0, REG_DWORD, (LPBYTE)&latency, sizeof(latency));
+					latencyApplied = (RegSetValueExW(paramKey, L"LatencyTimer", 0, REG_DWORD, (LPBYTE)&latency, sizeof(latency)) == ERROR_SUCCESS);
 					RegCloseKey(paramKey);
 				}
 				else if (requestElevatedPermissions)
@@ -163,7 +188,7 @@ void reduceLatencyToMinimum(const wchar_t* portName, unsigned char requestElevat
 					{
 						fprintf(registryFile, "Windows Registry Editor Version 5.00\n\n");
 						fprintf(registryFile, "[HKEY_LOCAL_MACHINE\\SYSTEM\\CurrentControlSet\\Enum\\FTDIBUS\\%s\\0000\\Device Parameters]\n", subkeyString);
-						fprintf(registryFile, "\"LatencyTimer\"=dword:00000002\n\n");
+						fprintf(registryFile, "\"LatencyTimer\"=dword:%08lx\n\n", (unsigned long)latency);
 						fclose(registryFile);
 					}
 
@@ -184,6 +209,15 @@ void reduceLatencyToMinimum(const wchar_t* portName, unsigned char requestElevat
 						CloseHandle(shExInfo.hProcess);
 					}
 
+					// Verify that the registry value was actually updated
+					oldLatencySize = sizeof(DWORD);
+					if (RegOpenKeyExW(key, subkey, 0, KEY_QUERY_VALUE, &paramKey) == ERROR_SUCCESS)
+					{
+						if (RegQueryValueExW(paramKey, L"LatencyTimer", NULL, NULL, (LPBYTE)&oldLatency, &oldLatencySize) == ERROR_SUCCESS)
+							latencyApplied = (oldLatency == latency);
+						RegCloseKey(paramKey);
+					}
+
 					// Delete the registry update file
 					remove(registryFileName);
 					free(workingDirectoryWide);
@@ -198,6 +232,7 @@ void reduceLatencyToMinimum(const wchar_t* portName, unsigned char requestElevat
 		free(regPortName);
 		free(subkey);
 	}
+	return latencyApplied;
 }
 
 int getPortPathFromSerial(wchar_t* portPath, const char* serialNumber)
@@ -236,4 +271,314 @@ int getPortPathFromSerial(wchar_t* portPath, const char* serialNumber)
 	return found;
 }
 
+// Runtime-loadable device notification definitions (only available on Windows 8 and later)
+typedef struct
+{
+	DWORD cbSize, Flags, FilterType, Reserved;
+	union { GUID ClassGuid; HANDLE hTarget; WCHAR InstanceId[200]; } u;
+} hotplugNotifyFilter;
+typedef DWORD (CALLBACK *hotplugNotifyCallback)(HANDLE, PVOID, DWORD, PVOID, DWORD);
+typedef DWORD (WINAPI *CM_Register_NotificationFunction)(hotplugNotifyFilter*, PVOID, hotplugNotifyCallback, HANDLE*);
+typedef DWORD (WINAPI *CM_Unregister_NotificationFunction)(HANDLE);
+#define HOTPLUG_FILTER_FLAG_ALL_INTERFACE_CLASSES 0x00000001
+#define HOTPLUG_FILTER_TYPE_DEVICEINTERFACE 0
+#define HOTPLUG_ACTION_DEVICEINTERFACEARRIVAL 0
+#define HOTPLUG_ACTION_DEVICEINTERFACEREMOVAL 1
+
+// Hotplug monitoring functionality
+static HMODULE cfgmgrLibInstance = NULL;
+static HANDLE hotplugNotification = NULL;
+static void (*hotplugNotify)(void) = NULL;
+
+static DWORD CALLBACK hotplugNotificationCallback(HANDLE notification, PVOID context, DWORD action, PVOID eventData, DWORD eventDataSize)
+{
+	if ((action == HOTPLUG_ACTION_DEVICEINTERFACEARRIVAL) || (action == HOTPLUG_ACTION_DEVICEINTERFACEREMOVAL))
+		hotplugNotify();
+	return ERROR_SUCCESS;
+}
+
+char startHotplugMonitor(void (*notifyCallback)(void))
+{
+	// Load the device notification functions at runtime
+	if (!(cfgmgrLibInstance = LoadLibrary(TEXT("cfgmgr32.dll"))))
+		return 0;
+	CM_Register_NotificationFunction CM_Register_Notification = (CM_Register_NotificationFunction)GetProcAddress(cfgmgrLibInstance, "CM_Register_Notification");
+	if (!CM_Register_Notification)
+	{
+		FreeLibrary(cfgmgrLibInstance);
+		cfgmgrLibInstance = NULL;
+		return 0;
+	}
+
+	// Listen for the arrival or removal of any device interface, since not all serial drivers register a COM port interface
+	hotplugNotifyFilter filter;
+	memset(&filter, 0, sizeof(filter));
+	filter.cbSize = sizeof(filter);
+	filter.Flags = HOTPLUG_FILTER_FLAG_ALL_INTERFACE_CLASSES;
+	filter.FilterType = HOTPLUG_FILTER_TYPE_DEVICEINTERFACE;
+	hotplugNotify = notifyCallback;
+	if (CM_Register_Notification(&filter, NULL, hotplugNotificationCallback, &hotplugNotification) != ERROR_SUCCESS)
+	{
+		FreeLibrary(cfgmgrLibInstance);
+		cfgmgrLibInstance = NULL;
+		hotplugNotification = NULL;
+		return 0;
+	}
+	return 1;
+}
+
+void stopHotplugMonitor(void)
+{
+	if (cfgmgrLibInstance)
+	{
+		CM_Unregister_NotificationFunction CM_Unregister_Notification = (CM_Unregister_NotificationFunction)GetProcAddress(cfgmgrLibInstance, "CM_Unregister_Notification");
+		if (CM_Unregister_Notification && hotplugNotification)
+			CM_Unregister_Notification(hotplugNotification);
+		FreeLibrary(cfgmgrLibInstance);
+		cfgmgrLibInstance = NULL;
+		hotplugNotification = NULL;
+	}
+}
+
+// Thread scheduling functionality
+typedef HANDLE (WINAPI *AvSetMmThreadCharacteristicsFunction)(LPCWSTR, LPDWORD);
+static AvSetMmThreadCharacteristicsFunction AvSetMmThreadCharacteristics = NULL;
+
+int applyThreadScheduling(long long cpuAffinityMask, int realTimePriority)
+{
+	// Restrict the calling thread to the requested CPUs
+	int appliedSettings = 0;
+	if (cpuAffinityMask && SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)cpuAffinityMask))
+		appliedSettings |= com_fazecast_jSerialComm_SerialPort_THREAD_SCHEDULING_AFFINITY;
+
+	// Raise the calling thread to the highest non-realtime-class priority and register it with the Multimedia Class Scheduler Service
+	if (realTimePriority > 0)
+	{
+		if (SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_TIME_CRITICAL))
+			appliedSettings |= com_fazecast_jSerialComm_SerialPort_THREAD_SCHEDULING_REAL_TIME;
+		if (!AvSetMmThreadCharacteristics)
+		{
+			// The scheduler library stays loaded for the lifetime of the process since registered threads may still be running
+			HMODULE avrtLibInstance = LoadLibrary(TEXT("avrt.dll"));
+			if (avrtLibInstance)
+				AvSetMmThreadCharacteristics = (AvSetMmThreadCharacteristicsFunction)GetProcAddress(avrtLibInstance, "AvSetMmThreadCharacteristicsW");
+		}
+		DWORD taskIndex = 0;
+		if (AvSetMmThreadCharacteristics && AvSetMmThreadCharacteristics(L"Pro Audio", &taskIndex))
+			appliedSettings |= com_fazecast_jSerialComm_SerialPort_THREAD_SCHEDULING_MMCSS;
+	}
+	return appliedSettings;
+}
+
+// Streaming frame decoding functionality
+static inline int appendFrameByte(jint *state, unsigned char *frame, unsigned char value)
+{
+	// Start discarding the current frame if it would exceed the maximum length
+	if (state[FRAME_STATE_FRAME_LENGTH] >= state[FRAME_STATE_MAX_LENGTH])
+	{
+		state[FRAME_STATE_DISCARDING] = 1;
+		state[FRAME_STATE_FRAME_LENGTH] = 0;
+		return 0;
+	}
+	frame[state[FRAME_STATE_FRAME_LENGTH]++] = value;
+	return 1;
+}
+
+int decodeFrames(const unsigned char *data, int length, jint *state, unsigned char *frames, jint *boundaries)
+{
+	// The frame buffer starts with any partially decoded frame carried over from the previous chunk
+	int numFrames = 0, frameStart = 0, offset = 0;
+	if (state[FRAME_STATE_FORMAT] == FRAME_FORMAT_LENGTH_PREFIXED)
+	{
+		int headerLength = state[FRAME_STATE_LENGTH_OFFSET] + state[FRAME_STATE_LENGTH_WIDTH];
+		while (offset < length)
+		{
+			// Skip the remainder of any oversized frame
+			if (state[FRAME_STATE_DISCARDING] > 0)
+			{
+				int numToSkip = ((length - offset) < state[FRAME_STATE_DISCARDING]) ? (length - offset) : state[FRAME_STATE_DISCARDING];
+				state[FRAME_STATE_DISCARDING] -= numToSkip;
+				offset += numToSkip;
+				continue;
+			}
+
+			// Accumulate the frame header and determine the total frame length
+			if (state[FRAME_STATE_EXPECTED_LENGTH] == 0)
+			{
+				int numToCopy = headerLength - state[FRAME_STATE_FRAME_LENGTH];
+				if (numToCopy > (length - offset))
+					numToCopy = length - offset;
+				memcpy(frames + frameStart + state[FRAME_STATE_FRAME_LENGTH], data + offset, numToCopy);
+				state[FRAME_STATE_FRAME_LENGTH] += numToCopy;
+				offset += numToCopy;
+				if (state[FRAME_STATE_FRAME_LENGTH] < headerLength)
+					break;
+				unsigned long long fieldValue = 0;
+				const unsigned char *lengthField = frames + frameStart + state[FRAME_STATE_LENGTH_OFFSET];
+				for (int i = 0; i < state[FRAME_STATE_LENGTH_WIDTH]; ++i)
+					fieldValue = (fieldValue << 8) | lengthField[state[FRAME_STATE_BIG_ENDIAN] ? i : (state[FRAME_STATE_LENGTH_WIDTH] - 1 - i)];
+				long long frameLength = (long long)headerLength + (long long)fieldValue + state[FRAME_STATE_LENGTH_ADJUSTMENT];
+				if ((frameLength < headerLength) || (frameLength > state[FRAME_STATE_MAX_LENGTH]))
+				{
+					// Drop the header of an invalid frame and discard the rest of its contents
+					state[FRAME_STATE_DISCARDING] = (frameLength > 0x7FFFFFFFLL) ? 0x7FFFFFFF : ((frameLength > headerLength) ? (int)(frameLength - headerLength) : 0);
+					state[FRAME_STATE_FRAME_LENGTH] = 0;
+					continue;
+				}
+				state[FRAME_STATE_EXPECTED_LENGTH] = (jint)frameLength;
+			}
+
+			// Copy the frame contents and publish the frame once complete
+			int numToCopy = state[FRAME_STATE_EXPECTED_LENGTH] - state[FRAME_STATE_FRAME_LENGTH];
+			if (numToCopy > (length - offset))
+				numToCopy = length - offset;
+			memcpy(frames + frameStart + state[FRAME_STATE_FRAME_LENGTH], data + offset, numToCopy);
+			state[FRAME_STATE_FRAME_LENGTH] += numToCopy;
+			offset += numToCopy;
+			if (state[FRAME_STATE_FRAME_LENGTH] == state[FRAME_STATE_EXPECTED_LENGTH])
+			{
+				frameStart += state[FRAME_STATE_FRAME_LENGTH];
+				boundaries[numFrames++] = frameStart;
+				state[FRAME_STATE_FRAME_LENGTH] = state[FRAME_STATE_EXPECTED_LENGTH] = 0;
+			}
+		}
+	}
+	else if (state[FRAME_STATE_FORMAT] == FRAME_FORMAT_SLIP)
+	{
+		for (; offset < length; ++offset)
+		{
+			// Publish any non-empty frame at each END byte and resynchronize after discarded frames
+			unsigned char value = data[offset];
+			if (value == 0xC0)
+			{
+				if (!state[FRAME_STATE_DISCARDING] && state[FRAME_STATE_FRAME_LENGTH])
+				{
+					frameStart += state[FRAME_STATE_FRAME_LENGTH];
+					boundaries[numFrames++] = frameStart;
+				}
+				state[FRAME_STATE_FRAME_LENGTH] = state[FRAME_STATE_ESCAPED] = state[FRAME_STATE_DISCARDING] = 0;
+			}
+			else if (state[FRAME_STATE_DISCARDING])
+				continue;
+			else if (state[FRAME_STATE_ESCAPED])
+			{
+				state[FRAME_STATE_ESCAPED] = 0;
+				appendFrameByte(state, frames + frameStart, (value == 0xDC) ? 0xC0 : ((value == 0xDD) ? 0xDB : value));
+			}
+			else if (value == 0xDB)
+				state[FRAME_STATE_ESCAPED] = 1;
+			else
+				appendFrameByte(state, frames + frameStart, value);
+		}
+	}
+	else if (state[FRAME_STATE_FORMAT] == FRAME_FORMAT_COBS)
+	{
+		for (; offset < length; ++offset)
+		{
+			// Publish any complete, non-empty frame at each zero delimiter
+			unsigned char value = data[offset];
+			if (value == 0)
+			{
+				if (!state[FRAME_STATE_DISCARDING] && !state[FRAME_STATE_ESCAPED] && state[FRAME_STATE_FRAME_LENGTH])
+				{
+					frameStart += state[FRAME_STATE_FRAME_LENGTH];
+					boundaries[numFrames++] = frameStart;
+				}
+				state[FRAME_STATE_FRAME_LENGTH] = state[FRAME_STATE_ESCAPED] = state[FRAME_STATE_COBS_CODE] = state[FRAME_STATE_DISCARDING] = 0;
+			}
+			else if (state[FRAME_STATE_DISCARDING])
+				continue;
+			else if (state[FRAME_STATE_ESCAPED])
+			{
+				// Copy the data bytes within the current block
+				appendFrameByte(state, frames + frameStart, value);
+				--state[FRAME_STATE_ESCAPED];
+			}
+			else
+			{
+				// Restore the zero implied by the previous code byte, unless it was a maximum-length block
+				if (state[FRAME_STATE_COBS_CODE] && (state[FRAME_STATE_COBS_CODE] != 0xFF) && !appendFrameByte(state, frames + frameStart, 0))
+					continue;
+				state[FRAME_STATE_COBS_CODE] = value;
+				state[FRAME_STATE_ESCAPED] = value - 1;
+			}
+		}
+	}
+	return numFrames;
+}
+
+// Rolling traffic recording functionality
+static inline unsigned long long getRecordingEntrySize(unsigned int length)
+{
+	return sizeof(recordingEntry) + ((length + 7ULL) & ~7ULL);
+}
+
+static void reclaimRecordingSpace(recordingHeader *header, const char *dataRegion, unsigned long long numBytesNeeded)
+{
+	// Discard the oldest entries until the requested number of bytes fits in the data region
+	while ((header->writePosition + numBytesNeeded - header->oldestPosition) > header->dataLength)
+	{
+		unsigned long long offset = header->oldestPosition % header->dataLength, remaining = header->dataLength - offset;
+		if (remaining < sizeof(recordingEntry))
+			header->oldestPosition += remaining;
+		else
+			header->oldestPosition += getRecordingEntrySize(((const recordingEntry*)(dataRegion + offset))->length);
+	}
+}
+
+void initializeRecording(char *recording, unsigned long long recordingLength, long long startTimestampNS, long long startWallClockNS)
+{
+	// Describe an empty data region whose length is a multiple of the entry alignment
+	recordingHeader *header = (recordingHeader*)recording;
+	memset(header, 0, sizeof(recordingHeader));
+	memcpy(header->magic, RECORDING_MAGIC, sizeof(header->magic));
+	header->byteOrderMark = RECORDING_BYTE_ORDER_MARK;
+	header->version = RECORDING_VERSION;
+	header->dataLength = (recordingLength - sizeof(recordingHeader)) & ~7ULL;
+	header->startTimestampNS = startTimestampNS;
+	header->startWallClockNS = startWallClockNS;
+}
+
+void appendRecording(char *recording, unsigned short direction, long long timestampNS, const char *data, int length)
+{
+	// Split chunks that are too large to share the data region with any other entries
+	recordingHeader *header = (recordingHeader*)recording;
+	char *dataRegion = recording + sizeof(recordingHeader);
+	unsigned int maxChunkLength = (unsigned int)(((header->dataLength / 2) & ~7ULL) - sizeof(recordingEntry));
+	while (length > 0)
+	{
+		unsigned int chunkLength = ((unsigned int)length > maxChunkLength) ? maxChunkLength : (unsigned int)length;
+		unsigned long long entrySize = getRecordingEntrySize(chunkLength);
+		unsigned long long offset = header->writePosition % header->dataLength, remaining = header->dataLength - offset;
+
+		// Entries never wrap, so pad out the end of the data region if the entry does not fit before it
+		if (remaining < entrySize)
+		{
+			reclaimRecordingSpace(header, dataRegion, remaining);
+			if (remaining >= sizeof(recordingEntry))
+			{
+				recordingEntry *padding = (recordingEntry*)(dataRegion + offset);
+				padding->timestampNS = timestampNS;
+				padding->length = (unsigned int)(remaining - sizeof(recordingEntry));
+				padding->direction = RECORDING_DIRECTION_PADDING;
+				padding->reserved = 0;
+			}
+			header->writePosition += remaining;
+			continue;
+		}
+
+		// Write the entry contents before publishing the new write position
+		reclaimRecordingSpace(header, dataRegion, entrySize);
+		recordingEntry *entry = (recordingEntry*)(dataRegion + offset);
+		entry->timestampNS = timestampNS;
+		entry->length = chunkLength;
+		entry->direction = direction;
+		entry->reserved = 0;
+		memcpy(entry + 1, data, chunkLength);
+		InterlockedExchange64((volatile LONGLONG*)&header->writePosition, (LONGLONG)(header->writePosition + entrySize));
+		data += chunkLength;
+		length -= (int)chunkLength;
+	}
+}
+
 #endif
@@ -29,17 +29,53 @@
 // Serial port JNI header file
 #include "../com_fazecast_jSerialComm_SerialPort.h"
 
+// Serial port performance statistics
+#define STATISTICS_HISTOGRAM_BUCKETS 32
+#define STATISTICS_ARRAY_LENGTH (17 + (3 * STATISTICS_HISTOGRAM_BUCKETS))
+typedef struct serialPortStatistics
+{
+	volatile LONGLONG bytesRead, bytesWritten, readCalls, writeCalls, readSyscalls, writeSyscalls, shortReads, readTimeouts, writeRetries, drainTimeNS;
+	volatile LONGLONG rs485Transmissions, rs485TurnaroundNS, rs485MaxTurnaroundNS;
+	volatile LONGLONG readLatency[STATISTICS_HISTOGRAM_BUCKETS], writeLatency[STATISTICS_HISTOGRAM_BUCKETS], rs485Turnaround[STATISTICS_HISTOGRAM_BUCKETS];
+} serialPortStatistics;
+
 // Serial port data structure
 typedef struct serialPort
 {
-	void *handle;
-	char *readBuffer;
+	void *handle, *eventEngineHandle, *ringReaderThread, *ringDataEvent, *ringSpaceEvent, *txWriterThread, *rs485Timer;
+	char *readBuffer, *writeBuffer, *ringBuffer, *txBuffer, *recording;
+	void *recordingMapping, *ftdiHandle, *ftdiEvent, *ftdiWait, *ftdiReadEvent, *ftdiListenerEvent, *ftdiRingEvent, *listenerWakeEvent;
 	wchar_t *portPath, *friendlyName, *portDescription, *portLocation;
-	int errorLineNumber, errorNumber, readBufferLength;
-	volatile char enumerated, eventListenerRunning;
+	OVERLAPPED readOverlapped, writeOverlapped, eventOverlapped, engineOverlapped, ringOverlapped, txOverlapped;
+	CRITICAL_SECTION txLock, recordingLock, rs485Lock, readLock, writeLock;
+	CONDITION_VARIABLE txDataQueued, txSpaceAvailable;
+	COMMTIMEOUTS configuredTimeouts;
+	DWORD engineEventMask, ringBufferLength, txBufferLength, txHead, txTail, ftdiEventMask, ftdiModemStatus, ftdiReceivedBytes, ftdiInterByteTimeout;
+	volatile LONG ringHead, ringTail, ringReaderWaiting, ringSpaceWaiting, ringDiscardHead, ringDiscardPending, ringErrorMask;
+	volatile LONGLONG readTimestamp, ringTimestamp, eventTimestamp;
+	LONGLONG rs485DelayBeforeNS, rs485DelayAfterNS, characterTimeNS;
+	serialPortStatistics statistics;
+	int errorLineNumber, errorNumber, readBufferLength, writeBufferLength, writeTimeout, threadPriority;
+	volatile LONG threadSchedulingStatus;
+	LONGLONG threadAffinityMask;
+	volatile char enumerated, opening, eventListenerRunning, engineRegistered, ringBufferEnabled, ringReaderRunning;
+	volatile char txQueueEnabled, txWriterRunning, txBlockWhenFull, txDiscard, txFailed, recordingEnabled, recordTransmitted, ftdiTxPending;
+	volatile char rs485SoftwareControl, rs485ActiveHigh, rs485RxDuringTx;
+	char rs485TimingEnabled, rs485PreciseTimer, rs485TimerPeriodRaised;
 	char serialNumber[16];
 } serialPort;
 
+// Asynchronous I/O engine data structure
+typedef struct asyncOperation
+{
+	OVERLAPPED overlapped;
+	void *completionEvent, *waitHandle, *completionPort;
+	serialPort *port;
+	char *buffer;
+	DWORD length;
+	int result, isWrite;
+} asyncOperation;
+
 // Common storage functionality
 typedef struct serialPortVector
 {
@@ -50,8 +86,61 @@ serialPort* pushBack(serialPortVector* vector, const wchar_t* key, const wchar_t
 serialPort* fetchPort(serialPortVector* vector, const wchar_t* key);
 void removePort(serialPortVector* vector, serialPort* port);
 
+// Port enumeration filtering functionality
+typedef struct portFilter
+{
+	const wchar_t *pathPattern, *driverName;
+	int vendorID, productID;
+} portFilter;
+
 // Windows-specific functionality
-void reduceLatencyToMinimum(const wchar_t* portName, unsigned char requestElevatedPermissions);
+char setLatencyTimer(const wchar_t* portName, DWORD latency, unsigned char onlyIfLower, unsigned char requestElevatedPermissions);
 int getPortPathFromSerial(wchar_t* portPath, const char* serialNumber);
+char startHotplugMonitor(void (*notifyCallback)(void));
+void stopHotplugMonitor(void);
+int applyThreadScheduling(long long cpuAffinityMask, int realTimePriority);
+
+// Frame decoder state layout (must match SerialPortFrameDecoder.java)
+#define FRAME_FORMAT_LENGTH_PREFIXED 1
+#define FRAME_FORMAT_SLIP 2
+#define FRAME_FORMAT_COBS 3
+#define FRAME_STATE_FORMAT 0
+#define FRAME_STATE_LENGTH_OFFSET 1
+#define FRAME_STATE_LENGTH_WIDTH 2
+#define FRAME_STATE_BIG_ENDIAN 3
+#define FRAME_STATE_LENGTH_ADJUSTMENT 4
+#define FRAME_STATE_MAX_LENGTH 5
+#define FRAME_STATE_FRAME_LENGTH 6
+#define FRAME_STATE_ESCAPED 7
+#define FRAME_STATE_COBS_CODE 8
+#define FRAME_STATE_DISCARDING 9
+#define FRAME_STATE_EXPECTED_LENGTH 10
+#define FRAME_STATE_LENGTH 11
+int decodeFrames(const unsigned char *data, int length, jint *state, unsigned char *frames, jint *boundaries);
+
+// Traffic recording file layout (must match SerialPortRecordingReader.java)
+#define RECORDING_MAGIC "jSCTrace"
+#define RECORDING_VERSION 1
+#define RECORDING_BYTE_ORDER_MARK 0x01020304
+#define RECORDING_MINIMUM_LENGTH 4096
+#define RECORDING_DIRECTION_RECEIVED 0
+#define RECORDING_DIRECTION_TRANSMITTED 1
+#define RECORDING_DIRECTION_PADDING 0xFFFF
+typedef struct recordingHeader
+{
+	char magic[8];
+	unsigned int byteOrderMark, version;
+	unsigned long long dataLength, writePosition, oldestPosition;
+	long long startTimestampNS, startWallClockNS;
+	unsigned long long reserved;
+} recordingHeader;
+typedef struct recordingEntry
+{
+	long long timestampNS;
+	unsigned int length;
+	unsigned short direction, reserved;
+} recordingEntry;
+void initializeRecording(char *recording, unsigned long long recordingLength, long long startTimestampNS, long long startWallClockNS);
+void appendRecording(char *recording, unsigned short direction, long long timestampNS, const char *data, int length);
 
 #endif		// #ifndef __WINDOWS_HELPER_FUNCTIONS_HEADER_H__
@@ -36,8 +36,22 @@ import java.io.IOException;
 import java.io.InputStream;
 import java.io.InputStreamReader;
 import java.io.OutputStream;
+import java.net.URL;
+import java.net.URLConnection;
+import java.nio.ByteBuffer;
+import java.util.ArrayList;
 import java.util.Arrays;
 import java.util.Date;
+import java.util.HashMap;
+import java.util.LinkedList;
+import java.util.concurrent.Callable;
+import java.util.concurrent.ConcurrentLinkedQueue;
+import java.util.concurrent.CopyOnWriteArrayList;
+import java.util.concurrent.ExecutionException;
+import java.util.concurrent.ExecutorService;
+import java.util.concurrent.Executors;
+import java.util.concurrent.Future;
+import java.util.concurrent.ThreadFactory;
 
 /**
  * This class provides native access to serial ports and devices without requiring external libraries or tools.
@@ -52,11 +66,19 @@ public final class SerialPort
 	// Static initializer loads correct native library for this machine
 	static private final String versionString = "2.9.1";
 	static private final String tmpdirAppIdProperty = "fazecast.jSerialComm.appid";
+	static private final String libraryPathProperty = "fazecast.jSerialComm.libraryPath";
+	static private final String virtualPortPrefix = "virtual:", virtualLoopbackPrefix = "virtual:loopback:", virtualReplayPrefix = "virtual:replay:";
 	static private volatile boolean isAndroid = false;
 	static private volatile boolean isWindows = false;
+	static private volatile SerialPortEventEngine eventEngine = null;
+	static private volatile SerialPortHotplugMonitor hotplugMonitor = null;
+	static private volatile SerialPortAsyncEngine asyncEngine = null;
+	static private volatile long engineThreadAffinityMask = 0;
+	static private volatile int engineThreadPriority = 0, engineThreadSchedulingStatus = 0;
+	static private volatile boolean engineThreadRoundRobin = false, engineThreadsScheduled = false;
 	static
 	{
-		// Determine the temporary file directory for Java and remove any previous versions of this library
+		// Determine the temporary file directories for Java
 		String OS = System.getProperty("os.name").toLowerCase(), arch = System.getProperty("os.arch").toLowerCase();
 		String libraryPath = "", fileName = "", backupLibraryPath = "";
 		String tempFileDirectory = System.getProperty("java.io.tmpdir"), userHomeDirectory = System.getProperty("user.home");
@@ -65,15 +87,19 @@ public final class SerialPort
 		if (!userHomeDirectory.endsWith("\\") && !userHomeDirectory.endsWith("/"))
 				userHomeDirectory += "/";
 
+		// Keep a separate tmpdir cache for each user so that no user can plant a library for another one to load, removing anything this user left in the shared legacy cache
+		File legacyTempFileRoot = new File(tempFileDirectory + "jSerialComm/");
+		tempFileDirectory += "jSerialComm-" + System.getProperty("user.name", "").replaceAll("[^A-Za-z0-9._-]", "_") + "/";
+		userHomeDirectory += ".jSerialComm/";
+		File tempFileRoot = new File(tempFileDirectory), userHomeRoot = new File(userHomeDirectory);
+
 		// Make sure to use appId to separate tmpdir directories if library is used by multiple modules so they don't erase each others' folders
-		tempFileDirectory += "jSerialComm/" + System.getProperty(tmpdirAppIdProperty, "");
-		userHomeDirectory += ".jSerialComm/" + System.getProperty(tmpdirAppIdProperty, "");
+		tempFileDirectory += System.getProperty(tmpdirAppIdProperty, "");
+		userHomeDirectory += System.getProperty(tmpdirAppIdProperty, "");
 		if (!tempFileDirectory.endsWith("\\") && !tempFileDirectory.endsWith("/"))
 			tempFileDirectory += "/";
 		if (!userHomeDirectory.endsWith("\\") && !userHomeDirectory.endsWith("/"))
 			userHomeDirectory += "/";
-		deleteDirectory(new File(tempFileDirectory));
-		deleteDirectory(new File(userHomeDirectory));
 
 		// Determine Operating System and architecture
 		if (System.getProperty("java.vm.vendor").toLowerCase().contains("android"))
@@ -310,27 +336,36 @@ public final class SerialPort
 			System.exit(-1);
 		}
 
-		// Copy platform-specific binary to a temporary location
+		// Load a pre-extracted native library if one was specified
+		boolean libraryLoaded = false;
+		String preExtractedLibraryPath = System.getProperty(libraryPathProperty);
+		if (preExtractedLibraryPath != null)
+		{
+			// Allow the property to point to the library file itself, to a directory containing it, or to a directory containing the extracted resource tree
+			File preExtractedLibrary = new File(preExtractedLibraryPath);
+			if (preExtractedLibrary.isDirectory())
+				preExtractedLibrary = (new File(preExtractedLibrary, libraryPath + "/" + fileName)).isFile() ? new File(preExtractedLibrary, libraryPath + "/" + fileName) : new File(preExtractedLibrary, fileName);
+			try { System.load(preExtractedLibrary.getAbsolutePath()); libraryLoaded = true; }
+			catch (UnsatisfiedLinkError e) { System.err.println("Could not load the pre-extracted native jSerialComm library at " + preExtractedLibrary.getAbsolutePath() + ", falling back to library extraction."); }
+		}
+
+		// Copy platform-specific binary to a cached temporary location
 		try
 		{
-			boolean libraryLoaded = false;
-			for (int attempt = 0; !libraryLoaded && (attempt < 2); ++attempt)
+			// Remove any libraries extracted by previous versions of this library, keeping the cache for the current version
+			if (!libraryLoaded)
 			{
-				// Get path of native library and copy file to working directory with open permissions
-				File tempNativeLibrary = new File(((attempt == 0) ? tempFileDirectory : userHomeDirectory) + (new Date()).getTime() + "-" + fileName);
-				File tempBackupNativeLibrary = new File(((attempt == 0) ? tempFileDirectory : userHomeDirectory) + (new Date()).getTime() + "-backup-" + fileName);
-				if (tempNativeLibrary.getParentFile().mkdirs())
-				{
-					tempNativeLibrary.getParentFile().setReadable(true, false);
-					tempNativeLibrary.getParentFile().setWritable(true, false);
-					tempNativeLibrary.getParentFile().setExecutable(true, false);
-					tempBackupNativeLibrary.deleteOnExit();
-					tempNativeLibrary.deleteOnExit();
-				}
-				else
-					continue;
+				deleteOwnedDirectory(legacyTempFileRoot);
+				deleteDirectoryContents(new File(tempFileDirectory), versionString);
+				deleteDirectoryContents(new File(userHomeDirectory), versionString);
+				deleteContentHashedEntries(new File(tempFileDirectory + versionString));
+				deleteContentHashedEntries(new File(userHomeDirectory + versionString));
+			}
 
-				// Load the native jSerialComm library
+			for (int attempt = 0; !libraryLoaded && (attempt < 2); ++attempt)
+			{
+				// Locate the native library resources for this platform
+				String cacheDirectory = ((attempt == 0) ? tempFileDirectory : userHomeDirectory) + versionString + "/";
 				InputStream fileContents = SerialPort.class.getResourceAsStream("/" + libraryPath + "/" + fileName);
 				InputStream backupFileContents = backupLibraryPath.isEmpty() ? null : SerialPort.class.getResourceAsStream("/" + backupLibraryPath + "/" + fileName);
 				if ((fileContents == null) && isAndroid)
@@ -342,65 +377,62 @@ public final class SerialPort
 				{
 					System.err.println("Could not locate or access the native jSerialComm shared library.");
 					System.err.println("If you are using multiple projects with interdependencies, you may need to fix your build settings to ensure that library resources are copied properly.");
+					if (backupFileContents != null)
+						backupFileContents.close();
+					break;
 				}
-				else
-				{
-					// Copy the native library to the system temp directory
-					FileOutputStream destinationFileContents = new FileOutputStream(tempNativeLibrary);
-					byte transferBuffer[] = new byte[4096];
-					int numBytesRead;
-					while ((numBytesRead = fileContents.read(transferBuffer)) > 0)
-						destinationFileContents.write(transferBuffer, 0, numBytesRead);
-					destinationFileContents.close();
-					fileContents.close();
-					tempNativeLibrary.setReadable(true, false);
-					tempNativeLibrary.setWritable(false, false);
-					tempNativeLibrary.setExecutable(true, false);
-
-					// Load primary native library
-					libraryLoaded = true;
-					try { System.load(tempNativeLibrary.getAbsolutePath()); }
-					catch (UnsatisfiedLinkError e)
-					{
-						libraryLoaded = false;
-						if ((backupFileContents == null) && (attempt > 0))
-							throw new UnsatisfiedLinkError("Cannot load native library " + tempNativeLibrary.getAbsolutePath() + " with expected architecture: " + libraryPath);
-					}
 
-					// Load backup native library upon error if available
+				// Copy the native library to the cache directory unless an identical copy is already present
+				File tempNativeLibrary = null;
+				try { tempNativeLibrary = extractNativeLibrary(fileContents, getResourceLength("/" + libraryPath + "/" + fileName), cacheDirectory + libraryPath + "/", fileName, (attempt == 0) ? tempFileRoot : userHomeRoot); }
+				catch (IOException e) { tempNativeLibrary = null; }
+				if (tempNativeLibrary == null)
+				{
 					if (backupFileContents != null)
+						backupFileContents.close();
+					continue;
+				}
+
+				// Load primary native library
+				libraryLoaded = true;
+				try { System.load(tempNativeLibrary.getAbsolutePath()); }
+				catch (UnsatisfiedLinkError e)
+				{
+					libraryLoaded = false;
+					if ((backupFileContents == null) && (attempt > 0))
+						throw new UnsatisfiedLinkError("Cannot load native library " + tempNativeLibrary.getAbsolutePath() + " with expected architecture: " + libraryPath);
+				}
+
+				// Load backup native library upon error if available
+				if (backupFileContents != null)
+				{
+					if (!libraryLoaded)
 					{
-						if (!libraryLoaded)
+						// Copy the backup native library to the cache directory unless an identical copy is already present
+						File tempBackupNativeLibrary = null;
+						try { tempBackupNativeLibrary = extractNativeLibrary(backupFileContents, getResourceLength("/" + backupLibraryPath + "/" + fileName), cacheDirectory + backupLibraryPath + "/", fileName, (attempt == 0) ? tempFileRoot : userHomeRoot); }
+						catch (IOException e) { tempBackupNativeLibrary = null; }
+						if (tempBackupNativeLibrary == null)
+							continue;
+
+						// Load backup native library
+						libraryLoaded = true;
+						try { System.load(tempBackupNativeLibrary.getAbsolutePath()); }
+						catch (UnsatisfiedLinkError e)
 						{
-							// Copy the native library to the system temp directory
-							destinationFileContents = new FileOutputStream(tempBackupNativeLibrary);
-							while ((numBytesRead = backupFileContents.read(transferBuffer)) > 0)
-								destinationFileContents.write(transferBuffer, 0, numBytesRead);
-							destinationFileContents.close();
-							backupFileContents.close();
-							tempBackupNativeLibrary.setReadable(true, false);
-							tempBackupNativeLibrary.setWritable(false, false);
-							tempBackupNativeLibrary.setExecutable(true, false);
-
-							// Load backup native library
-							libraryLoaded = true;
-							try { System.load(tempBackupNativeLibrary.getAbsolutePath()); }
-							catch (UnsatisfiedLinkError e)
-							{
-								libraryLoaded = false;
-								if (attempt > 0)
-									throw new UnsatisfiedLinkError("Cannot load native libraries " + tempNativeLibrary.getAbsolutePath() + " or " + tempBackupNativeLibrary.getAbsolutePath() + " with expected architectures: " + libraryPath + " or " + backupLibraryPath);
-							}
+							libraryLoaded = false;
+							if (attempt > 0)
+								throw new UnsatisfiedLinkError("Cannot load native libraries " + tempNativeLibrary.getAbsolutePath() + " or " + tempBackupNativeLibrary.getAbsolutePath() + " with expected architectures: " + libraryPath + " or " + backupLibraryPath);
 						}
-						else
-							backupFileContents.close();
 					}
-
-					// Initialize native library
-					if (libraryLoaded)
-						initializeLibrary();
+					else
+						backupFileContents.close();
 				}
 			}
+
+			// Initialize native library
+			if (libraryLoaded)
+				initializeLibrary();
 		}
 		catch (Exception e) { e.printStackTrace(); }
 
@@ -424,6 +456,125 @@ public final class SerialPort
 		path.delete();
 	}
 
+	// Static directory cleanup function that deletes everything except the specified entry
+	static private final void deleteDirectoryContents(File path, String entryToKeep)
+	{
+		File[] files = path.listFiles();
+		if (files != null)
+			for (File file : files)
+				if (!file.getName().equals(entryToKeep))
+					deleteDirectory(file);
+	}
+
+	// Static cleanup function for the content-hashed cache directories used before the cache was keyed on the resource path
+	static private final void deleteContentHashedEntries(File versionDirectory)
+	{
+		File[] files = versionDirectory.listFiles();
+		if (files != null)
+			for (File file : files)
+				if (file.getName().matches("[0-9a-f]{64}"))
+					deleteDirectory(file);
+	}
+
+	// Static ownership testing function, relying on the fact that only the owner of a file may explicitly set its timestamps
+	static private final boolean isOwnedByCurrentUser(File file)
+	{
+		long lastModified = file.lastModified();
+		return (lastModified > 0) && file.setLastModified(lastModified);
+	}
+
+	// Static recursive directory deletion function that leaves behind anything belonging to other users
+	static private final void deleteOwnedDirectory(File path)
+	{
+		File[] files = (path.isDirectory() && !isSymbolicLinkSafe(path)) ? path.listFiles() : null;
+		if (files != null)
+			for (File file : files)
+				deleteOwnedDirectory(file);
+		if (path.exists() && isOwnedByCurrentUser(path))
+			path.delete();
+	}
+
+	// Static symbolic link testing function that treats any error as a link so that it is never followed
+	static private final boolean isSymbolicLinkSafe(File file)
+	{
+		try { return isSymbolicLink(file); }
+		catch (IOException e) { return true; }
+	}
+
+	// Static resource length function that returns the size of a bundled resource without reading it, or -1 if unknown
+	static private final long getResourceLength(String resourcePath)
+	{
+		try
+		{
+			URL resource = SerialPort.class.getResource(resourcePath);
+			URLConnection connection = (resource == null) ? null : resource.openConnection();
+			return (connection == null) ? -1 : connection.getContentLength();
+		}
+		catch (IOException e) { return -1; }
+	}
+
+	// Static permission restriction function that limits file access to its owner, returning false if the current user does not own the file
+	static private final boolean restrictToOwner(File file, boolean writable)
+	{
+		// Windows temporary directories are already private to each user and do not support removing permissions from everyone
+		if (File.separatorChar == '\\')
+			return true;
+
+		// Only the owner can change permissions, so failing to do so means that the file belongs to another user
+		boolean restricted = file.setReadable(false, false) && file.setReadable(true, true);
+		restricted = restricted && file.setWritable(false, false) && (!writable || file.setWritable(true, true));
+		return restricted && file.setExecutable(false, false) && file.setExecutable(true, true);
+	}
+
+	// Static native library extraction function that reuses a previously extracted copy for the current library version
+	static private final File extractNativeLibrary(InputStream libraryContents, long libraryLength, String cacheDirectory, String fileName, File cacheRoot) throws IOException
+	{
+		// Create the cache directories and make them private to the current user, refusing to use any directory owned by someone else
+		File cachedLibrary = new File(cacheDirectory + fileName), libraryDirectory = cachedLibrary.getParentFile();
+		boolean directoriesSecured = libraryDirectory.mkdirs() || libraryDirectory.isDirectory();
+		String cacheRootPath = cacheRoot.getAbsolutePath();
+		for (File directory = libraryDirectory; directoriesSecured && (directory != null); directory = directory.getParentFile())
+		{
+			directoriesSecured = directory.canWrite() && restrictToOwner(directory, true);
+			if (directory.getAbsolutePath().equals(cacheRootPath))
+				break;
+		}
+
+		// The cache is keyed on the library version and only ever populated by atomic renames, so reuse any complete copy without reading the resource
+		if (!directoriesSecured || (cachedLibrary.isFile() && (cachedLibrary.length() > 0) && ((libraryLength < 0) || (cachedLibrary.length() == libraryLength)) && isOwnedByCurrentUser(cachedLibrary)))
+		{
+			libraryContents.close();
+			return directoriesSecured ? cachedLibrary : null;
+		}
+
+		// Read the library resource into memory
+		ByteArrayOutputStream libraryBytes = new ByteArrayOutputStream(262144);
+		byte transferBuffer[] = new byte[65536];
+		int numBytesRead;
+		try
+		{
+			while ((numBytesRead = libraryContents.read(transferBuffer)) > 0)
+				libraryBytes.write(transferBuffer, 0, numBytesRead);
+		}
+		finally { libraryContents.close(); }
+		byte[] contents = libraryBytes.toByteArray();
+
+		// Write the library to a unique temporary file and move it into place so that concurrent processes never load a partially written library
+		File tempLibrary = File.createTempFile((new Date()).getTime() + "-", "-" + fileName, libraryDirectory);
+		FileOutputStream destinationFileContents = new FileOutputStream(tempLibrary);
+		try { destinationFileContents.write(contents); }
+		finally { destinationFileContents.close(); }
+		restrictToOwner(tempLibrary, false);
+		if (cachedLibrary.exists())
+			cachedLibrary.delete();
+		if (tempLibrary.renameTo(cachedLibrary))
+			return cachedLibrary;
+
+		// Fall back to using the temporary copy directly if the cached copy is in use and could not be replaced
+		tempLibrary.deleteOnExit();
+		return tempLibrary;
+	}
+
 	/**
 	 * Returns the same output as calling {@link #getPortDescription()}.  This may be useful for display containers which call a Java Object's default toString() method.
 	 *
@@ -447,28 +598,65 @@ public final class SerialPort
 	 * Note that the {@link #openPort()} method must be called before any attempts to read from or write to the port.
 	 * Likewise, {@link #closePort()} should be called when you are finished accessing the port.
 	 * <p>
-	 * Also note that repeated calls to this function will re-enumerate all serial ports and will return a completely
-	 * unique set of array objects. As such, you should store a reference to the serial port object(s) you are
-	 * interested in in your own application code.
+	 * Also note that repeated calls to this function will return a completely unique set of array objects. As such, you
+	 * should store a reference to the serial port object(s) you are interested in in your own application code. On systems
+	 * that support hotplug notifications (Linux, macOS, and Windows 8 or later), the underlying port enumeration is cached
+	 * and only repeated after a device has been added or removed, making subsequent calls to this function inexpensive.
 	 * <p>
 	 * All serial port parameters or timeouts can be changed at any time after the port has been opened.
 	 *
 	 * @return An array of {@link SerialPort} objects.
 	 */
-	static public final synchronized native SerialPort[] getCommPorts();
+	static public final native SerialPort[] getCommPorts();
+
+	/**
+	 * Returns a list of the serial ports on this machine that match the specified filter criteria.
+	 * <p>
+	 * Unlike {@link #getCommPorts()}, this method always performs a fresh enumeration, but the filter criteria are evaluated before any descriptive
+	 * port details are retrieved. Ports that do not match the filter, such as unrelated virtual or Bluetooth terminals, therefore incur almost no
+	 * enumeration cost. This is useful when an application is only interested in a small number of specific devices on a system with many ports.
+	 * <p>
+	 * The returned {@link SerialPort} objects behave identically to those returned by {@link #getCommPorts()}.
+	 *
+	 * @param filter The criteria that each returned port must satisfy.
+	 * @return An array of {@link SerialPort} objects matching the specified filter.
+	 * @see SerialPortFilter
+	 */
+	static public final SerialPort[] getCommPorts(SerialPortFilter filter)
+	{
+		if (filter == null)
+			return getCommPorts();
+		return getCommPortsFiltered(filter.portPathPattern, filter.vendorID, filter.productID, filter.driverName);
+	}
 
 	/**
 	 * Allocates a {@link SerialPort} object corresponding to the user-specified port descriptor.
 	 * <p>
 	 * On Windows machines, this descriptor should be in the form of "COM[*]".<br>
 	 * On Linux machines, the descriptor will look similar to "/dev/tty[*]".
+	 * <p>
+	 * On non-Windows machines, descriptors of the form "virtual:loopback:[name]" or "virtual:replay:[name]:[speed]:[traceFile]" create virtual
+	 * ports instead, as described in {@link #getVirtualLoopbackPort(String)} and {@link #getVirtualReplayPort(String, String, double)}.
 	 *
 	 * @param portDescriptor The desired serial port to use with this library.
 	 * @return A {@link SerialPort} object.
 	 * @throws SerialPortInvalidPortException If a {@link SerialPort} object cannot be created due to a logical or formatting error in the portDescriptor parameter.
 	 */
-	static public final synchronized SerialPort getCommPort(String portDescriptor) throws SerialPortInvalidPortException
+	static public final SerialPort getCommPort(String portDescriptor) throws SerialPortInvalidPortException
 	{
+		// Virtual ports are created natively upon opening and do not correspond to any existing device
+		if (portDescriptor.startsWith(virtualPortPrefix))
+		{
+			if (isWindows || (!portDescriptor.startsWith(virtualLoopbackPrefix) && !portDescriptor.startsWith(virtualReplayPrefix)))
+				throw new SerialPortInvalidPortException("Unable to create a virtual serial port from the unsupported port descriptor: " + portDescriptor);
+			SerialPort serialPort = new SerialPort();
+			serialPort.comPort = portDescriptor;
+			serialPort.friendlyName = portDescriptor.startsWith(virtualLoopbackPrefix) ? "Virtual Loopback Port" : "Virtual Replay Port";
+			serialPort.portDescription = serialPort.friendlyName;
+			serialPort.portLocation = "0-0";
+			return serialPort;
+		}
+
 		// Correct port descriptor, if needed
 		try
 		{
@@ -505,6 +693,161 @@ public final class SerialPort
 		return serialPort;
 	}
 
+	/**
+	 * Allocates a virtual {@link SerialPort} object that loops all transmitted data back into its own receive path.
+	 * <p>
+	 * Virtual ports require no hardware but otherwise behave exactly like physical ports, since they are backed by a pseudo-terminal that is
+	 * created when the port is opened and serviced by a native thread. All read and write methods, timeouts, event listeners, and framing support
+	 * therefore go through the same native code paths as they would for a real device, which makes virtual ports suitable for load testing and
+	 * benchmarking on machines without any serial hardware. The modem control lines of a loopback port are wired as in a standard loopback plug:
+	 * RTS drives CTS, and DTR drives both DSR and DCD, with the corresponding events being reported to any listener that monitors them.
+	 * <p>
+	 * Each distinct name refers to a separate virtual port. Virtual ports are not currently supported on Windows.
+	 *
+	 * @param name A name that uniquely identifies this virtual port, which must not contain any colons.
+	 * @return A virtual loopback {@link SerialPort} object.
+	 * @throws SerialPortInvalidPortException If virtual ports are not supported on this operating system or the name is invalid.
+	 */
+	static public final SerialPort getVirtualLoopbackPort(String name) throws SerialPortInvalidPortException
+	{
+		if (name.indexOf(':') >= 0)
+			throw new SerialPortInvalidPortException("Virtual port names must not contain colons: " + name);
+		return getCommPort(virtualLoopbackPrefix + name);
+	}
+
+	/**
+	 * Allocates a virtual {@link SerialPort} object that receives the data captured in a trace file created by {@link #setRecordingFile(String, long, boolean)}.
+	 * <p>
+	 * When the port is opened, all data that was originally received by the recorded port is fed into this port's receive path with the same relative
+	 * timing as during the recording, scaled by the specified speed multiplier. A multiplier of 2.0 replays the capture twice as fast, while a multiplier of
+	 * 0 or less replays it as fast as the application can read. Any data written to the port is discarded, and the CTS, DSR, and DCD lines are always
+	 * asserted. In all other respects, the port behaves exactly like the loopback ports described in {@link #getVirtualLoopbackPort(String)}.
+	 * <p>
+	 * Each distinct name refers to a separate virtual port. Virtual ports are not currently supported on Windows.
+	 *
+	 * @param name A name that uniquely identifies this virtual port, which must not contain any colons.
+	 * @param traceFileName The path of the trace file to replay.
+	 * @param speedMultiplier The factor by which to speed up the recorded timing, or 0 to replay without any delays.
+	 * @return A virtual replay {@link SerialPort} object.
+	 * @throws SerialPortInvalidPortException If virtual ports are not supported on this operating system or the name is invalid.
+	 */
+	static public final SerialPort getVirtualReplayPort(String name, String traceFileName, double speedMultiplier) throws SerialPortInvalidPortException
+	{
+		if (name.indexOf(':') >= 0)
+			throw new SerialPortInvalidPortException("Virtual port names must not contain colons: " + name);
+		return getCommPort(virtualReplayPrefix + name + ":" + ((speedMultiplier > 0.0) ? Double.toString(speedMultiplier) : "0") + ":" + traceFileName);
+	}
+
+	/**
+	 * Enables a single shared event engine to be used for all serial port data listeners instead of one dedicated thread per port.
+	 * <p>
+	 * When enabled, every port that subsequently starts listening for events is registered with one kernel-level event queue (epoll on Linux, kqueue on macOS
+	 * and BSD, or an I/O completion port on Windows), and all resulting events are dispatched to their corresponding {@link SerialPortDataListener}s from a fixed-size pool of worker threads. Events
+	 * for any single port are always delivered sequentially and in order, but events for different ports may be delivered concurrently.
+	 * <p>
+	 * This is primarily useful for applications that listen to a large number of serial ports at once. On non-Windows systems, listeners that monitor modem control line changes
+	 * ({@link #LISTENING_EVENT_CARRIER_DETECT}, {@link #LISTENING_EVENT_CTS}, {@link #LISTENING_EVENT_DSR}, or {@link #LISTENING_EVENT_RING_INDICATOR}),
+	 * as well as any listener on an operating system where the shared engine is not supported, will continue to use a dedicated listening thread.
+	 * <p>
+	 * This method should be called before any data listeners are added, and the shared event engine cannot be disabled once it has been enabled.
+	 *
+	 * @param numWorkerThreads The number of worker threads used to deliver serial port events to their listeners.
+	 * @return Whether the shared event engine is enabled.
+	 * @see #addDataListener(SerialPortDataListener)
+	 */
+	static public final synchronized boolean enableSharedEventEngine(int numWorkerThreads)
+	{
+		if (eventEngine == null)
+		{
+			long engineHandle = createEventEngine();
+			if (engineHandle >= 0)
+				eventEngine = new SerialPortEventEngine(engineHandle, Math.max(numWorkerThreads, 1));
+		}
+		return (eventEngine != null);
+	}
+
+	/**
+	 * Sets the CPU affinity and real-time scheduling priority of the background threads shared by all serial ports.
+	 * <p>
+	 * These settings apply to the shared event engine thread and its workers (see {@link #enableSharedEventEngine(int)}), the asynchronous
+	 * I/O engine thread, and the Java thread that dispatches hotplug notifications to listeners. The native thread that receives device
+	 * notifications from the operating system only wakes up the dispatcher and keeps the default scheduling. Since each thread applies these
+	 * settings to itself when it starts, this method should be called before any of these facilities are first used; threads that are already
+	 * running keep their current scheduling.
+	 * <p>
+	 * See {@link #setThreadScheduling(long, int, boolean)} for a description of how each setting is applied on the different platforms.
+	 *
+	 * @param cpuAffinityMask A bitmask of the CPUs on which the threads may run (bit 0 corresponds to CPU 0), or 0 to leave the affinity unchanged.
+	 * @param realTimePriority The desired real-time priority between 1 and 99, or 0 to leave the priority unchanged.
+	 * @param roundRobin Whether to use round-robin instead of first-in-first-out real-time scheduling (Linux only).
+	 * @see #getEngineThreadSchedulingStatus()
+	 */
+	static public final synchronized void setEngineThreadScheduling(long cpuAffinityMask, int realTimePriority, boolean roundRobin)
+	{
+		engineThreadAffinityMask = cpuAffinityMask;
+		engineThreadPriority = Math.max(realTimePriority, 0);
+		engineThreadRoundRobin = roundRobin;
+		engineThreadsScheduled = false;
+	}
+
+	/**
+	 * Returns the thread scheduling settings that were successfully applied to every shared background thread started since the most recent
+	 * call to {@link #setEngineThreadScheduling(long, int, boolean)}.
+	 *
+	 * @return A bitmask consisting of {@link #THREAD_SCHEDULING_AFFINITY}, {@link #THREAD_SCHEDULING_REAL_TIME}, and {@link #THREAD_SCHEDULING_MMCSS},
+	 *         or 0 if no shared threads have been started with the current settings.
+	 */
+	static public final synchronized int getEngineThreadSchedulingStatus() { return engineThreadsScheduled ? engineThreadSchedulingStatus : 0; }
+
+	// Applies the shared thread scheduling settings to the calling engine thread
+	static private void applyEngineThreadScheduling()
+	{
+		if ((engineThreadAffinityMask == 0) && (engineThreadPriority == 0))
+			return;
+		int appliedSettings = setCurrentThreadScheduling(engineThreadAffinityMask, engineThreadPriority, engineThreadRoundRobin);
+		synchronized (SerialPort.class)
+		{
+			engineThreadSchedulingStatus = engineThreadsScheduled ? (engineThreadSchedulingStatus & appliedSettings) : appliedSettings;
+			engineThreadsScheduled = true;
+		}
+	}
+
+	/**
+	 * Registers a listener to be notified whenever a serial port is added to or removed from the system.
+	 * <p>
+	 * Port changes are detected using kernel device notifications (netlink uevents on Linux, IOKit notifications on macOS, or device
+	 * interface notifications on Windows 8 or later). On systems where these are not available, the port listing is instead compared
+	 * against its previous state once per second.
+	 * <p>
+	 * All callbacks are made sequentially from a single dedicated background thread, and only ports that appear or disappear after
+	 * the first listener has been registered will be reported.
+	 *
+	 * @param listener A {@link SerialPortHotplugListener}-implemented callback object.
+	 * @see #removeHotplugListener(SerialPortHotplugListener)
+	 */
+	static public final synchronized void addHotplugListener(SerialPortHotplugListener listener)
+	{
+		if (hotplugMonitor == null)
+			hotplugMonitor = new SerialPortHotplugMonitor();
+		hotplugMonitor.addListener(listener);
+	}
+
+	/**
+	 * Unregisters a listener that was previously registered using {@link #addHotplugListener(SerialPortHotplugListener)}.
+	 * <p>
+	 * The background monitoring thread is stopped once no more listeners are registered.
+	 *
+	 * @param listener The {@link SerialPortHotplugListener} to remove.
+	 */
+	static public final synchronized void removeHotplugListener(SerialPortHotplugListener listener)
+	{
+		if ((hotplugMonitor != null) && hotplugMonitor.removeListener(listener))
+		{
+			hotplugMonitor.stop();
+			hotplugMonitor = null;
+		}
+	}
+
 	// Parity Values
 	static final public int NO_PARITY = 0;
 	static final public int ODD_PARITY = 1;
@@ -549,21 +892,40 @@ public final class SerialPort
 	static final public int LISTENING_EVENT_PARITY_ERROR = 0x01000000;
 	static final public int LISTENING_EVENT_PORT_DISCONNECTED = 0x10000000;
 
+	// Low-Latency Settings
+	static final public int LOW_LATENCY_DRIVER_FLAG = 0x00000001;
+	static final public int LOW_LATENCY_DEVICE_TIMER = 0x00000010;
+	static final public int LOW_LATENCY_INTER_BYTE_TIMEOUT = 0x00000100;
+
+	// Thread Scheduling Settings
+	static final public int THREAD_SCHEDULING_AFFINITY = 0x00000001;
+	static final public int THREAD_SCHEDULING_REAL_TIME = 0x00000010;
+	static final public int THREAD_SCHEDULING_MMCSS = 0x00000100;
+
 	// Serial Port Parameters
 	private volatile long portHandle = 0;
 	private volatile int baudRate = 9600, dataBits = 8, stopBits = ONE_STOP_BIT, parity = NO_PARITY, eventFlags = 0;
 	private volatile int timeoutMode = TIMEOUT_NONBLOCKING, readTimeout = 0, writeTimeout = 0, flowControl = 0;
-	private volatile int sendDeviceQueueSize = 4096, receiveDeviceQueueSize = 4096;
+	private volatile int sendDeviceQueueSize = 4096, receiveDeviceQueueSize = 4096, backgroundReadBufferSize = 0;
 	private volatile int safetySleepTimeMS = 200, rs485DelayBefore = 0, rs485DelayAfter = 0;
+	private volatile int interByteTimeout = 0, lowLatencySettings = 0, transmitQueueSize = 0, inputStreamReadAheadSize = 0, ftdiTransferSize = 0;
+	private volatile int threadPriority = 0, listenerThreadSchedulingStatus = -1;
 	private volatile byte xonStartChar = 17, xoffStopChar = 19;
 	private volatile SerialPortDataListener userDataListener = null;
 	private volatile SerialPortEventListener serialEventListener = null;
-	private volatile String comPort, friendlyName, portDescription, portLocation;
+	private volatile String comPort, friendlyName, portDescription, portLocation, recordingFileName = null;
+	private volatile long recordingFileSize = 0, threadAffinityMask = 0;
 	private volatile boolean eventListenerRunning = false, disableConfig = false, disableExclusiveLock = false;
-	private volatile boolean rs485Mode = false, rs485ActiveHigh = true, rs485RxDuringTx = false, rs485EnableTermination = false;
+	private volatile boolean rs485Mode = false, rs485ActiveHigh = true, rs485RxDuringTx = false, rs485EnableTermination = false, rs485SoftwareControl = false;
 	private volatile boolean isRtsEnabled = true, isDtrEnabled = true, autoFlushIOBuffers = false, requestElevatedPermissions = false;
+	private volatile boolean lowLatencyMode = true, lowLatencyConfigured = false, transmitQueueBlocking = true, recordingTransmitted = false;
+	private volatile boolean ftdiDirectMode = false, threadRoundRobin = false;
 	private SerialPortInputStream inputStream = null;
 	private SerialPortOutputStream outputStream = null;
+	private final ArrayList<SerialPortFuture> asyncOperations = new ArrayList<SerialPortFuture>();
+	private final LinkedList<SerialPortFuture> asyncReadQueue = new LinkedList<SerialPortFuture>(), asyncWriteQueue = new LinkedList<SerialPortFuture>();
+	private int numActiveAsyncOperations = 0;
+	private boolean asyncOperationsClosing = false;
 
 	/**
 	 * Opens this serial port for reading and writing with an optional delay time and user-specified device buffer size.
@@ -582,62 +944,69 @@ public final class SerialPort
 	 * @param deviceReceiveQueueSize The requested size in bytes of the internal device driver's input queue (no effect on Linux/OSX)
 	 * @return Whether the port was successfully opened with a valid configuration.
 	 */
-	public final synchronized boolean openPort(int safetySleepTime, int deviceSendQueueSize, int deviceReceiveQueueSize)
+	public final boolean openPort(int safetySleepTime, int deviceSendQueueSize, int deviceReceiveQueueSize) { return openPort(safetySleepTime, deviceSendQueueSize, deviceReceiveQueueSize, true); }
+
+	// Opens this serial port, optionally skipping the safety sleep when it has already been performed on behalf of multiple ports
+	private synchronized boolean openPort(int safetySleepTime, int deviceSendQueueSize, int deviceReceiveQueueSize, boolean performSafetySleep)
 	{
-		// Synchronize this method to the class scope as well
-        synchronized (SerialPort.class)
-        {
-			// Set the send/receive internal buffer sizes, and return true if already opened
-			safetySleepTimeMS = safetySleepTime;
-			sendDeviceQueueSize = (deviceSendQueueSize > 0) ? deviceSendQueueSize : sendDeviceQueueSize;
-			receiveDeviceQueueSize = (deviceReceiveQueueSize > 0) ? deviceReceiveQueueSize : receiveDeviceQueueSize;
-			if (portHandle != 0)
-				return configPort(portHandle);
-	
-			// Force a sleep to ensure that the port does not become unusable due to rapid closing/opening on the part of the user
-			if (safetySleepTimeMS > 0)
-				try { Thread.sleep(safetySleepTimeMS); } catch (Exception e) { Thread.currentThread().interrupt(); }
-	
-			// If this is an Android root application, we must explicitly allow serial port access to the library
-			File portFile = isAndroid ? new File(comPort) : null;
-			if (portFile != null && (!portFile.canRead() || !portFile.canWrite()))
+		// Set the send/receive internal buffer sizes, and return true if already opened
+		safetySleepTimeMS = safetySleepTime;
+		sendDeviceQueueSize = (deviceSendQueueSize > 0) ? deviceSendQueueSize : sendDeviceQueueSize;
+		receiveDeviceQueueSize = (deviceReceiveQueueSize > 0) ? deviceReceiveQueueSize : receiveDeviceQueueSize;
+		if (portHandle != 0)
+			return configPort(portHandle);
+
+		// Force a sleep to ensure that the port does not become unusable due to rapid closing/opening on the part of the user
+		if (performSafetySleep && (safetySleepTimeMS > 0))
+			try { Thread.sleep(safetySleepTimeMS); } catch (Exception e) { Thread.currentThread().interrupt(); }
+
+		// If this is an Android root application, we must explicitly allow serial port access to the library
+		File portFile = isAndroid ? new File(comPort) : null;
+		if (portFile != null && (!portFile.canRead() || !portFile.canWrite()))
+		{
+			Process process = null;
+			try
 			{
-				Process process = null;
-				try
-				{
-					process = Runtime.getRuntime().exec("su");
-					DataOutputStream writer = new DataOutputStream(process.getOutputStream());
-					writer.writeBytes("chmod 666 " + comPort + "\n");
-					writer.writeBytes("exit\n");
-					writer.flush();
-					BufferedReader reader = new BufferedReader(new InputStreamReader(process.getInputStream()));
-					while (reader.readLine() != null);
-				}
-				catch (Exception e)
-				{
-					e.printStackTrace();
-					return false;
-				}
-				finally
-				{
-					if (process == null)
-						return false;
-					try { process.waitFor(); } catch (InterruptedException e) { Thread.currentThread().interrupt(); return false; }
-					try { process.getInputStream().close(); } catch (IOException e) { e.printStackTrace(); return false; }
-					try { process.getOutputStream().close(); } catch (IOException e) { e.printStackTrace(); return false; }
-					try { process.getErrorStream().close(); } catch (IOException e) { e.printStackTrace(); return false; }
-					try { Thread.sleep(500); } catch (InterruptedException e) { Thread.currentThread().interrupt(); return false; }
-				}
+				process = Runtime.getRuntime().exec("su");
+				DataOutputStream writer = new DataOutputStream(process.getOutputStream());
+				writer.writeBytes("chmod 666 " + comPort + "\n");
+				writer.writeBytes("exit\n");
+				writer.flush();
+				BufferedReader reader = new BufferedReader(new InputStreamReader(process.getInputStream()));
+				while (reader.readLine() != null);
 			}
-	
-			// Open the serial port and start an event-based listener if registered
-			if ((portHandle = openPortNative()) != 0)
+			catch (Exception e)
 			{
-				if (serialEventListener != null)
-					serialEventListener.startListening();
+				e.printStackTrace();
+				return false;
 			}
-			return (portHandle != 0);
-        }
+			finally
+			{
+				if (process == null)
+					return false;
+				try { process.waitFor(); } catch (InterruptedException e) { Thread.currentThread().interrupt(); return false; }
+				try { process.getInputStream().close(); } catch (IOException e) { e.printStackTrace(); return false; }
+				try { process.getOutputStream().close(); } catch (IOException e) { e.printStackTrace(); return false; }
+				try { process.getErrorStream().close(); } catch (IOException e) { e.printStackTrace(); return false; }
+				try { Thread.sleep(500); } catch (InterruptedException e) { Thread.currentThread().interrupt(); return false; }
+			}
+		}
+
+		// Open the serial port and start an event-based listener if registered
+		if ((portHandle = openPortNative()) != 0)
+		{
+			if (backgroundReadBufferSize > 0)
+				setBackgroundReading(portHandle, backgroundReadBufferSize);
+			if (transmitQueueSize > 0)
+				setTransmitQueue(portHandle, transmitQueueSize, transmitQueueBlocking);
+			if (recordingFileName != null)
+				setRecording(portHandle, recordingFileName, recordingFileSize, recordingTransmitted);
+			if (lowLatencyConfigured)
+				lowLatencySettings = applyLowLatencyMode();
+			if (serialEventListener != null)
+				serialEventListener.startListening();
+		}
+		return (portHandle != 0);
 	}
 
 	/**
@@ -675,24 +1044,100 @@ public final class SerialPort
 	 */
 	public final boolean openPort() { return openPort(200); }
 
+	/**
+	 * Opens and configures multiple serial ports in parallel.
+	 * <p>
+	 * This method is equivalent to calling {@link #openPort(int)} on each of the specified ports, except that all ports are opened
+	 * concurrently using a temporary pool of background threads, and the safety sleep is performed only once for the entire group instead
+	 * of once per port. This can drastically reduce the start-up time of applications that communicate with a large number of devices.
+	 * <p>
+	 * Each port is opened using its own current configuration, so all desired port parameters should be set before calling this method.
+	 * Any port that is already open will simply be reconfigured.
+	 *
+	 * @param ports The serial ports to open. Any <i>null</i> entries are ignored.
+	 * @param safetySleepTime The number of milliseconds to sleep before opening the ports in case of frequent closing/openings.
+	 * @return An array indicating whether each port at the corresponding index was successfully opened with a valid configuration.
+	 */
+	static public final boolean[] openPorts(SerialPort[] ports, final int safetySleepTime)
+	{
+		// Force a single sleep on behalf of all ports that are not yet open
+		final boolean[] portOpened = new boolean[ports.length];
+		boolean performSafetySleep = false, interrupted = false;
+		for (SerialPort port : ports)
+			performSafetySleep |= ((port != null) && !port.isOpen());
+		if (performSafetySleep && (safetySleepTime > 0))
+			try { Thread.sleep(safetySleepTime); } catch (InterruptedException e) { interrupted = true; }
+
+		// Open all ports concurrently
+		ExecutorService openerPool = Executors.newFixedThreadPool(Math.max(Math.min(ports.length, 32), 1), new ThreadFactory()
+		{
+			@Override
+			public Thread newThread(Runnable runnable)
+			{
+				Thread openerThread = new Thread(runnable, "jSerialComm Port Opener");
+				openerThread.setDaemon(true);
+				return openerThread;
+			}
+		});
+		ArrayList<Future<Boolean>> openResults = new ArrayList<Future<Boolean>>(ports.length);
+		for (final SerialPort port : ports)
+			openResults.add((port == null) ? null : openerPool.submit(new Callable<Boolean>()
+			{
+				@Override
+				public Boolean call() { return port.openPort(safetySleepTime, port.sendDeviceQueueSize, port.receiveDeviceQueueSize, false); }
+			}));
+		openerPool.shutdown();
+
+		// Wait for all open operations to complete so that every opened port is reported, restoring any interruption afterward
+		for (int i = 0; i < ports.length; ++i)
+			while (openResults.get(i) != null)
+			{
+				try { portOpened[i] = openResults.get(i).get(); break; }
+				catch (InterruptedException e) { interrupted = true; }
+				catch (ExecutionException e) { portOpened[i] = false; break; }
+			}
+		if (interrupted)
+			Thread.currentThread().interrupt();
+		return portOpened;
+	}
+
 	/**
 	 * Closes this serial port.
 	 * <p>
+	 * This method is equivalent to calling {@link #closePort(boolean)} with a value of false, so any data still waiting to be written
+	 * is transmitted before the port is closed.
+	 * <p>
+	 * Note that calling this method on an already closed port will simply return a value of true.
+	 *
+	 * @return Whether the port was successfully closed.
+	 */
+	public final boolean closePort() { return closePort(false); }
+
+	/**
+	 * Closes this serial port, optionally without waiting for any unsent data to be transmitted.
+	 * <p>
+	 * Any threads blocked in a read or write call, as well as any running event listener, are woken up immediately when the port is closed.
+	 * If <i>immediate</i> is true, all data remaining in the transmit queue and the device driver is discarded instead of being written out,
+	 * which guarantees that closing cannot stall on a peer that is withholding hardware or software flow control. This is intended for
+	 * failover and reconnection logic that needs to release a port as quickly as possible.
+	 * <p>
 	 * Note that calling this method on an already closed port will simply return a value of true.
 	 *
+	 * @param immediate Whether to discard any unsent data instead of waiting for it to be transmitted.
 	 * @return Whether the port was successfully closed.
 	 */
-	public final synchronized boolean closePort()
+	public final synchronized boolean closePort(boolean immediate)
 	{
-		// Synchronize this method to the class scope as well
-        synchronized (SerialPort.class)
-        {
-			if (serialEventListener != null)
-				serialEventListener.stopListening();
-			if (portHandle != 0)
-				portHandle = closePortNative(portHandle);
-			return (portHandle == 0);
-        }
+		if (serialEventListener != null)
+			serialEventListener.stopListening();
+
+		// Abort all outstanding asynchronous operations before releasing the native port resources
+		if (asyncEngine != null)
+			asyncEngine.cancelAll(this);
+		if (portHandle != 0)
+			portHandle = closePortNative(portHandle, immediate);
+		synchronized (asyncOperations) { asyncOperationsClosing = false; }
+		return (portHandle == 0);
 	}
 
 	/**
@@ -763,21 +1208,58 @@ public final class SerialPort
 	 */
 	public final synchronized int getLastErrorCode() { return getLastErrorCode(portHandle); }
 
+	/**
+	 * Returns a snapshot of the performance counters and call latency histograms maintained by the native code for this port.
+	 * <p>
+	 * These statistics can be used to determine whether I/O slowness originates in the serial device, in the operating system driver, or in
+	 * the application itself. All counters are reset whenever the port is opened or when {@link #resetStatistics()} is called.
+	 *
+	 * @return A snapshot of the current port statistics, or <i>null</i> if the port is not open.
+	 * @see SerialPortStatistics
+	 */
+	public final synchronized SerialPortStatistics getStatistics()
+	{
+		long[] statistics = new long[SerialPortStatistics.LENGTH];
+		return ((portHandle != 0) && getStatistics(portHandle, statistics, false)) ? new SerialPortStatistics(statistics) : null;
+	}
+
+	/**
+	 * Resets all performance counters and latency histograms for this port to zero.
+	 *
+	 * @return Whether the statistics were successfully reset.
+	 * @see #getStatistics()
+	 */
+	public final synchronized boolean resetStatistics() { return (portHandle != 0) && getStatistics(portHandle, null, true); }
+
 	// Serial Port Setup Methods
 	private static native void initializeLibrary();						// Initializes the JNI code
 	private static native void uninitializeLibrary();					// Un-initializes the JNI code
+	private static native SerialPort[] getCommPortsFiltered(String portPathPattern, int vendorID, int productID, String driverName);	// Enumerates only the ports matching the filter criteria
 	private final native void retrievePortDetails();					// Retrieves port descriptions, names, and details
 	private final native long openPortNative();							// Opens serial port
-	private final native long closePortNative(long portHandle);			// Closes serial port
+	private final native long closePortNative(long portHandle, boolean immediate);	// Closes serial port, optionally discarding any unsent data
 	private final native boolean configPort(long portHandle);			// Changes/sets serial port parameters as defined by this class
 	private final native boolean configTimeouts(long portHandle, int timeoutMode, int readTimeout, int writeTimeout, int eventsToMonitor);	// Changes/sets serial port timeouts as defined by this class
+	private final native boolean setFrameParameters(long portHandle, int baudRate, int dataBits, int stopBits, int parity);	// Atomically changes only the baud rate and word framing parameters
 	private final native boolean flushRxTxBuffers(long portHandle);     // Flushes underlying RX/TX device buffers
 	private final native int waitForEvent(long portHandle);				// Waits for serial event to occur as specified in eventFlags
 	private final native int bytesAvailable(long portHandle);			// Returns number of bytes available for reading
 	private final native int bytesAwaitingWrite(long portHandle);		// Returns number of bytes still waiting to be written
 	private final native int readBytes(long portHandle, byte[] buffer, long bytesToRead, long offset, int timeoutMode, int readTimeout);	// Reads bytes from serial port
+	private final native int readBytesTimestamped(long portHandle, byte[] buffer, long bytesToRead, long offset, int timeoutMode, int readTimeout, long[] receiveTimestamp);	// Reads bytes from serial port along with their receive timestamp
 	private final native int writeBytes(long portHandle, byte[] buffer, long bytesToWrite, long offset, int timeoutMode);	// Write bytes to serial port
+	private final native int readBytesDirect(long portHandle, ByteBuffer buffer, long bytesToRead, long offset, int timeoutMode, int readTimeout);	// Reads bytes from serial port directly into a direct buffer
+	private final native int readBytesAhead(long portHandle, byte[] buffer, long bufferSize, int timeoutMode, int readTimeout);	// Reads at least 1 byte plus any already-available bytes into a read-ahead buffer
+	private final native int writeBytesDirect(long portHandle, ByteBuffer buffer, long bytesToWrite, long offset, int timeoutMode);	// Writes bytes to serial port directly from a direct buffer
+	private final native int writeBytesGather(long portHandle, ByteBuffer[] directBuffers, byte[][] arrayBuffers, int[] offsets, int[] lengths, int timeoutMode);	// Writes multiple buffer segments to serial port at once
+	private final native int transact(long portHandle, byte[] request, long requestLength, byte[] response, long responseLength, int expectedLength, int terminator, int silenceGapMicros, int timeoutMS);	// Writes a request and reads its complete response
 	private final native void setEventListeningStatus(long portHandle, boolean eventListenerRunning);	// Change event listener running flag in native code
+	private final native boolean setBackgroundReading(long portHandle, int bufferSize);	// Starts or stops the native background reading thread
+	private final native boolean setTransmitQueue(long portHandle, int bufferSize, boolean blockWhenFull);	// Starts or stops the native background transmit queue writer
+	private final native boolean flushTransmitQueue(long portHandle, int timeoutMS, boolean drainDevice);	// Waits for all queued transmit data to be written
+	private final native boolean setRecording(long portHandle, String fileName, long fileSize, boolean includeTransmitted);	// Starts or stops recording all transferred data to a memory-mapped file
+	private final native int configLowLatency(long portHandle, boolean enabled);	// Applies or reverts driver-level latency optimizations
+	private static native int waitForPortListChange(int lastGeneration, int timeoutMS);	// Waits for the system port listing to change and returns its current generation
 	private final native boolean setBreak(long portHandle);				// Set BREAK status on serial line
 	private final native boolean clearBreak(long portHandle);			// Clear BREAK status on serial line
 	private final native boolean setRTS(long portHandle);				// Set RTS line to 1
@@ -796,6 +1278,25 @@ public final class SerialPort
 	private final native boolean getRI(long portHandle);				// Returns whether the RI signal is 1
 	private final native int getLastErrorLocation(long portHandle);		// Returns the source code line location of the latest native code error
 	private final native int getLastErrorCode(long portHandle);			// Returns the errno value of the latest native code error
+	private final native boolean getStatistics(long portHandle, long[] statistics, boolean reset);	// Retrieves and optionally resets the native performance counters
+	private final native long getReceiveTimestamp(long portHandle, boolean eventTimestamp);	// Returns the native monotonic time of the latest detected event or read data
+	private final native boolean getFtdiDirectMode(long portHandle);		// Returns whether the FTDI D2XX driver owns the port
+	private final native int getThreadSchedulingStatus(long portHandle);	// Returns the scheduling settings applied to all native threads belonging to the port, or -1 if none have started
+	private final native long getNativeHandle(long portHandle);			// Returns the underlying file descriptor or device handle
+	private static native long createEventEngine();						// Creates a shared kernel event queue for multiple ports
+	private static native boolean addToEventEngine(long engineHandle, long portHandle, boolean rearm);	// Registers or re-arms a port for a single event engine notification
+	private static native boolean removeFromEventEngine(long engineHandle, long portHandle);	// Removes a port from the shared event engine
+	private static native int waitForEventEngine(long engineHandle, long[] portHandles, int[] events, int timeoutMS);	// Waits for events on any registered port
+	private static native int readAvailable(long[] portHandles, ByteBuffer[] directBuffers, byte[][] arrayBuffers, int[] offsets, int[] lengths, int[] results, int timeoutMS);	// Waits for and reads available data from multiple ports
+	private static native int setCurrentThreadScheduling(long cpuAffinityMask, int realTimePriority, boolean roundRobin);	// Applies CPU affinity and real-time priority to the calling thread
+	private static native int findMessageBoundaries(byte[] data, int length, byte[] delimiters, int[] delimiterState, int[] boundaries);	// Returns the end offsets of all delimited messages within a chunk
+	private final native int readFrames(long portHandle, int bytesToRead, int timeoutMode, int readTimeout, int[] decoderState, byte[] frameBuffer, int[] boundaries);	// Reads and decodes available bytes into complete frames
+	private static native long createAsyncEngine();						// Creates the native asynchronous I/O engine
+	private static native long startAsyncIO(long engineHandle, long portHandle, boolean write, ByteBuffer directBuffer, byte[] arrayBuffer, int offset, int length);	// Starts an asynchronous read or write operation
+	private static native boolean cancelAsyncIO(long engineHandle, long operationHandle);	// Aborts an in-progress asynchronous operation
+	private static native void wakeAsyncEngine(long engineHandle);		// Interrupts an in-progress asynchronous engine wait
+	private static native int waitForAsyncIO(long engineHandle, long[] operationHandles, int[] results, int timeoutMS);	// Waits for and returns any completed asynchronous operations
+	private static native int finishAsyncIO(long operationHandle, ByteBuffer directBuffer, byte[] arrayBuffer, int offset);	// Copies any read data into its destination and frees an asynchronous operation
 
 	/**
 	 * Returns the number of bytes available without blocking if {@link #readBytes(byte[], long)} were to be called immediately
@@ -845,6 +1346,26 @@ public final class SerialPort
 	 */
 	public final int readBytes(byte[] buffer, long bytesToRead, long offset) { return (portHandle != 0) ? readBytes(portHandle, buffer, bytesToRead, offset, timeoutMode, readTimeout) : -1; }
 
+	/**
+	 * Reads up to <i>bytesToRead</i> raw data bytes from the serial port into the buffer starting at the indicated offset and reports when that data was received.
+	 * <p>
+	 * This method behaves identically to {@link #readBytes(byte[], long, long)}, except that upon successfully reading at least one byte, the first element
+	 * of <i>receiveTimestamp</i> will be set to the monotonic time in nanoseconds at which the native code first obtained the returned data from the device
+	 * driver. If background reading is enabled using {@link #setBackgroundReadBufferSize(int)}, the timestamp instead indicates when the oldest unread data in
+	 * the background buffer arrived. Since this timestamp is captured natively at read time, its accuracy does not depend on any garbage collection or thread
+	 * scheduling delays that occur before this method returns.
+	 * <p>
+	 * On Linux and Windows, the timestamp uses the same time base as {@link System#nanoTime()} and can be compared directly against it.
+	 *
+	 * @param buffer The buffer into which the raw data is read.
+	 * @param bytesToRead The number of bytes to read from the serial port.
+	 * @param offset The read buffer index into which to begin storing data.
+	 * @param receiveTimestamp An array of at least one element into which the receive timestamp will be stored. It is left unchanged if no bytes were read.
+	 * @return The number of bytes successfully read, or -1 if there was an error reading from the port.
+	 * @see SerialPortEvent#getTimestamp()
+	 */
+	public final int readBytes(byte[] buffer, long bytesToRead, long offset, long[] receiveTimestamp) { return (portHandle != 0) ? readBytesTimestamped(portHandle, buffer, bytesToRead, offset, timeoutMode, readTimeout, receiveTimestamp) : -1; }
+
 	/**
 	 * Writes up to <i>bytesToWrite</i> raw data bytes from the buffer parameter to the serial port.
 	 * <p>
@@ -901,31 +1422,370 @@ public final class SerialPort
 		}
 		return ((portHandle != 0) && (totalNumWritten >= 0)) ? totalNumWritten : -1;
 	}
-	
+
 	/**
-	 * Returns the underlying transmit buffer size used by the serial port device driver. The device or operating system may choose to misrepresent this value.
+	 * Reads up to {@link ByteBuffer#remaining()} raw data bytes from the serial port and stores them in the buffer starting at its current position.
 	 * <p>
-	 * Only Windows and Linux-based operating systems are potentially able to return a correct value for this method. On other operating systems, this value is undefined.
-	 * @return The underlying device transmit buffer size.
+	 * If the buffer is a direct buffer, the data is read from the device straight into the buffer's native memory without any intermediate copies
+	 * or Java heap allocations. For non-direct buffers, this method falls back to reading into the buffer's backing array. Upon return, the position
+	 * of the buffer will have been advanced by the number of bytes successfully read.
+	 * <p>
+	 * In blocking-read mode, if no timeouts were specified or the read timeout was set to 0, this call will block until {@link ByteBuffer#remaining()} bytes of data have been
+	 * successfully read from the serial port. Otherwise, this method will return after the requested number of bytes of data have been read or the number of milliseconds
+	 * specified by the read timeout have elapsed, whichever comes first, regardless of the availability of more data.
+	 *
+	 * @param buffer The direct or array-backed buffer into which the raw data is read.
+	 * @return The number of bytes successfully read, or -1 if there was an error reading from the port or the buffer is read-only.
 	 */
-	public final int getDeviceWriteBufferSize() { return sendDeviceQueueSize; }
+	public final int readBytes(ByteBuffer buffer)
+	{
+		// Read directly into the native buffer memory if possible
+		int numRead = -1;
+		if ((portHandle == 0) || buffer.isReadOnly())
+			return -1;
+		else if (buffer.isDirect())
+			numRead = readBytesDirect(portHandle, buffer, buffer.remaining(), buffer.position(), timeoutMode, readTimeout);
+		else if (buffer.hasArray())
+			numRead = readBytes(portHandle, buffer.array(), buffer.remaining(), buffer.arrayOffset() + buffer.position(), timeoutMode, readTimeout);
+
+		// Advance the buffer position past the newly read bytes
+		if (numRead > 0)
+			buffer.position(buffer.position() + numRead);
+		return numRead;
+	}
 
 	/**
-	 * Returns the underlying receive buffer size used by the serial port device driver. The device or operating system may choose to misrepresent this value.
+	 * Reads any immediately available data from multiple serial ports at once using a single native call.
 	 * <p>
-	 * Only Windows and Linux-based operating systems are potentially able to return a correct value for this method. On other operating systems, this value is undefined.
-	 * @return The underlying device receive buffer size.
+	 * This method waits until at least one of the specified ports has data available to be read or until <i>timeoutMS</i> milliseconds have elapsed,
+	 * whichever comes first, and then reads all available data from every ready port into its corresponding buffer, up to {@link ByteBuffer#remaining()}
+	 * bytes each. Upon return, the position of each buffer will have been advanced by the number of bytes read into it. This is intended for
+	 * applications that poll a large number of ports, for which calling {@link #bytesAvailable()} and {@link #readBytes(byte[], long)} on each port
+	 * individually would be dominated by per-call overhead.
+	 * <p>
+	 * The current timeout mode of each individual port is ignored by this method. Closed ports are skipped, and a timeout value less than 0 waits forever.
+	 *
+	 * @param ports The serial ports from which to read.
+	 * @param buffers The direct or array-backed buffers into which to store each corresponding port's data.
+	 * @param timeoutMS The maximum number of milliseconds to wait for any port to become ready.
+	 * @return The number of ports from which data was read, or -1 if the arguments were invalid or the wait itself failed.
 	 */
-	public final int getDeviceReadBufferSize() { return receiveDeviceQueueSize; }
+	static public final int readAvailable(SerialPort[] ports, ByteBuffer[] buffers, int timeoutMS)
+	{
+		// Gather the port handles and buffer extents
+		if ((ports == null) || (buffers == null) || (ports.length != buffers.length))
+			return -1;
+		long[] portHandles = new long[ports.length];
+		ByteBuffer[] directBuffers = new ByteBuffer[ports.length];
+		byte[][] arrayBuffers = new byte[ports.length][];
+		int[] offsets = new int[ports.length], lengths = new int[ports.length], results = new int[ports.length];
+		for (int i = 0; i < ports.length; ++i)
+		{
+			ByteBuffer buffer = buffers[i];
+			if ((buffer == null) || buffer.isReadOnly() || (!buffer.isDirect() && !buffer.hasArray()))
+				return -1;
+			portHandles[i] = (ports[i] != null) ? ports[i].portHandle : 0;
+			lengths[i] = buffer.remaining();
+			if (buffer.isDirect())
+			{
+				directBuffers[i] = buffer;
+				offsets[i] = buffer.position();
+			}
+			else
+			{
+				arrayBuffers[i] = buffer.array();
+				offsets[i] = buffer.arrayOffset() + buffer.position();
+			}
+		}
 
-	/**
-	 * Sets the BREAK signal on the serial control line.
-	 * @return true if successful, false if not.
-	 */
-	public final boolean setBreak() { return (portHandle != 0) && setBreak(portHandle); }
+		// Wait for and read data from all ready ports, advancing the buffer positions past the newly read bytes
+		int numReady = readAvailable(portHandles, directBuffers, arrayBuffers, offsets, lengths, results, timeoutMS);
+		for (int i = 0; i < ports.length; ++i)
+			if (results[i] > 0)
+				buffers[i].position(buffers[i].position() + results[i]);
+		return numReady;
+	}
 
 	/**
-	 * Clears the BREAK signal from the serial control line.
+	 * Writes all {@link ByteBuffer#remaining()} raw data bytes from the buffer parameter to the serial port starting at its current position.
+	 * <p>
+	 * If the buffer is a direct buffer, the data is written to the device straight from the buffer's native memory without requiring any intermediate
+	 * copies. For non-direct buffers, this method falls back to writing from the buffer's backing array. Upon return, the position of the buffer will
+	 * have been advanced by the number of bytes successfully written.
+	 * <p>
+	 * In blocking-write mode, this call will block until all remaining bytes of data have been successfully written to the serial port. Otherwise, this method will return
+	 * after the bytes have been written to the device driver's internal data buffer, which, in most cases, should be almost instantaneous unless the data buffer is full.
+	 *
+	 * @param buffer The direct or array-backed buffer containing the raw data to write to the serial port.
+	 * @return The number of bytes successfully written, or -1 if there was an error writing to the port.
+	 */
+	public final int writeBytes(ByteBuffer buffer)
+	{
+		// Ensure that the buffer contents are accessible
+		if ((portHandle == 0) || (!buffer.isDirect() && !buffer.hasArray()))
+			return -1;
+
+		// Write to the serial port until all bytes have been consumed
+		int totalNumWritten = 0, bytesToWrite = buffer.remaining();
+		while ((portHandle != 0) && (totalNumWritten != bytesToWrite))
+		{
+			int numWritten = buffer.isDirect() ?
+					writeBytesDirect(portHandle, buffer, bytesToWrite - totalNumWritten, buffer.position(), timeoutMode) :
+					writeBytes(portHandle, buffer.array(), bytesToWrite - totalNumWritten, buffer.arrayOffset() + buffer.position(), timeoutMode);
+			if (numWritten > 0)
+			{
+				totalNumWritten += numWritten;
+				buffer.position(buffer.position() + numWritten);
+			}
+			else
+				break;
+		}
+		return ((portHandle != 0) && (totalNumWritten >= 0)) ? totalNumWritten : -1;
+	}
+
+	/**
+	 * Writes all {@link ByteBuffer#remaining()} raw data bytes from each of the specified buffers to the serial port as one contiguous stream, in order.
+	 * <p>
+	 * This gather-write allows a frame that is built from several separate parts (for example, a header, payload, and checksum) to be written without
+	 * first concatenating the parts into a single array. On non-Windows systems, all segments are handed to the operating system using as few vectored
+	 * write calls as possible; on Windows, the segments are coalesced into a single native buffer and written by one operation. In either case, the
+	 * frame is never split into one write per segment, which is important when the driver toggles line states between writes (as in RS-485 mode).
+	 * Upon return, the position of each buffer will have been advanced by the number of its bytes successfully written.
+	 * <p>
+	 * In blocking-write mode, this call will block until all remaining bytes of data have been successfully written to the serial port. Otherwise, this method will return
+	 * after the bytes have been written to the device driver's internal data buffer, which, in most cases, should be almost instantaneous unless the data buffer is full.
+	 *
+	 * @param segments The direct or array-backed buffers containing the raw data to write to the serial port.
+	 * @return The total number of bytes successfully written, or -1 if there was an error writing to the port.
+	 */
+	public final int writeBytes(ByteBuffer... segments)
+	{
+		// Ensure that all buffer contents are accessible
+		if (portHandle == 0)
+			return -1;
+		int bytesToWrite = 0;
+		for (ByteBuffer segment : segments)
+			if (!segment.isDirect() && !segment.hasArray())
+				return -1;
+			else
+				bytesToWrite += segment.remaining();
+
+		// Write to the serial port until all bytes from all segments have been consumed
+		ByteBuffer[] directBuffers = new ByteBuffer[segments.length];
+		byte[][] arrayBuffers = new byte[segments.length][];
+		int[] offsets = new int[segments.length], lengths = new int[segments.length];
+		int totalNumWritten = 0;
+		while ((portHandle != 0) && (totalNumWritten != bytesToWrite))
+		{
+			for (int i = 0; i < segments.length; ++i)
+			{
+				lengths[i] = segments[i].remaining();
+				if (segments[i].isDirect())
+				{
+					directBuffers[i] = segments[i];
+					offsets[i] = segments[i].position();
+				}
+				else
+				{
+					arrayBuffers[i] = segments[i].array();
+					offsets[i] = segments[i].arrayOffset() + segments[i].position();
+				}
+			}
+			int numWritten = writeBytesGather(portHandle, directBuffers, arrayBuffers, offsets, lengths, timeoutMode);
+			if (numWritten <= 0)
+				break;
+
+			// Advance the buffer positions past the newly written bytes
+			totalNumWritten += numWritten;
+			for (int i = 0; (i < segments.length) && (numWritten > 0); ++i)
+			{
+				int numSegmentBytesWritten = Math.min(numWritten, segments[i].remaining());
+				segments[i].position(segments[i].position() + numSegmentBytesWritten);
+				numWritten -= numSegmentBytesWritten;
+			}
+		}
+		return ((portHandle != 0) && (totalNumWritten >= 0)) ? totalNumWritten : -1;
+	}
+
+	/**
+	 * Performs a complete request/response exchange with a remote device using a single native call.
+	 * <p>
+	 * This method is intended for master/slave polling protocols such as Modbus RTU or DLMS. Any unread data that has already been received is discarded,
+	 * the request is written and fully transmitted, and the response is then read into <i>response</i> until one of the following conditions is met:
+	 * <ul>
+	 * <li><i>expectedLength</i> is positive and that many response bytes have been received.</li>
+	 * <li><i>terminator</i> is between 0 and 255 and that byte value has been received. Any bytes received after the terminator are discarded.</li>
+	 * <li><i>silenceGapMicros</i> is positive, at least one response byte has been received, and the line has been idle for that many microseconds.</li>
+	 * <li>The response buffer is full.</li>
+	 * <li><i>timeoutMS</i> is positive and that many milliseconds have elapsed since this method was called.</li>
+	 * </ul>
+	 * <p>
+	 * The inter-character silence gap is timed natively with sub-millisecond resolution where supported by the operating system, so it can be used to detect
+	 * the end of frames such as the 3.5-character Modbus RTU gap without any of the scheduling jitter that would be introduced by separate read calls.
+	 * The currently configured timeout mode and read timeouts of this port are ignored for the duration of the exchange. If <i>timeoutMS</i> is 0, writing
+	 * and transmitting the request is still bounded by the configured write timeout, if any.
+	 *
+	 * @param request The buffer containing the raw request data to transmit.
+	 * @param requestLength The number of request bytes to transmit.
+	 * @param response The buffer into which the response is read.
+	 * @param expectedLength The exact number of bytes expected in the response, or 0 if unknown.
+	 * @param terminator The byte value that marks the end of the response, or -1 if the response is not delimited.
+	 * @param silenceGapMicros The number of microseconds of line silence that marks the end of the response, or 0 to disable silence detection.
+	 * @param timeoutMS The maximum number of milliseconds the entire exchange may take, or 0 to wait indefinitely.
+	 * @return The number of response bytes received, or -1 if there was an error transmitting the request or reading from the port.
+	 * @throws IndexOutOfBoundsException If <i>requestLength</i> is negative or larger than the <i>request</i> buffer.
+	 */
+	public final int transact(byte[] request, int requestLength, byte[] response, int expectedLength, int terminator, int silenceGapMicros, int timeoutMS) throws IndexOutOfBoundsException
+	{
+		if ((requestLength < 0) || (requestLength > request.length))
+			throw new IndexOutOfBoundsException("The specified request length extends past the end of the specified request buffer.");
+		return (portHandle != 0) ? transact(portHandle, request, requestLength, response, response.length, expectedLength, terminator, silenceGapMicros, timeoutMS) : -1;
+	}
+
+	/**
+	 * Starts an asynchronous read of up to {@link ByteBuffer#remaining()} raw data bytes from the serial port into the buffer starting at its current position.
+	 * <p>
+	 * This method is identical to {@link #readAsync(ByteBuffer, int, SerialPortCompletionListener)} without a completion listener.
+	 *
+	 * @param buffer The direct or array-backed buffer into which the raw data is read.
+	 * @param timeoutMS The maximum number of milliseconds to wait for data to arrive, or 0 to wait indefinitely.
+	 * @return A {@link SerialPortFuture} representing the pending result of the read operation.
+	 */
+	public final SerialPortFuture readAsync(ByteBuffer buffer, int timeoutMS) { return readAsync(buffer, timeoutMS, null); }
+
+	/**
+	 * Starts an asynchronous read of up to {@link ByteBuffer#remaining()} raw data bytes from the serial port into the buffer starting at its current position.
+	 * <p>
+	 * The read completes as soon as any data has been received, or with a result of 0 if no data arrives before the specified timeout expires. Its completion
+	 * is reported through the returned {@link SerialPortFuture} as well as to the optional <i>listener</i>. All asynchronous operations are carried out by a
+	 * single background thread using the native event notification mechanism of the operating system (epoll on Linux, kqueue on macOS and BSD, or overlapped
+	 * I/O on Windows), so no thread is blocked for the duration of the transfer. Multiple reads on the same port are carried out one at a time in the order
+	 * in which they were requested.
+	 * <p>
+	 * On Windows, each asynchronous read additionally obeys the timeout settings of the port, so the port should be configured using
+	 * {@link #TIMEOUT_READ_SEMI_BLOCKING} with a read timeout of 0 in order for a read to wait for the arrival of its first byte.
+	 * <p>
+	 * Asynchronous reads cannot be used while background reading is enabled using {@link #setBackgroundReadBufferSize(int)}. A request that cannot be started,
+	 * as well as one for zero bytes, is completed before this method returns, in which case any listener is notified from the calling thread.
+	 *
+	 * @param buffer The direct or array-backed buffer into which the raw data is read.
+	 * @param timeoutMS The maximum number of milliseconds to wait for data to arrive, or 0 to wait indefinitely.
+	 * @param listener An optional {@link SerialPortCompletionListener} to be notified when the read completes, or null.
+	 * @return A {@link SerialPortFuture} representing the pending result of the read operation.
+	 * @see SerialPortCompletionListener
+	 */
+	public final SerialPortFuture readAsync(ByteBuffer buffer, int timeoutMS, SerialPortCompletionListener listener)
+	{
+		SerialPortFuture future = new SerialPortFuture(this, buffer, false, Math.max(timeoutMS, 0), listener);
+		boolean bufferUsable = !buffer.isReadOnly() && (buffer.isDirect() || buffer.hasArray());
+		submitAsyncOperation(future, bufferUsable && (backgroundReadBufferSize <= 0));
+		return future;
+	}
+
+	/**
+	 * Starts an asynchronous write of all {@link ByteBuffer#remaining()} raw data bytes from the buffer to the serial port starting at its current position.
+	 * <p>
+	 * This method is identical to {@link #writeAsync(ByteBuffer, SerialPortCompletionListener)} without a completion listener.
+	 *
+	 * @param buffer The direct or array-backed buffer containing the raw data to write to the serial port.
+	 * @return A {@link SerialPortFuture} representing the pending result of the write operation.
+	 */
+	public final SerialPortFuture writeAsync(ByteBuffer buffer) { return writeAsync(buffer, null); }
+
+	/**
+	 * Starts an asynchronous write of all {@link ByteBuffer#remaining()} raw data bytes from the buffer to the serial port starting at its current position.
+	 * <p>
+	 * The data is copied out of the buffer when the write is started, and the write completes once all of it has been accepted by the device driver.
+	 * Its completion is reported through the returned {@link SerialPortFuture} as well as to the optional <i>listener</i>. Multiple writes on the same port
+	 * are carried out one at a time in the order in which they were requested, so their data is never interleaved. On Windows, each asynchronous write
+	 * additionally obeys the write timeout settings of the port.
+	 * <p>
+	 * A request that cannot be started, as well as one for zero bytes, is completed before this method returns, in which case any listener is notified
+	 * from the calling thread.
+	 *
+	 * @param buffer The direct or array-backed buffer containing the raw data to write to the serial port.
+	 * @param listener An optional {@link SerialPortCompletionListener} to be notified when the write completes, or null.
+	 * @return A {@link SerialPortFuture} representing the pending result of the write operation.
+	 * @see SerialPortCompletionListener
+	 * @see #readAsync(ByteBuffer, int, SerialPortCompletionListener)
+	 */
+	public final SerialPortFuture writeAsync(ByteBuffer buffer, SerialPortCompletionListener listener)
+	{
+		SerialPortFuture future = new SerialPortFuture(this, buffer, true, 0, listener);
+		submitAsyncOperation(future, buffer.isDirect() || buffer.hasArray());
+		return future;
+	}
+
+	// Hands an asynchronous operation over to the shared asynchronous I/O engine, completing it immediately if it cannot be started
+	private void submitAsyncOperation(SerialPortFuture future, boolean isValid)
+	{
+		SerialPortAsyncEngine engine = (isValid && (portHandle != 0)) ? getAsyncEngine() : null;
+		if (isValid && (future.buffer.remaining() == 0))
+		{
+			future.completeAndNotify((portHandle != 0) ? 0 : -1);
+			return;
+		}
+		synchronized (asyncOperations)
+		{
+			if ((engine == null) || asyncOperationsClosing)
+				engine = null;
+			else
+				asyncOperations.add(future);
+		}
+		if (engine != null)
+			engine.submit(future);
+		else
+			future.completeAndNotify(-1);
+	}
+
+	// Requests that the asynchronous I/O engine abort the specified operation
+	final void cancelAsyncOperation(SerialPortFuture future)
+	{
+		SerialPortAsyncEngine engine = asyncEngine;
+		if (engine != null)
+			engine.submit(future);
+	}
+
+	// Returns the shared asynchronous I/O engine, creating it if necessary
+	static private final SerialPortAsyncEngine getAsyncEngine()
+	{
+		if (asyncEngine == null)
+			synchronized (SerialPortAsyncEngine.class)
+			{
+				if (asyncEngine == null)
+				{
+					long engineHandle = createAsyncEngine();
+					if (engineHandle != 0)
+						asyncEngine = new SerialPortAsyncEngine(engineHandle);
+				}
+			}
+		return asyncEngine;
+	}
+
+	/**
+	 * Returns the underlying transmit buffer size used by the serial port device driver. The device or operating system may choose to misrepresent this value.
+	 * <p>
+	 * Only Windows and Linux-based operating systems are potentially able to return a correct value for this method. On other operating systems, this value is undefined.
+	 * @return The underlying device transmit buffer size.
+	 */
+	public final int getDeviceWriteBufferSize() { return sendDeviceQueueSize; }
+
+	/**
+	 * Returns the underlying receive buffer size used by the serial port device driver. The device or operating system may choose to misrepresent this value.
+	 * <p>
+	 * Only Windows and Linux-based operating systems are potentially able to return a correct value for this method. On other operating systems, this value is undefined.
+	 * @return The underlying device receive buffer size.
+	 */
+	public final int getDeviceReadBufferSize() { return receiveDeviceQueueSize; }
+
+	/**
+	 * Sets the BREAK signal on the serial control line.
+	 * @return true if successful, false if not.
+	 */
+	public final boolean setBreak() { return (portHandle != 0) && setBreak(portHandle); }
+
+	/**
+	 * Clears the BREAK signal from the serial control line.
 	 * @return true if successful, false if not.
 	 */
 	public final boolean clearBreak() { return (portHandle != 0) && clearBreak(portHandle); }
@@ -1035,7 +1895,26 @@ public final class SerialPort
 	 * @see SerialPortMessageListener
 	 * @see SerialPortMessageListenerWithExceptions
 	 */
-	public final synchronized boolean addDataListener(SerialPortDataListener listener)
+	public final synchronized boolean addDataListener(SerialPortDataListener listener) { return addDataListener(listener, false); }
+
+	/**
+	 * Adds a {@link SerialPortDataListener} to the serial port interface, optionally recycling all event buffers.
+	 * <p>
+	 * This method behaves identically to {@link #addDataListener(SerialPortDataListener)}, except that when <i>recycleEventBuffers</i> is true,
+	 * the listening thread will not allocate any new memory in its steady state. Instead, a single {@link SerialPortEvent} object and a set of internal
+	 * data buffers are reused for every callback to {@link SerialPortDataListener#serialEvent(SerialPortEvent)}.
+	 * <p>
+	 * When buffer recycling is enabled, the array returned by {@link SerialPortEvent#getReceivedData()} is only valid until the
+	 * {@link SerialPortDataListener#serialEvent(SerialPortEvent)} callback returns, and only the first {@link SerialPortEvent#getReceivedDataLength()} bytes
+	 * of that array contain valid data. Listeners that need to retain received data beyond the lifetime of the callback must copy it themselves.
+	 *
+	 * @param listener A {@link SerialPortDataListener}, {@link SerialPortDataListenerWithExceptions}, {@link SerialPortPacketListener}, {@link SerialPortMessageListener}, {@link SerialPortMessageListenerWithExceptions}, or {@link SerialPortFrameListener} implementation to be used for event-based serial port communications.
+	 * @param recycleEventBuffers Whether the {@link SerialPortEvent} objects and data buffers passed to the listener should be recycled between callbacks.
+	 * @return Whether the listener was successfully registered with the serial port.
+	 * @see #addDataListener(SerialPortDataListener)
+	 * @see SerialPortEvent#getReceivedDataLength()
+	 */
+	public final synchronized boolean addDataListener(SerialPortDataListener listener, boolean recycleEventBuffers)
 	{
 		if (userDataListener != null)
 			return false;
@@ -1043,10 +1922,11 @@ public final class SerialPort
 		eventFlags = listener.getListeningEvents();
 		if ((eventFlags & LISTENING_EVENT_DATA_RECEIVED) > 0)
 			eventFlags |= LISTENING_EVENT_DATA_AVAILABLE;
-		serialEventListener = ((userDataListener instanceof SerialPortPacketListener) ? new SerialPortEventListener(((SerialPortPacketListener)userDataListener).getPacketSize()) :
+		serialEventListener = ((userDataListener instanceof SerialPortFrameListener) ? new SerialPortEventListener(((SerialPortFrameListener)userDataListener).getFrameDecoder(), recycleEventBuffers) :
+			(userDataListener instanceof SerialPortPacketListener) ? new SerialPortEventListener(((SerialPortPacketListener)userDataListener).getPacketSize(), recycleEventBuffers) :
 			((userDataListener instanceof SerialPortMessageListener) ?
-					new SerialPortEventListener(((SerialPortMessageListener)userDataListener).getMessageDelimiter(), ((SerialPortMessageListener)userDataListener).delimiterIndicatesEndOfMessage()) :
-						new SerialPortEventListener()));
+					new SerialPortEventListener(((SerialPortMessageListener)userDataListener).getMessageDelimiter(), ((SerialPortMessageListener)userDataListener).delimiterIndicatesEndOfMessage(), recycleEventBuffers) :
+						new SerialPortEventListener(recycleEventBuffers)));
 		if (portHandle != 0)
 		{
 			configTimeouts(portHandle, timeoutMode, readTimeout, writeTimeout, eventFlags);
@@ -1121,6 +2001,26 @@ public final class SerialPort
 		return inputStream;
 	}
 
+	/**
+	 * Sets the size of the read-ahead buffer used by all {@link java.io.InputStream} objects associated with this serial port.
+	 * <p>
+	 * By default, every single-byte {@link java.io.InputStream#read()} call results in a separate native read, which is extremely slow when the stream is
+	 * consumed one character at a time (for example, by a {@link java.util.Scanner} or a custom line parser). When a read-ahead buffer is configured,
+	 * any read that finds the buffer empty waits for its first byte exactly as dictated by the current timeout mode (see
+	 * {@link #setComPortTimeouts(int, int, int)}), and then also retrieves up to <i>bufferSize</i> bytes that have already arrived without waiting any
+	 * further. Subsequent single-byte reads, small array reads, and calls to {@link java.io.InputStream#skip(long)} are then served directly from memory.
+	 * <p>
+	 * Note that bytes held in the read-ahead buffer have already been removed from the serial driver, so they will only be returned by the stream
+	 * itself and not by calls to {@link #readBytes(byte[], long)} or {@link #bytesAvailable()}. Reads using an array at least as large as the read-ahead
+	 * buffer bypass it entirely once it is empty, so {@link #TIMEOUT_READ_BLOCKING} semantics are retained for large reads.
+	 * <p>
+	 * This setting may be changed at any time and takes effect the next time a stream buffer becomes empty. The default value of 0 disables read-ahead
+	 * buffering.
+	 *
+	 * @param bufferSize The capacity of the read-ahead buffer in bytes, or 0 to disable read-ahead buffering.
+	 */
+	public final void setInputStreamReadAheadSize(int bufferSize) { inputStreamReadAheadSize = (bufferSize > 0) ? bufferSize : 0; }
+
 	/**
 	 * Returns an {@link java.io.OutputStream} object associated with this serial port.
 	 * <p>
@@ -1145,6 +2045,25 @@ public final class SerialPort
 		return outputStream;
 	}
 
+	/**
+	 * Returns a {@link SerialPortChannel} object associated with this serial port.
+	 * <p>
+	 * The returned channel implements the {@link java.nio.channels.ReadableByteChannel}, {@link java.nio.channels.WritableByteChannel}, and
+	 * {@link java.nio.channels.GatheringByteChannel} interfaces, allowing the port to be used directly with NIO buffers and utilities. It also
+	 * exposes the native file descriptor of the port so that it can be monitored by an external event loop.
+	 *
+	 * @return A {@link SerialPortChannel} object associated with this serial port.
+	 * @see SerialPortChannel
+	 */
+	public final SerialPortChannel getChannel() { return new SerialPortChannel(this); }
+
+	// Returns the native file descriptor or handle of the open port
+	final long getNativeHandle()
+	{
+		long nativeHandle = portHandle;
+		return (nativeHandle != 0) ? getNativeHandle(nativeHandle) : -1;
+	}
+
 	/**
 	 * Flushes the serial port's Rx/Tx device buffers.
 	 * <p>
@@ -1249,10 +2168,41 @@ public final class SerialPort
 		return true;
 	}
 
+	/**
+	 * Changes the baud rate, number of data bits, number of stop bits, and parity of this serial port without reapplying any other settings.
+	 * <p>
+	 * Unlike {@link #setComPortParameters(int, int, int, int)}, this method does not perform a safety sleep or a complete port reconfiguration.
+	 * Instead, only the specified framing parameters are changed, using a single driver update wherever the system allows it, so the port never
+	 * operates with a partially updated configuration. Flow control, timeouts, RS-485 settings, and driver buffer sizes are left unchanged. This is intended for protocols that change
+	 * their line settings in the middle of a session, such as bootloaders that switch to a higher baud rate after a handshake or LIN masters that
+	 * generate a break signal by temporarily lowering the baud rate.
+	 * <p>
+	 * <i>Note that the update is only atomic for standard baud rates on all systems, and for any baud rate on Windows and on Linux kernels
+	 * supporting termios2. On macOS and the other systems, a non-standard baud rate is applied by a second driver call immediately after the
+	 * framing update, so the new framing may briefly be used at the previous or a placeholder baud rate.</i>
+	 * <p>
+	 * If the port is not currently open, the new parameters are simply stored and applied when the port is opened.
+	 *
+	 * @param newBaudRate The desired baud rate for this serial port.
+	 * @param newDataBits The number of data bits to use per word.
+	 * @param newStopBits The number of stop bits to use.
+	 * @param newParity The type of parity error-checking desired.
+	 * @return Whether the new parameters were successfully applied (only meaningful after the port is already opened).
+	 * @see #setBaudRateFast(int)
+	 */
+	public final synchronized boolean setComPortParametersFast(int newBaudRate, int newDataBits, int newStopBits, int newParity)
+	{
+		baudRate = newBaudRate;
+		dataBits = newDataBits;
+		stopBits = newStopBits;
+		parity = newParity;
+		return (portHandle == 0) || setFrameParameters(portHandle, baudRate, dataBits, stopBits, parity);
+	}
+
 	/**
 	 * Sets the serial port read and write timeout parameters.
 	 * <p>
-	 * <i>Note that time-based write timeouts are only available on Windows systems. There is no functionality to set a write timeout on other operating systems.</i>
+	 * <i>Note that on non-Windows systems, the write timeout bounds the time spent waiting for the driver to accept data and, in write-blocking mode, for it to finish transmitting.</i>
 	 * <p>
 	 * The built-in timeout mode constants should be used ({@link #TIMEOUT_NONBLOCKING}, {@link #TIMEOUT_READ_SEMI_BLOCKING}, {@link #TIMEOUT_READ_BLOCKING},
 	 * {@link #TIMEOUT_WRITE_BLOCKING}, {@link #TIMEOUT_SCANNER}) to specify how timeouts are to be handled.
@@ -1286,30 +2236,23 @@ public final class SerialPort
 	 * In order to specify that both a blocking read and write mode should be used, {@link #TIMEOUT_WRITE_BLOCKING} can be OR'd together with any of the read modes to pass
 	 * to the first parameter.
 	 * <p>
-	 * It is important to note that non-Windows operating systems only allow decisecond (1/10th of a second) granularity for serial port timeouts. As such, your
-	 * millisecond timeout value will be rounded to the nearest decisecond under Linux or Mac OS. To ensure consistent performance across multiple platforms, it is
-	 * advisable that you set your timeout values to be multiples of 100, although this is not strictly enforced.
+	 * Read timeouts are honored with millisecond granularity on all platforms. On non-Windows systems, the timeout is measured against a monotonic clock from the
+	 * start of the read call, so it is not affected by changes to the system time.
 	 * <p>
 	 * Also note that if the serial port has an event-based data listener actively registered for the event type {@link #LISTENING_EVENT_DATA_RECEIVED}, all serial port
 	 * timeout settings are ignored.
 	 *
 	 * @param newTimeoutMode The new timeout mode as specified above.
 	 * @param newReadTimeout The number of milliseconds of inactivity to tolerate before returning from a {@link #readBytes(byte[],long)} call.
-	 * @param newWriteTimeout The number of milliseconds of inactivity to tolerate before returning from a {@link #writeBytes(byte[],long)} call (effective only on Windows).
+	 * @param newWriteTimeout The number of milliseconds of inactivity to tolerate before returning from a {@link #writeBytes(byte[],long)} call (0 to wait indefinitely).
 	 * @return Whether the port configuration is valid or disallowed on this system (only meaningful after the port is already opened).
 	 */
 	public final synchronized boolean setComPortTimeouts(int newTimeoutMode, int newReadTimeout, int newWriteTimeout)
 	{
 		timeoutMode = newTimeoutMode;
+		readTimeout = newReadTimeout;
 		if (isWindows)
-		{
-			readTimeout = newReadTimeout;
 			writeTimeout = newWriteTimeout;
-		}
-		else if ((newReadTimeout > 0) && (newReadTimeout <= 100))
-			readTimeout = 100;
-		else
-			readTimeout = Math.round((float)newReadTimeout / 100.0f) * 100;
 
 		if (portHandle != 0)
 		{
@@ -1320,6 +2263,252 @@ public final class SerialPort
 		return true;
 	}
 
+	/**
+	 * Enables or disables a native background thread that continuously drains all incoming data from the serial device into an internal buffer.
+	 * <p>
+	 * Normally, data is only removed from the operating system's serial driver when a read call is made. If the application is unable to read quickly
+	 * enough (for example, during a long garbage collection pause or inside a slow data listener), the device or driver receive queue may overflow and
+	 * data will be lost. When background reading is enabled, a dedicated native thread moves received data into a lock-free ring buffer of the
+	 * specified size as soon as it arrives, and all subsequent calls to {@link #bytesAvailable()} and {@link #readBytes(byte[], long)} are served
+	 * directly from that buffer while still honoring the current timeout mode.
+	 * <p>
+	 * The requested size will be rounded up to the next power of two. If the ring buffer itself becomes full, the background thread simply stops draining
+	 * the device until space becomes available. Any unread data in the ring buffer is discarded when background reading is disabled or the port is closed.
+	 * <p>
+	 * This setting may be changed at any time before or after the port has been opened. The default value of 0 disables background reading.
+	 *
+	 * @param bufferSize The capacity of the background receive buffer in bytes, or 0 to disable background reading.
+	 * @return Whether background reading was successfully configured (only meaningful after the port is already opened).
+	 */
+	public final synchronized boolean setBackgroundReadBufferSize(int bufferSize)
+	{
+		backgroundReadBufferSize = (bufferSize > 0) ? bufferSize : 0;
+
+		if (portHandle != 0)
+		{
+			// Restart any event listener so that it waits on the correct data source
+			if (serialEventListener != null)
+				serialEventListener.stopListening();
+			boolean success = setBackgroundReading(portHandle, backgroundReadBufferSize);
+			if (serialEventListener != null)
+			{
+				configTimeouts(portHandle, timeoutMode, readTimeout, writeTimeout, eventFlags);
+				serialEventListener.startListening();
+			}
+			return success;
+		}
+		return true;
+	}
+
+	/**
+	 * Enables or disables a native transmit queue that allows write calls to return as soon as their data has been copied into an internal buffer.
+	 * <p>
+	 * Normally, every write call results in at least one operating system call that blocks until the data has been accepted by the serial driver, which
+	 * becomes a significant bottleneck for applications that send many small messages. When the transmit queue is enabled, all calls to
+	 * {@link #writeBytes(byte[], long)} and the {@link java.io.OutputStream} returned by {@link #getOutputStream()} simply copy the data into a ring buffer
+	 * of the specified size, and a dedicated native thread writes all contiguous queued data to the device using as few system calls as possible.
+	 * <p>
+	 * The requested size will be rounded up to the next power of two. If <i>blockWhenFull</i> is true, a write call that does not fit in the remaining
+	 * queue space will wait for space to become available, returning the number of bytes queued so far if a non-zero write timeout expires first. Otherwise, the call will only queue as many bytes as
+	 * will currently fit and return that number immediately. Use {@link #flushTransmitQueue(int)} or {@link #drainTransmitQueue(int)} when the
+	 * application needs to know that all previously written data has actually left the queue.
+	 * <p>
+	 * Any data remaining in the queue is written out before the queue is disabled or the port is closed. If the device reports a write error, all queued
+	 * data is discarded and the next write call will indicate the failure.
+	 * <p>
+	 * This setting may be changed at any time before or after the port has been opened. The default value of 0 disables the transmit queue.
+	 *
+	 * @param bufferSize The capacity of the transmit queue in bytes, or 0 to disable the transmit queue.
+	 * @param blockWhenFull Whether write calls should wait for queue space to become available instead of returning early.
+	 * @return Whether the transmit queue was successfully configured (only meaningful after the port is already opened).
+	 */
+	public final synchronized boolean setTransmitQueueSize(int bufferSize, boolean blockWhenFull)
+	{
+		transmitQueueSize = (bufferSize > 0) ? bufferSize : 0;
+		transmitQueueBlocking = blockWhenFull;
+		return (portHandle == 0) || setTransmitQueue(portHandle, transmitQueueSize, transmitQueueBlocking);
+	}
+
+	/**
+	 * Waits until all data in the native transmit queue has been handed to the serial driver.
+	 * <p>
+	 * This method returns immediately if the transmit queue has not been enabled using {@link #setTransmitQueueSize(int, boolean)}.
+	 *
+	 * @param timeoutMS The maximum number of milliseconds to wait, or 0 to wait indefinitely.
+	 * @return Whether all queued data was successfully written before the timeout elapsed.
+	 */
+	public final boolean flushTransmitQueue(int timeoutMS) { return (portHandle != 0) && flushTransmitQueue(portHandle, timeoutMS, false); }
+
+	/**
+	 * Waits until all data in the native transmit queue has been handed to the serial driver and then until the driver has physically transmitted it.
+	 * <p>
+	 * The timeout only applies to emptying the transmit queue. Waiting for the device to finish transmitting may take additional time depending on the
+	 * current baud rate and the amount of data buffered by the driver.
+	 *
+	 * @param timeoutMS The maximum number of milliseconds to wait for the transmit queue to empty, or 0 to wait indefinitely.
+	 * @return Whether all queued data was successfully written and transmitted.
+	 */
+	public final boolean drainTransmitQueue(int timeoutMS) { return (portHandle != 0) && flushTransmitQueue(portHandle, timeoutMS, true); }
+
+	/**
+	 * Starts or stops recording all data received by this serial port, and optionally all data transmitted, into a memory-mapped rolling trace file.
+	 * <p>
+	 * Recording takes place entirely within the native read and write paths, so every chunk of data is captured exactly as it was exchanged with the
+	 * device driver, including data read by the background reader set up using {@link #setBackgroundReadBufferSize(int)}, data written by the
+	 * transmit queue set up using {@link #setTransmitQueueSize(int, boolean)}, and data transferred asynchronously. Each chunk is tagged with its
+	 * direction and a native monotonic timestamp in the same time base as {@link SerialPortEvent#getTimestamp()}, and no data is copied into Java.
+	 * <p>
+	 * The file is created or truncated to exactly <i>fileSize</i> bytes each time recording starts, including every time the port is opened. Once the
+	 * file is full, the oldest chunks are overwritten, so the file always contains the most recent traffic. The file contents are complete once
+	 * recording has been stopped or the port has been closed, and may be read using {@link SerialPortRecordingReader}.
+	 * <p>
+	 * This setting may be changed at any time before or after the port has been opened. Specifying a <i>null</i> file name stops recording.
+	 *
+	 * @param fileName The path of the trace file to create, or <i>null</i> to stop recording.
+	 * @param fileSize The total size of the trace file in bytes, which must be at least 4160 bytes.
+	 * @param recordTransmitted Whether transmitted data should be recorded in addition to received data.
+	 * @return Whether recording was successfully configured (only meaningful after the port is already opened).
+	 */
+	public final synchronized boolean setRecordingFile(String fileName, long fileSize, boolean recordTransmitted)
+	{
+		if ((fileName != null) && (fileSize < 4160))
+			return false;
+		recordingFileName = fileName;
+		recordingFileSize = (fileName != null) ? fileSize : 0;
+		recordingTransmitted = recordTransmitted;
+		return (portHandle == 0) || setRecording(portHandle, recordingFileName, recordingFileSize, recordingTransmitted);
+	}
+
+	/**
+	 * Explicitly enables or disables all available low-latency optimizations for this serial port and returns the settings that were actually applied.
+	 * <p>
+	 * By default, the driver low-latency flag is requested on Linux and the FTDI latency timer is reduced to 2ms on Windows whenever a port is opened.
+	 * Calling this method replaces that implicit behavior with the following explicit settings:
+	 * <ul>
+	 * <li>{@link #LOW_LATENCY_DRIVER_FLAG}: The <i>ASYNC_LOW_LATENCY</i> serial driver flag is set or cleared (Linux only).</li>
+	 * <li>{@link #LOW_LATENCY_DEVICE_TIMER}: The USB-serial device latency timer is set to 1ms when enabled or back to the 16ms driver default when disabled.
+	 *     On Linux, this uses the <i>latency_timer</i> sysfs attribute of drivers such as <i>ftdi_sio</i> and usually requires write permission to that file.
+	 *     On Windows, this updates the FTDI driver registry value, which takes effect the next time the port is opened.</li>
+	 * <li>{@link #LOW_LATENCY_INTER_BYTE_TIMEOUT}: In {@link #TIMEOUT_READ_SEMI_BLOCKING} mode, a read call will return as soon as the line has been idle for
+	 *     <i>interByteTimeoutMS</i> after at least one byte has been received, allowing a complete frame to be returned by a single read. The inter-byte
+	 *     timeout has millisecond granularity, and any configured read timeout still bounds the total duration of the call.</li>
+	 * </ul>
+	 * <p>
+	 * The returned value is a bitmask of the settings listed above that were verified to be in effect, allowing applications to detect permission problems
+	 * or unsupported drivers. If the port is not yet open, the settings will be applied when it is opened, and the result can be retrieved using
+	 * {@link #getLowLatencyModeStatus()}.
+	 *
+	 * @param enabled Whether low-latency mode should be enabled or disabled.
+	 * @param interByteTimeoutMS The number of milliseconds of line inactivity after which a semi-blocking read returns, or 0 to disable.
+	 * @return A bitmask of the low-latency settings that were actually applied (only meaningful after the port is already opened).
+	 */
+	public final synchronized int setLowLatencyMode(boolean enabled, int interByteTimeoutMS)
+	{
+		lowLatencyMode = enabled;
+		lowLatencyConfigured = true;
+		interByteTimeout = (interByteTimeoutMS > 0) ? interByteTimeoutMS : 0;
+
+		if (portHandle != 0)
+		{
+			lowLatencySettings = applyLowLatencyMode();
+			return lowLatencySettings;
+		}
+		return 0;
+	}
+
+	/**
+	 * Returns the bitmask of low-latency settings that were actually applied by the most recent call to {@link #setLowLatencyMode(boolean, int)}
+	 * or by opening the port with an explicit low-latency configuration.
+	 *
+	 * @return A bitmask consisting of {@link #LOW_LATENCY_DRIVER_FLAG}, {@link #LOW_LATENCY_DEVICE_TIMER}, and {@link #LOW_LATENCY_INTER_BYTE_TIMEOUT}.
+	 */
+	public final int getLowLatencyModeStatus() { return lowLatencySettings; }
+
+	/**
+	 * Requests that this serial port be accessed directly through the FTDI D2XX driver instead of the standard virtual COM port driver (Windows only).
+	 * <p>
+	 * When enabled, the next call to {@link #openPort()} will attempt to open the underlying FTDI device through <i>ftd2xx.dll</i>, bypassing the virtual
+	 * COM port layer entirely. This allows the USB transfer size to be tuned and the device latency timer to be reduced without editing the registry or
+	 * requiring elevated permissions. If the D2XX library is not installed or the port does not belong to an FTDI device, the port will silently be opened
+	 * using the standard driver instead, and {@link #isFtdiDirectModeActive()} can be used to determine which path was taken.
+	 * <p>
+	 * Driver-controlled RS-485 mode, asynchronous read and write operations, and the shared event engine are not available while the D2XX driver owns
+	 * the port, although RS-485 mode can still be used with {@link #setRs485SoftwareDirectionControl(boolean)}. Event-based listeners remain fully
+	 * functional using a dedicated listening thread.
+	 * <p>
+	 * This setting has no effect on non-Windows systems, and it only takes effect the next time the port is opened.
+	 *
+	 * @param enabled Whether direct D2XX access should be attempted when the port is opened.
+	 * @param usbTransferSize The desired USB transfer size in bytes (rounded up to a multiple of 64 between 64 and 65536), or 0 to use the driver default.
+	 * @return Whether direct D2XX access is supported on this system.
+	 */
+	public final synchronized boolean setFtdiDirectMode(boolean enabled, int usbTransferSize)
+	{
+		ftdiDirectMode = enabled && isWindows;
+		ftdiTransferSize = (usbTransferSize <= 0) ? 0 : ((Math.min(usbTransferSize, 65536) + 63) & ~63);
+		return isWindows;
+	}
+
+	/**
+	 * Returns whether this serial port is currently being accessed directly through the FTDI D2XX driver.
+	 *
+	 * @return Whether the port is open and owned by the FTDI D2XX driver.
+	 * @see #setFtdiDirectMode(boolean, int)
+	 */
+	public final boolean isFtdiDirectModeActive()
+	{
+		long nativeHandle = portHandle;
+		return (nativeHandle != 0) && getFtdiDirectMode(nativeHandle);
+	}
+
+	/**
+	 * Sets the CPU affinity and real-time scheduling priority of all background threads created for this serial port.
+	 * <p>
+	 * These settings apply to the native threads used for event monitoring, background reading, and transmit queueing, as well as to the
+	 * dedicated event listener thread. They take effect the next time the port is opened or an event listener is started.
+	 * <p>
+	 * On Linux, the affinity is applied using <i>sched_setaffinity</i>, and the priority selects the <i>SCHED_FIFO</i> (or <i>SCHED_RR</i>)
+	 * policy, which usually requires the <i>CAP_SYS_NICE</i> capability or an appropriate <i>RLIMIT_RTPRIO</i> limit. On Windows, any
+	 * non-zero priority raises the threads to <i>THREAD_PRIORITY_TIME_CRITICAL</i> and registers them with the Multimedia Class Scheduler
+	 * Service as "Pro Audio" tasks. On other systems, only the priority is supported. Settings which could not be applied are reported by
+	 * {@link #getThreadSchedulingStatus()} rather than causing the port to fail to open.
+	 *
+	 * @param cpuAffinityMask A bitmask of the CPUs on which the threads may run (bit 0 corresponds to CPU 0), or 0 to leave the affinity unchanged.
+	 * @param realTimePriority The desired real-time priority between 1 and 99, or 0 to leave the priority unchanged.
+	 * @param roundRobin Whether to use round-robin instead of first-in-first-out real-time scheduling (Linux only).
+	 * @see #setEngineThreadScheduling(long, int, boolean)
+	 */
+	public final synchronized void setThreadScheduling(long cpuAffinityMask, int realTimePriority, boolean roundRobin)
+	{
+		threadAffinityMask = cpuAffinityMask;
+		threadPriority = Math.max(realTimePriority, 0);
+		threadRoundRobin = roundRobin;
+	}
+
+	/**
+	 * Returns the thread scheduling settings that were successfully applied to every background thread started for this serial port.
+	 *
+	 * @return A bitmask consisting of {@link #THREAD_SCHEDULING_AFFINITY}, {@link #THREAD_SCHEDULING_REAL_TIME}, and {@link #THREAD_SCHEDULING_MMCSS},
+	 *         or 0 if the port is not opened or none of its background threads has started yet.
+	 * @see #setThreadScheduling(long, int, boolean)
+	 */
+	public final int getThreadSchedulingStatus()
+	{
+		long nativeHandle = portHandle;
+		int appliedSettings = (nativeHandle != 0) ? (getThreadSchedulingStatus(nativeHandle) & listenerThreadSchedulingStatus) : 0;
+		return (appliedSettings == -1) ? 0 : appliedSettings;
+	}
+
+	// Applies the currently requested low-latency configuration to an open port
+	private int applyLowLatencyMode()
+	{
+		int appliedSettings = configLowLatency(portHandle, lowLatencyMode);
+		boolean timeoutsApplied = configTimeouts(portHandle, timeoutMode, readTimeout, writeTimeout, eventFlags);
+		if (timeoutsApplied && (interByteTimeout > 0) && ((timeoutMode & TIMEOUT_READ_SEMI_BLOCKING) > 0) && ((eventFlags & LISTENING_EVENT_DATA_RECEIVED) == 0))
+			appliedSettings |= LOW_LATENCY_INTER_BYTE_TIMEOUT;
+		return appliedSettings;
+	}
+
 	/**
 	 * Sets the desired baud rate for this serial port.
 	 * <p>
@@ -1341,6 +2530,20 @@ public final class SerialPort
 		return true;
 	}
 
+	/**
+	 * Changes the baud rate of this serial port without reapplying any other settings.
+	 * <p>
+	 * This method is equivalent to calling {@link #setComPortParametersFast(int, int, int, int)} with the current number of data bits,
+	 * stop bits, and parity. No safety sleep is performed, making it suitable for switching baud rates in the middle of a session.
+	 * <p>
+	 * <i>Note that on macOS and other systems without an atomic custom baud rate interface, a non-standard baud rate takes effect through
+	 * a second driver call, so see {@link #setComPortParametersFast(int, int, int, int)} for when the change is atomic.</i>
+	 *
+	 * @param newBaudRate The desired baud rate for this serial port.
+	 * @return Whether the new baud rate was successfully applied (only meaningful after the port is already opened).
+	 */
+	public final synchronized boolean setBaudRateFast(int newBaudRate) { return setComPortParametersFast(newBaudRate, dataBits, stopBits, parity); }
+
 	/**
 	 * Sets the desired number of data bits per word.
 	 * <p>
@@ -1490,7 +2693,9 @@ public final class SerialPort
 	 * may not work with all RS-485 devices. On the other hand there are devices that operate in RS-485 mode by
 	 * default and do not require explicit configuration (like some USB to RS-485 adapters).
 	 * <p>
-	 * Please note that the parameters beyond <i>useRS485Mode</i> are only effective on Linux.
+	 * Please note that the parameters beyond <i>useRS485Mode</i> are only effective on Linux, unless software direction control has been enabled using
+	 * {@link #setRs485SoftwareDirectionControl(boolean)}, in which case the RTS polarity, receive-during-transmit, and delay parameters are honored on
+	 * all systems.
 	 * <p>
 	 * The RTS "active high" parameter specifies that the logical level of the RTS line will be set to 1 when transmitting and
 	 * 0 when receiving.
@@ -1524,6 +2729,40 @@ public final class SerialPort
 		return true;
 	}
 
+	/**
+	 * Sets whether RS-485 transmit/receive direction switching should be carried out by this library instead of by the device driver.
+	 * <p>
+	 * This mode is intended for devices whose drivers cannot toggle the RTS line around transmissions by themselves, such as many USB-to-serial adapters
+	 * and embedded UARTs on Linux, or any device on Windows whose driver does not implement automatic RTS toggling. It only takes effect while RS-485 mode
+	 * is enabled using {@link #setRs485ModeParameters(boolean, boolean, boolean, boolean, int, int)}, and it replaces any driver-based RS-485 support.
+	 * <p>
+	 * When enabled, every write asserts the RTS line, waits for the configured "delay before send" time, transmits the data, waits until the device
+	 * reports that its transmitter is empty, waits for the configured "delay after send" time, and then releases the RTS line. All of this happens in
+	 * native code using a high-resolution monotonic clock, which typically switches the bus back into receive mode within microseconds of the last bit
+	 * being sent. On Linux, the UART line status register is polled when the driver exposes it; otherwise, and on all other systems, the end of each
+	 * transmission is determined from the driver's transmit queue together with the configured baud rate and word framing. Any data received while
+	 * transmitting is discarded unless receiving during transmission was requested. The achieved turnaround times are reported in the
+	 * {@link SerialPortStatistics} returned by {@link #getStatistics()}.
+	 * <p>
+	 * Note that every write call will block until its data has physically been transmitted, regardless of the current write timeout mode, and that
+	 * asynchronous writes are not available while software direction control is active. Software direction control is not applied to virtual ports.
+	 *
+	 * @param useSoftwareControl Whether RS-485 direction switching should be carried out by this library.
+	 * @return Whether the port configuration is valid or disallowed on this system (only meaningful after the port is already opened).
+	 */
+	public final synchronized boolean setRs485SoftwareDirectionControl(boolean useSoftwareControl)
+	{
+		rs485SoftwareControl = useSoftwareControl;
+
+		if (portHandle != 0)
+		{
+			if (safetySleepTimeMS > 0)
+				try { Thread.sleep(safetySleepTimeMS); } catch (Exception e) { Thread.currentThread().interrupt(); }
+			return configPort(portHandle);
+		}
+		return true;
+	}
+
 	/**
 	 * Sets custom XON/XOFF flow control characters for the device.
 	 * <p>
@@ -1565,7 +2804,17 @@ public final class SerialPort
 	 *
 	 * @return The system-defined device name of this serial port.
 	 */
-	public final String getSystemPortName() { return (isWindows ? comPort.substring(comPort.lastIndexOf('\\')+1) : comPort.substring(comPort.lastIndexOf('/')+1)); }
+	public final String getSystemPortName()
+	{
+		if (comPort.startsWith(virtualLoopbackPrefix))
+			return comPort.substring(virtualLoopbackPrefix.length());
+		else if (comPort.startsWith(virtualReplayPrefix))
+		{
+			String name = comPort.substring(virtualReplayPrefix.length());
+			return (name.indexOf(':') >= 0) ? name.substring(0, name.indexOf(':')) : name;
+		}
+		return (isWindows ? comPort.substring(comPort.lastIndexOf('\\')+1) : comPort.substring(comPort.lastIndexOf('/')+1));
+	}
 
 	/**
 	 * Gets the operating system-defined device path corresponding to this serial port. The path will be unique,
@@ -1671,7 +2920,7 @@ public final class SerialPort
 	 * Any value other than 0 indicates the number of milliseconds of inactivity that will be tolerated before the {@link #writeBytes(byte[],long)}
 	 * call will return.
 	 * <p>
-	 * Note that write timeouts are only available on Windows operating systems. This value is ignored on all other systems.
+	 * On non-Windows systems, the write timeout bounds the time spent waiting for the driver to accept data and to drain in write-blocking mode.
 	 *
 	 * @return The number of milliseconds of inactivity to tolerate before returning from a {@link #writeBytes(byte[],long)} call.
 	 */
@@ -1708,17 +2957,29 @@ public final class SerialPort
 	public final int getFlowControlSettings() { return flowControl; }
 
 	// Private EventListener class
-	private final class SerialPortEventListener
+	private final class SerialPortEventListener implements Runnable
 	{
-		private final boolean messageEndIsDelimited;
+		private final boolean messageEndIsDelimited, recycleEventBuffers;
 		private final byte[] dataPacket, delimiters;
-		private volatile ByteArrayOutputStream messageBytes = new ByteArrayOutputStream();
-		private volatile int dataPacketIndex = 0, delimiterIndex = 0;
-		private Thread serialEventThread = null;
-
-		public SerialPortEventListener() { dataPacket = new byte[0]; delimiters = new byte[0]; messageEndIsDelimited = true; }
-		public SerialPortEventListener(int packetSizeToReceive) { dataPacket = new byte[packetSizeToReceive]; delimiters = new byte[0]; messageEndIsDelimited = true; }
-		public SerialPortEventListener(byte[] messageDelimiters, boolean delimiterForMessageEnd) { dataPacket = new byte[0]; delimiters = messageDelimiters; messageEndIsDelimited = delimiterForMessageEnd; }
+		private final int[] frameState;
+		private final int maximumFrameLength;
+		private byte[] frameBuffer = new byte[0];
+		private final SerialPortEvent recycledEvent = new SerialPortEvent(SerialPort.this, LISTENING_EVENT_TIMED_OUT);
+		private byte[] readBuffer = new byte[0], messageBuffer = new byte[0];
+		private int[] messageBoundaries = new int[0];
+		private final int[] delimiterState = new int[1];
+		private volatile int dataPacketIndex = 0, messageLength = 0;
+		private long messageTimestamp = 0;
+		private int pendingEngineEvents = 0;
+		private volatile long engineRegisteredHandle = 0;
+		private volatile SerialPortEventEngine registeredEngine = null;
+		private Thread serialEventThread = null, engineDispatchThread = null;
+		private boolean engineDispatchScheduled = false;
+
+		public SerialPortEventListener(boolean recycleBuffers) { dataPacket = new byte[0]; delimiters = new byte[0]; messageEndIsDelimited = true; recycleEventBuffers = recycleBuffers; frameState = null; maximumFrameLength = 0; }
+		public SerialPortEventListener(int packetSizeToReceive, boolean recycleBuffers) { dataPacket = new byte[packetSizeToReceive]; delimiters = new byte[0]; messageEndIsDelimited = true; recycleEventBuffers = recycleBuffers; frameState = null; maximumFrameLength = 0; }
+		public SerialPortEventListener(byte[] messageDelimiters, boolean delimiterForMessageEnd, boolean recycleBuffers) { dataPacket = new byte[0]; delimiters = messageDelimiters; messageEndIsDelimited = delimiterForMessageEnd; recycleEventBuffers = recycleBuffers; frameState = null; maximumFrameLength = 0; }
+		public SerialPortEventListener(SerialPortFrameDecoder frameDecoder, boolean recycleBuffers) { dataPacket = new byte[0]; delimiters = new byte[0]; messageEndIsDelimited = true; recycleEventBuffers = recycleBuffers; frameState = frameDecoder.createState(); maximumFrameLength = frameDecoder.getMaximumFrameLength(); }
 
 		public final void startListening()
 		{
@@ -1728,22 +2989,31 @@ public final class SerialPort
 
 			dataPacketIndex = 0;
 			setEventListeningStatus(portHandle, true);
+
+			// Attempt to use the shared event engine before falling back to a dedicated thread
+			SerialPortEventEngine engine = eventEngine;
+			int modemLineEvents = LISTENING_EVENT_CARRIER_DETECT | LISTENING_EVENT_CTS | LISTENING_EVENT_DSR | LISTENING_EVENT_RING_INDICATOR;
+			if ((engine != null) && (isWindows || (((eventFlags & modemLineEvents) == 0) && (backgroundReadBufferSize == 0))))
+			{
+				registeredEngine = engine;
+				engineRegisteredHandle = portHandle;
+				if (engine.register(SerialPort.this, portHandle))
+					return;
+				engineRegisteredHandle = 0;
+				registeredEngine = null;
+			}
+			listenerThreadSchedulingStatus = -1;
 			serialEventThread = new Thread(new Runnable()
 			{
 				@Override
 				public void run()
 				{
+					if ((threadAffinityMask != 0) || (threadPriority > 0))
+						listenerThreadSchedulingStatus = setCurrentThreadScheduling(threadAffinityMask, threadPriority, threadRoundRobin);
 					while (eventListenerRunning)
 					{
 						try { waitForSerialEvent(); }
-						catch (Exception e)
-						{
-							eventListenerRunning = false;
-							if (userDataListener instanceof SerialPortDataListenerWithExceptions)
-								((SerialPortDataListenerWithExceptions)userDataListener).catchException(e);
-							else if (userDataListener instanceof SerialPortMessageListenerWithExceptions)
-								((SerialPortMessageListenerWithExceptions)userDataListener).catchException(e);
-						}
+						catch (Exception e) { handleListenerException(e); }
 					}
 				}
 			});
@@ -1754,10 +3024,35 @@ public final class SerialPort
 		{
 			if (!eventListenerRunning)
 				return;
-			eventListenerRunning = false;
+
+			// Unregister while holding the listener lock so that an in-progress dispatch cannot re-arm the port afterward
+			boolean engineWasRegistered;
+			synchronized (this)
+			{
+				eventListenerRunning = false;
+				engineWasRegistered = (engineRegisteredHandle != 0);
+				if (engineWasRegistered)
+					registeredEngine.unregister(engineRegisteredHandle);
+				engineRegisteredHandle = 0;
+			}
 			configTimeouts(portHandle, TIMEOUT_NONBLOCKING, 0, 0, 0);
 			setEventListeningStatus(portHandle, false);
-			
+
+			// Wait for any in-progress event engine dispatch to complete
+			if (engineWasRegistered)
+			{
+				synchronized (this)
+				{
+					try
+					{
+						while (engineDispatchScheduled && (engineDispatchThread != Thread.currentThread()))
+							wait();
+					}
+					catch (InterruptedException e) { Thread.currentThread().interrupt(); }
+				}
+				return;
+			}
+
 			try
 			{
 				serialEventThread.join(500);
@@ -1769,67 +3064,524 @@ public final class SerialPort
 			serialEventThread = null;
 		}
 
-		public final void waitForSerialEvent() throws Exception
+		public final void queueEngineEvent(int event)
+		{
+			// Immediately re-arm the port if the engine woke up without any reportable events
+			if (event == 0)
+			{
+				rearmEngine();
+				return;
+			}
+
+			// Merge the event into any pending events and schedule a dispatch if one is not already underway
+			SerialPortEventEngine engine;
+			synchronized (this)
+			{
+				engine = registeredEngine;
+				pendingEngineEvents |= event;
+				if (engineDispatchScheduled || !eventListenerRunning || (engine == null))
+					return;
+				engineDispatchScheduled = true;
+			}
+			engine.dispatch(this);
+		}
+
+		private final synchronized void rearmEngine()
+		{
+			// Only re-arm a port that is still listening and registered, since the engine must never re-register a removed port
+			if (eventListenerRunning && (engineRegisteredHandle != 0) && (registeredEngine != null))
+				registeredEngine.rearm(engineRegisteredHandle);
+		}
+
+		@Override
+		public final void run()
+		{
+			// Deliver all pending event engine events for this port in order
+			while (true)
+			{
+				int event;
+				synchronized (this)
+				{
+					event = pendingEngineEvents;
+					pendingEngineEvents = 0;
+					if ((event == 0) || !eventListenerRunning)
+					{
+						engineDispatchScheduled = false;
+						engineDispatchThread = null;
+						notifyAll();
+						return;
+					}
+					engineDispatchThread = Thread.currentThread();
+				}
+				try { processSerialEvent(event & eventFlags); }
+				catch (Exception e) { handleListenerException(e); }
+
+				// Re-arm the port unless it has been disconnected or is no longer listening
+				if ((event & LISTENING_EVENT_PORT_DISCONNECTED) == 0)
+					rearmEngine();
+			}
+		}
+
+		private final void handleListenerException(Exception e)
+		{
+			eventListenerRunning = false;
+			if (userDataListener instanceof SerialPortDataListenerWithExceptions)
+				((SerialPortDataListenerWithExceptions)userDataListener).catchException(e);
+			else if (userDataListener instanceof SerialPortMessageListenerWithExceptions)
+				((SerialPortMessageListenerWithExceptions)userDataListener).catchException(e);
+		}
+
+		public final void waitForSerialEvent() throws Exception { processSerialEvent(waitForEvent(portHandle) & eventFlags); }
+
+		private final void processSerialEvent(int event) throws Exception
 		{
-			int event = waitForEvent(portHandle) & eventFlags;
+			// Data read in direct response to an event is stamped with the native event detection time, while any further reads use their own native read times
+			long eventTimestamp = getReceiveTimestamp(portHandle, true);
 			if (((event & LISTENING_EVENT_DATA_AVAILABLE) > 0) && ((eventFlags & LISTENING_EVENT_DATA_RECEIVED) > 0))
 			{
 				// Read data from serial port
 				int numBytesAvailable, bytesRemaining, newBytesIndex;
+				long dataTimestamp = eventTimestamp;
 				event &= ~(LISTENING_EVENT_DATA_AVAILABLE | LISTENING_EVENT_DATA_RECEIVED);
 				while (eventListenerRunning && ((numBytesAvailable = bytesAvailable(portHandle)) > 0))
 				{
+					if (frameState != null)
+					{
+						decodeFrames(numBytesAvailable, dataTimestamp);
+						dataTimestamp = -1;
+						continue;
+					}
 					newBytesIndex = 0;
-					byte[] newBytes = new byte[numBytesAvailable];
-					bytesRemaining = readBytes(portHandle, newBytes, newBytes.length, 0, timeoutMode, readTimeout);
+					if (numBytesAvailable > readBuffer.length)
+						readBuffer = new byte[numBytesAvailable];
+					bytesRemaining = readBytes(portHandle, readBuffer, numBytesAvailable, 0, timeoutMode, readTimeout);
 					if (bytesRemaining > 0)
 					{
+						if (dataTimestamp < 0)
+							dataTimestamp = getReceiveTimestamp(portHandle, false);
 						if (delimiters.length > 0)
 						{
-							int startIndex = 0;
-							for (int offset = 0; offset < bytesRemaining; ++offset)
-								if (newBytes[offset] == delimiters[delimiterIndex])
-								{
-									if ((++delimiterIndex) == delimiters.length)
-									{
-										messageBytes.write(newBytes, startIndex, 1 + offset - startIndex);
-										byte[] byteArray = (messageEndIsDelimited ? messageBytes.toByteArray() : Arrays.copyOf(messageBytes.toByteArray(), messageBytes.size() - delimiters.length));
-										if ((byteArray.length > 0) && (messageEndIsDelimited || (delimiters[0] == byteArray[0])))
-											userDataListener.serialEvent(new SerialPortEvent(SerialPort.this, LISTENING_EVENT_DATA_RECEIVED, byteArray));
-										startIndex = offset + 1;
-										messageBytes.reset();
-										delimiterIndex = 0;
-										if (!messageEndIsDelimited)
-											messageBytes.write(delimiters, 0, delimiters.length);
-									}
-								}
-								else if (delimiterIndex != 0)
-									delimiterIndex = (newBytes[offset] == delimiters[0]) ? 1 : 0;
-							messageBytes.write(newBytes, startIndex, bytesRemaining - startIndex);
+							// Locate all message boundaries within the newly read chunk in a single native pass
+							if (messageBoundaries.length < (bytesRemaining + 1))
+								messageBoundaries = new int[readBuffer.length + 1];
+							int startIndex = 0, numBoundaries = findMessageBoundaries(readBuffer, bytesRemaining, delimiters, delimiterState, messageBoundaries);
+							if (messageLength == 0)
+								messageTimestamp = dataTimestamp;
+							for (int i = 0; i < numBoundaries; ++i)
+							{
+								appendToMessage(readBuffer, startIndex, messageBoundaries[i] - startIndex);
+								int messageSize = messageEndIsDelimited ? messageLength : (messageLength - delimiters.length);
+								if ((messageSize > 0) && (messageEndIsDelimited || (delimiters[0] == messageBuffer[0])))
+									dispatchEvent(LISTENING_EVENT_DATA_RECEIVED, messageBuffer, messageSize, messageTimestamp);
+								startIndex = messageBoundaries[i];
+								messageTimestamp = dataTimestamp;
+								messageLength = 0;
+								if (!messageEndIsDelimited)
+									appendToMessage(delimiters, 0, delimiters.length);
+							}
+							appendToMessage(readBuffer, startIndex, bytesRemaining - startIndex);
 						}
 						else if (dataPacket.length == 0)
-							userDataListener.serialEvent(new SerialPortEvent(SerialPort.this, LISTENING_EVENT_DATA_RECEIVED, newBytes.clone()));
+							dispatchEvent(LISTENING_EVENT_DATA_RECEIVED, readBuffer, bytesRemaining, dataTimestamp);
 						else
 						{
+							if (dataPacketIndex == 0)
+								messageTimestamp = dataTimestamp;
 							while (bytesRemaining >= (dataPacket.length - dataPacketIndex))
 							{
-								System.arraycopy(newBytes, newBytesIndex, dataPacket, dataPacketIndex, dataPacket.length - dataPacketIndex);
+								System.arraycopy(readBuffer, newBytesIndex, dataPacket, dataPacketIndex, dataPacket.length - dataPacketIndex);
 								bytesRemaining -= (dataPacket.length - dataPacketIndex);
 								newBytesIndex += (dataPacket.length - dataPacketIndex);
 								dataPacketIndex = 0;
-								userDataListener.serialEvent(new SerialPortEvent(SerialPort.this, LISTENING_EVENT_DATA_RECEIVED, dataPacket.clone()));
+								dispatchEvent(LISTENING_EVENT_DATA_RECEIVED, dataPacket, dataPacket.length, messageTimestamp);
+								messageTimestamp = dataTimestamp;
 							}
 							if (bytesRemaining > 0)
 							{
-								System.arraycopy(newBytes, newBytesIndex, dataPacket, dataPacketIndex, bytesRemaining);
+								System.arraycopy(readBuffer, newBytesIndex, dataPacket, dataPacketIndex, bytesRemaining);
 								dataPacketIndex += bytesRemaining;
 							}
 						}
 					}
+					dataTimestamp = -1;
 				}
 			}
 			if (event != LISTENING_EVENT_TIMED_OUT)
-				userDataListener.serialEvent(new SerialPortEvent(SerialPort.this, event));
+				dispatchEvent(event, null, 0, eventTimestamp);
+		}
+
+		private final void decodeFrames(int numBytesAvailable, long dataTimestamp)
+		{
+			// Ensure that the decoded frame buffer can hold any partial frame plus all newly read bytes, since decoding never expands the data
+			if ((maximumFrameLength + numBytesAvailable) > frameBuffer.length)
+				frameBuffer = Arrays.copyOf(frameBuffer, maximumFrameLength + numBytesAvailable);
+			if (messageBoundaries.length < (numBytesAvailable + 1))
+				messageBoundaries = new int[numBytesAvailable + 1];
+
+			// Read and decode all available bytes natively, then deliver each completed frame exactly once
+			boolean frameInProgress = (frameState[SerialPortFrameDecoder.STATE_FRAME_LENGTH] > 0);
+			int startIndex = 0, numFrames = readFrames(portHandle, numBytesAvailable, timeoutMode, readTimeout, frameState, frameBuffer, messageBoundaries);
+			if ((numFrames > 0) && (dataTimestamp < 0))
+				dataTimestamp = getReceiveTimestamp(portHandle, false);
+			for (int i = 0; i < numFrames; ++i)
+			{
+				// A frame that was already underway before this read keeps the timestamp of the read in which it started
+				int frameSize = messageBoundaries[i] - startIndex;
+				long frameTimestamp = ((i == 0) && frameInProgress) ? messageTimestamp : dataTimestamp;
+				if (startIndex == 0)
+					dispatchEvent(LISTENING_EVENT_DATA_RECEIVED, frameBuffer, frameSize, frameTimestamp);
+				else if (recycleEventBuffers)
+				{
+					messageLength = 0;
+					appendToMessage(frameBuffer, startIndex, frameSize);
+					dispatchEvent(LISTENING_EVENT_DATA_RECEIVED, messageBuffer, frameSize, frameTimestamp);
+				}
+				else
+					userDataListener.serialEvent(new SerialPortEvent(SerialPort.this, LISTENING_EVENT_DATA_RECEIVED, Arrays.copyOfRange(frameBuffer, startIndex, messageBoundaries[i]), frameTimestamp));
+				startIndex = messageBoundaries[i];
+			}
+
+			// Move any remaining partial frame to the start of the buffer and remember when it started
+			int partialFrameLength = frameState[SerialPortFrameDecoder.STATE_FRAME_LENGTH];
+			if ((partialFrameLength > 0) && ((numFrames > 0) || !frameInProgress))
+				messageTimestamp = (dataTimestamp < 0) ? getReceiveTimestamp(portHandle, false) : dataTimestamp;
+			if ((startIndex > 0) && (partialFrameLength > 0))
+				System.arraycopy(frameBuffer, startIndex, frameBuffer, 0, partialFrameLength);
+		}
+
+		private final void appendToMessage(byte[] data, int offset, int length)
+		{
+			// Grow the message buffer geometrically so that its allocations are amortized away
+			if ((messageLength + length) > messageBuffer.length)
+				messageBuffer = Arrays.copyOf(messageBuffer, Math.max(messageLength + length, 2 * messageBuffer.length));
+			System.arraycopy(data, offset, messageBuffer, messageLength, length);
+			messageLength += length;
+		}
+
+		private final void dispatchEvent(int eventType, byte[] data, int dataLength, long timestamp)
+		{
+			// Only hand out internal buffers when the listener has agreed not to retain them
+			if (recycleEventBuffers)
+				userDataListener.serialEvent(recycledEvent.recycle(eventType, data, dataLength, timestamp));
+			else
+				userDataListener.serialEvent(new SerialPortEvent(SerialPort.this, eventType, (data == null) ? null : Arrays.copyOf(data, dataLength), timestamp));
+		}
+	}
+
+	// Shared multi-port event engine class
+	private static final class SerialPortEventEngine implements Runnable
+	{
+		private final long engineHandle;
+		private final long[] readyPortHandles = new long[64];
+		private final int[] readyEvents = new int[64];
+		private final HashMap<Long, SerialPort> registeredPorts = new HashMap<Long, SerialPort>();
+		private final ExecutorService workerPool;
+
+		public SerialPortEventEngine(long nativeEngineHandle, int numWorkerThreads)
+		{
+			engineHandle = nativeEngineHandle;
+			workerPool = Executors.newFixedThreadPool(numWorkerThreads, new ThreadFactory()
+			{
+				@Override
+				public Thread newThread(final Runnable runnable)
+				{
+					Thread workerThread = new Thread(new Runnable()
+					{
+						@Override
+						public void run()
+						{
+							applyEngineThreadScheduling();
+							runnable.run();
+						}
+					}, "jSerialComm Event Engine Worker");
+					workerThread.setDaemon(true);
+					return workerThread;
+				}
+			});
+			Thread engineThread = new Thread(this, "jSerialComm Event Engine");
+			engineThread.setDaemon(true);
+			engineThread.start();
+		}
+
+		public final boolean register(SerialPort port, long portHandle)
+		{
+			synchronized (registeredPorts) { registeredPorts.put(portHandle, port); }
+			if (addToEventEngine(engineHandle, portHandle, false))
+				return true;
+			synchronized (registeredPorts) { registeredPorts.remove(portHandle); }
+			return false;
+		}
+
+		public final void unregister(long portHandle)
+		{
+			synchronized (registeredPorts) { registeredPorts.remove(portHandle); }
+			removeFromEventEngine(engineHandle, portHandle);
+		}
+
+		public final boolean rearm(long portHandle) { return addToEventEngine(engineHandle, portHandle, true); }
+
+		public final void dispatch(SerialPortEventListener listener) { workerPool.execute(listener); }
+
+		@Override
+		public final void run()
+		{
+			applyEngineThreadScheduling();
+
+			// Continuously hand off port events to the corresponding listeners
+			while (true)
+			{
+				int numReady = waitForEventEngine(engineHandle, readyPortHandles, readyEvents, 1000);
+				for (int i = 0; i < numReady; ++i)
+				{
+					SerialPort port;
+					synchronized (registeredPorts) { port = registeredPorts.get(readyPortHandles[i]); }
+					SerialPortEventListener listener = (port != null) ? port.serialEventListener : null;
+					if (listener != null)
+						listener.queueEngineEvent(readyEvents[i]);
+				}
+				if (numReady < 0)
+					try { Thread.sleep(100); } catch (InterruptedException e) { return; }
+			}
+		}
+	}
+
+	// Shared asynchronous I/O engine class
+	private static final class SerialPortAsyncEngine implements Runnable
+	{
+		private final long engineHandle;
+		private final Thread engineThread;
+		private final long[] completedOperations = new long[64];
+		private final int[] completedResults = new int[64];
+		private final ConcurrentLinkedQueue<SerialPortFuture> pendingRequests = new ConcurrentLinkedQueue<SerialPortFuture>();
+		private final HashMap<Long, SerialPortFuture> activeOperations = new HashMap<Long, SerialPortFuture>();
+		private final LinkedList<SerialPortFuture> completedOperationFutures = new LinkedList<SerialPortFuture>();
+
+		public SerialPortAsyncEngine(long nativeEngineHandle)
+		{
+			engineHandle = nativeEngineHandle;
+			engineThread = new Thread(this, "jSerialComm Async I/O Engine");
+			engineThread.setDaemon(true);
+			engineThread.start();
+		}
+
+		public final void submit(SerialPortFuture future)
+		{
+			// Queue a new operation or cancellation request for the engine thread
+			pendingRequests.add(future);
+			wakeAsyncEngine(engineHandle);
+		}
+
+		public final void cancelAll(SerialPort port)
+		{
+			// Prevent any new operations from starting and cancel all outstanding ones
+			synchronized (port.asyncOperations)
+			{
+				port.asyncOperationsClosing = true;
+				for (SerialPortFuture future : new ArrayList<SerialPortFuture>(port.asyncOperations))
+					future.cancel(true);
+			}
+
+			// Wait until the native engine has released all operations on the port, driving the engine directly if called from a completion listener
+			if (Thread.currentThread() == engineThread)
+				while (port.numActiveAsyncOperations > 0)
+					processOperations();
+			else
+				synchronized (port.asyncOperations)
+				{
+					while (port.numActiveAsyncOperations > 0)
+						try { port.asyncOperations.wait(); } catch (InterruptedException e) { Thread.currentThread().interrupt(); break; }
+				}
+		}
+
+		private final void startNextOperation(SerialPort port, LinkedList<SerialPortFuture> queue)
+		{
+			// Start the operation at the head of the queue unless one is already in progress
+			while (!queue.isEmpty() && (queue.peek().operationHandle == 0))
+			{
+				SerialPortFuture future = queue.peek();
+				ByteBuffer buffer = future.buffer;
+				long operationHandle = 0;
+				synchronized (port.asyncOperations)
+				{
+					if (!future.isCancelled() && !port.asyncOperationsClosing && (port.portHandle != 0))
+					{
+						future.offset = buffer.isDirect() ? buffer.position() : (buffer.arrayOffset() + buffer.position());
+						operationHandle = startAsyncIO(engineHandle, port.portHandle, future.isWrite, buffer.isDirect() ? buffer : null,
+								buffer.isDirect() ? null : buffer.array(), future.offset, buffer.remaining());
+						if (operationHandle != 0)
+							++port.numActiveAsyncOperations;
+					}
+					if (operationHandle == 0)
+						port.asyncOperations.remove(future);
+				}
+
+				// Track the new operation or fail it immediately
+				if (operationHandle != 0)
+				{
+					future.operationHandle = operationHandle;
+					future.deadline = (future.timeoutMS > 0) ? (System.nanoTime() + (future.timeoutMS * 1000000L)) : 0;
+					activeOperations.put(operationHandle, future);
+				}
+				else
+				{
+					queue.poll();
+					if (future.complete(-1))
+						completedOperationFutures.add(future);
+				}
+			}
+		}
+
+		private final void finishOperation(long operationHandle)
+		{
+			// Copy any read data into the caller's buffer unless the operation was cancelled
+			SerialPortFuture future = activeOperations.remove(operationHandle);
+			if (future == null)
+				return;
+			future.operationHandle = 0;
+			synchronized (future)
+			{
+				ByteBuffer buffer = future.isCancelled() ? null : future.buffer;
+				int result = finishAsyncIO(operationHandle, ((buffer != null) && buffer.isDirect()) ? buffer : null,
+						((buffer != null) && !buffer.isDirect()) ? buffer.array() : null, future.offset);
+				if ((buffer != null) && (result > 0))
+					buffer.position(buffer.position() + result);
+				if (future.complete(result))
+					completedOperationFutures.add(future);
+			}
+
+			// Release the operation and start the next one queued on the port
+			SerialPort port = future.port;
+			synchronized (port.asyncOperations)
+			{
+				port.asyncOperations.remove(future);
+				--port.numActiveAsyncOperations;
+				port.asyncOperations.notifyAll();
+			}
+			LinkedList<SerialPortFuture> queue = future.isWrite ? port.asyncWriteQueue : port.asyncReadQueue;
+			queue.remove(future);
+			startNextOperation(port, queue);
+		}
+
+		private final void processOperations()
+		{
+			// Enqueue new operations and abort any that have been cancelled
+			SerialPortFuture request;
+			while ((request = pendingRequests.poll()) != null)
+				if (request.operationHandle != 0)
+				{
+					if (request.isCancelled())
+						cancelAsyncIO(engineHandle, request.operationHandle);
+				}
+				else
+				{
+					LinkedList<SerialPortFuture> queue = request.isWrite ? request.port.asyncWriteQueue : request.port.asyncReadQueue;
+					if (request.isCancelled())
+					{
+						queue.remove(request);
+						synchronized (request.port.asyncOperations) { request.port.asyncOperations.remove(request); }
+					}
+					else
+					{
+						queue.add(request);
+						startNextOperation(request.port, queue);
+					}
+				}
+
+			// Abort any reads whose timeouts have expired, waiting no longer than the nearest remaining deadline
+			long currentTime = System.nanoTime(), waitTimeNS = 1000000000L;
+			for (SerialPortFuture future : activeOperations.values())
+				if (future.deadline != 0)
+				{
+					long remainingNS = future.deadline - currentTime;
+					if (remainingNS <= 0)
+					{
+						future.deadline = 0;
+						cancelAsyncIO(engineHandle, future.operationHandle);
+					}
+					else if (remainingNS < waitTimeNS)
+						waitTimeNS = remainingNS;
+				}
+
+			// Wait for operations to complete, only notifying their listeners once all engine bookkeeping is done since a listener may re-enter the engine
+			int numCompleted = waitForAsyncIO(engineHandle, completedOperations, completedResults, (int)((waitTimeNS + 999999L) / 1000000L));
+			for (int i = 0; i < numCompleted; ++i)
+				finishOperation(completedOperations[i]);
+			SerialPortFuture completedFuture;
+			while ((completedFuture = completedOperationFutures.poll()) != null)
+				completedFuture.notifyListener();
+			if (numCompleted < 0)
+				try { Thread.sleep(100); } catch (InterruptedException e) { Thread.currentThread().interrupt(); }
+		}
+
+		@Override
+		public final void run()
+		{
+			applyEngineThreadScheduling();
+
+			// Continuously drive all asynchronous operations
+			while (true)
+				processOperations();
+		}
+	}
+
+	// Hotplug port monitoring class
+	private static final class SerialPortHotplugMonitor implements Runnable
+	{
+		private final CopyOnWriteArrayList<SerialPortHotplugListener> listeners = new CopyOnWriteArrayList<SerialPortHotplugListener>();
+		private HashMap<String, SerialPort> knownPorts = new HashMap<String, SerialPort>();
+		private volatile boolean isRunning = true;
+		private int portListGeneration;
+
+		public SerialPortHotplugMonitor()
+		{
+			// Take an initial snapshot of the port listing so that only subsequent changes are reported
+			portListGeneration = waitForPortListChange(0, 0);
+			for (SerialPort port : getCommPorts())
+				knownPorts.put(port.getSystemPortPath(), port);
+			Thread monitorThread = new Thread(this, "jSerialComm Hotplug Monitor");
+			monitorThread.setDaemon(true);
+			monitorThread.start();
+		}
+
+		public final void addListener(SerialPortHotplugListener listener) { listeners.addIfAbsent(listener); }
+
+		public final boolean removeListener(SerialPortHotplugListener listener)
+		{
+			listeners.remove(listener);
+			return listeners.isEmpty();
+		}
+
+		public final void stop() { isRunning = false; }
+
+		@Override
+		public final void run()
+		{
+			applyEngineThreadScheduling();
+			while (isRunning)
+			{
+				// Wait for the native port listing to change
+				int newGeneration = waitForPortListChange(portListGeneration, 1000);
+				if (!isRunning || (newGeneration == portListGeneration))
+					continue;
+				portListGeneration = newGeneration;
+
+				// Determine which ports were added, keeping the original objects for any ports that are still present
+				HashMap<String, SerialPort> currentPorts = new HashMap<String, SerialPort>();
+				for (SerialPort port : getCommPorts())
+				{
+					SerialPort knownPort = knownPorts.remove(port.getSystemPortPath());
+					currentPorts.put(port.getSystemPortPath(), (knownPort != null) ? knownPort : port);
+					if (knownPort == null)
+						for (SerialPortHotplugListener listener : listeners)
+							try { listener.serialPortAdded(port); } catch (Exception e) { e.printStackTrace(); }
+				}
+
+				// Any ports remaining in the previous listing have been removed
+				for (SerialPort port : knownPorts.values())
+					for (SerialPortHotplugListener listener : listeners)
+						try { listener.serialPortRemoved(port); } catch (Exception e) { e.printStackTrace(); }
+				knownPorts = currentPorts;
+			}
 		}
 	}
 
@@ -1837,19 +3589,34 @@ public final class SerialPort
 	private final class SerialPortInputStream extends InputStream
 	{
 		private final boolean timeoutExceptionsSuppressed;
-		private byte[] byteBuffer = new byte[1];
+		private byte[] byteBuffer = new byte[1], readAheadBuffer = null;
+		private int readAheadPosition = 0, readAheadLength = 0;
 
 		public SerialPortInputStream(boolean suppressReadTimeoutExceptions)
 		{
 			timeoutExceptionsSuppressed = suppressReadTimeoutExceptions;
 		}
 
+		// Returns the number of bytes in the read-ahead buffer, refilling it first if it is empty, or the result of the failed native read
+		private final int fillReadAhead(int bufferSize)
+		{
+			if (readAheadPosition < readAheadLength)
+				return readAheadLength - readAheadPosition;
+			if ((readAheadBuffer == null) || (readAheadBuffer.length != bufferSize))
+				readAheadBuffer = new byte[bufferSize];
+			readAheadPosition = 0;
+			int numRead = readBytesAhead(portHandle, readAheadBuffer, bufferSize, timeoutMode, readTimeout);
+			readAheadLength = (numRead > 0) ? numRead : 0;
+			return numRead;
+		}
+
 		@Override
 		public final int available() throws SerialPortIOException
 		{
 			if (portHandle == 0)
 				throw new SerialPortIOException("This port appears to have been shutdown or disconnected.");
-			return bytesAvailable(portHandle);
+			int numBytesAvailable = bytesAvailable(portHandle);
+			return (numBytesAvailable < 0) ? numBytesAvailable : (numBytesAvailable + readAheadLength - readAheadPosition);
 		}
 
 		@Override
@@ -1859,8 +3626,17 @@ public final class SerialPort
 			if (portHandle == 0)
 				throw new SerialPortIOException("This port appears to have been shutdown or disconnected.");
 
-			// Read from the serial port
-			int numRead = readBytes(portHandle, byteBuffer, 1L, 0, timeoutMode, readTimeout);
+			// Serve the read from the read-ahead buffer if it is enabled or still contains data
+			int numRead, readAheadSize = inputStreamReadAheadSize;
+			if ((readAheadPosition < readAheadLength) || (readAheadSize > 1))
+			{
+				if ((numRead = fillReadAhead(readAheadSize)) > 0)
+					return (int)readAheadBuffer[readAheadPosition++] & 0xFF;
+			}
+			else
+				numRead = readBytes(portHandle, byteBuffer, 1L, 0, timeoutMode, readTimeout);
+
+			// Handle any timeouts or errors
 			if (numRead == 0)
 			{
 				if (timeoutExceptionsSuppressed)
@@ -1877,16 +3653,7 @@ public final class SerialPort
 			// Perform error checking
 			if (b == null)
 				throw new NullPointerException("A null pointer was passed in for the read buffer.");
-			if (portHandle == 0)
-				throw new SerialPortIOException("This port appears to have been shutdown or disconnected.");
-			if (b.length == 0)
-				return 0;
-
-			// Read from the serial port
-			int numRead = readBytes(portHandle, b, b.length, 0, timeoutMode, readTimeout);
-			if ((numRead == 0) && !timeoutExceptionsSuppressed)
-				throw new SerialPortTimeoutException("The read operation timed out before any data was returned.");
-			return numRead;
+			return read(b, 0, b.length);
 		}
 
 		@Override
@@ -1902,8 +3669,22 @@ public final class SerialPort
 			if ((b.length == 0) || (len == 0))
 				return 0;
 
-			// Read from the serial port
-			int numRead = readBytes(portHandle, b, len, off, timeoutMode, readTimeout);
+			// Return any buffered data first, only refilling the read-ahead buffer for reads that are smaller than it
+			int numRead, readAheadSize = inputStreamReadAheadSize;
+			if ((readAheadPosition < readAheadLength) || (readAheadSize > len))
+			{
+				if ((numRead = fillReadAhead(readAheadSize)) > 0)
+				{
+					numRead = Math.min(numRead, len);
+					System.arraycopy(readAheadBuffer, readAheadPosition, b, off, numRead);
+					readAheadPosition += numRead;
+					return numRead;
+				}
+			}
+			else
+				numRead = readBytes(portHandle, b, len, off, timeoutMode, readTimeout);
+
+			// Handle any timeouts
 			if ((numRead == 0) && !timeoutExceptionsSuppressed)
 				throw new SerialPortTimeoutException("The read operation timed out before any data was returned.");
 			return numRead;
@@ -1914,8 +3695,26 @@ public final class SerialPort
 		{
 			if (portHandle == 0)
 				throw new SerialPortIOException("This port appears to have been shutdown or disconnected.");
-			byte[] buffer = new byte[(int)n];
-			return readBytes(portHandle, buffer, n, 0, timeoutMode, readTimeout);
+			if (n <= 0)
+				return 0;
+
+			// Discard any buffered data first, otherwise read and discard up to one scratch buffer's worth of data without allocating
+			int numRead, readAheadSize = inputStreamReadAheadSize;
+			if ((readAheadPosition < readAheadLength) || (readAheadSize > 0))
+			{
+				if ((numRead = fillReadAhead(readAheadSize)) > 0)
+				{
+					numRead = (int)Math.min(numRead, n);
+					readAheadPosition += numRead;
+				}
+			}
+			else
+			{
+				if (byteBuffer.length < 1024)
+					byteBuffer = new byte[1024];
+				numRead = readBytes(portHandle, byteBuffer, Math.min(n, byteBuffer.length), 0, timeoutMode, readTimeout);
+			}
+			return (numRead < 0) ? 0 : numRead;
 		}
 	}
 
@@ -1972,5 +3771,13 @@ public final class SerialPort
 					totalNumWritten += numWritten;
 			}
 		}
+
+		@Override
+		public final void flush() throws SerialPortIOException
+		{
+			// Wait for any data in the native transmit queue to be written
+			if ((transmitQueueSize > 0) && (portHandle != 0) && !flushTransmitQueue(portHandle, 0, false))
+				throw new SerialPortIOException("The transmit queue could not be flushed. This port appears to have been shutdown or disconnected.");
+		}
 	}
 }
@@ -0,0 +1,178 @@
+/*
+ * SerialPortChannel.java
+ *
+ *       Created on:  Oct 14, 2026
+ *  Last Updated on:  Oct 14, 2026
+ *           Author:  Will Hedgecock
+ *
+ * Copyright (C) 2012-2022 Fazecast, Inc.
+ *
+ * This file is part of jSerialComm.
+ *
+ * jSerialComm is free software: you can redistribute it and/or modify
+ * it under the terms of either the Apache Software License, version 2, or
+ * the GNU Lesser General Public License as published by the Free Software
+ * Foundation, version 3 or above.
+ *
+ * jSerialComm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of both the GNU Lesser General Public
+ * License and the Apache Software License along with jSerialComm. If not,
+ * see <http://www.gnu.org/licenses/> and <http://www.apache.org/licenses/>.
+ */
+
+
+package com.fazecast.jSerialComm;
+
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.channels.ByteChannel;
+import java.nio.channels.ClosedChannelException;
+import java.nio.channels.GatheringByteChannel;
+import java.util.Arrays;
+
+/**
+ * This class provides a {@link java.nio.channels.ByteChannel} view of a serial port.
+ * <p>
+ * All transfers go directly through the native read and write paths of the port, so reading into or writing from direct buffers never requires
+ * any intermediate copies. Each operation obeys the timeout settings of the port as specified in {@link SerialPort#setComPortTimeouts(int, int, int)}.
+ * In particular, when the port is configured using {@link SerialPort#TIMEOUT_NONBLOCKING}, a read returns immediately with whatever data is
+ * available, which may be none.
+ * <p>
+ * This channel is not a {@link java.nio.channels.SelectableChannel} since the standard Java selectors can only monitor channels that were created
+ * by their own selector provider. Instead, {@link #getNativeHandle()} returns the underlying file descriptor of the port on non-Windows systems so
+ * that it can be monitored for readiness by any event loop capable of watching arbitrary file descriptors, after which this channel can be used
+ * to transfer the data without blocking.
+ * <p>
+ * Closing this channel does not close the underlying serial port, which should still be closed using {@link SerialPort#closePort()}.
+ *
+ * @author Will Hedgecock &lt;will.hedgecock@fazecast.com&gt;
+ * @version 2.9.1
+ * @see SerialPort#getChannel()
+ * @see java.nio.channels.ByteChannel
+ * @see java.nio.channels.GatheringByteChannel
+ */
+public final class SerialPortChannel implements ByteChannel, GatheringByteChannel
+{
+	private final SerialPort port;
+	private volatile boolean isClosed = false;
+
+	SerialPortChannel(SerialPort serialPort) { port = serialPort; }
+
+	/**
+	 * Returns the serial port associated with this channel.
+	 *
+	 * @return The serial port associated with this channel.
+	 */
+	public final SerialPort getPort() { return port; }
+
+	/**
+	 * Returns the native handle of the underlying serial port.
+	 * <p>
+	 * On non-Windows systems, this is the file descriptor of the open device, which may be registered with an external event loop in order to
+	 * be notified when the port becomes readable or writable. On Windows, this is the device <i>HANDLE</i>, which was opened for overlapped I/O.
+	 * <p>
+	 * The returned handle remains owned by the serial port and must never be closed or reconfigured directly.
+	 *
+	 * @return The native handle of the underlying port, or -1 if the port or this channel is closed.
+	 */
+	public final long getNativeHandle() { return isOpen() ? port.getNativeHandle() : -1; }
+
+	/**
+	 * Returns whether this channel and its underlying serial port are both open.
+	 *
+	 * @return Whether this channel is open.
+	 */
+	@Override
+	public final boolean isOpen() { return !isClosed && port.isOpen(); }
+
+	/**
+	 * Closes this channel without closing the underlying serial port.
+	 */
+	@Override
+	public final void close() { isClosed = true; }
+
+	/**
+	 * Reads a sequence of bytes from the serial port into the given buffer.
+	 *
+	 * @param dst The buffer into which bytes are to be transferred.
+	 * @return The number of bytes read, which may be zero if no data arrived before the read timeout expired.
+	 * @throws ClosedChannelException If this channel or its underlying serial port is closed.
+	 * @throws IllegalArgumentException If the buffer is read-only.
+	 * @throws SerialPortIOException If an error occurred while reading from the port.
+	 */
+	@Override
+	public final int read(ByteBuffer dst) throws IOException
+	{
+		if (!isOpen())
+			throw new ClosedChannelException();
+		if (dst.isReadOnly())
+			throw new IllegalArgumentException("A read-only buffer was passed in for the read buffer.");
+		if (!dst.hasRemaining())
+			return 0;
+		int numRead = port.readBytes(dst);
+		if (numRead < 0)
+			throw new SerialPortIOException("This port appears to have been shutdown or disconnected.");
+		return numRead;
+	}
+
+	/**
+	 * Writes a sequence of bytes to the serial port from the given buffer.
+	 *
+	 * @param src The buffer from which bytes are to be retrieved.
+	 * @return The number of bytes written.
+	 * @throws ClosedChannelException If this channel or its underlying serial port is closed.
+	 * @throws SerialPortIOException If an error occurred while writing to the port.
+	 */
+	@Override
+	public final int write(ByteBuffer src) throws IOException
+	{
+		if (!isOpen())
+			throw new ClosedChannelException();
+		if (!src.hasRemaining())
+			return 0;
+		int numWritten = port.writeBytes(src);
+		if (numWritten < 0)
+			throw new SerialPortIOException("This port appears to have been shutdown or disconnected.");
+		return numWritten;
+	}
+
+	/**
+	 * Writes a sequence of bytes to the serial port from a subsequence of the given buffers.
+	 * <p>
+	 * On non-Windows systems, the buffers are written using as few vectored write calls as possible.
+	 *
+	 * @param srcs The buffers from which bytes are to be retrieved.
+	 * @param offset The offset within the buffer array of the first buffer to be written.
+	 * @param length The maximum number of buffers to be accessed.
+	 * @return The number of bytes written.
+	 * @throws ClosedChannelException If this channel or its underlying serial port is closed.
+	 * @throws IndexOutOfBoundsException If the offset and length parameters do not describe a valid subsequence of the buffer array.
+	 * @throws SerialPortIOException If an error occurred while writing to the port.
+	 */
+	@Override
+	public final long write(ByteBuffer[] srcs, int offset, int length) throws IOException
+	{
+		if ((offset < 0) || (length < 0) || (offset > (srcs.length - length)))
+			throw new IndexOutOfBoundsException("The specified offset plus length extends past the end of the specified buffer array.");
+		if (!isOpen())
+			throw new ClosedChannelException();
+		int numWritten = port.writeBytes(Arrays.copyOfRange(srcs, offset, offset + length));
+		if (numWritten < 0)
+			throw new SerialPortIOException("This port appears to have been shutdown or disconnected.");
+		return numWritten;
+	}
+
+	/**
+	 * Writes a sequence of bytes to the serial port from the given buffers.
+	 *
+	 * @param srcs The buffers from which bytes are to be retrieved.
+	 * @return The number of bytes written.
+	 * @throws ClosedChannelException If this channel or its underlying serial port is closed.
+	 * @throws SerialPortIOException If an error occurred while writing to the port.
+	 */
+	@Override
+	public final long write(ByteBuffer[] srcs) throws IOException { return write(srcs, 0, srcs.length); }
+}
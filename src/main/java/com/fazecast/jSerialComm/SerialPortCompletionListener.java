@@ -0,0 +1,56 @@
+/*
+ * SerialPortCompletionListener.java
+ *
+ *       Created on:  Oct 14, 2026
+ *  Last Updated on:  Oct 14, 2026
+ *           Author:  Will Hedgecock
+ *
+ * Copyright (C) 2012-2022 Fazecast, Inc.
+ *
+ * This file is part of jSerialComm.
+ *
+ * jSerialComm is free software: you can redistribute it and/or modify
+ * it under the terms of either the Apache Software License, version 2, or
+ * the GNU Lesser General Public License as published by the Free Software
+ * Foundation, version 3 or above.
+ *
+ * jSerialComm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of both the GNU Lesser General Public
+ * License and the Apache Software License along with jSerialComm. If not,
+ * see <http://www.gnu.org/licenses/> and <http://www.apache.org/licenses/>.
+ */
+
+
+package com.fazecast.jSerialComm;
+
+import java.nio.ByteBuffer;
+import java.util.EventListener;
+
+/**
+ * This interface must be implemented to be notified when an asynchronous serial port read or write operation completes.
+ *
+ * @author Will Hedgecock &lt;will.hedgecock@fazecast.com&gt;
+ * @version 2.9.1
+ * @see java.util.EventListener
+ * @see SerialPort#readAsync(ByteBuffer, int, SerialPortCompletionListener)
+ * @see SerialPort#writeAsync(ByteBuffer, SerialPortCompletionListener)
+ */
+public interface SerialPortCompletionListener extends EventListener
+{
+	/**
+	 * Called whenever an asynchronous operation completes.
+	 * <p>
+	 * This method is called from the single background thread that drives all asynchronous serial port operations, so it should return as
+	 * quickly as possible. It is not called for operations that were cancelled using {@link SerialPortFuture#cancel(boolean)}.
+	 * <p>
+	 * Upon entry, the position of the buffer will already have been advanced by the number of bytes successfully transferred.
+	 *
+	 * @param port The serial port on which the operation was carried out.
+	 * @param buffer The buffer that was used for the operation.
+	 * @param result The number of bytes successfully transferred, or -1 if an error occurred.
+	 */
+	void operationCompleted(SerialPort port, ByteBuffer buffer, int result);
+}
@@ -37,8 +37,9 @@ import java.util.EventObject;
 public class SerialPortEvent extends EventObject
 {
 	private static final long serialVersionUID = 3060830619653354150L;
-	private final int eventType;
-	private final byte[] serialData;
+	private int eventType, serialDataLength;
+	private byte[] serialData;
+	private long timestamp;
 
 	/**
 	 * Constructs a {@link SerialPortEvent} object corresponding to the specified serial event type.
@@ -88,6 +89,8 @@ public class SerialPortEvent extends EventObject
 		super(comPort);
 		eventType = serialEventType;
 		serialData = null;
+		serialDataLength = 0;
+		timestamp = System.nanoTime();
 	}
 	
 	/**
@@ -137,6 +140,25 @@ public class SerialPortEvent extends EventObject
 		super(comPort);
 		eventType = serialEventType;
 		serialData = data;
+		serialDataLength = (data == null) ? 0 : data.length;
+		timestamp = System.nanoTime();
+	}
+
+	// Constructs an event stamped with the native time at which its data or condition was detected
+	SerialPortEvent(SerialPort comPort, int serialEventType, byte[] data, long receiveTimestamp)
+	{
+		this(comPort, serialEventType, data);
+		timestamp = receiveTimestamp;
+	}
+
+	// Re-initializes this event with new contents so that it may be recycled without allocation
+	final SerialPortEvent recycle(int serialEventType, byte[] data, int dataLength, long receiveTimestamp)
+	{
+		eventType = serialEventType;
+		serialData = data;
+		serialDataLength = dataLength;
+		timestamp = receiveTimestamp;
+		return this;
 	}
 	
 	/**
@@ -190,8 +212,42 @@ public class SerialPortEvent extends EventObject
 	
 	/**
 	 * Returns any raw data bytes associated with this serial port event.
+	 * <p>
+	 * If the corresponding data listener was registered with event buffer recycling enabled using
+	 * {@link SerialPort#addDataListener(SerialPortDataListener, boolean)}, the returned array is owned by the
+	 * serial port and will be overwritten as soon as the listener's {@link SerialPortDataListener#serialEvent(SerialPortEvent)}
+	 * method returns. In that case, the array may also be larger than the received data, so only the first
+	 * {@link #getReceivedDataLength()} bytes should be considered valid.
 	 * 
 	 * @return Any data bytes associated with this serial port event or null if none exist.
+	 * @see #getReceivedDataLength()
 	 */
 	public final byte[] getReceivedData() { return serialData; }
+
+	/**
+	 * Returns the number of valid raw data bytes associated with this serial port event.
+	 * <p>
+	 * Unless event buffer recycling was enabled for the corresponding data listener, this value will always be equal to
+	 * the length of the array returned by {@link #getReceivedData()}.
+	 * 
+	 * @return The number of valid data bytes associated with this serial port event, or 0 if none exist.
+	 * @see #getReceivedData()
+	 */
+	public final int getReceivedDataLength() { return serialDataLength; }
+
+	/**
+	 * Returns the monotonic time in nanoseconds at which the condition or data described by this event was detected.
+	 * <p>
+	 * For events generated by a serial port data listener, this timestamp is captured by the native code as soon as the event is detected or the
+	 * corresponding data is read from the device driver, so its accuracy does not depend on any garbage collection or thread scheduling delays that
+	 * occur before the event is delivered. Data that was read in direct response to an event carries the time at which that event was detected, and
+	 * any packet, message, or frame spanning multiple reads carries the time of the read in which it started. For events constructed directly by user
+	 * code, this is the time of construction as returned by {@link System#nanoTime()}.
+	 * <p>
+	 * On Linux and Windows, the timestamp uses the same time base as {@link System#nanoTime()} and can be compared directly against it.
+	 * 
+	 * @return The monotonic detection time of this event in nanoseconds.
+	 * @see SerialPort#readBytes(byte[], long, long, long[])
+	 */
+	public final long getTimestamp() { return timestamp; }
 }
@@ -0,0 +1,85 @@
+/*
+ * SerialPortFilter.java
+ *
+ *       Created on:  Oct 14, 2026
+ *  Last Updated on:  Oct 14, 2026
+ *           Author:  Will Hedgecock
+ *
+ * Copyright (C) 2012-2022 Fazecast, Inc.
+ *
+ * This file is part of jSerialComm.
+ *
+ * jSerialComm is free software: you can redistribute it and/or modify
+ * it under the terms of either the Apache Software License, version 2, or
+ * the GNU Lesser General Public License as published by the Free Software
+ * Foundation, version 3 or above.
+ *
+ * jSerialComm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of both the GNU Lesser General Public
+ * License and the Apache Software License along with jSerialComm. If not,
+ * see <http://www.gnu.org/licenses/> and <http://www.apache.org/licenses/>.
+ */
+
+
+package com.fazecast.jSerialComm;
+
+/**
+ * This class describes the criteria used to select a subset of the serial ports on the current system using {@link SerialPort#getCommPorts(SerialPortFilter)}.
+ * <p>
+ * Every criterion is optional, and a port must satisfy all specified criteria in order to be returned. The criteria are evaluated natively during
+ * enumeration before any descriptive details are retrieved, so filtering out unwanted ports avoids the cost of querying their friendly names,
+ * descriptions, and locations.
+ * <p>
+ * USB identifier and driver criteria are only supported on Linux and Windows. On all other systems, a filter containing either of these criteria
+ * will not match any ports.
+ *
+ * @author Will Hedgecock &lt;will.hedgecock@fazecast.com&gt;
+ * @version 2.9.1
+ * @see SerialPort#getCommPorts(SerialPortFilter)
+ */
+public final class SerialPortFilter
+{
+	// Filter criteria
+	String portPathPattern = null, driverName = null;
+	int vendorID = -1, productID = -1;
+
+	/**
+	 * Creates a new filter that matches all serial ports until criteria are added.
+	 */
+	public SerialPortFilter() {}
+
+	/**
+	 * Restricts the filter to ports whose system path matches the specified wildcard pattern.
+	 * <p>
+	 * The pattern may contain the wildcards '*' and '?' (and character classes on non-Windows systems). If the pattern contains a path separator,
+	 * it is compared against the full system port path (for example, "/dev/ttyUSB*" or "\\.\COM1?"). Otherwise, it is compared against the
+	 * system port name only (for example, "ttyACM*" or "COM*"). Matching is case-insensitive on Windows.
+	 *
+	 * @param pattern The wildcard pattern to match, or null to remove this criterion.
+	 * @return This filter object.
+	 */
+	public final SerialPortFilter setPortPathPattern(String pattern) { portPathPattern = pattern; return this; }
+
+	/**
+	 * Restricts the filter to USB devices with the specified vendor and product identifiers.
+	 *
+	 * @param usbVendorID The USB vendor ID to match, or -1 to match any vendor.
+	 * @param usbProductID The USB product ID to match, or -1 to match any product.
+	 * @return This filter object.
+	 */
+	public final SerialPortFilter setUsbIdentifiers(int usbVendorID, int usbProductID) { vendorID = usbVendorID; productID = usbProductID; return this; }
+
+	/**
+	 * Restricts the filter to ports that are handled by the specified device driver.
+	 * <p>
+	 * On Linux, this is the name of the kernel driver bound to the device or any of its parent devices (for example, "ftdi_sio", "cp210x", or
+	 * "cdc_acm"). On Windows, this is the name of the device's driver service (for example, "FTSER2K", "silabser", or "usbser").
+	 *
+	 * @param driver The device driver name to match, or null to remove this criterion.
+	 * @return This filter object.
+	 */
+	public final SerialPortFilter setDriverName(String driver) { driverName = driver; return this; }
+}
@@ -0,0 +1,119 @@
+/*
+ * SerialPortFrameDecoder.java
+ *
+ *       Created on:  Oct 14, 2026
+ *  Last Updated on:  Oct 14, 2026
+ *           Author:  Will Hedgecock
+ *
+ * Copyright (C) 2012-2022 Fazecast, Inc.
+ *
+ * This file is part of jSerialComm.
+ *
+ * jSerialComm is free software: you can redistribute it and/or modify
+ * it under the terms of either the Apache Software License, version 2, or
+ * the GNU Lesser General Public License as published by the Free Software
+ * Foundation, version 3 or above.
+ *
+ * jSerialComm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of both the GNU Lesser General Public
+ * License and the Apache Software License along with jSerialComm. If not,
+ * see <http://www.gnu.org/licenses/> and <http://www.apache.org/licenses/>.
+ */
+
+package com.fazecast.jSerialComm;
+
+import java.util.Arrays;
+
+/**
+ * This class describes a streaming frame format that is decoded by the native read path of a {@link SerialPortFrameListener}.
+ * <p>
+ * Instances are created using one of the static factory methods in this class:
+ * <ul>
+ * <li>{@link #lengthPrefixed(int, int, boolean, int, int)}: Frames containing a binary length field at a fixed offset from the start of the frame.</li>
+ * <li>{@link #slip(int)}: Frames encoded using the Serial Line Internet Protocol (RFC 1055).</li>
+ * <li>{@link #cobs(int)}: Frames encoded using Consistent Overhead Byte Stuffing and terminated by a zero byte.</li>
+ * </ul>
+ * <p>
+ * Any frame that would exceed the configured maximum frame length is silently discarded, and decoding resumes at the start of the next frame.
+ *
+ * @author Will Hedgecock &lt;will.hedgecock@fazecast.com&gt;
+ * @version 2.9.1
+ * @see SerialPortFrameListener
+ */
+public final class SerialPortFrameDecoder
+{
+	// Native decoder state layout
+	static final int FORMAT_LENGTH_PREFIXED = 1, FORMAT_SLIP = 2, FORMAT_COBS = 3;
+	static final int STATE_FORMAT = 0, STATE_LENGTH_OFFSET = 1, STATE_LENGTH_WIDTH = 2, STATE_BIG_ENDIAN = 3, STATE_LENGTH_ADJUSTMENT = 4, STATE_MAX_LENGTH = 5,
+			STATE_FRAME_LENGTH = 6, STATE_LENGTH = 11;
+
+	private final int[] configuration = new int[STATE_LENGTH];
+
+	private SerialPortFrameDecoder(int format, int lengthFieldOffset, int lengthFieldWidth, boolean bigEndian, int lengthAdjustment, int maximumFrameLength)
+	{
+		if (maximumFrameLength <= 0)
+			throw new IllegalArgumentException("The maximum frame length must be positive");
+		configuration[STATE_FORMAT] = format;
+		configuration[STATE_LENGTH_OFFSET] = lengthFieldOffset;
+		configuration[STATE_LENGTH_WIDTH] = lengthFieldWidth;
+		configuration[STATE_BIG_ENDIAN] = bigEndian ? 1 : 0;
+		configuration[STATE_LENGTH_ADJUSTMENT] = lengthAdjustment;
+		configuration[STATE_MAX_LENGTH] = maximumFrameLength;
+	}
+
+	/**
+	 * Creates a decoder for frames that contain a binary length field.
+	 * <p>
+	 * The total size of each frame is calculated as <i>lengthFieldOffset + lengthFieldWidth + fieldValue + lengthAdjustment</i>, where <i>fieldValue</i>
+	 * is the unsigned integer stored in the length field. For example, a protocol with a one-byte start marker followed by a two-byte big-endian payload
+	 * length and a two-byte trailing checksum would use an offset of 1, a width of 2, and a length adjustment of 2.
+	 * <p>
+	 * Each complete frame, including its header, is delivered unmodified.
+	 *
+	 * @param lengthFieldOffset The number of bytes preceding the length field within each frame.
+	 * @param lengthFieldWidth The size of the length field in bytes, from 1 to 4.
+	 * @param bigEndian Whether the length field is stored in big-endian (network) byte order.
+	 * @param lengthAdjustment The value to add to the length field to account for any bytes following the length field that are not included in its value.
+	 * @param maximumFrameLength The size of the largest frame that should be accepted.
+	 * @return A new length-prefixed frame decoder.
+	 */
+	static public final SerialPortFrameDecoder lengthPrefixed(int lengthFieldOffset, int lengthFieldWidth, boolean bigEndian, int lengthAdjustment, int maximumFrameLength)
+	{
+		if ((lengthFieldOffset < 0) || (lengthFieldWidth < 1) || (lengthFieldWidth > 4) || ((lengthFieldOffset + lengthFieldWidth) > maximumFrameLength))
+			throw new IllegalArgumentException("Invalid length field location");
+		return new SerialPortFrameDecoder(FORMAT_LENGTH_PREFIXED, lengthFieldOffset, lengthFieldWidth, bigEndian, lengthAdjustment, maximumFrameLength);
+	}
+
+	/**
+	 * Creates a decoder for SLIP-encoded frames.
+	 * <p>
+	 * Each frame is delivered with all escape sequences removed and without its END delimiter. Empty frames are ignored.
+	 *
+	 * @param maximumFrameLength The size of the largest decoded frame that should be accepted.
+	 * @return A new SLIP frame decoder.
+	 */
+	static public final SerialPortFrameDecoder slip(int maximumFrameLength) { return new SerialPortFrameDecoder(FORMAT_SLIP, 0, 0, false, 0, maximumFrameLength); }
+
+	/**
+	 * Creates a decoder for COBS-encoded frames that are terminated by a zero byte.
+	 * <p>
+	 * Each frame is delivered fully decoded and without its zero delimiter. Empty or malformed frames are ignored.
+	 *
+	 * @param maximumFrameLength The size of the largest decoded frame that should be accepted.
+	 * @return A new COBS frame decoder.
+	 */
+	static public final SerialPortFrameDecoder cobs(int maximumFrameLength) { return new SerialPortFrameDecoder(FORMAT_COBS, 0, 0, false, 0, maximumFrameLength); }
+
+	/**
+	 * Returns the size of the largest frame that will be accepted by this decoder.
+	 *
+	 * @return The maximum frame length in bytes.
+	 */
+	public final int getMaximumFrameLength() { return configuration[STATE_MAX_LENGTH]; }
+
+	// Returns a fresh native decoder state array initialized with this configuration
+	final int[] createState() { return Arrays.copyOf(configuration, STATE_LENGTH); }
+}
@@ -0,0 +1,51 @@
+/*
+ * SerialPortFrameListener.java
+ *
+ *       Created on:  Oct 14, 2026
+ *  Last Updated on:  Oct 14, 2026
+ *           Author:  Will Hedgecock
+ *
+ * Copyright (C) 2012-2022 Fazecast, Inc.
+ *
+ * This file is part of jSerialComm.
+ *
+ * jSerialComm is free software: you can redistribute it and/or modify
+ * it under the terms of either the Apache Software License, version 2, or
+ * the GNU Lesser General Public License as published by the Free Software
+ * Foundation, version 3 or above.
+ *
+ * jSerialComm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of both the GNU Lesser General Public
+ * License and the Apache Software License along with jSerialComm. If not,
+ * see <http://www.gnu.org/licenses/> and <http://www.apache.org/licenses/>.
+ */
+
+package com.fazecast.jSerialComm;
+
+/**
+ * This interface must be implemented to enable natively decoded frame reads using event-based serial port I/O.
+ * <p>
+ * Incoming data is decoded within the native read path according to the {@link SerialPortFrameDecoder} returned by {@link #getFrameDecoder()},
+ * and the {@link #serialEvent(SerialPortEvent)} callback is triggered exactly once for each complete frame, with the event data containing
+ * only the decoded frame contents.
+ * <p>
+ * <i>Note</i>: Using this interface will negate any serial port read timeout settings since they make no sense in an asynchronous context.
+ * 
+ * @author Will Hedgecock &lt;will.hedgecock@fazecast.com&gt;
+ * @version 2.9.1
+ * @see com.fazecast.jSerialComm.SerialPortDataListener
+ * @see com.fazecast.jSerialComm.SerialPortFrameDecoder
+ * @see java.util.EventListener
+ */
+public interface SerialPortFrameListener extends SerialPortDataListener
+{
+	/**
+	 * Must be overridden to return the frame format that should be used to decode incoming data.
+	 * 
+	 * @return The frame decoder to use for all incoming data.
+	 */
+	public abstract SerialPortFrameDecoder getFrameDecoder();
+}
@@ -0,0 +1,176 @@
+/*
+ * SerialPortFuture.java
+ *
+ *       Created on:  Oct 14, 2026
+ *  Last Updated on:  Oct 14, 2026
+ *           Author:  Will Hedgecock
+ *
+ * Copyright (C) 2012-2022 Fazecast, Inc.
+ *
+ * This file is part of jSerialComm.
+ *
+ * jSerialComm is free software: you can redistribute it and/or modify
+ * it under the terms of either the Apache Software License, version 2, or
+ * the GNU Lesser General Public License as published by the Free Software
+ * Foundation, version 3 or above.
+ *
+ * jSerialComm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of both the GNU Lesser General Public
+ * License and the Apache Software License along with jSerialComm. If not,
+ * see <http://www.gnu.org/licenses/> and <http://www.apache.org/licenses/>.
+ */
+
+
+package com.fazecast.jSerialComm;
+
+import java.nio.ByteBuffer;
+import java.util.concurrent.CancellationException;
+import java.util.concurrent.Future;
+import java.util.concurrent.TimeUnit;
+import java.util.concurrent.TimeoutException;
+
+/**
+ * This class represents the pending result of an asynchronous serial port read or write operation.
+ * <p>
+ * The result of a completed operation is the number of bytes that were successfully transferred, or -1 if an error occurred. Upon
+ * completion, the position of the buffer passed to the operation will have been advanced by the number of bytes transferred. The buffer
+ * must not be accessed or modified by the calling application until the operation is done.
+ * <p>
+ * Cancelling an operation discards any data that it had already read, although a cancelled write may still have transmitted part of its data.
+ *
+ * @author Will Hedgecock &lt;will.hedgecock@fazecast.com&gt;
+ * @version 2.9.1
+ * @see SerialPort#readAsync(ByteBuffer, int)
+ * @see SerialPort#writeAsync(ByteBuffer)
+ * @see java.util.concurrent.Future
+ */
+public final class SerialPortFuture implements Future<Integer>
+{
+	// Operation details used by the asynchronous I/O engine
+	final SerialPort port;
+	final ByteBuffer buffer;
+	final SerialPortCompletionListener listener;
+	final boolean isWrite;
+	final int timeoutMS;
+	long operationHandle = 0, deadline = 0;
+	int offset = 0;
+
+	private volatile boolean isDone = false, isCancelled = false;
+	private volatile int result = -1;
+
+	SerialPortFuture(SerialPort serialPort, ByteBuffer dataBuffer, boolean writeOperation, int operationTimeoutMS, SerialPortCompletionListener completionListener)
+	{
+		port = serialPort;
+		buffer = dataBuffer;
+		isWrite = writeOperation;
+		timeoutMS = operationTimeoutMS;
+		listener = completionListener;
+	}
+
+	/**
+	 * Attempts to cancel this operation.
+	 * <p>
+	 * If the operation is still in progress, it will be aborted as soon as possible, and any data that it had already read will be discarded.
+	 * The <i>mayInterruptIfRunning</i> parameter is ignored since an in-progress serial port transfer can always be aborted.
+	 *
+	 * @param mayInterruptIfRunning Ignored.
+	 * @return Whether the operation was cancelled, which will be false if it had already completed.
+	 */
+	@Override
+	public final synchronized boolean cancel(boolean mayInterruptIfRunning)
+	{
+		if (isDone)
+			return false;
+		isCancelled = isDone = true;
+		notifyAll();
+		port.cancelAsyncOperation(this);
+		return true;
+	}
+
+	/**
+	 * Returns whether this operation was cancelled before it completed.
+	 *
+	 * @return Whether the operation was cancelled.
+	 */
+	@Override
+	public final boolean isCancelled() { return isCancelled; }
+
+	/**
+	 * Returns whether this operation has completed, failed, or been cancelled.
+	 *
+	 * @return Whether the operation is done.
+	 */
+	@Override
+	public final boolean isDone() { return isDone; }
+
+	/**
+	 * Waits for this operation to complete and returns its result.
+	 *
+	 * @return The number of bytes successfully transferred, or -1 if an error occurred.
+	 * @throws CancellationException If the operation was cancelled.
+	 * @throws InterruptedException If the current thread was interrupted while waiting.
+	 */
+	@Override
+	public final synchronized Integer get() throws InterruptedException
+	{
+		while (!isDone)
+			wait();
+		if (isCancelled)
+			throw new CancellationException("The serial port operation was cancelled");
+		return result;
+	}
+
+	/**
+	 * Waits for up to the specified amount of time for this operation to complete and returns its result.
+	 *
+	 * @param timeout The maximum amount of time to wait.
+	 * @param unit The time unit of the timeout parameter.
+	 * @return The number of bytes successfully transferred, or -1 if an error occurred.
+	 * @throws CancellationException If the operation was cancelled.
+	 * @throws InterruptedException If the current thread was interrupted while waiting.
+	 * @throws TimeoutException If the operation did not complete within the specified amount of time.
+	 */
+	@Override
+	public final synchronized Integer get(long timeout, TimeUnit unit) throws InterruptedException, TimeoutException
+	{
+		long remainingNS = unit.toNanos(timeout), deadlineNS = System.nanoTime() + remainingNS;
+		while (!isDone && (remainingNS > 0))
+		{
+			TimeUnit.NANOSECONDS.timedWait(this, remainingNS);
+			remainingNS = deadlineNS - System.nanoTime();
+		}
+		if (!isDone)
+			throw new TimeoutException("The serial port operation did not complete in time");
+		if (isCancelled)
+			throw new CancellationException("The serial port operation was cancelled");
+		return result;
+	}
+
+	// Marks the operation as completed with the specified result, returning false if it had already been cancelled
+	final synchronized boolean complete(int operationResult)
+	{
+		if (isDone)
+			return false;
+		result = operationResult;
+		isDone = true;
+		notifyAll();
+		return true;
+	}
+
+	// Notifies the completion listener, if any, of the operation result from the current thread
+	final void notifyListener()
+	{
+		if (listener != null)
+			try { listener.operationCompleted(port, buffer, result); } catch (Exception e) { e.printStackTrace(); }
+	}
+
+	// Completes the operation and notifies its listener from the current thread
+	final void completeAndNotify(int operationResult)
+	{
+		if (complete(operationResult))
+			notifyListener();
+	}
+}
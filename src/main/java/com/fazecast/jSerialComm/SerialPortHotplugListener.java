@@ -0,0 +1,59 @@
+/*
+ * SerialPortHotplugListener.java
+ *
+ *       Created on:  Oct 14, 2026
+ *  Last Updated on:  Oct 14, 2026
+ *           Author:  Will Hedgecock
+ *
+ * Copyright (C) 2012-2022 Fazecast, Inc.
+ *
+ * This file is part of jSerialComm.
+ *
+ * jSerialComm is free software: you can redistribute it and/or modify
+ * it under the terms of either the Apache Software License, version 2, or
+ * the GNU Lesser General Public License as published by the Free Software
+ * Foundation, version 3 or above.
+ *
+ * jSerialComm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of both the GNU Lesser General Public
+ * License and the Apache Software License along with jSerialComm. If not,
+ * see <http://www.gnu.org/licenses/> and <http://www.apache.org/licenses/>.
+ */
+
+package com.fazecast.jSerialComm;
+
+import java.util.EventListener;
+
+/**
+ * This interface must be implemented to be notified when serial ports are added to or removed from the system.
+ *
+ * @author Will Hedgecock &lt;will.hedgecock@fazecast.com&gt;
+ * @version 2.9.1
+ * @see java.util.EventListener
+ * @see SerialPort#addHotplugListener(SerialPortHotplugListener)
+ */
+public interface SerialPortHotplugListener extends EventListener
+{
+	/**
+	 * Called whenever a new serial port appears on the system.
+	 * <p>
+	 * The passed-in {@link SerialPort} object is identical to one that would be returned by {@link SerialPort#getCommPorts()}
+	 * and may be opened directly.
+	 *
+	 * @param port The serial port that was added.
+	 */
+	void serialPortAdded(SerialPort port);
+
+	/**
+	 * Called whenever a previously available serial port disappears from the system.
+	 * <p>
+	 * The passed-in {@link SerialPort} object is the same instance that was previously passed to {@link #serialPortAdded(SerialPort)},
+	 * or that was part of the port listing when this listener was registered.
+	 *
+	 * @param port The serial port that was removed.
+	 */
+	void serialPortRemoved(SerialPort port);
+}
@@ -0,0 +1,316 @@
+/*
+ * SerialPortRecordingReader.java
+ *
+ *       Created on:  Oct 14, 2026
+ *  Last Updated on:  Oct 14, 2026
+ *           Author:  Will Hedgecock
+ *
+ * Copyright (C) 2012-2022 Fazecast, Inc.
+ *
+ * This file is part of jSerialComm.
+ *
+ * jSerialComm is free software: you can redistribute it and/or modify
+ * it under the terms of either the Apache Software License, version 2, or
+ * the GNU Lesser General Public License as published by the Free Software
+ * Foundation, version 3 or above.
+ *
+ * jSerialComm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of both the GNU Lesser General Public
+ * License and the Apache Software License along with jSerialComm. If not,
+ * see <http://www.gnu.org/licenses/> and <http://www.apache.org/licenses/>.
+ */
+
+
+package com.fazecast.jSerialComm;
+
+import java.io.Closeable;
+import java.io.IOException;
+import java.io.RandomAccessFile;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+import java.nio.channels.FileChannel;
+
+/**
+ * This class reads back the trace files produced by {@link SerialPort#setRecordingFile(String, long, boolean)}.
+ * <p>
+ * A trace file consists of a 64-byte header followed by a rolling data region containing one entry per chunk of data that was exchanged with the
+ * device driver. Each entry is made up of a 64-bit native timestamp, a 32-bit data length, a 16-bit direction tag, 16 reserved bits, and the data
+ * itself padded to a multiple of 8 bytes. All values are stored in the native byte order of the machine that made the recording, which is detected
+ * automatically. Entries are iterated from oldest to newest by repeatedly calling {@link #next()}, or written back out to another serial port
+ * using {@link #replay(SerialPort, int, boolean)}.
+ * <p>
+ * A recording that is still being written can also be read. The header positions are re-read before every entry, so newly appended entries
+ * are returned as they become available, and any entries that the recording port reclaims before they are read are skipped rather than
+ * returned with overwritten contents.
+ *
+ * @author Will Hedgecock &lt;will.hedgecock@fazecast.com&gt;
+ * @version 2.9.1
+ * @see SerialPort#setRecordingFile(String, long, boolean)
+ */
+public final class SerialPortRecordingReader implements Closeable
+{
+	/**
+	 * Direction tag for data that was received from the serial port.
+	 */
+	static final public int DIRECTION_RECEIVED = 0;
+
+	/**
+	 * Direction tag for data that was transmitted to the serial port.
+	 */
+	static final public int DIRECTION_TRANSMITTED = 1;
+
+	// Trace file layout (must match the native recording structures)
+	private static final String MAGIC = "jSCTrace";
+	private static final int VERSION = 1, BYTE_ORDER_MARK = 0x01020304, HEADER_LENGTH = 64, ENTRY_HEADER_LENGTH = 16, DIRECTION_PADDING = 0xFFFF;
+	private static final int WRITE_POSITION_OFFSET = 24, OLDEST_POSITION_OFFSET = 32;
+
+	private final RandomAccessFile file;
+	private final ByteBuffer contents;
+	private final long dataRegionLength, startTimestamp, startWallClockTime;
+	private long position, entryTimestamp = 0;
+	private int entryDirection = -1, entryLength = 0;
+	private byte[] entryData = new byte[256];
+
+	/**
+	 * Opens an existing trace file for reading and positions the reader before its oldest entry.
+	 *
+	 * @param fileName The path of the trace file to read.
+	 * @throws IOException If the file cannot be read or is not a valid trace file.
+	 */
+	public SerialPortRecordingReader(String fileName) throws IOException
+	{
+		// Map the entire file into memory
+		file = new RandomAccessFile(fileName, "r");
+		try
+		{
+			long fileLength = file.length();
+			if ((fileLength < HEADER_LENGTH) || (fileLength > Integer.MAX_VALUE))
+				throw new IOException("Invalid trace file length: " + fileLength);
+			contents = file.getChannel().map(FileChannel.MapMode.READ_ONLY, 0, fileLength);
+
+			// Validate the header and determine the byte order used by the recording machine
+			byte[] magic = new byte[MAGIC.length()];
+			contents.get(magic);
+			if (!MAGIC.equals(new String(magic, "US-ASCII")))
+				throw new IOException("Not a jSerialComm trace file: " + fileName);
+			contents.order(ByteOrder.BIG_ENDIAN);
+			if (contents.getInt(8) != BYTE_ORDER_MARK)
+				contents.order(ByteOrder.LITTLE_ENDIAN);
+			if ((contents.getInt(8) != BYTE_ORDER_MARK) || (contents.getInt(12) != VERSION))
+				throw new IOException("Unsupported trace file format: " + fileName);
+			dataRegionLength = contents.getLong(16);
+			long writePosition = contents.getLong(WRITE_POSITION_OFFSET), oldestPosition = contents.getLong(OLDEST_POSITION_OFFSET);
+			startTimestamp = contents.getLong(40);
+			startWallClockTime = contents.getLong(48);
+			if ((dataRegionLength <= 0) || ((dataRegionLength % 8) != 0) || ((HEADER_LENGTH + dataRegionLength) > fileLength) ||
+					(oldestPosition < 0) || (writePosition < oldestPosition) || ((writePosition - oldestPosition) > dataRegionLength))
+				throw new IOException("Corrupt trace file header: " + fileName);
+			position = oldestPosition;
+		}
+		catch (IOException e)
+		{
+			file.close();
+			throw e;
+		}
+	}
+
+	/**
+	 * Closes the underlying trace file.
+	 *
+	 * @throws IOException If the file could not be closed.
+	 */
+	@Override
+	public final void close() throws IOException { file.close(); }
+
+	/**
+	 * Returns the native monotonic timestamp in nanoseconds at which recording was started.
+	 *
+	 * @return The native timestamp at which recording was started.
+	 */
+	public final long getStartTimestamp() { return startTimestamp; }
+
+	/**
+	 * Returns the wall clock time in milliseconds since the epoch at which recording was started.
+	 *
+	 * @return The wall clock time at which recording was started.
+	 */
+	public final long getStartTime() { return startWallClockTime / 1000000L; }
+
+	/**
+	 * Repositions the reader before the oldest entry in the trace file.
+	 */
+	public final void rewind()
+	{
+		position = contents.getLong(OLDEST_POSITION_OFFSET);
+		entryDirection = -1;
+		entryLength = 0;
+	}
+
+	/**
+	 * Advances the reader to the next entry in the trace file.
+	 *
+	 * @return Whether another entry was available.
+	 * @throws IOException If the trace file contents are corrupt.
+	 */
+	public final boolean next() throws IOException
+	{
+		while (true)
+		{
+			// Re-read the header positions in case the recording is still live, skipping ahead past any entries that were reclaimed before being read
+			long writePosition = contents.getLong(WRITE_POSITION_OFFSET), oldestPosition = contents.getLong(OLDEST_POSITION_OFFSET);
+			if (position < oldestPosition)
+				position = oldestPosition;
+			if (position >= writePosition)
+				break;
+
+			// Skip any unused space at the end of the data region
+			long offset = position % dataRegionLength, remaining = dataRegionLength - offset;
+			if (remaining < ENTRY_HEADER_LENGTH)
+			{
+				position += remaining;
+				continue;
+			}
+
+			// Parse the entry header, skipping over padding entries
+			int entryStart = (int)(HEADER_LENGTH + offset);
+			long length = contents.getInt(entryStart + 8) & 0xFFFFFFFFL, entrySize = ENTRY_HEADER_LENGTH + ((length + 7) & ~7L);
+			if (entrySize > remaining)
+			{
+				if (contents.getLong(OLDEST_POSITION_OFFSET) > position)
+					continue;
+				throw new IOException("Corrupt trace file entry at position " + position);
+			}
+			long entryPosition = position;
+			position += entrySize;
+			int direction = contents.getShort(entryStart + 12) & 0xFFFF;
+			if (direction == DIRECTION_PADDING)
+				continue;
+
+			// Copy out the entry, then discard it if the recording port reclaimed its space while it was being copied
+			long timestamp = contents.getLong(entryStart);
+			if (length > entryData.length)
+				entryData = new byte[(int)length];
+			ByteBuffer entryContents = contents.duplicate();
+			entryContents.position(entryStart + ENTRY_HEADER_LENGTH);
+			entryContents.get(entryData, 0, (int)length);
+			if (contents.getLong(OLDEST_POSITION_OFFSET) > entryPosition)
+				continue;
+			entryTimestamp = timestamp;
+			entryDirection = direction;
+			entryLength = (int)length;
+			return true;
+		}
+		entryDirection = -1;
+		entryLength = 0;
+		return false;
+	}
+
+	/**
+	 * Returns the native monotonic timestamp in nanoseconds at which the data in the current entry was transferred.
+	 * <p>
+	 * This uses the same time base as {@link SerialPortEvent#getTimestamp()} on the machine that made the recording.
+	 *
+	 * @return The native timestamp of the current entry.
+	 */
+	public final long getTimestamp() { return entryTimestamp; }
+
+	/**
+	 * Returns the approximate wall clock time in milliseconds since the epoch at which the data in the current entry was transferred.
+	 *
+	 * @return The wall clock time of the current entry.
+	 */
+	public final long getTime() { return (startWallClockTime + (entryTimestamp - startTimestamp)) / 1000000L; }
+
+	/**
+	 * Returns the direction of the current entry.
+	 *
+	 * @return Either {@link #DIRECTION_RECEIVED} or {@link #DIRECTION_TRANSMITTED}, or -1 if there is no current entry.
+	 */
+	public final int getDirection() { return entryDirection; }
+
+	/**
+	 * Returns the number of data bytes in the current entry.
+	 *
+	 * @return The number of data bytes in the current entry.
+	 */
+	public final int getLength() { return entryLength; }
+
+	/**
+	 * Returns a copy of the data in the current entry.
+	 *
+	 * @return The data in the current entry.
+	 */
+	public final byte[] getData()
+	{
+		byte[] data = new byte[entryLength];
+		getData(data, 0);
+		return data;
+	}
+
+	/**
+	 * Copies the data in the current entry into the specified buffer.
+	 *
+	 * @param buffer The buffer into which to copy the data, which must have at least {@link #getLength()} bytes available starting at <i>offset</i>.
+	 * @param offset The buffer index at which to begin storing data.
+	 * @return The number of bytes copied.
+	 */
+	public final int getData(byte[] buffer, int offset)
+	{
+		System.arraycopy(entryData, 0, buffer, offset, entryLength);
+		return entryLength;
+	}
+
+	/**
+	 * Writes the data from all remaining entries in the specified direction to a serial port, optionally reproducing their original timing.
+	 * <p>
+	 * This is typically used to feed a previously captured data stream back into an application or device under test. The serial port must
+	 * already be open and configured.
+	 *
+	 * @param port The open serial port to which the recorded data should be written.
+	 * @param direction The direction of the entries to replay, either {@link #DIRECTION_RECEIVED} or {@link #DIRECTION_TRANSMITTED}.
+	 * @param preserveTiming Whether to wait between entries for the same amount of time that elapsed between them while recording.
+	 * @return The total number of bytes written, or -1 if a write failed or timed out before an entire entry could be written.
+	 * @throws IOException If the trace file contents are corrupt.
+	 * @throws InterruptedException If the calling thread was interrupted while waiting between entries.
+	 */
+	public final long replay(SerialPort port, int direction, boolean preserveTiming) throws IOException, InterruptedException
+	{
+		long numBytesWritten = 0, firstTimestamp = 0, replayStartTime = 0;
+		byte[] buffer = new byte[256];
+		while (next())
+		{
+			if (entryDirection != direction)
+				continue;
+
+			// Wait until the same amount of time has elapsed since the first replayed entry as during the recording
+			if (preserveTiming)
+			{
+				if (replayStartTime == 0)
+				{
+					firstTimestamp = entryTimestamp;
+					replayStartTime = System.nanoTime();
+				}
+				long delayNS = (entryTimestamp - firstTimestamp) - (System.nanoTime() - replayStartTime);
+				if (delayNS > 0)
+					Thread.sleep(delayNS / 1000000L, (int)(delayNS % 1000000L));
+			}
+
+			// Write out the entire entry, failing if the port stops accepting data
+			if (entryLength > buffer.length)
+				buffer = new byte[entryLength];
+			getData(buffer, 0);
+			for (int offset = 0; offset < entryLength; )
+			{
+				int result = port.writeBytes(buffer, entryLength - offset, offset);
+				if (result <= 0)
+					return -1;
+				offset += result;
+				numBytesWritten += result;
+			}
+		}
+		return numBytesWritten;
+	}
+}
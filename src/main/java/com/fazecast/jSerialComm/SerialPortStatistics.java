@@ -0,0 +1,281 @@
+/*
+ * SerialPortStatistics.java
+ *
+ *       Created on:  Oct 14, 2026
+ *  Last Updated on:  Oct 14, 2026
+ *           Author:  Will Hedgecock
+ *
+ * Copyright (C) 2012-2022 Fazecast, Inc.
+ *
+ * This file is part of jSerialComm.
+ *
+ * jSerialComm is free software: you can redistribute it and/or modify
+ * it under the terms of either the Apache Software License, version 2, or
+ * the GNU Lesser General Public License as published by the Free Software
+ * Foundation, version 3 or above.
+ *
+ * jSerialComm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of both the GNU Lesser General Public
+ * License and the Apache Software License along with jSerialComm. If not,
+ * see <http://www.gnu.org/licenses/> and <http://www.apache.org/licenses/>.
+ */
+
+package com.fazecast.jSerialComm;
+
+/**
+ * This class contains a snapshot of the performance counters and call latency histograms that are maintained by the native code for an open serial port.
+ * <p>
+ * All counters start at zero when the port is opened or when {@link SerialPort#resetStatistics()} is called. Latency histograms use logarithmic
+ * buckets, where bucket <i>n</i> counts calls that completed in less than 2<sup>n+1</sup> microseconds but no less than 2<sup>n</sup> microseconds
+ * (with bucket 0 also containing all calls that completed in under one microsecond).
+ * <p>
+ * Any counter that is not supported by the current operating system or device driver is reported as -1.
+ *
+ * @author Will Hedgecock &lt;will.hedgecock@fazecast.com&gt;
+ * @version 2.9.1
+ * @see SerialPort#getStatistics()
+ */
+public final class SerialPortStatistics
+{
+	/**
+	 * The number of buckets contained in each latency histogram.
+	 */
+	static final public int HISTOGRAM_BUCKETS = 32;
+
+	// Native statistics array layout
+	static final int BYTES_READ = 0, BYTES_WRITTEN = 1, READ_CALLS = 2, WRITE_CALLS = 3, READ_SYSCALLS = 4, WRITE_SYSCALLS = 5, SHORT_READS = 6,
+			READ_TIMEOUTS = 7, WRITE_RETRIES = 8, DRAIN_TIME_NS = 9, FRAMING_ERRORS = 10, OVERRUN_ERRORS = 11, PARITY_ERRORS = 12, BUFFER_OVERRUN_ERRORS = 13,
+			READ_HISTOGRAM = 14, WRITE_HISTOGRAM = READ_HISTOGRAM + HISTOGRAM_BUCKETS, RS485_TRANSMISSIONS = WRITE_HISTOGRAM + HISTOGRAM_BUCKETS,
+			RS485_TURNAROUND_NS = RS485_TRANSMISSIONS + 1, RS485_MAX_TURNAROUND_NS = RS485_TRANSMISSIONS + 2, RS485_TURNAROUND_HISTOGRAM = RS485_TRANSMISSIONS + 3,
+			LENGTH = RS485_TURNAROUND_HISTOGRAM + HISTOGRAM_BUCKETS;
+
+	private final long[] statistics;
+
+	/**
+	 * Constructs a {@link SerialPortStatistics} object from the raw statistics array filled in by the native code.
+	 *
+	 * @param rawStatistics The native statistics array.
+	 */
+	SerialPortStatistics(long[] rawStatistics) { statistics = rawStatistics; }
+
+	/**
+	 * Returns the total number of bytes returned by all read calls.
+	 *
+	 * @return The total number of bytes read.
+	 */
+	public final long getBytesRead() { return statistics[BYTES_READ]; }
+
+	/**
+	 * Returns the total number of bytes accepted by all write calls.
+	 *
+	 * @return The total number of bytes written.
+	 */
+	public final long getBytesWritten() { return statistics[BYTES_WRITTEN]; }
+
+	/**
+	 * Returns the number of read calls made through this library, including those served from a background read buffer.
+	 *
+	 * @return The number of library-level read calls.
+	 */
+	public final long getReadCalls() { return statistics[READ_CALLS]; }
+
+	/**
+	 * Returns the number of write calls made through this library.
+	 *
+	 * @return The number of library-level write calls.
+	 */
+	public final long getWriteCalls() { return statistics[WRITE_CALLS]; }
+
+	/**
+	 * Returns the number of operating system read operations issued to the device driver.
+	 * <p>
+	 * A ratio of system reads to library read calls that is much greater than 1 indicates that data is arriving from the device in many small chunks.
+	 *
+	 * @return The number of operating system read operations.
+	 */
+	public final long getReadSyscalls() { return statistics[READ_SYSCALLS]; }
+
+	/**
+	 * Returns the number of operating system write operations issued to the device driver.
+	 *
+	 * @return The number of operating system write operations.
+	 */
+	public final long getWriteSyscalls() { return statistics[WRITE_SYSCALLS]; }
+
+	/**
+	 * Returns the number of successful read calls that returned fewer bytes than were requested.
+	 *
+	 * @return The number of short reads.
+	 */
+	public final long getShortReads() { return statistics[SHORT_READS]; }
+
+	/**
+	 * Returns the number of read calls that returned because the configured read timeout expired.
+	 *
+	 * @return The number of timed-out reads.
+	 */
+	public final long getReadTimeouts() { return statistics[READ_TIMEOUTS]; }
+
+	/**
+	 * Returns the number of times a write call had to wait for space in the driver's transmit buffer before it could continue.
+	 *
+	 * @return The number of write retries.
+	 */
+	public final long getWriteRetries() { return statistics[WRITE_RETRIES]; }
+
+	/**
+	 * Returns the total time spent waiting for transmitted data to drain from the driver in {@link SerialPort#TIMEOUT_WRITE_BLOCKING} mode.
+	 *
+	 * @return The total drain time in nanoseconds.
+	 */
+	public final long getDrainTimeNanoseconds() { return statistics[DRAIN_TIME_NS]; }
+
+	/**
+	 * Returns the number of framing errors counted by the device driver.
+	 *
+	 * @return The number of framing errors, or -1 if not supported.
+	 */
+	public final long getFramingErrors() { return statistics[FRAMING_ERRORS]; }
+
+	/**
+	 * Returns the number of hardware overrun errors counted by the device driver.
+	 *
+	 * @return The number of hardware overrun errors, or -1 if not supported.
+	 */
+	public final long getOverrunErrors() { return statistics[OVERRUN_ERRORS]; }
+
+	/**
+	 * Returns the number of parity errors counted by the device driver.
+	 *
+	 * @return The number of parity errors, or -1 if not supported.
+	 */
+	public final long getParityErrors() { return statistics[PARITY_ERRORS]; }
+
+	/**
+	 * Returns the number of driver receive buffer overruns counted by the device driver.
+	 *
+	 * @return The number of driver buffer overrun errors, or -1 if not supported.
+	 */
+	public final long getBufferOverrunErrors() { return statistics[BUFFER_OVERRUN_ERRORS]; }
+
+	/**
+	 * Returns the number of transmissions whose bus direction was switched by software RS-485 direction control.
+	 *
+	 * @return The number of software-controlled RS-485 transmissions, or -1 if software direction control is not active.
+	 * @see SerialPort#setRs485SoftwareDirectionControl(boolean)
+	 */
+	public final long getRs485Transmissions() { return statistics[RS485_TRANSMISSIONS]; }
+
+	/**
+	 * Returns the total RS-485 turnaround time of all software-controlled transmissions.
+	 * <p>
+	 * The turnaround time of a transmission is measured from the moment its last bit was detected to have left the device until the RTS line was
+	 * released, and it therefore includes the configured "delay after send" time.
+	 *
+	 * @return The total turnaround time in nanoseconds, or -1 if software direction control is not active.
+	 */
+	public final long getRs485TurnaroundTimeNanoseconds() { return statistics[RS485_TURNAROUND_NS]; }
+
+	/**
+	 * Returns the longest RS-485 turnaround time of any software-controlled transmission.
+	 *
+	 * @return The longest turnaround time in nanoseconds, or -1 if software direction control is not active.
+	 * @see #getRs485TurnaroundTimeNanoseconds()
+	 */
+	public final long getRs485MaxTurnaroundNanoseconds() { return statistics[RS485_MAX_TURNAROUND_NS]; }
+
+	/**
+	 * Returns a copy of the read call latency histogram.
+	 *
+	 * @return An array of {@link #HISTOGRAM_BUCKETS} call counts with logarithmically increasing latency bounds.
+	 */
+	public final long[] getReadLatencyHistogram() { return getHistogram(READ_HISTOGRAM); }
+
+	/**
+	 * Returns a copy of the write call latency histogram.
+	 *
+	 * @return An array of {@link #HISTOGRAM_BUCKETS} call counts with logarithmically increasing latency bounds.
+	 */
+	public final long[] getWriteLatencyHistogram() { return getHistogram(WRITE_HISTOGRAM); }
+
+	/**
+	 * Returns a copy of the software RS-485 turnaround time histogram.
+	 *
+	 * @return An array of {@link #HISTOGRAM_BUCKETS} transmission counts with logarithmically increasing turnaround time bounds.
+	 * @see #getRs485TurnaroundTimeNanoseconds()
+	 */
+	public final long[] getRs485TurnaroundHistogram() { return getHistogram(RS485_TURNAROUND_HISTOGRAM); }
+
+	/**
+	 * Returns an upper bound on the read call latency at the specified percentile.
+	 *
+	 * @param percentile The percentile to search for, between 0.0 and 100.0.
+	 * @return The upper latency bound in microseconds of the histogram bucket containing the specified percentile, or 0 if no reads have been recorded.
+	 */
+	public final long getReadLatencyPercentile(double percentile) { return getPercentile(READ_HISTOGRAM, percentile); }
+
+	/**
+	 * Returns an upper bound on the write call latency at the specified percentile.
+	 *
+	 * @param percentile The percentile to search for, between 0.0 and 100.0.
+	 * @return The upper latency bound in microseconds of the histogram bucket containing the specified percentile, or 0 if no writes have been recorded.
+	 */
+	public final long getWriteLatencyPercentile(double percentile) { return getPercentile(WRITE_HISTOGRAM, percentile); }
+
+	/**
+	 * Returns an upper bound on the software RS-485 turnaround time at the specified percentile.
+	 *
+	 * @param percentile The percentile to search for, between 0.0 and 100.0.
+	 * @return The upper turnaround time bound in microseconds of the histogram bucket containing the specified percentile, or 0 if no software-controlled transmissions have been recorded.
+	 */
+	public final long getRs485TurnaroundPercentile(double percentile) { return getPercentile(RS485_TURNAROUND_HISTOGRAM, percentile); }
+
+	/**
+	 * Returns the exclusive upper latency bound of the specified histogram bucket.
+	 *
+	 * @param bucket The histogram bucket index.
+	 * @return The upper latency bound of the bucket in microseconds.
+	 */
+	static public final long getBucketUpperBoundMicroseconds(int bucket) { return 2L << bucket; }
+
+	@Override
+	public String toString()
+	{
+		return "bytesRead=" + getBytesRead() + ", bytesWritten=" + getBytesWritten() + ", readCalls=" + getReadCalls() + ", writeCalls=" + getWriteCalls() +
+				", readSyscalls=" + getReadSyscalls() + ", writeSyscalls=" + getWriteSyscalls() + ", shortReads=" + getShortReads() + ", readTimeouts=" + getReadTimeouts() +
+				", writeRetries=" + getWriteRetries() + ", drainTimeNs=" + getDrainTimeNanoseconds() + ", framingErrors=" + getFramingErrors() +
+				", overrunErrors=" + getOverrunErrors() + ", parityErrors=" + getParityErrors() + ", bufferOverrunErrors=" + getBufferOverrunErrors() +
+				", readP50us=" + getReadLatencyPercentile(50.0) + ", readP99us=" + getReadLatencyPercentile(99.0) +
+				", writeP50us=" + getWriteLatencyPercentile(50.0) + ", writeP99us=" + getWriteLatencyPercentile(99.0) +
+				((getRs485Transmissions() < 0) ? "" : (", rs485Transmissions=" + getRs485Transmissions() + ", rs485MaxTurnaroundNs=" + getRs485MaxTurnaroundNanoseconds() +
+				", rs485TurnaroundP99us=" + getRs485TurnaroundPercentile(99.0)));
+	}
+
+	// Histogram helper functions
+	private long[] getHistogram(int offset)
+	{
+		long[] histogram = new long[HISTOGRAM_BUCKETS];
+		System.arraycopy(statistics, offset, histogram, 0, HISTOGRAM_BUCKETS);
+		return histogram;
+	}
+
+	private long getPercentile(int offset, double percentile)
+	{
+		long totalCount = 0, runningCount = 0;
+		for (int i = 0; i < HISTOGRAM_BUCKETS; ++i)
+			totalCount += statistics[offset + i];
+		if (totalCount == 0)
+			return 0;
+		double threshold = totalCount * Math.min(Math.max(percentile, 0.0), 100.0) / 100.0;
+		for (int i = 0; i < HISTOGRAM_BUCKETS; ++i)
+		{
+			runningCount += statistics[offset + i];
+			if ((runningCount >= threshold) && (runningCount > 0))
+				return getBucketUpperBoundMicroseconds(i);
+		}
+		return getBucketUpperBoundMicroseconds(HISTOGRAM_BUCKETS - 1);
+	}
+}
@@ -0,0 +1,245 @@
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+#if defined(__APPLE__) || defined(__FreeBSD__) || defined(__OpenBSD__)
+#include <util.h>
+#else
+#include <pty.h>
+#endif
+
+// Benchmark parameters
+#define THROUGHPUT_BYTES (16 * 1024 * 1024)
+#define THROUGHPUT_CHUNK 4096
+#define ROUND_TRIP_ITERATIONS 10000
+#define ROUND_TRIP_MESSAGE 32
+
+// Global static variables
+static volatile sig_atomic_t bridgeRunning = 1;
+
+static long long getMonotonicTimeNS(void)
+{
+	struct timespec currentTime;
+	clock_gettime(CLOCK_MONOTONIC, &currentTime);
+	return ((long long)currentTime.tv_sec * 1000000000LL) + currentTime.tv_nsec;
+}
+
+static void stopBridge(int signalNumber)
+{
+	(void)signalNumber;
+	bridgeRunning = 0;
+}
+
+static int compareLatencies(const void *first, const void *second)
+{
+	long long a = *(const long long*)first, b = *(const long long*)second;
+	return (a > b) - (a < b);
+}
+
+// Opens a pseudo-terminal pair with both ends in raw mode
+static int openRawPair(int *master, int *slave, char *slaveName)
+{
+	struct termios options;
+	if (openpty(master, slave, slaveName, NULL, NULL))
+		return 0;
+	tcgetattr(*slave, &options);
+	cfmakeraw(&options);
+	options.c_cc[VMIN] = 1;
+	options.c_cc[VTIME] = 0;
+	tcsetattr(*slave, TCSANOW, &options);
+	tcgetattr(*master, &options);
+	cfmakeraw(&options);
+	tcsetattr(*master, TCSANOW, &options);
+	return 1;
+}
+
+// Writes an entire buffer, waiting for space in the terminal queue as necessary
+static int writeFully(int fd, const char *buffer, int length)
+{
+	int numBytesWritten = 0, result;
+	struct pollfd waitingSet = { fd, POLLOUT, 0 };
+	while (numBytesWritten < length)
+	{
+		do { result = write(fd, buffer + numBytesWritten, length - numBytesWritten); } while ((result < 0) && (errno == EINTR));
+		if ((result < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
+			poll(&waitingSet, 1, -1);
+		else if (result < 0)
+			return -1;
+		else
+			numBytesWritten += result;
+	}
+	return numBytesWritten;
+}
+
+// Reads an entire buffer, waiting for data as necessary
+static int readFully(int fd, char *buffer, int length)
+{
+	int numBytesRead = 0, result;
+	struct pollfd waitingSet = { fd, POLLIN, 0 };
+	while (numBytesRead < length)
+	{
+		do { result = read(fd, buffer + numBytesRead, length - numBytesRead); } while ((result < 0) && (errno == EINTR));
+		if ((result < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
+			poll(&waitingSet, 1, -1);
+		else if (result <= 0)
+			return -1;
+		else
+			numBytesRead += result;
+	}
+	return numBytesRead;
+}
+
+// Background thread functions
+static void* throughputWriter(void *fdPointer)
+{
+	char chunk[THROUGHPUT_CHUNK];
+	int fd = *(int*)fdPointer;
+	memset(chunk, 0x55, sizeof(chunk));
+	for (int i = 0; i < (THROUGHPUT_BYTES / THROUGHPUT_CHUNK); ++i)
+		if (writeFully(fd, chunk, sizeof(chunk)) < 0)
+			break;
+	return NULL;
+}
+
+static void* echoResponder(void *fdPointer)
+{
+	char message[ROUND_TRIP_MESSAGE];
+	int fd = *(int*)fdPointer;
+	for (int i = 0; i < ROUND_TRIP_ITERATIONS; ++i)
+		if ((readFully(fd, message, sizeof(message)) < 0) || (writeFully(fd, message, sizeof(message)) < 0))
+			break;
+	return NULL;
+}
+
+// Benchmark functions
+static int benchmarkThroughput(void)
+{
+	int master, slave;
+	char slaveName[256], buffer[THROUGHPUT_CHUNK];
+	if (!openRawPair(&master, &slave, slaveName))
+		return -1;
+
+	// Stream data from the master to the slave as quickly as possible
+	pthread_t writerThread;
+	long long startTime = getMonotonicTimeNS(), readCalls = 0;
+	int numBytesRead = 0, result;
+	pthread_create(&writerThread, NULL, throughputWriter, &master);
+	while (numBytesRead < THROUGHPUT_BYTES)
+	{
+		do { result = read(slave, buffer, sizeof(buffer)); } while ((result < 0) && (errno == EINTR));
+		if (result <= 0)
+			break;
+		numBytesRead += result;
+		++readCalls;
+	}
+	double elapsedSeconds = (double)(getMonotonicTimeNS() - startTime) / 1e9;
+	pthread_join(writerThread, NULL);
+	close(slave);
+	close(master);
+
+	// Output the results as a single JSON object
+	printf("{\"benchmark\":\"pty_throughput\",\"bytes\":%d,\"seconds\":%.6f,\"bytesPerSecond\":%.0f,\"readCalls\":%lld,\"bytesPerRead\":%.1f}\n",
+			numBytesRead, elapsedSeconds, numBytesRead / elapsedSeconds, readCalls, readCalls ? ((double)numBytesRead / readCalls) : 0.0);
+	return (numBytesRead == THROUGHPUT_BYTES) ? 0 : -1;
+}
+
+static int benchmarkRoundTrip(void)
+{
+	int master, slave;
+	char slaveName[256], message[ROUND_TRIP_MESSAGE];
+	if (!openRawPair(&master, &slave, slaveName))
+		return -1;
+	long long *latencies = (long long*)malloc(ROUND_TRIP_ITERATIONS * sizeof(long long));
+	if (!latencies)
+		return -1;
+
+	// Measure request/response latency against an echoing peer
+	int completed = 0;
+	pthread_t responderThread;
+	memset(message, 0xAA, sizeof(message));
+	pthread_create(&responderThread, NULL, echoResponder, &master);
+	for (; completed < ROUND_TRIP_ITERATIONS; ++completed)
+	{
+		long long startTime = getMonotonicTimeNS();
+		if ((writeFully(slave, message, sizeof(message)) < 0) || (readFully(slave, message, sizeof(message)) < 0))
+			break;
+		latencies[completed] = getMonotonicTimeNS() - startTime;
+	}
+	pthread_join(responderThread, NULL);
+	close(slave);
+	close(master);
+
+	// Output the latency percentiles as a single JSON object
+	if (completed)
+	{
+		qsort(latencies, completed, sizeof(long long), compareLatencies);
+		printf("{\"benchmark\":\"pty_round_trip\",\"iterations\":%d,\"messageBytes\":%d,\"p50Nanoseconds\":%lld,\"p90Nanoseconds\":%lld,\"p99Nanoseconds\":%lld,\"maxNanoseconds\":%lld}\n",
+				completed, ROUND_TRIP_MESSAGE, latencies[completed / 2], latencies[(completed * 9) / 10], latencies[(completed * 99) / 100], latencies[completed - 1]);
+	}
+	free(latencies);
+	return (completed == ROUND_TRIP_ITERATIONS) ? 0 : -1;
+}
+
+// Cross-connects two pseudo-terminal pairs so that their slave devices act as a null-modem loopback
+static int runBridge(void)
+{
+	int masters[2], slaves[2];
+	char slaveNames[2][256], buffer[THROUGHPUT_CHUNK];
+	if (!openRawPair(&masters[0], &slaves[0], slaveNames[0]) || !openRawPair(&masters[1], &slaves[1], slaveNames[1]))
+	{
+		printf("Error creating pseudo-terminal pairs: %s\n", strerror(errno));
+		return -1;
+	}
+
+	// Print the device paths so that they can be passed to a benchmark client, keeping the slave ends open so that the pairs persist between connections
+	printf("%s %s\n", slaveNames[0], slaveNames[1]);
+	fflush(stdout);
+	signal(SIGINT, stopBridge);
+	signal(SIGTERM, stopBridge);
+
+	// Relay data between the two masters until told to stop
+	struct pollfd waitingSet[2] = { { masters[0], POLLIN, 0 }, { masters[1], POLLIN, 0 } };
+	while (bridgeRunning)
+	{
+		if (poll(waitingSet, 2, 100) <= 0)
+			continue;
+		for (int i = 0; i < 2; ++i)
+			if (waitingSet[i].revents & POLLIN)
+			{
+				int numBytesRead = read(masters[i], buffer, sizeof(buffer));
+				if (numBytesRead > 0)
+					writeFully(masters[1 - i], buffer, numBytesRead);
+			}
+	}
+
+	// Close all pseudo-terminal devices
+	for (int i = 0; i < 2; ++i)
+	{
+		close(slaves[i]);
+		close(masters[i]);
+	}
+	return 0;
+}
+
+int main(int argc, char *argv[])
+{
+	// Run as a loopback bridge if requested
+	if ((argc == 2) && !strcmp(argv[1], "bridge"))
+		return runBridge();
+	else if (argc != 1)
+	{
+		printf("Usage: ./testBenchmarkPosix [bridge]\n");
+		return 0;
+	}
+
+	// Run the raw pseudo-terminal baseline benchmarks
+	int result = benchmarkThroughput();
+	return benchmarkRoundTrip() || result;
+}
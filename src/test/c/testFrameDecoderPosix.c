@@ -0,0 +1,131 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "PosixHelperFunctions.h"
+
+// Test parameters
+#define MAX_INPUT_LENGTH 1024
+#define MAX_DECODED_LENGTH 4096
+
+// Global static variables
+static int numFailures = 0;
+
+// Feeds the input to the decoder in fixed-size chunks the same way SerialPort.java does, concatenating all decoded frames separated by their lengths
+static int decodeInChunks(const jint *configuration, const unsigned char *input, int inputLength, int chunkLength, unsigned char *output)
+{
+	jint state[FRAME_STATE_LENGTH], boundaries[MAX_INPUT_LENGTH + 1];
+	unsigned char frames[MAX_INPUT_LENGTH + 256];
+	int outputLength = 0;
+	memcpy(state, configuration, sizeof(state));
+	for (int offset = 0; offset < inputLength; offset += chunkLength)
+	{
+		int startIndex = 0, length = ((inputLength - offset) < chunkLength) ? (inputLength - offset) : chunkLength;
+		int numFrames = decodeFrames(input + offset, length, state, frames, boundaries);
+		for (int i = 0; i < numFrames; ++i)
+		{
+			output[outputLength++] = (unsigned char)(boundaries[i] - startIndex);
+			memcpy(output + outputLength, frames + startIndex, boundaries[i] - startIndex);
+			outputLength += boundaries[i] - startIndex;
+			startIndex = boundaries[i];
+		}
+		if ((startIndex > 0) && (state[FRAME_STATE_FRAME_LENGTH] > 0))
+			memmove(frames, frames + startIndex, state[FRAME_STATE_FRAME_LENGTH]);
+	}
+	return outputLength;
+}
+
+// Checks that every chunking of the input decodes to exactly the expected frames
+static void expectFrames(const char *testName, const jint *configuration, const unsigned char *input, int inputLength, const unsigned char *expected, int expectedLength)
+{
+	static const int chunkLengths[] = { 1, 2, 3, 7, MAX_INPUT_LENGTH };
+	unsigned char output[MAX_DECODED_LENGTH];
+	for (int i = 0; i < (int)(sizeof(chunkLengths) / sizeof(chunkLengths[0])); ++i)
+	{
+		int outputLength = decodeInChunks(configuration, input, inputLength, chunkLengths[i], output);
+		if ((outputLength != expectedLength) || memcmp(output, expected, expectedLength))
+		{
+			printf("FAILED: %s with %d-byte chunks (decoded %d bytes, expected %d)\n", testName, chunkLengths[i], outputLength, expectedLength);
+			++numFailures;
+			return;
+		}
+	}
+	printf("PASSED: %s\n", testName);
+}
+
+static void testLengthPrefixed(void)
+{
+	// One type byte followed by a two-byte big-endian payload length
+	jint bigEndian[FRAME_STATE_LENGTH] = { FRAME_FORMAT_LENGTH_PREFIXED, 1, 2, 1, 0, 16 };
+	const unsigned char bigEndianInput[] = { 0x01, 0x00, 0x03, 'a', 'b', 'c', 0x02, 0x00, 0x00, 0x03, 0x00, 0x01, 'z' };
+	const unsigned char bigEndianExpected[] = { 6, 0x01, 0x00, 0x03, 'a', 'b', 'c', 3, 0x02, 0x00, 0x00, 4, 0x03, 0x00, 0x01, 'z' };
+	expectFrames("Length-prefixed big-endian frames", bigEndian, bigEndianInput, sizeof(bigEndianInput), bigEndianExpected, sizeof(bigEndianExpected));
+
+	// A two-byte little-endian length that counts itself, leaving a trailing partial frame undelivered
+	jint littleEndian[FRAME_STATE_LENGTH] = { FRAME_FORMAT_LENGTH_PREFIXED, 0, 2, 0, -2, 16 };
+	const unsigned char littleEndianInput[] = { 0x04, 0x00, 'h', 'i', 0x02, 0x00, 0x05, 0x00, 'x' };
+	const unsigned char littleEndianExpected[] = { 4, 0x04, 0x00, 'h', 'i', 2, 0x02, 0x00 };
+	expectFrames("Length-prefixed little-endian frames", littleEndian, littleEndianInput, sizeof(littleEndianInput), littleEndianExpected, sizeof(littleEndianExpected));
+
+	// Oversized frames are skipped in their entirety and frames shorter than their own header are dropped header-first
+	jint limited[FRAME_STATE_LENGTH] = { FRAME_FORMAT_LENGTH_PREFIXED, 0, 1, 0, -1, 4 };
+	const unsigned char limitedInput[] = { 0x0A, 1, 2, 3, 4, 5, 6, 7, 8, 9, 0x00, 0x03, 'o', 'k', 0x04, 1, 2, 3 };
+	const unsigned char limitedExpected[] = { 3, 0x03, 'o', 'k', 4, 0x04, 1, 2, 3 };
+	expectFrames("Length-prefixed oversized and invalid frames", limited, limitedInput, sizeof(limitedInput), limitedExpected, sizeof(limitedExpected));
+}
+
+static void testSlip(void)
+{
+	// Escaped END and ESC bytes are restored and empty frames between END bytes are ignored
+	jint slip[FRAME_STATE_LENGTH] = { FRAME_FORMAT_SLIP, 0, 0, 0, 0, 4 };
+	const unsigned char slipInput[] = { 0xC0, 'a', 0xDB, 0xDC, 'b', 0xDB, 0xDD, 0xC0, 0xC0, 'c', 0xC0 };
+	const unsigned char slipExpected[] = { 4, 'a', 0xC0, 'b', 0xDB, 1, 'c' };
+	expectFrames("SLIP frames", slip, slipInput, sizeof(slipInput), slipExpected, sizeof(slipExpected));
+
+	// Frames exceeding the maximum length are discarded until the next END byte
+	const unsigned char oversizedInput[] = { '1', '2', '3', '4', '5', 0xDB, 0xDC, 0xC0, 'o', 'k', 0xC0, 'x' };
+	const unsigned char oversizedExpected[] = { 2, 'o', 'k' };
+	expectFrames("SLIP oversized frames", slip, oversizedInput, sizeof(oversizedInput), oversizedExpected, sizeof(oversizedExpected));
+}
+
+static void testCobs(void)
+{
+	// Frames containing zeros, a lone zero, and full 254-byte blocks with and without a following block
+	unsigned char input[MAX_INPUT_LENGTH], expected[MAX_DECODED_LENGTH];
+	int inputLength = 0, expectedLength = 0;
+	jint cobs[FRAME_STATE_LENGTH] = { FRAME_FORMAT_COBS, 0, 0, 0, 0, 255 };
+	const unsigned char zerosInput[] = { 0x03, 0x11, 0x22, 0x02, 0x33, 0x00, 0x01, 0x01, 0x00 };
+	const unsigned char zerosExpected[] = { 4, 0x11, 0x22, 0x00, 0x33, 1, 0x00 };
+	memcpy(input, zerosInput, sizeof(zerosInput));
+	inputLength = sizeof(zerosInput);
+	memcpy(expected, zerosExpected, sizeof(zerosExpected));
+	expectedLength = sizeof(zerosExpected);
+	input[inputLength++] = 0xFF;
+	expected[expectedLength++] = 254;
+	for (int i = 1; i < 255; ++i)
+		input[inputLength++] = expected[expectedLength++] = (unsigned char)i;
+	input[inputLength++] = 0x00;
+	input[inputLength++] = 0xFF;
+	expected[expectedLength++] = 255;
+	for (int i = 1; i < 255; ++i)
+		input[inputLength++] = expected[expectedLength++] = (unsigned char)i;
+	input[inputLength++] = 0x02;
+	input[inputLength++] = expected[expectedLength++] = 0xFF;
+	input[inputLength++] = 0x00;
+	expectFrames("COBS frames", cobs, input, inputLength, expected, expectedLength);
+
+	// Truncated and oversized frames are dropped at the next delimiter
+	jint limited[FRAME_STATE_LENGTH] = { FRAME_FORMAT_COBS, 0, 0, 0, 0, 3 };
+	const unsigned char limitedInput[] = { 0x04, 0x11, 0x00, 0x05, 1, 2, 3, 4, 0x00, 0x02, 'k', 0x01, 0x00, 0x02, 'x' };
+	const unsigned char limitedExpected[] = { 2, 'k', 0x00 };
+	expectFrames("COBS truncated and oversized frames", limited, limitedInput, sizeof(limitedInput), limitedExpected, sizeof(limitedExpected));
+}
+
+int main(void)
+{
+	// Exercise every supported framing format
+	testLengthPrefixed();
+	testSlip();
+	testCobs();
+	printf("%d test(s) failed\n", numFailures);
+	return numFailures ? -1 : 0;
+}
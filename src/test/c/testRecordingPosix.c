@@ -0,0 +1,165 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "PosixHelperFunctions.h"
+
+// Test parameters
+#define RECORDING_LENGTH RECORDING_MINIMUM_LENGTH
+#define NUM_ENTRIES 20000
+#define MAX_ENTRY_LENGTH 300
+#define SPLIT_ENTRY_LENGTH 5000
+
+// Global static variables
+static int numFailures = 0, numPaddingEntries = 0, numSkippedTails = 0;
+static unsigned int randomState = 12345;
+
+static unsigned int nextRandom(void)
+{
+	randomState = (randomState * 1103515245U) + 12345U;
+	return (randomState >> 16) & 0x7FFF;
+}
+
+static unsigned char getPatternByte(long long timestampNS, unsigned int index)
+{
+	return (unsigned char)((timestampNS * 31) + index);
+}
+
+static void fail(const char *testName, const char *reason, long long timestampNS)
+{
+	printf("FAILED: %s at entry %lld: %s\n", testName, timestampNS, reason);
+	++numFailures;
+}
+
+// Walks all retained entries from the oldest to the newest the way a reader would, returning the number of data entries or -1 if the layout is invalid
+static int walkRecording(const char *recording, int (*visitEntry)(const recordingEntry*, void*), void *context)
+{
+	const recordingHeader *header = (const recordingHeader*)recording;
+	const char *dataRegion = recording + sizeof(recordingHeader);
+	unsigned long long position = header->oldestPosition;
+	int numEntries = 0;
+	numPaddingEntries = numSkippedTails = 0;
+	if ((header->writePosition < header->oldestPosition) || ((header->writePosition - header->oldestPosition) > header->dataLength))
+		return -1;
+	while (position < header->writePosition)
+	{
+		unsigned long long offset = position % header->dataLength, remaining = header->dataLength - offset;
+		if (remaining < sizeof(recordingEntry))
+		{
+			++numSkippedTails;
+			position += remaining;
+			continue;
+		}
+		const recordingEntry *entry = (const recordingEntry*)(dataRegion + offset);
+		unsigned long long entrySize = sizeof(recordingEntry) + ((entry->length + 7ULL) & ~7ULL);
+		if ((entrySize > remaining) || ((position + entrySize) > header->writePosition))
+			return -1;
+		position += entrySize;
+		if (entry->direction == RECORDING_DIRECTION_PADDING)
+		{
+			if (entrySize != remaining)
+				return -1;
+			++numPaddingEntries;
+			continue;
+		}
+		if (!visitEntry(entry, context))
+			return -1;
+		++numEntries;
+	}
+	return numEntries;
+}
+
+// Checks that retained entries are consecutive, intact, and end with the most recently appended entry
+static int checkSequentialEntry(const recordingEntry *entry, void *context)
+{
+	long long *expectedTimestampNS = (long long*)context;
+	const unsigned char *data = (const unsigned char*)(entry + 1);
+	if ((*expectedTimestampNS >= 0) && (entry->timestampNS != *expectedTimestampNS))
+		return 0;
+	if (entry->direction != (unsigned short)(entry->timestampNS & 1))
+		return 0;
+	for (unsigned int i = 0; i < entry->length; ++i)
+		if (data[i] != getPatternByte(entry->timestampNS, i))
+			return 0;
+	*expectedTimestampNS = entry->timestampNS + 1;
+	return 1;
+}
+
+static void testWrapAround(void)
+{
+	// Append many variable-length entries so that the data region wraps repeatedly
+	const char *testName = "Recording wrap-around";
+	char *recording = (char*)calloc(1, RECORDING_LENGTH);
+	unsigned char payload[MAX_ENTRY_LENGTH];
+	initializeRecording(recording, RECORDING_LENGTH, 0, 0);
+	const recordingHeader *header = (const recordingHeader*)recording;
+	unsigned long long maxEntrySize = sizeof(recordingEntry) + MAX_ENTRY_LENGTH + 8;
+	int paddingWritten = 0, tailSkipped = 0;
+	for (long long timestampNS = 0; (timestampNS < NUM_ENTRIES) && !numFailures; ++timestampNS)
+	{
+		unsigned int length = 1 + (nextRandom() % MAX_ENTRY_LENGTH);
+		for (unsigned int i = 0; i < length; ++i)
+			payload[i] = getPatternByte(timestampNS, i);
+		appendRecording(recording, (unsigned short)(timestampNS & 1), timestampNS, (const char*)payload, (int)length);
+
+		// Verify the retained entries and that no more space was reclaimed than necessary
+		long long expectedTimestampNS = -1;
+		unsigned long long usedLength = header->writePosition - header->oldestPosition;
+		if (walkRecording(recording, checkSequentialEntry, &expectedTimestampNS) <= 0)
+			fail(testName, "invalid recording layout", timestampNS);
+		else if (expectedTimestampNS != (timestampNS + 1))
+			fail(testName, "newest entry missing", timestampNS);
+		else if (header->oldestPosition && ((usedLength + (2 * maxEntrySize)) < header->dataLength))
+			fail(testName, "too much space reclaimed", timestampNS);
+		paddingWritten = paddingWritten || numPaddingEntries;
+		tailSkipped = tailSkipped || numSkippedTails;
+	}
+	if (!numFailures && (header->writePosition < (10 * header->dataLength)))
+		fail(testName, "data region did not wrap", NUM_ENTRIES);
+	else if (!numFailures && !paddingWritten)
+		fail(testName, "no padding entries were written", NUM_ENTRIES);
+	else if (!numFailures)
+		printf("PASSED: %s (%llu wraps, %s)\n", testName, header->writePosition / header->dataLength, tailSkipped ? "padded and skipped tails" : "padded tails only");
+	free(recording);
+}
+
+// Concatenates the data of all retained entries
+static int appendEntryData(const recordingEntry *entry, void *context)
+{
+	unsigned char **output = (unsigned char**)context;
+	memcpy(*output, entry + 1, entry->length);
+	*output += entry->length;
+	return entry->timestampNS == 1;
+}
+
+static void testSplitEntries(void)
+{
+	// Append a chunk too large to fit and make sure that the retained entries hold the tail of its data
+	const char *testName = "Recording oversized chunk splitting";
+	char *recording = (char*)calloc(1, RECORDING_LENGTH);
+	unsigned char payload[SPLIT_ENTRY_LENGTH], retained[SPLIT_ENTRY_LENGTH], *retainedEnd = retained;
+	for (unsigned int i = 0; i < SPLIT_ENTRY_LENGTH; ++i)
+		payload[i] = getPatternByte(1, i);
+	initializeRecording(recording, RECORDING_LENGTH, 0, 0);
+	appendRecording(recording, RECORDING_DIRECTION_TRANSMITTED, 1, (const char*)payload, SPLIT_ENTRY_LENGTH);
+	const recordingHeader *header = (const recordingHeader*)recording;
+	int numEntries = walkRecording(recording, appendEntryData, &retainedEnd);
+	int retainedLength = (int)(retainedEnd - retained);
+	if (numEntries < 2)
+		fail(testName, "chunk was not split", 1);
+	else if ((header->writePosition - header->oldestPosition) > header->dataLength)
+		fail(testName, "data region overflowed", 1);
+	else if ((retainedLength < (int)(header->dataLength / 2)) || memcmp(retained, payload + SPLIT_ENTRY_LENGTH - retainedLength, retainedLength))
+		fail(testName, "retained data is not the tail of the chunk", 1);
+	else
+		printf("PASSED: %s (%d entries holding the last %d bytes)\n", testName, numEntries, retainedLength);
+	free(recording);
+}
+
+int main(void)
+{
+	// Exercise the rolling recording buffer
+	testWrapAround();
+	testSplitEntries();
+	printf("%d test(s) failed\n", numFailures);
+	return numFailures ? -1 : 0;
+}
@@ -0,0 +1,197 @@
+// Include the native implementation directly so that its static virtual port functions can be exercised without a JVM
+#include "SerialPort_Posix.c"
+
+// Test parameters
+#define LOOPBACK_LENGTH 65536
+#define READ_TIMEOUT_MS 2000
+#define NUM_REPLAY_ENTRIES 2000
+
+// Global static variables
+static int numFailures = 0;
+
+static void fail(const char *testName, const char *reason)
+{
+	printf("FAILED: %s: %s\n", testName, reason);
+	++numFailures;
+}
+
+// Opens a virtual port in raw mode the same way the port configuration step would
+static int openRawVirtualPort(serialPort *port, const char *portName)
+{
+	struct termios options;
+	memset(port, 0, sizeof(serialPort));
+	port->virtualDevice = -1;
+	int portFD = openVirtualPort(port, portName);
+	if ((portFD >= 0) && !tcgetattr(portFD, &options))
+	{
+		cfmakeraw(&options);
+		tcsetattr(portFD, TCSANOW, &options);
+	}
+	return portFD;
+}
+
+// Reads until the requested number of bytes arrives or no data has been received for the timeout period
+static int readWithTimeout(int fd, unsigned char *buffer, int length, int timeoutMS)
+{
+	struct pollfd waitingSet = { fd, POLLIN, 0 };
+	int numBytesRead = 0;
+	while ((numBytesRead < length) && (poll(&waitingSet, 1, timeoutMS) > 0))
+	{
+		int result = read(fd, buffer + numBytesRead, length - numBytesRead);
+		if ((result < 0) && (errno != EAGAIN) && (errno != EWOULDBLOCK) && (errno != EINTR))
+			break;
+		else if (result > 0)
+			numBytesRead += result;
+	}
+	return numBytesRead;
+}
+
+// Writes an entire buffer to a non-blocking port
+static int writeFully(int fd, const unsigned char *buffer, int length)
+{
+	struct pollfd waitingSet = { fd, POLLOUT, 0 };
+	int numBytesWritten = 0;
+	while (numBytesWritten < length)
+	{
+		int result = write(fd, buffer + numBytesWritten, length - numBytesWritten);
+		if ((result < 0) && ((errno == EAGAIN) || (errno == EWOULDBLOCK)))
+			poll(&waitingSet, 1, READ_TIMEOUT_MS);
+		else if ((result < 0) && (errno != EINTR))
+			return -1;
+		else if (result > 0)
+			numBytesWritten += result;
+	}
+	return numBytesWritten;
+}
+
+static void testLoopback(void)
+{
+	// Every byte value written to a loopback port must be read back unchanged and in order
+	const char *testName = "Virtual loopback port";
+	serialPort port;
+	unsigned char *written = (unsigned char*)malloc(LOOPBACK_LENGTH), *received = (unsigned char*)malloc(LOOPBACK_LENGTH);
+	int portFD = openRawVirtualPort(&port, VIRTUAL_LOOPBACK_PREFIX "test"), numBytesRead = 0, modemLines = 0;
+	for (int i = 0; i < LOOPBACK_LENGTH; ++i)
+		written[i] = (unsigned char)((i * 7) + (i >> 8));
+	if (portFD < 0)
+		fail(testName, strerror(errno));
+	else
+	{
+		// Write in chunks while draining the port so that neither side of the pseudo-terminal fills up
+		for (int offset = 0; offset < LOOPBACK_LENGTH; offset += 1024)
+		{
+			if (writeFully(portFD, written + offset, 1024) != 1024)
+				break;
+			numBytesRead += readWithTimeout(portFD, received + numBytesRead, offset + 1024 - numBytesRead, READ_TIMEOUT_MS);
+		}
+		if ((numBytesRead != LOOPBACK_LENGTH) || memcmp(written, received, LOOPBACK_LENGTH))
+			fail(testName, "looped back data does not match");
+
+		// The emulated modem lines follow the outputs that are wired to them
+		else if (getModemLines(&port, &modemLines) || ((modemLines & (TIOCM_CTS | TIOCM_DSR | TIOCM_CAR)) != (TIOCM_CTS | TIOCM_DSR | TIOCM_CAR)))
+			fail(testName, "inputs not asserted after opening");
+		else if (changeModemLines(&port, 0, TIOCM_RTS) || getModemLines(&port, &modemLines) || (modemLines & TIOCM_CTS) || !(modemLines & TIOCM_DSR))
+			fail(testName, "clearing RTS did not clear only CTS");
+		else if (changeModemLines(&port, 0, TIOCM_DTR) || getModemLines(&port, &modemLines) || (modemLines & (TIOCM_DSR | TIOCM_CAR)))
+			fail(testName, "clearing DTR did not clear DSR and DCD");
+		else
+			printf("PASSED: %s (%d bytes)\n", testName, numBytesRead);
+		close(portFD);
+		closeVirtualPort(&port);
+	}
+	free(written);
+	free(received);
+}
+
+// Writes a trace file with interleaved received and transmitted entries, returning the received data that remains after wrapping
+static int createReplayFile(const char *fileName, unsigned char *expected)
+{
+	int expectedLength = 0, fileFD = open(fileName, O_RDWR | O_CREAT | O_TRUNC, 0600);
+	char *recording = (char*)calloc(1, RECORDING_MINIMUM_LENGTH);
+	initializeRecording(recording, RECORDING_MINIMUM_LENGTH, 0, 0);
+	for (int i = 0; i < NUM_REPLAY_ENTRIES; ++i)
+	{
+		char entry[32];
+		int length = snprintf(entry, sizeof(entry), "%s%d;", (i % 3) ? "rx" : "tx", i);
+		appendRecording(recording, (i % 3) ? RECORDING_DIRECTION_RECEIVED : RECORDING_DIRECTION_TRANSMITTED, 1000LL * i, entry, length);
+	}
+
+	// Replay starts at the oldest retained entry, so only count received entries at or after it
+	const recordingHeader *header = (const recordingHeader*)recording;
+	unsigned long long position = header->oldestPosition;
+	const recordingEntry *entry;
+	serialPort replayPort;
+	memset(&replayPort, 0, sizeof(replayPort));
+	replayPort.virtualReplay = recording;
+	while ((entry = getNextReplayEntry(&replayPort, &position)) != NULL)
+	{
+		memcpy(expected + expectedLength, entry + 1, entry->length);
+		expectedLength += entry->length;
+	}
+	if ((fileFD < 0) || (write(fileFD, recording, RECORDING_MINIMUM_LENGTH) != RECORDING_MINIMUM_LENGTH) || !header->oldestPosition)
+		expectedLength = -1;
+	if (fileFD >= 0)
+		close(fileFD);
+	free(recording);
+	return expectedLength;
+}
+
+static void testReplay(void)
+{
+	// A replay port delivers exactly the retained received data, ignoring transmitted entries and anything written to it
+	const char *testName = "Virtual replay port";
+	char fileName[] = "/tmp/jSerialCommReplayXXXXXX", portName[PATH_MAX];
+	unsigned char expected[RECORDING_MINIMUM_LENGTH], received[RECORDING_MINIMUM_LENGTH];
+	serialPort port;
+	int fileFD = mkstemp(fileName);
+	if (fileFD < 0)
+	{
+		fail(testName, "unable to create a trace file");
+		return;
+	}
+	close(fileFD);
+	int expectedLength = createReplayFile(fileName, expected);
+	snprintf(portName, sizeof(portName), VIRTUAL_REPLAY_PREFIX "test:0:%s", fileName);
+	int portFD = (expectedLength > 0) ? openRawVirtualPort(&port, portName) : -1;
+	if (expectedLength <= 0)
+		fail(testName, "unable to write a wrapped trace file");
+	else if (portFD < 0)
+		fail(testName, strerror(errno));
+	else
+	{
+		int numBytesRead = (writeFully(portFD, (const unsigned char*)"ignored", 7) == 7) ? readWithTimeout(portFD, received, sizeof(received), READ_TIMEOUT_MS / 4) : -1;
+		if ((numBytesRead != expectedLength) || memcmp(expected, received, expectedLength) || memcmp(received, "rx", 2))
+			fail(testName, "replayed data does not match the received entries");
+		else
+			printf("PASSED: %s (%d bytes)\n", testName, numBytesRead);
+		close(portFD);
+		closeVirtualPort(&port);
+	}
+
+	// Malformed descriptors and trace files must be rejected
+	int invalidFD = open(fileName, O_WRONLY);
+	if ((invalidFD < 0) || (write(invalidFD, "notATrace", 9) != 9))
+		fail(testName, "unable to corrupt the trace file");
+	if (invalidFD >= 0)
+		close(invalidFD);
+	errno = 0;
+	if ((openRawVirtualPort(&port, portName) >= 0) || (errno != EINVAL))
+		fail(testName, "corrupt trace file accepted");
+	snprintf(portName, sizeof(portName), VIRTUAL_REPLAY_PREFIX "test:fast:%s", fileName);
+	errno = 0;
+	if ((openRawVirtualPort(&port, portName) >= 0) || (errno != EINVAL))
+		fail(testName, "invalid replay speed accepted");
+	errno = 0;
+	if ((openRawVirtualPort(&port, VIRTUAL_PORT_PREFIX "unknown:test") >= 0) || (errno != EINVAL))
+		fail(testName, "unknown virtual port type accepted");
+	unlink(fileName);
+}
+
+int main(void)
+{
+	// Exercise both kinds of virtual ports
+	testLoopback();
+	testReplay();
+	printf("%d test(s) failed\n", numFailures);
+	return numFailures ? -1 : 0;
+}
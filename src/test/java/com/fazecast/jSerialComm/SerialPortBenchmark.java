@@ -0,0 +1,363 @@
+/*
+ * SerialPortBenchmark.java
+ *
+ *       Created on:  Oct 14, 2026
+ *  Last Updated on:  Oct 14, 2026
+ *           Author:  Will Hedgecock
+ *
+ * Copyright (C) 2012-2022 Fazecast, Inc.
+ *
+ * This file is part of jSerialComm.
+ *
+ * jSerialComm is free software: you can redistribute it and/or modify
+ * it under the terms of either the Apache Software License, version 2, or
+ * the GNU Lesser General Public License as published by the Free Software
+ * Foundation, version 3 or above.
+ *
+ * jSerialComm is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ *
+ * You should have received a copy of both the GNU Lesser General Public
+ * License and the Apache Software License along with jSerialComm. If not,
+ * see <http://www.gnu.org/licenses/> and <http://www.apache.org/licenses/>.
+ */
+
+package com.fazecast.jSerialComm;
+
+import java.io.InputStream;
+import java.io.OutputStream;
+import java.lang.management.ManagementFactory;
+import java.lang.reflect.Method;
+import java.util.Arrays;
+import java.util.concurrent.Semaphore;
+import java.util.concurrent.TimeUnit;
+
+/**
+ * This class provides a reproducible throughput and latency benchmark for the jSerialComm library.
+ * <p>
+ * The benchmark requires two serial ports that are connected to each other, such as the pseudo-terminal pair created by running
+ * <i>testBenchmarkPosix bridge</i> from the native test directory on a Posix system, or a <i>com0com</i> virtual null-modem pair
+ * on Windows. Each result is printed to standard output as a single-line JSON object so that it can be collected and compared
+ * between releases.
+ *
+ * @author Will Hedgecock &lt;will.hedgecock@gmail.com&gt;
+ * @version 2.9.1
+ */
+public class SerialPortBenchmark
+{
+	// Benchmark parameters
+	private static final int THROUGHPUT_BYTES = 4 * 1024 * 1024, THROUGHPUT_CHUNK = 4096, MESSAGE_SIZE = 32, WARMUP_ITERATIONS = 200;
+	private static int iterations = 2000;
+
+	// Per-thread allocation measurement using the HotSpot-specific thread management extension, if available
+	private static Object threadBean = null;
+	private static Method allocatedBytesMethod = null;
+	static
+	{
+		try
+		{
+			threadBean = ManagementFactory.getThreadMXBean();
+			allocatedBytesMethod = Class.forName("com.sun.management.ThreadMXBean").getMethod("getThreadAllocatedBytes", long.class);
+			if (((Long)allocatedBytesMethod.invoke(threadBean, Thread.currentThread().getId())).longValue() < 0)
+				allocatedBytesMethod = null;
+		}
+		catch (Exception e) { allocatedBytesMethod = null; }
+	}
+
+	private static long getAllocatedBytes()
+	{
+		try { return (allocatedBytesMethod != null) ? ((Long)allocatedBytesMethod.invoke(threadBean, Thread.currentThread().getId())).longValue() : -1; }
+		catch (Exception e) { return -1; }
+	}
+
+	// Latency recording functionality
+	private static final class LatencyRecorder
+	{
+		private final long[] latencies;
+		private int count = 0, allocationStartCount = 0;
+		private long allocationStart = -1, allocationEnd = -1;
+
+		public LatencyRecorder(int capacity) { latencies = new long[capacity]; }
+		public void record(long latencyNS) { if (count < latencies.length) latencies[count++] = latencyNS; }
+		public boolean isFull() { return count == latencies.length; }
+		public void startAllocations() { allocationStartCount = count; allocationStart = getAllocatedBytes(); }
+		public void stopAllocations() { allocationEnd = getAllocatedBytes(); }
+
+		public String toJson(String name, String api)
+		{
+			long[] sorted = Arrays.copyOf(latencies, count);
+			Arrays.sort(sorted);
+			int allocationMessages = count - allocationStartCount;
+			double allocationsPerMessage = ((allocationStart >= 0) && (allocationEnd >= 0) && (allocationMessages > 0)) ? ((double)(allocationEnd - allocationStart) / allocationMessages) : -1.0;
+			return "{\"benchmark\":\"" + name + "\",\"api\":\"" + api + "\",\"iterations\":" + count + ",\"messageBytes\":" + MESSAGE_SIZE +
+					",\"p50Nanoseconds\":" + percentile(sorted, 50) + ",\"p90Nanoseconds\":" + percentile(sorted, 90) + ",\"p99Nanoseconds\":" + percentile(sorted, 99) +
+					",\"maxNanoseconds\":" + ((count > 0) ? sorted[count - 1] : 0) + ",\"allocatedBytesPerMessage\":" + String.format("%.1f", allocationsPerMessage) + "}";
+		}
+
+		private static long percentile(long[] sorted, int percentile) { return (sorted.length > 0) ? sorted[(sorted.length * percentile) / 100] : 0; }
+	}
+
+	// Echoing peer functionality
+	private static final class EchoResponder extends Thread
+	{
+		private final SerialPort port;
+		private final int messageCount;
+
+		public EchoResponder(SerialPort port, int messageCount) { this.port = port; this.messageCount = messageCount; setDaemon(true); }
+
+		@Override
+		public void run()
+		{
+			byte[] message = new byte[MESSAGE_SIZE];
+			for (int i = 0; i < messageCount; ++i)
+				if ((readFully(port, message, MESSAGE_SIZE) != MESSAGE_SIZE) || (port.writeBytes(message, MESSAGE_SIZE) != MESSAGE_SIZE))
+					break;
+		}
+	}
+
+	// Listener dispatch measurement functionality
+	private static class DispatchListener implements SerialPortDataListener
+	{
+		protected final Semaphore messageReceived = new Semaphore(0);
+		protected final LatencyRecorder recorder;
+		protected volatile long sendTime = 0;
+		private int bytesPending = 0;
+
+		public DispatchListener(LatencyRecorder recorder) { this.recorder = recorder; }
+
+		protected final void messageComplete(long receiveTime)
+		{
+			// Allocations are measured on the event dispatch thread between the first and last recorded messages
+			if (sendTime != 0)
+			{
+				recorder.record(receiveTime - sendTime);
+				if (recorder.count == 1)
+					recorder.startAllocations();
+				else if (recorder.isFull())
+					recorder.stopAllocations();
+			}
+			messageReceived.release();
+		}
+		@Override
+		public int getListeningEvents() { return SerialPort.LISTENING_EVENT_DATA_RECEIVED; }
+		@Override
+		public void serialEvent(SerialPortEvent event)
+		{
+			// Signal the sender only once a complete message has arrived
+			bytesPending += event.getReceivedData().length;
+			if (bytesPending >= MESSAGE_SIZE)
+			{
+				bytesPending -= MESSAGE_SIZE;
+				messageComplete(System.nanoTime());
+			}
+		}
+	}
+
+	private static final class AvailableDispatchListener extends DispatchListener
+	{
+		private final byte[] message = new byte[MESSAGE_SIZE];
+		private SerialPort port = null;
+
+		public AvailableDispatchListener(LatencyRecorder recorder) { super(recorder); }
+		public void setPort(SerialPort port) { this.port = port; }
+		@Override
+		public int getListeningEvents() { return SerialPort.LISTENING_EVENT_DATA_AVAILABLE; }
+		@Override
+		public void serialEvent(SerialPortEvent event)
+		{
+			// Read each complete message manually as it becomes available
+			while (port.bytesAvailable() >= MESSAGE_SIZE)
+			{
+				port.readBytes(message, MESSAGE_SIZE);
+				messageComplete(System.nanoTime());
+			}
+		}
+	}
+
+	private static final class PacketDispatchListener extends DispatchListener implements SerialPortPacketListener
+	{
+		public PacketDispatchListener(LatencyRecorder recorder) { super(recorder); }
+		@Override
+		public int getPacketSize() { return MESSAGE_SIZE; }
+	}
+
+	private static final class MessageDispatchListener extends DispatchListener implements SerialPortMessageListener
+	{
+		public MessageDispatchListener(LatencyRecorder recorder) { super(recorder); }
+		@Override
+		public byte[] getMessageDelimiter() { return new byte[] { (byte)'\n' }; }
+		@Override
+		public boolean delimiterIndicatesEndOfMessage() { return true; }
+	}
+
+	// Helper functions
+	private static int readFully(SerialPort port, byte[] buffer, int length)
+	{
+		int numRead = 0;
+		while (numRead < length)
+		{
+			int result = port.readBytes(buffer, length - numRead, numRead);
+			if (result <= 0)
+				return numRead;
+			numRead += result;
+		}
+		return numRead;
+	}
+
+	private static byte[] createMessage()
+	{
+		byte[] message = new byte[MESSAGE_SIZE];
+		Arrays.fill(message, (byte)'A');
+		message[MESSAGE_SIZE - 1] = (byte)'\n';
+		return message;
+	}
+
+	private static void printThroughput(String api, long numBytes, long elapsedNS, String direction)
+	{
+		double elapsedSeconds = elapsedNS / 1e9;
+		System.out.println("{\"benchmark\":\"throughput\",\"api\":\"" + api + "\",\"direction\":\"" + direction + "\",\"bytes\":" + numBytes +
+				",\"seconds\":" + String.format("%.6f", elapsedSeconds) + ",\"bytesPerSecond\":" + String.format("%.0f", numBytes / elapsedSeconds) + "}");
+	}
+
+	private static void printStatistics(String api, SerialPort port)
+	{
+		SerialPortStatistics statistics = port.getStatistics();
+		if (statistics != null)
+			System.out.println("{\"benchmark\":\"statistics\",\"api\":\"" + api + "\",\"port\":\"" + port.getSystemPortName() + "\",\"readCalls\":" + statistics.getReadCalls() +
+					",\"readSyscalls\":" + statistics.getReadSyscalls() + ",\"shortReads\":" + statistics.getShortReads() + ",\"writeCalls\":" + statistics.getWriteCalls() +
+					",\"writeSyscalls\":" + statistics.getWriteSyscalls() + ",\"writeRetries\":" + statistics.getWriteRetries() + ",\"readP99Microseconds\":" +
+					statistics.getReadLatencyPercentile(99.0) + ",\"writeP99Microseconds\":" + statistics.getWriteLatencyPercentile(99.0) + "}");
+	}
+
+	// Benchmark functions
+	private static void benchmarkThroughput(final SerialPort sender, final SerialPort receiver, final boolean useStreams) throws Exception
+	{
+		// Stream data from the sender to the receiver as quickly as possible
+		final byte[] chunk = new byte[THROUGHPUT_CHUNK];
+		receiver.setComPortTimeouts(SerialPort.TIMEOUT_READ_SEMI_BLOCKING, 1000, 0);
+		sender.resetStatistics();
+		receiver.resetStatistics();
+		Thread writer = new Thread(new Runnable() {
+			@Override
+			public void run()
+			{
+				try
+				{
+					OutputStream outputStream = useStreams ? sender.getOutputStream() : null;
+					for (int i = 0; i < (THROUGHPUT_BYTES / THROUGHPUT_CHUNK); ++i)
+						if (useStreams)
+							outputStream.write(chunk);
+						else if (sender.writeBytes(chunk, chunk.length) != chunk.length)
+							break;
+				}
+				catch (Exception e) { e.printStackTrace(); }
+			}
+		});
+		byte[] readBuffer = new byte[THROUGHPUT_CHUNK];
+		InputStream inputStream = useStreams ? receiver.getInputStream() : null;
+		long numBytesRead = 0, startTime = System.nanoTime();
+		writer.start();
+		while (numBytesRead < THROUGHPUT_BYTES)
+		{
+			int result = useStreams ? inputStream.read(readBuffer) : receiver.readBytes(readBuffer, readBuffer.length);
+			if (result <= 0)
+				break;
+			numBytesRead += result;
+		}
+		long elapsedTime = System.nanoTime() - startTime;
+		writer.join();
+		printThroughput(useStreams ? "streams" : "readBytes", numBytesRead, elapsedTime, sender.getSystemPortName() + "->" + receiver.getSystemPortName());
+		printStatistics(useStreams ? "streams" : "readBytes", receiver);
+	}
+
+	private static void benchmarkRoundTrip(SerialPort requester, SerialPort responder, boolean useStreams) throws Exception
+	{
+		// Measure the request/response latency against an echoing peer
+		byte[] message = createMessage();
+		requester.setComPortTimeouts(SerialPort.TIMEOUT_READ_BLOCKING, 1000, 0);
+		responder.setComPortTimeouts(SerialPort.TIMEOUT_READ_BLOCKING, 1000, 0);
+		EchoResponder echoThread = new EchoResponder(responder, WARMUP_ITERATIONS + iterations);
+		echoThread.start();
+		InputStream inputStream = requester.getInputStream();
+		OutputStream outputStream = requester.getOutputStream();
+		LatencyRecorder recorder = new LatencyRecorder(iterations);
+		for (int i = 0; i < (WARMUP_ITERATIONS + iterations); ++i)
+		{
+			if (i == WARMUP_ITERATIONS)
+				recorder.startAllocations();
+			long startTime = System.nanoTime();
+			if (useStreams)
+			{
+				outputStream.write(message);
+				for (int numRead = 0; numRead < MESSAGE_SIZE; )
+					numRead += inputStream.read(message, numRead, MESSAGE_SIZE - numRead);
+			}
+			else if ((requester.writeBytes(message, MESSAGE_SIZE) != MESSAGE_SIZE) || (readFully(requester, message, MESSAGE_SIZE) != MESSAGE_SIZE))
+				break;
+			if (i >= WARMUP_ITERATIONS)
+				recorder.record(System.nanoTime() - startTime);
+		}
+		recorder.stopAllocations();
+		echoThread.join(1000);
+		System.out.println(recorder.toJson("round_trip", useStreams ? "streams" : "readBytes"));
+	}
+
+	private static void benchmarkListener(SerialPort sender, SerialPort receiver, String api, DispatchListener listener) throws Exception
+	{
+		// Measure the time from writing a message to its delivery to the registered listener
+		byte[] message = createMessage();
+		if (listener instanceof AvailableDispatchListener)
+			((AvailableDispatchListener)listener).setPort(receiver);
+		receiver.addDataListener(listener);
+		for (int i = 0; i < (WARMUP_ITERATIONS + iterations); ++i)
+		{
+			listener.sendTime = (i >= WARMUP_ITERATIONS) ? System.nanoTime() : 0;
+			sender.writeBytes(message, MESSAGE_SIZE);
+			if (!listener.messageReceived.tryAcquire(1, TimeUnit.SECONDS))
+				break;
+		}
+		receiver.removeDataListener();
+		System.out.println(listener.recorder.toJson("listener_dispatch", api));
+	}
+
+	static public void main(String[] args)
+	{
+		// Ensure that a pair of connected ports was specified
+		if ((args.length < 2) || (args.length > 3))
+		{
+			System.out.println("Usage: java -cp jSerialComm-test.jar com.fazecast.jSerialComm.SerialPortBenchmark <portA> <portB> [iterations]");
+			return;
+		}
+		if (args.length == 3)
+			iterations = Integer.parseInt(args[2]);
+		SerialPort portA = SerialPort.getCommPort(args[0]), portB = SerialPort.getCommPort(args[1]);
+		portA.setBaudRate(115200);
+		portB.setBaudRate(115200);
+		if (!portA.openPort(0) || !portB.openPort(0))
+		{
+			System.out.println("{\"error\":\"Unable to open ports\",\"codeA\":" + portA.getLastErrorCode() + ",\"codeB\":" + portB.getLastErrorCode() + "}");
+			portA.closePort();
+			portB.closePort();
+			return;
+		}
+		System.out.println("{\"benchmark\":\"environment\",\"version\":\"" + SerialPort.getVersion() + "\",\"os\":\"" + System.getProperty("os.name") +
+				"\",\"arch\":\"" + System.getProperty("os.arch") + "\",\"java\":\"" + System.getProperty("java.version") + "\",\"iterations\":" + iterations + "}");
+
+		// Run all benchmarks in a fixed order
+		try
+		{
+			benchmarkThroughput(portA, portB, false);
+			benchmarkThroughput(portA, portB, true);
+			benchmarkRoundTrip(portA, portB, false);
+			benchmarkRoundTrip(portA, portB, true);
+			benchmarkListener(portA, portB, "dataAvailableListener", new AvailableDispatchListener(new LatencyRecorder(iterations)));
+			benchmarkListener(portA, portB, "dataReceivedListener", new DispatchListener(new LatencyRecorder(iterations)));
+			benchmarkListener(portA, portB, "packetListener", new PacketDispatchListener(new LatencyRecorder(iterations)));
+			benchmarkListener(portA, portB, "messageListener", new MessageDispatchListener(new LatencyRecorder(iterations)));
+		}
+		catch (Exception e) { e.printStackTrace(); }
+		portA.closePort();
+		portB.closePort();
+	}
+}